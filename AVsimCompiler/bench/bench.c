@@ -0,0 +1,632 @@
+/** @file bench.c
+*
+* @brief Benchmark of the Avalon Compiler: reproducible synthetic sources and the throughput
+*           of the compiler functions against a stored baseline.
+*
+*/
+
+#include "bench.h"
+
+// === Type Definitions ===
+//
+typedef struct benchOptions
+{
+    uint64_t maxLines;          // Largest corpus of the suite
+    int jobs;                   // Worker threads of CompileCode and EmitCode
+    int repeats;
+    uint64_t seed;
+    const char *p_profile;      // Single profile, NULL: each one
+    const char *p_baseline;     // Baseline to compare with
+    const char *p_save;         // Baseline to be written
+    const char *p_generate;     // Generator mode: the path of the source
+    uint64_t generateLines;
+} benchOptions_t;
+
+typedef struct benchResult
+{
+    char name[BENCH_NAME_LIMIT];    // <profile>-<rows>
+    corpusStats_t corpus;
+    int64_t time[benchPhaseLimit];  // Best wall time of each phase [us]
+    uint64_t foundInvalid;          // Invalid rows found by the compiler
+} benchResult_t;
+
+// === Constant Definitions ===
+//
+static const benchProfile_t PROFILES[] =
+{
+    // name            nop read write wait load repeat bread bwrite   comment invalid digits
+    { "mixed",       {  2,  10,  10,   3,   2,   2,     1,    1 },   20,      1,      8 },
+    { "transfer",    {  1,  20,  20,   1,   1,   0,     0,    0 },    5,      0,      8 },
+    { "control",     {  1,   4,   4,   2,   4,   6,     3,    3 },   10,      0,      4 },
+    { "commented",   {  2,  10,  10,   3,   2,   2,     1,    1 },   70,      0,      8 },
+    { "invalid",     {  2,  10,  10,   3,   2,   2,     1,    1 },   20,     25,      8 },
+    { "narrow",      {  2,  10,  10,   3,   2,   2,     1,    1 },   20,      1,      2 }
+};
+
+static const uint64_t SUITE_LINES[] = { 1000, 10000, 100000, 1000000, 10000000, 50000000 };
+
+static const char * const PHASE_NAMES[benchPhaseLimit] = { "read", "compile", "emit", "write", "notify", "total" };
+
+static const char * const COMMENTS[] =
+{
+    "Set the dividend", "Poll the ready flag of the divider", "timing", "Clear IRQ",
+    "Start the module and wait for the completion of the operation", "burst of the frame buffer", "x"
+};
+
+static const char * const LOAD_MODES[] = { "", "1", "2", "4", "5" };   // <mode> digit before the setup
+
+// === Protected Functions ===
+//
+static inline uint64_t NextRandom (uint64_t * const p_state)
+{
+    // xorshift64*
+    uint64_t x = *p_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *p_state = x;
+
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static inline uint32_t RandomBelow (uint64_t * const p_state, const uint32_t limit)
+{
+    return (uint32_t) ((NextRandom(p_state) >> 32) % limit);
+}
+
+/*!
+* @brief Writes a random hexadecimal operand of 1..digitsMax digits in random case.
+*
+* @param[out] p_target Output position.
+* @param[in,out] p_state State of the generator.
+* @param[in] digitsMax Maximum number of the digits.
+* @param[in] b_isNonZero The operand is an iteration count or a burst length.
+*
+* @return The position after the operand.
+*/
+static char *FormatOperand (char *p_target, uint64_t * const p_state, const uint32_t digitsMax, const bool b_isNonZero)
+{
+    const char * const p_digits = RandomBelow(p_state, 2) ? "0123456789ABCDEF" : "0123456789abcdef";
+    const uint32_t digits = 1 + RandomBelow(p_state, digitsMax);
+    bool b_isZero = true;
+
+    for (uint32_t i = 0; i < digits; i++)
+    {
+        const uint32_t digit = RandomBelow(p_state, 16);
+        b_isZero = b_isZero && (digit == 0);
+        *p_target++ = p_digits[digit];
+    }
+    if (b_isNonZero && b_isZero)
+    {
+        p_target[-1] = '1';
+    }
+    *p_target = '\0';
+
+    return p_target;
+}
+
+/*!
+* @brief Selects the instruction kind by the weights of the profile.
+*
+* @param[in] p_profile The profile of the corpus.
+* @param[in,out] p_state State of the generator.
+*
+* @return The instruction kind.
+*/
+static benchKind_t SelectKind (const benchProfile_t * const p_profile, uint64_t * const p_state)
+{
+    uint32_t total = 0;
+
+    for (int i = 0; i < benchKindLimit; i++)
+    {
+        total += p_profile->weights[i];
+    }
+    uint32_t pick = RandomBelow(p_state, total);
+    for (int i = 0; i < benchKindLimit; i++)
+    {
+        if (pick < p_profile->weights[i])
+        {
+            return (benchKind_t) i;
+        }
+        pick -= p_profile->weights[i];
+    }
+
+    return benchNop;
+}
+
+/*!
+* @brief Writes one row into the corpus and updates its size and hash.
+*
+* @param[in] p_file The corpus.
+* @param[in] p_row The row with its new line.
+* @param[in,out] p_stats The size and the hash of the corpus.
+*
+* @return void
+*/
+static void WriteRow (FILE * const p_file, const char * const p_row, corpusStats_t * const p_stats)
+{
+    const size_t length = strlen(p_row);
+
+    fwrite(p_row, 1, length, p_file);
+    for (size_t i = 0; i < length; i++)
+    {
+        p_stats->hash = (p_stats->hash ^ (uint8_t) p_row[i]) * FNV_PRIME;
+    }
+    p_stats->bytes += length;
+    p_stats->lines++;
+}
+
+/*!
+* @brief Writes one instruction row: the opcode in random case, the operands, the optional comment.
+*           One field of an invalid row is broken: unknown opcode, non-hexadecimal address or too long data.
+*
+* @param[in] p_file The corpus.
+* @param[in] p_name The opcode.
+* @param[in] p_address The address operand.
+* @param[in] p_data The data operand.
+* @param[in] b_isInvalid One field is broken.
+* @param[in] p_comment The comment, NULL: no comment.
+* @param[in,out] p_state State of the generator.
+* @param[in,out] p_stats The size and the hash of the corpus.
+*
+* @return void
+*/
+static void WriteInstruction (FILE * const p_file, const char * const p_name, const char * const p_address, const char * const p_data,
+                              const bool b_isInvalid, const char * const p_comment, uint64_t * const p_state, corpusStats_t * const p_stats)
+{
+    char row[BENCH_LINE_LIMIT];
+    char name[BENCH_NAME_LIMIT];
+    const uint32_t broken = b_isInvalid ? 1 + RandomBelow(p_state, 3) : 0;
+    const bool b_isUpper = (RandomBelow(p_state, 8) == 0);
+
+    snprintf(name, sizeof(name), "%s%s", (broken == 1) ? "x" : "", p_name);
+    for (char *p_char = name; *p_char != '\0'; p_char++)
+    {
+        *p_char = (char) (b_isUpper ? toupper((unsigned char) *p_char) : tolower((unsigned char) *p_char));
+    }
+    snprintf(row, sizeof(row), "%s %s%s %s%s%s\n", name, p_address, (broken == 2) ? "g" : "",
+             (broken == 3) ? "123456789" : p_data, (p_comment != NULL) ? " ; " : "", (p_comment != NULL) ? p_comment : "");
+    WriteRow(p_file, row, p_stats);
+    p_stats->invalid += (broken != 0);
+}
+
+// Benchmark options
+static bool ParseBenchOptions (int argc, char **pp_argv, benchOptions_t * const p_options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const bool b_hasValue = (i + 1 < argc);
+        if (!strcmp(pp_argv[i], OPTION_BENCH_LINES) && b_hasValue)
+        {
+            p_options->maxLines = strtoull(pp_argv[++i], NULL, 0);
+        }
+        else if (!strcmp(pp_argv[i], OPTION_BENCH_JOBS) && b_hasValue)
+        {
+            p_options->jobs = atoi(pp_argv[++i]);
+        }
+        else if (!strcmp(pp_argv[i], OPTION_BENCH_REPEAT) && b_hasValue)
+        {
+            p_options->repeats = atoi(pp_argv[++i]);
+        }
+        else if (!strcmp(pp_argv[i], OPTION_BENCH_SEED) && b_hasValue)
+        {
+            p_options->seed = strtoull(pp_argv[++i], NULL, 0);
+        }
+        else if (!strcmp(pp_argv[i], OPTION_BENCH_PROFILE) && b_hasValue)
+        {
+            p_options->p_profile = pp_argv[++i];
+        }
+        else if (!strcmp(pp_argv[i], OPTION_BENCH_BASELINE) && b_hasValue)
+        {
+            p_options->p_baseline = pp_argv[++i];
+        }
+        else if (!strcmp(pp_argv[i], OPTION_BENCH_SAVE) && b_hasValue)
+        {
+            p_options->p_save = pp_argv[++i];
+        }
+        else if (!strcmp(pp_argv[i], OPTION_BENCH_GENERATE) && (i + 2 < argc))
+        {
+            p_options->p_generate = pp_argv[++i];
+            p_options->generateLines = strtoull(pp_argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "Unknown or incomplete benchmark option: '%s'\n", pp_argv[i]);
+            return false;
+        }
+    }
+
+    const uint64_t lines = (p_options->p_generate != NULL) ? p_options->generateLines : p_options->maxLines;
+    if ((lines < BENCH_LINES_MIN) || (lines > BENCH_LINES_MAX) || (p_options->jobs < 0) || (p_options->repeats < 1))
+    {
+        fprintf(stderr, "Invalid benchmark options: %d..%d rows, jobs >= 0, repeat >= 1.\n", BENCH_LINES_MIN, BENCH_LINES_MAX);
+        return false;
+    }
+
+    return true;
+}
+
+static const benchProfile_t *FindProfile (const char * const p_name)
+{
+    for (int i = 0; i < (int) (sizeof(PROFILES) / sizeof(PROFILES[0])); i++)
+    {
+        if (!strcmp(PROFILES[i].p_name, p_name))
+        {
+            return &PROFILES[i];
+        }
+    }
+    fprintf(stderr, "Unknown benchmark profile: '%s'\n", p_name);
+
+    return NULL;
+}
+
+/*!
+* @brief Generates the corpus, then measures the compiler functions on it, the best of the repeats is kept.
+*
+* @param[in] p_profile The profile of the corpus.
+* @param[in] lines Number of the rows.
+* @param[in] p_options The benchmark options.
+* @param[out] p_result The measurement.
+*
+* @return Returns with true in case of success.
+*/
+static bool MeasureCorpus (const benchProfile_t * const p_profile, const uint64_t lines, const benchOptions_t * const p_options,
+                           benchResult_t * const p_result)
+{
+    memset(p_result, 0, sizeof(benchResult_t));
+    snprintf(p_result->name, sizeof(p_result->name), "%s-%" PRIu64, p_profile->p_name, lines);
+    if (!GenerateCorpus(BENCH_CORPUS_FILE, p_profile, lines, p_options->seed, &p_result->corpus))
+    {
+        return false;
+    }
+
+    bool b_isMeasured = true;
+    for (int r = 0; b_isMeasured && (r < p_options->repeats); r++)
+    {
+        int64_t stamp[benchPhaseLimit];
+        textBuffer_t compiled = { NULL, 0, 0 };
+
+        stamp[benchReadFile] = GetTimeStamp();
+        sourceText_t * const p_source = ReadFile(BENCH_CORPUS_FILE);
+        stamp[benchCompileCode] = GetTimeStamp();
+        program_t * const p_program = (p_source != NULL) ? CompileCode(p_source, p_options->jobs) : NULL;
+        stamp[benchEmitCode] = GetTimeStamp();
+        b_isMeasured = (p_program != NULL) && EmitCode(p_program, &compiled);
+        stamp[benchWriteFile] = GetTimeStamp();
+        b_isMeasured = b_isMeasured && WriteFile(BENCH_TARGET_FILE, &compiled);
+        stamp[benchNotifyInvalid] = GetTimeStamp();
+        if (b_isMeasured)
+        {
+            NotifyInvalid(p_program);
+            p_result->foundInvalid = (uint64_t) CountInvalid(p_program);
+        }
+        stamp[benchTotal] = GetTimeStamp();
+
+        for (int i = 0; i < benchTotal; i++)
+        {
+            const int64_t time = stamp[i + 1] - stamp[i];
+            p_result->time[i] = ((r == 0) || (time < p_result->time[i])) ? time : p_result->time[i];
+        }
+        const int64_t total = stamp[benchTotal] - stamp[benchReadFile];
+        p_result->time[benchTotal] = ((r == 0) || (total < p_result->time[benchTotal])) ? total : p_result->time[benchTotal];
+
+        CleanupBuffer(&compiled);
+        CleanupProgram(p_program);
+        CleanupText(p_source);
+    }
+    remove(BENCH_CORPUS_FILE);
+    remove(BENCH_TARGET_FILE);
+
+    return b_isMeasured;
+}
+
+static inline double Throughput (const uint64_t bytes, const int64_t time)
+{
+    return (time > 0) ? (double) bytes / (double) time : 0.0;     // B/us = MB/s
+}
+
+/*!
+* @brief Prints the throughput of each function, then its change to the baseline if the baseline
+*           was measured on the same corpus.
+*
+* @param[in] p_result The measurement.
+* @param[in] p_baseline The baseline records, NULL: no baseline.
+* @param[in] baselineSize Number of the baseline records.
+*
+* @return void
+*/
+static void PrintResult (const benchResult_t * const p_result, const benchResult_t * const p_baseline, const int baselineSize)
+{
+    printf("%-18s %10" PRIu64 " %8.1f", p_result->name, p_result->corpus.lines, (double) p_result->corpus.bytes / 1e6);
+    for (int i = 0; i < benchPhaseLimit; i++)
+    {
+        printf(" %8.1f", Throughput(p_result->corpus.bytes, p_result->time[i]));
+    }
+    puts((p_result->foundInvalid == p_result->corpus.invalid) ? "" : "  INVALID ROW MISMATCH");
+
+    for (int k = 0; k < baselineSize; k++)
+    {
+        if (strcmp(p_baseline[k].name, p_result->name))
+        {
+            continue;
+        }
+        if (p_baseline[k].corpus.hash != p_result->corpus.hash)
+        {
+            puts("  vs baseline: different corpus, check the seed");
+            break;
+        }
+        printf("  vs baseline %27s", "");
+        for (int i = 0; i < benchPhaseLimit; i++)
+        {
+            const double change = p_result->time[i] ? ((double) p_baseline[k].time[i] / (double) p_result->time[i] - 1.0) * 100.0 : 0.0;
+            printf(" %+7.1f%%", change);
+        }
+        puts("");
+        break;
+    }
+}
+
+/*!
+* @brief Reads the baseline: "<corpus> <hash> <us of each phase>" records.
+*
+* @param[in] p_path The path of the baseline.
+* @param[out] p_size Number of the records.
+*
+* @return MEMORY ALLOCATION: The records, NULL on error.
+*/
+static benchResult_t *ReadBaseline (const char * const p_path, int * const p_size)
+{
+    char line[BENCH_LINE_LIMIT];
+    int capacity = 16;
+    benchResult_t *p_records = (benchResult_t *) malloc((size_t) capacity * sizeof(benchResult_t));
+    FILE * const p_file = fopen(p_path, "r");
+
+    *p_size = 0;
+    if ((p_records == NULL) || (p_file == NULL))
+    {
+        fprintf(stderr, "No benchmark baseline was detected: '%s'\n", p_path);
+        free(p_records);
+        if (p_file != NULL)
+        {
+            fclose(p_file);
+        }
+        return NULL;
+    }
+
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        benchResult_t record;
+        memset(&record, 0, sizeof(benchResult_t));
+        if ((line[0] == '#') || (sscanf(line, "%47s %" SCNx64 " %" SCNd64 " %" SCNd64 " %" SCNd64 " %" SCNd64 " %" SCNd64 " %" SCNd64,
+                                         record.name, &record.corpus.hash, &record.time[0], &record.time[1], &record.time[2],
+                                         &record.time[3], &record.time[4], &record.time[5]) != 2 + benchPhaseLimit))
+        {
+            continue;
+        }
+        if (*p_size == capacity)
+        {
+            capacity *= 2;
+            benchResult_t * const p_grown = (benchResult_t *) realloc(p_records, (size_t) capacity * sizeof(benchResult_t));
+            if (p_grown == NULL)
+            {
+                break;
+            }
+            p_records = p_grown;
+        }
+        p_records[(*p_size)++] = record;
+    }
+    fclose(p_file);
+
+    return p_records;
+}
+
+static void SaveResult (FILE * const p_file, const benchResult_t * const p_result)
+{
+    fprintf(p_file, "%s %016" PRIx64, p_result->name, p_result->corpus.hash);
+    for (int i = 0; i < benchPhaseLimit; i++)
+    {
+        fprintf(p_file, " %" PRId64, p_result->time[i]);
+    }
+    fputc('\n', p_file);
+}
+
+// === Public API Functions ===
+//
+bool GenerateCorpus (const char * const p_path, const benchProfile_t * const p_profile, const uint64_t lines,
+                     const uint64_t seed, corpusStats_t * const p_stats)
+{
+    static char buffer[1 << 20];
+    uint64_t state = seed ? seed : FNV_OFFSET;
+    uint32_t depth = 0;
+    char address[BENCH_NAME_LIMIT];
+    char data[BENCH_NAME_LIMIT];
+    char row[BENCH_LINE_LIMIT];
+
+    memset(p_stats, 0, sizeof(corpusStats_t));
+    p_stats->hash = FNV_OFFSET;
+    FILE * const p_file = fopen(p_path, "wb");
+    if (p_file == NULL)
+    {
+        perror("Unable to create the benchmark corpus.");
+        return false;
+    }
+    setvbuf(p_file, buffer, _IOFBF, sizeof(buffer));
+
+    while (p_stats->lines < lines)
+    {
+        const uint64_t remaining = lines - p_stats->lines;
+        const bool b_hasComment = RandomBelow(&state, 100) < p_profile->commentPercent;
+        const char * const p_comment = b_hasComment ? COMMENTS[RandomBelow(&state, sizeof(COMMENTS) / sizeof(COMMENTS[0]))] : NULL;
+
+        // The open repeat blocks are closed in the last rows
+        if (remaining <= depth)
+        {
+            WriteInstruction(p_file, END, "0", "0", false, p_comment, &state, p_stats);
+            depth--;
+            continue;
+        }
+        if (b_hasComment && (RandomBelow(&state, 4) == 0))
+        {
+            snprintf(row, sizeof(row), "; %s\n", p_comment);
+            WriteRow(p_file, row, p_stats);
+            continue;
+        }
+
+        benchKind_t kind = SelectKind(p_profile, &state);
+        const bool b_isInvalid = (kind <= benchLoad) && (RandomBelow(&state, 100) < p_profile->invalidPercent);
+        const uint32_t beats = 1 + RandomBelow(&state, 4);
+        if ((kind == benchBurstWrite) && (remaining < beats + 1 + depth))
+        {
+            kind = benchWrite;
+        }
+        FormatOperand(address, &state, p_profile->operandDigits, false);
+        FormatOperand(data, &state, p_profile->operandDigits, false);
+
+        switch (kind)
+        {
+            case benchNop:
+                WriteInstruction(p_file, NOP, "0", "0", b_isInvalid, p_comment, &state, p_stats);
+            break;
+            case benchRead:
+                WriteInstruction(p_file, READ, address, "0", b_isInvalid, p_comment, &state, p_stats);
+            break;
+            case benchWrite:
+                WriteInstruction(p_file, WRITE, address, data, b_isInvalid, p_comment, &state, p_stats);
+            break;
+            case benchWait:
+                WriteInstruction(p_file, WAIT, "0", data, b_isInvalid, p_comment, &state, p_stats);
+            break;
+            case benchLoad:
+                // <mode><setup>: pipelined, waitrequest, fast issue or fixed timing
+                snprintf(address, sizeof(address), "%s%X", LOAD_MODES[RandomBelow(&state, sizeof(LOAD_MODES) / sizeof(LOAD_MODES[0]))],
+                         RandomBelow(&state, 0x100));
+                WriteInstruction(p_file, LOAD, address, data, b_isInvalid, p_comment, &state, p_stats);
+            break;
+            case benchRepeat:
+                if ((depth > 0) && ((depth == LOOP_DEPTH_LIMIT) || (remaining < depth + 2) || RandomBelow(&state, 2)))
+                {
+                    WriteInstruction(p_file, END, "0", "0", false, p_comment, &state, p_stats);
+                    depth--;
+                }
+                else if (remaining >= depth + 2)
+                {
+                    FormatOperand(data, &state, 2, true);
+                    WriteInstruction(p_file, REPEAT, address, data, false, p_comment, &state, p_stats);
+                    depth++;
+                }
+                else
+                {
+                    WriteInstruction(p_file, NOP, "0", "0", false, p_comment, &state, p_stats);
+                }
+            break;
+            case benchBurstRead:
+                snprintf(data, sizeof(data), "%X", 1 + RandomBelow(&state, BURST_LIMIT));
+                WriteInstruction(p_file, BURSTREAD, address, data, false, p_comment, &state, p_stats);
+            break;
+            default:
+                snprintf(data, sizeof(data), "%X", beats);
+                WriteInstruction(p_file, BURSTWRITE, address, data, false, p_comment, &state, p_stats);
+                for (uint32_t i = 0; i < beats; i++)
+                {
+                    FormatOperand(data, &state, p_profile->operandDigits, false);
+                    WriteInstruction(p_file, BEAT, "0", data, false, NULL, &state, p_stats);
+                }
+            break;
+        }
+    }
+    fclose(p_file);
+
+    return true;
+}
+
+int RunBenchmark (int argc, char **pp_argv)
+{
+    benchOptions_t options = { BENCH_LINES_DEFAULT, 1, BENCH_REPEATS, BENCH_SEED, NULL, NULL, NULL, NULL, 0 };
+    if (!ParseBenchOptions(argc, pp_argv, &options))
+    {
+        return -1;
+    }
+    const benchProfile_t * const p_single = (options.p_profile != NULL) ? FindProfile(options.p_profile) : NULL;
+    if ((options.p_profile != NULL) && (p_single == NULL))
+    {
+        return -1;
+    }
+
+    // Generator only
+    if (options.p_generate != NULL)
+    {
+        corpusStats_t corpus;
+        const benchProfile_t * const p_profile = (p_single != NULL) ? p_single : &PROFILES[0];
+        if (!GenerateCorpus(options.p_generate, p_profile, options.generateLines, options.seed, &corpus))
+        {
+            return -1;
+        }
+        printf("Generated '%s' (%s): %" PRIu64 " row(s), %" PRIu64 " byte(s), %" PRIu64 " invalid row(s), hash %016" PRIx64 "\n",
+               options.p_generate, p_profile->p_name, corpus.lines, corpus.bytes, corpus.invalid, corpus.hash);
+        return 0;
+    }
+
+    int baselineSize = 0;
+    benchResult_t * const p_baseline = (options.p_baseline != NULL) ? ReadBaseline(options.p_baseline, &baselineSize) : NULL;
+    FILE * const p_save = (options.p_save != NULL) ? fopen(options.p_save, "w") : NULL;
+    if ((options.p_save != NULL) && (p_save == NULL))
+    {
+        perror("Unable to create the benchmark baseline.");
+        free(p_baseline);
+        return -1;
+    }
+    if (p_save != NULL)
+    {
+        fprintf(p_save, "%s\n# <corpus> <hash> <us of read compile emit write notify total>\n", BENCH_DUMP_HEADER);
+    }
+
+    printf("--- Compiler Benchmark | jobs: %d; repeats: %d; seed: 0x%" PRIX64 " ---\n", options.jobs, options.repeats, options.seed);
+    printf("%-18s %10s %8s", "corpus", "rows", "MB");
+    for (int i = 0; i < benchPhaseLimit; i++)
+    {
+        printf(" %8s", PHASE_NAMES[i]);
+    }
+    puts("  [MB/s]");
+
+    int errors = 0;
+    for (int p = 0; p < (int) (sizeof(PROFILES) / sizeof(PROFILES[0])); p++)
+    {
+        if ((p_single != NULL) && (p_single != &PROFILES[p]))
+        {
+            continue;
+        }
+        for (int s = 0; (s < (int) (sizeof(SUITE_LINES) / sizeof(SUITE_LINES[0]))) && (SUITE_LINES[s] <= options.maxLines); s++)
+        {
+            benchResult_t result;
+            if (!MeasureCorpus(&PROFILES[p], SUITE_LINES[s], &options, &result))
+            {
+                errors++;
+                continue;
+            }
+            PrintResult(&result, p_baseline, baselineSize);
+            errors += (result.foundInvalid != result.corpus.invalid);
+            if (p_save != NULL)
+            {
+                SaveResult(p_save, &result);
+            }
+        }
+    }
+
+    if (p_save != NULL)
+    {
+        fclose(p_save);
+    }
+    free(p_baseline);
+
+    return errors ? -1 : 0;
+}
+
+// === MAIN ===
+//
+// Entry point of the Benchmark target, instead of the compiler of main.c
+int main (int argc, char **pp_argv)
+{
+    return RunBenchmark(argc, pp_argv);
+}
+
+/*** EOF ***/
@@ -0,0 +1,125 @@
+/** @file bench.h
+*
+* @brief Benchmark of the Avalon Compiler: reproducible synthetic sources and the throughput
+*           of the compiler functions against a stored baseline.
+*
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "..\source\file_access.h"
+#include "..\source\compile.h"
+#include "..\source\emit.h"
+#include "..\source\notify_invalid.h"
+#include "..\source\file_watch.h"
+
+// === Type Definitions ===
+//
+typedef enum
+{
+    benchNop = 0,
+    benchRead,
+    benchWrite,
+    benchWait,
+    benchLoad,
+    benchRepeat,            // REPEAT or the END of the innermost open block
+    benchBurstRead,
+    benchBurstWrite,        // BURSTWRITE and its BEAT rows
+    benchKindLimit
+} benchKind_t;
+
+typedef struct benchProfile
+{
+    const char *p_name;
+    uint8_t weights[benchKindLimit];    // Relative frequency of the instruction kinds
+    uint8_t commentPercent;             // Rows with a comment, a quarter of them comment only
+    uint8_t invalidPercent;             // Simple instructions with an invalid field
+    uint8_t operandDigits;              // Maximum hexadecimal digits of the operands
+} benchProfile_t;
+
+typedef struct corpusStats
+{
+    uint64_t lines;
+    uint64_t bytes;
+    uint64_t invalid;       // Generated invalid rows, the compiler has to find the same number
+    uint64_t hash;          // FNV-1a of the corpus: the same seed gives the same corpus
+} corpusStats_t;
+
+typedef enum
+{
+    benchReadFile = 0,
+    benchCompileCode,
+    benchEmitCode,
+    benchWriteFile,
+    benchNotifyInvalid,
+    benchTotal,             // End-to-end: ReadFile .. NotifyInvalid
+    benchPhaseLimit
+} benchPhase_t;
+
+// === Constant Definitions ===
+//
+#define BENCH_SEED          0x41564253494DULL   // Default seed of the corpora: "AVBSIM"
+#define BENCH_LINES_MIN     1000
+#define BENCH_LINES_DEFAULT 1000000             // Largest corpus of the default suite
+#define BENCH_LINES_MAX     50000000
+#define BENCH_REPEATS       3                   // The best of the repeated measurements is kept
+#define BENCH_CORPUS_FILE   "bench_corpus.av"
+#define BENCH_TARGET_FILE   "bench_corpus.mem"
+#define BENCH_DUMP_HEADER   "# avsim bench 1"
+#define BENCH_LINE_LIMIT    160                 // Longest generated row and baseline record
+#define BENCH_NAME_LIMIT    48
+#define FNV_OFFSET          0xCBF29CE484222325ULL
+#define FNV_PRIME           0x100000001B3ULL
+
+#define OPTION_BENCH_LINES      "--lines"
+#define OPTION_BENCH_JOBS       "--jobs"
+#define OPTION_BENCH_REPEAT     "--repeat"
+#define OPTION_BENCH_SEED       "--seed"
+#define OPTION_BENCH_PROFILE    "--profile"
+#define OPTION_BENCH_BASELINE   "--baseline"
+#define OPTION_BENCH_SAVE       "--save"
+#define OPTION_BENCH_GENERATE   "--generate"
+
+// === Public API Functions ===
+//
+/*!
+* @brief Writes a reproducible synthetic source: the instruction kinds, the comments,
+*           the invalid rows and the operand widths follow the profile. The repeat blocks
+*           are nested at most LOOP_DEPTH_LIMIT deep and closed, the burst writes get their beats.
+*
+* @param[in] p_path The path of the source.
+* @param[in] p_profile The profile of the corpus.
+* @param[in] lines Number of the rows.
+* @param[in] seed Seed of the generator.
+* @param[out] p_stats The size, the invalid rows and the hash of the corpus.
+*
+* @return Returns with true in case of success.
+*/
+bool GenerateCorpus (const char * const p_path, const benchProfile_t * const p_profile, const uint64_t lines,
+                     const uint64_t seed, corpusStats_t * const p_stats);
+
+/*!
+* @brief Benchmark of the Benchmark target, called by its main:
+*           avsim_bench [--lines <max>] [--jobs <n>] [--repeat <n>] [--seed <n>] [--profile <name>]
+*                       [--baseline <file>] [--save <file>]
+*           avsim_bench --generate <source> <lines> [--profile <name>] [--seed <n>]
+*
+* @param[in] argc Number of the arguments.
+* @param[in] pp_argv The arguments.
+*
+* @return Exit code: 0 in case of success.
+*/
+int RunBenchmark (int argc, char **pp_argv);
+
+#endif /* BENCH_H */
+
+/*** EOF ***/
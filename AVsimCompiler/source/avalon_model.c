@@ -0,0 +1,878 @@
+/** @file avalon_model.c
+*
+* @brief Cycle-accurate model of the avalon_master HDL module executing the compiled images.
+*
+*/
+
+#include "avalon_model.h"
+
+#include <ctype.h>
+
+// === Protected Functions ===
+//
+/*!
+* @brief Returns with the value of the hexadecimal digit.
+*
+* @param[in] character Digit to be converted.
+*
+* @return Value of the digit, -1 if it is not a hexadecimal digit.
+*/
+static int HexDigitValue (const char character)
+{
+    if ((character >= '0') && (character <= '9'))
+    {
+        return character - '0';
+    }
+    if ((character >= 'a') && (character <= 'f'))
+    {
+        return character - 'a' + 10;
+    }
+    if ((character >= 'A') && (character <= 'F'))
+    {
+        return character - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/*!
+* @brief Ensures that the entry of the instruction memory exists, the new entries are unknown.
+*
+* @param[in,out] p_image The instruction memory.
+* @param[in] index Index of the entry.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+static bool ReserveEntry (modelImage_t * const p_image, const uint32_t index)
+{
+    if (index < p_image->capacity)
+    {
+        return true;
+    }
+
+    uint32_t capacity = (p_image->capacity < MODEL_IMAGE_MIN) ? MODEL_IMAGE_MIN : p_image->capacity;
+    while ((capacity <= index) && (capacity < (UINT32_C(1) << INSTR_DEPTH_MAX)))
+    {
+        capacity *= 2;
+    }
+    if (capacity <= index)
+    {
+        return false;
+    }
+
+    modelInstr_t * const p_instr = (modelInstr_t *) realloc(p_image->p_instr, (size_t) capacity * sizeof(modelInstr_t));
+    if (p_instr == NULL)
+    {
+        return false;
+    }
+    memset(&p_instr[p_image->capacity], 0, (size_t) (capacity - p_image->capacity) * sizeof(modelInstr_t));
+    p_image->p_instr = p_instr;
+    p_image->capacity = capacity;
+
+    return true;
+}
+
+/*!
+* @brief Parses the hexadecimal word of the image.
+*
+* @param[in,out] pp_text Start of the word, the position after the word at return.
+* @param[in] p_end End of the image text.
+* @param[out] p_high Most significant bits above the 64-bit value.
+* @param[out] p_value Least significant 64 bits.
+*
+* @return Number of digits, -1 if the word is invalid or too wide.
+*/
+static int ParseWord (const char ** const pp_text, const char * const p_end, uint64_t * const p_high, uint64_t * const p_value)
+{
+    const char *p_text = *pp_text;
+    int digitCount = 0;
+
+    *p_high = 0;
+    *p_value = 0;
+    for (; (p_text < p_end) && !isspace((unsigned char) *p_text) && (*p_text != '/'); p_text++)
+    {
+        if (*p_text == '_')
+        {
+            continue;
+        }
+
+        const int digit = HexDigitValue(*p_text);
+        if ((digit < 0) || (++digitCount * 4 > MODEL_INSTR_BITS))
+        {
+            return -1;
+        }
+        *p_high = (*p_high << 4) | (*p_value >> 60);
+        *p_value = (*p_value << 4) | (uint64_t) digit;
+    }
+    *pp_text = p_text;
+
+    return digitCount;
+}
+
+/*!
+* @brief Fast-forward over the idle span of the current state: the rest of WAIT,
+*           or the setup and strobe countdowns of READ_TIMING and WRITE_TIMING,
+*           the latency and hold countdowns. The outputs are constant during the span
+*           and no bus event is captured, the cycle counter follows the skipped cycles.
+*
+* @param[in,out] p_model The model without slave.
+* @param[in] cycleLimit Maximum number of cycles.
+*
+* @return void
+*/
+static void SkipIdleCycles (avalonModel_t * const p_model, const uint64_t cycleLimit)
+{
+    const uint64_t cycleLeft = cycleLimit - p_model->cycle;
+    uint64_t span;
+
+    switch (p_model->state)
+    {
+        case stWait:
+            // The last cycle of WAIT is stepped: waitCount == wait - 1
+            span = (uint32_t) (p_model->wait - 1 - p_model->waitCount);
+            span = (span < cycleLeft) ? span : cycleLeft;
+            p_model->waitCount += (uint32_t) span;
+            p_model->cycle += span;
+        return;
+        case stReadTiming:
+            span = (uint64_t) p_model->setup + p_model->readWait;
+            if (span && (span < cycleLeft))
+            {
+                p_model->setup = 0;
+                p_model->readWait = 0;
+                p_model->cycle += span;
+            }
+        return;
+        case stWriteTiming:
+            span = (uint64_t) p_model->setup + p_model->writeWait;
+            if (span && (span < cycleLeft))
+            {
+                p_model->setup = 0;
+                p_model->writeWait = 0;
+                p_model->cycle += span;
+            }
+        return;
+        case stReadLatency:
+            if (p_model->readLatency < cycleLeft)
+            {
+                p_model->cycle += p_model->readLatency;
+                p_model->readLatency = 0;
+            }
+        return;
+        case stWriteHold:
+            if (p_model->hold < cycleLeft)
+            {
+                p_model->cycle += p_model->hold;
+                p_model->hold = 0;
+            }
+        return;
+        case stBurstRead:
+            // The latency after the command: the first beat is stepped
+            if (!p_model->b_burstCommand && (p_model->beatDue > p_model->cycle) && (p_model->beatDue - p_model->cycle < cycleLeft))
+            {
+                p_model->cycle = p_model->beatDue;
+            }
+        return;
+        default:
+            // Active state
+        return;
+    }
+}
+
+/*!
+* @brief Latches the timing parameters of the read or the write into the countdown registers.
+*           In waitrequest mode the slave sets the length of the strobe.
+*
+* @param[in,out] p_model The model.
+* @param[in] opCode read or write.
+*
+* @return void
+*/
+static void LatchTiming (avalonModel_t * const p_model, const uint8_t opCode)
+{
+    p_model->setup = p_model->setupStore;
+    if (opCode == read)
+    {
+        p_model->readWait = p_model->b_isWaitrequest ? 0 : p_model->readWaitStore;
+        p_model->readLatency = p_model->readLatencyStore;
+    }
+    else
+    {
+        p_model->writeWait = p_model->b_isWaitrequest ? 0 : p_model->writeWaitStore;
+        p_model->hold = p_model->holdStore;
+    }
+}
+
+/*!
+* @brief Fast issue at the end of a read or a write: the prefetched instruction at pc + 1 is decoded
+*           in the same cycle. A read or a write starts at once, the other instructions go to FETCH.
+*
+* @param[in,out] p_model The model.
+*
+* @return The next state.
+*/
+static uint8_t IssueNext (avalonModel_t * const p_model)
+{
+    const uint32_t pc = (p_model->pc + 1) & p_model->pcMask;
+    const modelInstr_t * const p_next = (pc < p_model->p_image->size) ? &p_model->p_image->p_instr[pc] : NULL;
+
+    p_model->pc = pc;
+    p_model->instrCount++;
+    if ((p_next == NULL) || !p_next->b_isLoaded || ((p_next->opCode != read) && (p_next->opCode != write)) ||
+        ((p_next->opCode == read) && p_model->b_isPipelined))
+    {
+        return stFetch;
+    }
+    LatchTiming(p_model, p_next->opCode);
+    p_model->transferAddress = p_next->address + p_model->loops.addressOffset;
+
+    return (p_next->opCode == read) ? stReadTiming : stWriteTiming;
+}
+
+/*!
+* @brief Counts the cycle: the phase of the FSM state, the bus utilization and the stalls.
+*           The cycles belong to the instruction issuing them until it is retired.
+*
+* @param[in,out] p_perf The counters.
+* @param[in] p_bus The signals of the cycle.
+* @param[in] p_image The instruction memory.
+* @param[in] b_isRetired The instruction is completed at the clock edge.
+* @param[in] pcNext Program counter after the clock edge.
+*
+* @return void
+*/
+static void CountPerf (perfCounters_t * const p_perf, const avalonBus_t * const p_bus, const modelImage_t * const p_image,
+                       const bool b_isRetired, const uint32_t pcNext)
+{
+    uint8_t phase = perfControl;
+    const uint32_t pc = p_perf->issuePC;
+
+    switch (p_bus->b_isStalled ? UINT8_MAX : p_bus->state)
+    {
+        case UINT8_MAX:
+            phase = perfStall;
+        break;
+        case stFetch:
+            phase = p_bus->b_chipselect ? perfStrobe : perfFetch;
+        break;
+        case stReadTiming:
+        case stWriteTiming:
+            phase = (p_bus->b_read || p_bus->b_write) ? perfStrobe : perfSetup;
+        break;
+        case stReadLatency:
+            phase = perfLatency;
+        break;
+        case stWriteHold:
+            phase = perfHold;
+        break;
+        case stWait:
+            phase = perfWait;
+        break;
+        case stBurstRead:
+            phase = (p_bus->b_read || p_bus->b_readDataEN) ? perfStrobe : perfLatency;
+        break;
+        case stBurstWrite:
+            phase = perfStrobe;
+        break;
+        default:
+            // LOAD, PC_INCR
+        break;
+    }
+
+    p_perf->cycles++;
+    p_perf->busCycles += p_bus->b_chipselect;
+    p_perf->dataCycles += p_bus->b_readDataEN || (p_bus->b_write && !p_bus->b_isStalled);
+    p_perf->phaseCycles[phase]++;
+    p_perf->stall = p_bus->b_isStalled ? p_perf->stall + 1 : 0;
+    if (p_perf->stall > p_perf->longestStall)
+    {
+        p_perf->longestStall = p_perf->stall;
+        p_perf->stallPC = pc;
+    }
+    p_perf->span++;
+    if (pc < p_perf->pcSize)
+    {
+        p_perf->p_pcCycles[pc]++;
+    }
+
+    if (b_isRetired)
+    {
+        const uint8_t opCode = (pc < p_image->size) ? p_image->p_instr[pc].opCode : UINT8_MAX;
+        if (opCode < OPCODE_LIMIT)
+        {
+            p_perf->opCodeCount[opCode]++;
+        }
+        if (pc < p_perf->pcSize)
+        {
+            p_perf->p_pcCount[pc]++;
+        }
+        if (p_perf->span > p_perf->longestSpan)
+        {
+            p_perf->longestSpan = p_perf->span;
+            p_perf->longestPC = pc;
+        }
+        p_perf->span = 0;
+        p_perf->issuePC = pcNext;
+    }
+}
+
+// === Public API Functions ===
+//
+modelImage_t *LoadImage (const char * const p_path)
+{
+    sourceText_t * const p_text = ReadFile(p_path);
+    if (p_text == NULL)
+    {
+        return NULL;
+    }
+
+    modelImage_t * const p_image = (modelImage_t *) calloc(1, sizeof(modelImage_t));
+    if (p_image == NULL)
+    {
+        perror("Unable to allocate memory for the instruction memory.");
+        CleanupText(p_text);
+        return NULL;
+    }
+
+    const char *p_data = p_text->p_data;
+    const char * const p_end = p_text->p_data + p_text->dataSize;
+    uint32_t index = 0;
+    int row = 1;
+    bool b_isValid = true;
+
+    while (b_isValid && (p_data < p_end))
+    {
+        uint64_t high;
+        uint64_t value;
+
+        if (*p_data == EOL_CHAR)
+        {
+            row++;
+            p_data++;
+        }
+        else if (isspace((unsigned char) *p_data))
+        {
+            p_data++;
+        }
+        else if ((*p_data == '/') && (p_data + 1 < p_end) && (p_data[1] == '/'))
+        {
+            // Line comment
+            while ((p_data < p_end) && (*p_data != EOL_CHAR))
+            {
+                p_data++;
+            }
+        }
+        else if ((*p_data == '/') && (p_data + 1 < p_end) && (p_data[1] == '*'))
+        {
+            // Block comment
+            for (p_data += 2; (p_data < p_end) && !((*p_data == '*') && (p_data + 1 < p_end) && (p_data[1] == '/')); p_data++)
+            {
+                row += (*p_data == EOL_CHAR);
+            }
+            b_isValid = (p_data < p_end);
+            p_data += 2;
+        }
+        else if (*p_data == '@')
+        {
+            // Address of the next word
+            p_data++;
+            b_isValid = (ParseWord(&p_data, p_end, &high, &value) > 0) && (high == 0) &&
+                        (value < (UINT64_C(1) << INSTR_DEPTH_MAX));
+            index = (uint32_t) value;
+        }
+        else
+        {
+            b_isValid = (ParseWord(&p_data, p_end, &high, &value) > 0) && ReserveEntry(p_image, index);
+            if (b_isValid)
+            {
+                modelInstr_t * const p_instr = &p_image->p_instr[index++];
+                p_instr->opCode = (uint8_t) (high & 0xF);
+                p_instr->address = (uint32_t) (value >> 32);
+                p_instr->data = (uint32_t) value;
+                p_instr->b_isLoaded = true;
+                p_image->opCodeMask |= UINT32_C(1) << p_instr->opCode;
+                p_image->loadModes |= (p_instr->opCode == load) ? (p_instr->address & LOAD_MODE_MASK) : 0;
+                if (index > p_image->size)
+                {
+                    p_image->size = index;
+                }
+            }
+        }
+    }
+
+    if (!b_isValid)
+    {
+        fprintf(stderr, "=> ERROR in '%s' at line %d.: invalid instruction memory word.\n", p_path, row);
+        CleanupImage(p_image);
+        CleanupText(p_text);
+        return NULL;
+    }
+    CleanupText(p_text);
+
+    return p_image;
+}
+
+void ResetModel (avalonModel_t * const p_model, const modelImage_t * const p_image, const int depthBits,
+                 const slaveHook_t p_slaveHook, void * const p_slave)
+{
+    memset(p_model, 0, sizeof(avalonModel_t));
+    p_model->p_image = p_image;
+    p_model->pcMask = (uint32_t) ((UINT64_C(1) << depthBits) - 1);
+    p_model->state = stFetch;
+    p_model->p_slaveHook = p_slaveHook;
+    p_model->p_slave = p_slave;
+}
+
+bool StepModel (avalonModel_t * const p_model, avalonBus_t * const p_bus)
+{
+    static const modelInstr_t UNKNOWN = { 0, 0, 0, false };
+    const modelInstr_t * const p_instr = (p_model->pc < p_model->p_image->size) ?
+                                         &p_model->p_image->p_instr[p_model->pc] : &UNKNOWN;
+    const bool b_isReady = !p_instr->b_isLoaded;    // simReady: the instruction is unknown
+    const bool b_isWaitEnd = (p_model->waitCount == p_model->wait - 1);
+    // readdatavalid of the oldest outstanding pipelined read
+    const pendingRead_t * const p_head = &p_model->p_pending[p_model->pendingHead];
+    const bool b_isResponse = p_model->pendingCount && (p_head->dueCycle == p_model->cycle);
+    bool b_isWaitCounting = false;
+    bool b_isLoadEN = false;
+    bool b_isPatternStep = false;
+    bool b_isReadIssue = false;
+    bool b_isTransferEnd = false;
+    uint8_t stateNext = p_model->state;
+    const uint8_t transferEnd = p_model->b_isWaitrequest ? stPcIncr : stWait;
+    // The registers changed by a command, restored if the slave holds the command
+    const uint32_t pcHeld = p_model->pc;
+    const uint64_t instrCountHeld = p_model->instrCount;
+    const uint8_t readLatencyHeld = p_model->readLatency;
+    const uint8_t holdHeld = p_model->hold;
+    const uint32_t beatCountHeld = p_model->beatCount;
+
+    p_bus->state = p_model->state;
+    p_bus->pc = p_model->pc;
+    p_bus->b_chipselect = false;
+    p_bus->b_read = false;
+    p_bus->b_write = false;
+    p_bus->b_readDataEN = b_isResponse;
+    p_bus->b_beginBurst = false;
+    p_bus->beat = 0;
+
+    // Finite State Machine of avalon_master
+    switch (p_model->state)
+    {
+        case stFetch:
+            if (!b_isReady && (p_instr->opCode == read) && p_model->b_isPipelined)
+            {
+                // Pipelined read: the command is issued in FETCH, the next instruction follows in the next cycle
+                if (p_model->pendingCount < PENDING_READ_LIMIT)
+                {
+                    p_bus->b_chipselect = true;
+                    p_bus->b_read = true;
+                    b_isReadIssue = true;
+                    p_model->transferAddress = p_instr->address + p_model->loops.addressOffset;
+                    p_model->pc = (p_model->pc + 1) & p_model->pcMask;
+                    p_model->instrCount++;
+                }
+                break;
+            }
+            if (p_model->pendingCount)
+            {
+                // The other instructions wait for the outstanding reads
+                break;
+            }
+
+            // The unknown operating code falls to the default branch
+            switch (b_isReady ? UINT8_MAX : p_instr->opCode)
+            {
+                case nop:
+                    stateNext = stPcIncr;
+                break;
+                case read:
+                    stateNext = stReadTiming;
+                    LatchTiming(p_model, read);
+                break;
+                case write:
+                    stateNext = stWriteTiming;
+                    LatchTiming(p_model, write);
+                break;
+                case wait:
+                    stateNext = stWait;
+                break;
+                case load:
+                    stateNext = stLoad;
+                    b_isLoadEN = p_model->b_isFastIssue;
+                break;
+                case burstRead:
+                    stateNext = stBurstRead;
+                break;
+                case burstWrite:
+                    // The first beat row follows the burst write
+                    stateNext = stBurstWrite;
+                    p_model->pc = (p_model->pc + 1) & p_model->pcMask;
+                break;
+                default:
+                    stateNext = stPcIncr;
+                break;
+            }
+            if (p_model->b_isFastIssue && !b_isReady && ((p_instr->opCode == nop) || (p_instr->opCode == load)))
+            {
+                // Completed in FETCH
+                p_model->pc = (p_model->pc + 1) & p_model->pcMask;
+                p_model->instrCount++;
+                stateNext = stFetch;
+            }
+            p_model->wait = (!b_isReady && (p_instr->opCode == wait)) ? p_instr->data : AVALON_DELAY;
+            p_model->transferAddress = p_instr->address + p_model->loops.addressOffset;
+            p_model->burstCount = p_instr->data & ((UINT32_C(1) << BURST_COUNT_BITS) - 1);
+            p_model->beatCount = p_model->burstCount;
+            p_model->burstStep = p_instr->data >> BURST_STEP_BITS;
+            p_model->patternOffset = 0;
+            p_model->b_burstBegin = true;
+            p_model->b_burstCommand = true;
+        break;
+        case stReadTiming:
+            p_bus->b_chipselect = true;
+            if (p_model->setup)
+            {
+                p_model->setup--;
+            }
+            else if (p_model->readWait)
+            {
+                p_model->readWait--;
+                p_bus->b_read = true;
+            }
+            else if (p_model->readLatency)
+            {
+                p_model->readLatency--;
+                stateNext = stReadLatency;
+                p_bus->b_read = true;
+            }
+            else
+            {
+                stateNext = transferEnd;
+                b_isTransferEnd = true;
+                p_bus->b_read = true;
+                p_bus->b_readDataEN = true;
+            }
+        break;
+        case stReadLatency:
+            if (p_model->readLatency)
+            {
+                p_model->readLatency--;
+            }
+            else
+            {
+                p_bus->b_readDataEN = true;
+                stateNext = transferEnd;
+                b_isTransferEnd = true;
+            }
+        break;
+        case stWriteTiming:
+            p_bus->b_chipselect = true;
+            if (p_model->setup)
+            {
+                p_model->setup--;
+            }
+            else if (p_model->writeWait)
+            {
+                p_model->writeWait--;
+                p_bus->b_write = true;
+            }
+            else if (p_model->hold)
+            {
+                p_model->hold--;
+                p_bus->b_write = true;
+                stateNext = stWriteHold;
+            }
+            else
+            {
+                p_bus->b_write = true;
+                stateNext = transferEnd;
+                b_isTransferEnd = true;
+            }
+        break;
+        case stWriteHold:
+            p_bus->b_chipselect = true;
+            if (p_model->hold)
+            {
+                p_model->hold--;
+            }
+            else
+            {
+                stateNext = transferEnd;
+                b_isTransferEnd = true;
+            }
+        break;
+        case stWait:
+            b_isWaitCounting = true;
+            if (b_isWaitEnd)
+            {
+                stateNext = stPcIncr;
+            }
+        break;
+        case stLoad:
+            b_isLoadEN = true;
+            stateNext = stPcIncr;
+        break;
+        case stBurstRead:
+            p_bus->b_chipselect = true;
+            p_bus->b_read = p_model->b_burstCommand;
+            p_bus->b_beginBurst = p_model->b_burstBegin;
+            p_bus->beat = p_model->burstCount - p_model->beatCount;
+            p_model->b_burstBegin = false;
+            // The beats are captured at the readdatavalid of the slave
+        break;
+        case stBurstWrite:
+            p_bus->b_chipselect = true;
+            p_bus->b_write = true;
+            p_bus->b_beginBurst = p_model->b_burstBegin;
+            p_bus->beat = p_model->burstCount - p_model->beatCount;
+            p_model->b_burstBegin = false;
+            if (p_model->beatCount > 1)
+            {
+                // Next inline beat row, or the next value of the pattern
+                p_model->beatCount--;
+                if (p_model->burstStep)
+                {
+                    b_isPatternStep = true;
+                }
+                else
+                {
+                    p_model->pc = (p_model->pc + 1) & p_model->pcMask;
+                }
+            }
+            else
+            {
+                stateNext = transferEnd;
+            }
+        break;
+        case stPcIncr:
+            // The master stays here at the end of the simulation
+            if (!b_isReady)
+            {
+                p_model->pc = StepLoop(&p_model->loops, p_instr, (p_model->pc + 1) & p_model->pcMask);
+                p_model->instrCount++;
+                stateNext = stFetch;
+            }
+        break;
+        default:
+            // NOP
+        break;
+    }
+
+    // Data path
+    p_bus->address = p_bus->b_chipselect ? p_model->transferAddress : 0;
+    p_bus->writedata = ((p_model->state == stWriteTiming) || (p_model->state == stWriteHold) || (p_model->state == stBurstWrite)) ?
+                       p_instr->data + p_model->loops.dataOffset + p_model->patternOffset : 0;
+    p_bus->burstcount = ((p_model->state == stBurstRead) || (p_model->state == stBurstWrite)) ? p_model->burstCount : 1;
+    p_bus->b_waitrequest = false;
+    // Fixed latency slave: the beats follow the accepted burst read command after the read latency
+    p_bus->b_readdatavalid = (p_model->state == stBurstRead) && !p_model->b_burstCommand && (p_model->cycle >= p_model->beatDue);
+    p_bus->readdata = (p_model->p_slaveHook != NULL) ? p_model->p_slaveHook(p_model->p_slave, p_bus) : 0;
+    p_bus->b_isStalled = p_model->b_isWaitrequest && p_bus->b_waitrequest && (p_bus->b_read || p_bus->b_write);
+    if (p_bus->b_isStalled)
+    {
+        // The master holds the command: the FSM stays in the cycle
+        p_model->pc = pcHeld;
+        p_model->instrCount = instrCountHeld;
+        p_model->readLatency = readLatencyHeld;
+        p_model->hold = holdHeld;
+        p_model->beatCount = beatCountHeld;
+        p_bus->b_readDataEN = b_isResponse;
+        b_isReadIssue = false;
+        b_isPatternStep = false;
+        b_isTransferEnd = false;
+        stateNext = p_model->state;
+    }
+    else if (p_model->state == stBurstRead)
+    {
+        if (p_model->b_burstCommand)
+        {
+            // Accepted command: response of the fixed latency slave at least one cycle later
+            p_model->b_burstCommand = false;
+            p_model->beatDue = p_model->cycle + (p_model->readLatencyStore ? p_model->readLatencyStore : 1);
+        }
+        else if (p_bus->b_readdatavalid)
+        {
+            p_bus->b_readDataEN = true;
+            if (p_model->beatCount > 1)
+            {
+                p_model->beatCount--;
+            }
+            else
+            {
+                stateNext = transferEnd;
+            }
+        }
+    }
+    if (b_isResponse)
+    {
+        p_bus->readdataWatch = p_head->data;
+        p_bus->watchPC = p_head->pc;
+        p_bus->watchAddress = p_head->address;
+    }
+    else
+    {
+        p_bus->readdataWatch = p_bus->b_readDataEN ? p_bus->readdata : 0;
+        p_bus->watchPC = p_bus->pc;
+        p_bus->watchAddress = p_model->transferAddress + p_bus->beat;
+    }
+
+    // Clock edge
+    if (b_isResponse)
+    {
+        p_model->pendingHead = (p_model->pendingHead + 1) % PENDING_READ_LIMIT;
+        p_model->pendingCount--;
+    }
+    if (b_isReadIssue)
+    {
+        // Response of the fixed latency pipelined slave: at least one cycle after the command
+        pendingRead_t * const p_tail = &p_model->p_pending[(p_model->pendingHead + p_model->pendingCount) % PENDING_READ_LIMIT];
+        p_tail->dueCycle = p_model->cycle + (p_model->readLatencyStore ? p_model->readLatencyStore : 1);
+        p_tail->pc = p_bus->pc;
+        p_tail->address = p_bus->address;
+        p_tail->data = p_bus->readdata;
+        p_model->pendingCount++;
+    }
+    p_model->waitCount = b_isWaitCounting ? p_model->waitCount + 1 : 0;
+    if (b_isPatternStep)
+    {
+        p_model->patternOffset += p_model->burstStep;
+    }
+    if (b_isLoadEN)
+    {
+        p_model->setupStore = (uint8_t) p_instr->address;
+        p_model->holdStore = (uint8_t) (p_instr->data >> 24);
+        p_model->readLatencyStore = (uint8_t) (p_instr->data >> 16);
+        p_model->writeWaitStore = (uint8_t) (p_instr->data >> 8);
+        p_model->readWaitStore = (uint8_t) p_instr->data;
+        p_model->b_isPipelined = (p_instr->address & LOAD_MODE_PIPELINED) != 0;
+        p_model->b_isWaitrequest = (p_instr->address & LOAD_MODE_WAITREQUEST) != 0;
+        p_model->b_isFastIssue = (p_instr->address & LOAD_MODE_FAST_ISSUE) != 0;
+    }
+    if (b_isTransferEnd && p_model->b_isFastIssue)
+    {
+        stateNext = IssueNext(p_model);
+    }
+    p_model->state = stateNext;
+    p_model->cycle++;
+    if (p_model->p_perf != NULL)
+    {
+        CountPerf(p_model->p_perf, p_bus, p_model->p_image, p_model->instrCount != instrCountHeld, p_model->pc);
+    }
+
+    return b_isReady && (p_bus->state == stPcIncr);
+}
+
+uint32_t StepLoop (loopStack_t * const p_loops, const modelInstr_t * const p_instr, const uint32_t pcNext)
+{
+    const uint32_t level = p_loops->level;
+
+    if ((p_instr->opCode == loop) && (level < LOOP_DEPTH_LIMIT))
+    {
+        p_loops->count[level] = p_instr->data;
+        p_loops->returnPC[level] = pcNext;
+        p_loops->addressStep[level] = p_instr->address >> LOOP_STEP_BITS;
+        p_loops->dataStep[level] = p_instr->address & ((UINT32_C(1) << LOOP_STEP_BITS) - 1);
+        p_loops->addressBase[level] = p_loops->addressOffset;
+        p_loops->dataBase[level] = p_loops->dataOffset;
+        p_loops->level++;
+    }
+    else if ((p_instr->opCode == loopEnd) && level)
+    {
+        const uint32_t top = level - 1;
+        if (p_loops->count[top] > 1)
+        {
+            p_loops->count[top]--;
+            p_loops->addressOffset += p_loops->addressStep[top];
+            p_loops->dataOffset += p_loops->dataStep[top];
+            return p_loops->returnPC[top];
+        }
+        p_loops->addressOffset = p_loops->addressBase[top];
+        p_loops->dataOffset = p_loops->dataBase[top];
+        p_loops->level--;
+    }
+
+    return pcNext;
+}
+
+bool RunModel (avalonModel_t * const p_model, const uint64_t cycleLimit, eventLog_t * const p_log)
+{
+    avalonBus_t bus;
+
+    while (p_model->cycle < cycleLimit)
+    {
+        const uint32_t pc = p_model->pc;
+
+        // The slave may act and the counters count in any cycle
+        if ((p_model->p_slaveHook == NULL) && (p_model->p_perf == NULL))
+        {
+            SkipIdleCycles(p_model, cycleLimit);
+            if (p_model->cycle == cycleLimit)
+            {
+                break;
+            }
+        }
+        if (StepModel(p_model, &bus))
+        {
+            return true;
+        }
+
+        // Read data capture or the last cycle of the write strobe
+        if ((p_log != NULL) && (bus.b_readDataEN || (bus.b_write && !bus.b_isStalled && ((p_model->state != stWriteTiming) || (p_model->pc != pc)))))
+        {
+            const modelEvent_t event =
+            {
+                p_model->cycle - 1, bus.b_readDataEN ? bus.watchPC : pc,
+                bus.b_readDataEN ? bus.watchAddress : bus.address + bus.beat,
+                bus.b_readDataEN ? bus.readdataWatch : bus.writedata,
+                bus.b_readDataEN ? eventRead : eventWrite
+            };
+            if (!AppendEvent(p_log, &event))
+            {
+                return false;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool AppendEvent (eventLog_t * const p_log, const modelEvent_t * const p_event)
+{
+    if (p_log->size == p_log->capacity)
+    {
+        const size_t capacity = (p_log->capacity < MODEL_LOG_MIN) ? MODEL_LOG_MIN : 2 * p_log->capacity;
+        modelEvent_t * const p_events = (modelEvent_t *) realloc(p_log->p_events, capacity * sizeof(modelEvent_t));
+        if (p_events == NULL)
+        {
+            perror("Unable to allocate memory for the event log.");
+            return false;
+        }
+        p_log->p_events = p_events;
+        p_log->capacity = capacity;
+    }
+    p_log->p_events[p_log->size++] = *p_event;
+
+    return true;
+}
+
+void CleanupImage (modelImage_t * const p_image)
+{
+    if (p_image == NULL)
+    {
+        return;
+    }
+
+    free(p_image->p_instr);
+    free(p_image);
+}
+
+void CleanupLog (eventLog_t * const p_log)
+{
+    free(p_log->p_events);
+    p_log->p_events = NULL;
+    p_log->size = 0;
+    p_log->capacity = 0;
+}
+
+/*** EOF ***/
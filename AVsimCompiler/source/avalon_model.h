@@ -0,0 +1,304 @@
+/** @file avalon_model.h
+*
+* @brief Cycle-accurate model of the avalon_master HDL module executing the compiled images.
+*
+*/
+
+#ifndef AVALON_MODEL_H
+#define AVALON_MODEL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "file_access.h"
+#include "compile.h"
+
+// === Type Definitions ===
+//
+typedef enum
+{
+    stFetch = 0,
+    stReadTiming,
+    stReadLatency,
+    stWriteTiming,
+    stWriteHold,
+    stWait,
+    stLoad,
+    stPcIncr,
+    stBurstRead,            // Burst command until accepted, then one beat at each readdatavalid
+    stBurstWrite            // One beat in each cycle
+} modelState_t;
+
+typedef enum
+{
+    eventRead = 0,          // Read data is captured: readDataEN
+    eventWrite              // Last cycle of the write strobe
+} eventType_t;
+
+typedef enum
+{
+    perfFetch = 0,          // FETCH without command
+    perfSetup,              // Chipselect before the strobe
+    perfStrobe,             // Read / write strobe and the beats of the bursts
+    perfStall,              // Command held by waitrequest
+    perfLatency,            // Read latency
+    perfHold,               // Write hold
+    perfWait,               // ST_WAIT: WAIT instruction and AVALON_DELAY after the transfers
+    perfControl,            // LOAD, PC_INCR
+    perfPhaseLimit
+} perfPhase_t;
+
+typedef struct modelInstr
+{
+    uint32_t address;
+    uint32_t data;
+    uint8_t opCode;
+    uint8_t b_isLoaded;     // Entries out of the image are unknown: end of simulation
+} modelInstr_t;
+
+typedef struct modelImage
+{
+    modelInstr_t *p_instr;  // Instruction memory from address 0
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t opCodeMask;    // Bit of each operating code of the image
+    uint32_t loadModes;     // Mode bits of the load instructions: LOAD_MODE_*
+} modelImage_t;
+
+typedef struct avalonBus
+{
+    uint32_t address;       // Signals of the master in the current cycle
+    uint32_t writedata;
+    uint32_t readdata;      // Input of the master, driven by the slave
+    uint32_t readdataWatch;
+    uint32_t watchPC;       // readdataWatchPC: program counter of the read issuing the captured data
+    uint32_t watchAddress;  // Bus address of the read issuing the captured data
+    uint32_t pc;
+    uint32_t burstcount;    // 1 out of the bursts
+    uint32_t beat;          // Beat of the burst transferred in the cycle: the slave address is address + beat
+    uint8_t state;
+    bool b_chipselect;
+    bool b_read;
+    bool b_write;
+    bool b_readDataEN;
+    bool b_beginBurst;      // beginbursttransfer
+    bool b_waitrequest;     // Input of the master, driven by the slave
+    bool b_readdatavalid;   // Input of the master in the burst reads, preset by the fixed latency slave
+    bool b_isStalled;       // The command of the cycle is held by waitrequest
+} avalonBus_t;
+
+/* Slave hook: called in each cycle with the output signals of the master,
+   returns with the readdata input of the cycle and drives the b_waitrequest and b_readdatavalid inputs. */
+typedef uint32_t (*slaveHook_t) (void *p_slave, avalonBus_t * const p_bus);
+
+typedef struct loopStack
+{
+    // Registers of the repeat blocks, one entry for each nesting level
+    uint32_t count[LOOP_DEPTH_LIMIT];           // Iterations left including the current one
+    uint32_t returnPC[LOOP_DEPTH_LIMIT];        // First instruction of the block
+    uint32_t addressStep[LOOP_DEPTH_LIMIT];
+    uint32_t dataStep[LOOP_DEPTH_LIMIT];
+    uint32_t addressBase[LOOP_DEPTH_LIMIT];     // Offsets before the block
+    uint32_t dataBase[LOOP_DEPTH_LIMIT];
+    uint32_t level;                             // Number of the open blocks
+    // Added to the bus address of read / write and to the writedata
+    uint32_t addressOffset;
+    uint32_t dataOffset;
+} loopStack_t;
+
+typedef struct pendingRead
+{
+    uint64_t dueCycle;      // readdatavalid of the fixed latency pipelined slave
+    uint32_t pc;
+    uint32_t address;
+    uint32_t data;          // The readdata is sampled by the command
+} pendingRead_t;
+
+typedef struct perfCounters
+{
+    // Performance counters of avalon_master
+    uint64_t cycles;
+    uint64_t busCycles;                     // chipselect
+    uint64_t dataCycles;                    // Read data captured or write accepted
+    uint64_t phaseCycles[perfPhaseLimit];
+    uint64_t opCodeCount[OPCODE_LIMIT];     // Retired instructions
+    uint64_t longestStall;                  // Longest run of the held command cycles
+    uint32_t stallPC;
+    uint64_t longestSpan;                   // Longest instruction: cycles between two retired instructions
+    uint32_t longestPC;
+    // Profile: cycles and retired count of each program counter below pcSize
+    uint64_t *p_pcCycles;
+    uint64_t *p_pcCount;
+    uint32_t pcSize;
+    // Running state
+    uint32_t issuePC;                       // Instruction of the cycle: the beat rows belong to their burst
+    uint64_t stall;
+    uint64_t span;
+} perfCounters_t;
+
+typedef struct avalonModel
+{
+    const modelImage_t *p_image;
+    uint32_t pcMask;            // 2^INSTR_LIMIT_SIZE - 1
+    // Registers of avalon_master
+    uint8_t state;
+    uint8_t setup, readWait, writeWait, hold, readLatency;
+    uint8_t setupStore, readWaitStore, writeWaitStore, holdStore, readLatencyStore;
+    uint32_t pc;
+    uint32_t waitCount;
+    uint32_t wait;
+    loopStack_t loops;
+    // Transfer registers latched in FETCH
+    uint32_t transferAddress;   // Address of the instruction with the loop offset
+    uint32_t burstCount;
+    uint32_t beatCount;         // Beats left including the current one
+    uint32_t burstStep;         // Pattern step of the burst write, 0: the beats are inline
+    uint32_t patternOffset;     // Added to the data of the pattern start
+    bool b_burstBegin;          // First cycle of the burst
+    bool b_burstCommand;        // Burst read command until accepted
+    uint64_t beatDue;           // First readdatavalid of the burst read from the fixed latency slave
+    // Pipelined reads: response FIFO of the outstanding reads
+    bool b_isPipelined;         // Selected by the load
+    // waitrequest mode: the transfers end without the WAIT of AVALON_DELAY
+    bool b_isWaitrequest;       // Selected by the load
+    // Fast issue mode: back to back reads and writes without FETCH, WAIT and PC_INCR
+    bool b_isFastIssue;         // Selected by the load
+    pendingRead_t p_pending[PENDING_READ_LIMIT];
+    uint32_t pendingHead;
+    uint32_t pendingCount;
+    // Statistics
+    uint64_t cycle;             // Number of simulated cycles
+    uint64_t instrCount;        // Number of executed instructions
+    slaveHook_t p_slaveHook;    // NULL: readdata is 0
+    void *p_slave;
+    perfCounters_t *p_perf;     // Counted in each cycle, NULL: no counters
+} avalonModel_t;
+
+typedef struct modelEvent
+{
+    uint64_t cycle;
+    uint32_t pc;
+    uint32_t address;           // Bus address of the instruction, address + beat in the bursts
+    uint32_t data;              // Captured readdata or writedata
+    uint8_t type;               // eventType_t
+} modelEvent_t;
+
+typedef struct eventLog
+{
+    modelEvent_t *p_events;
+    size_t size;
+    size_t capacity;
+} eventLog_t;
+
+// === Constant Definitions ===
+//
+#define AVALON_DELAY            25          // Wait cycles after each bus operation of the HDL
+#define MODEL_INSTR_BITS        68          // opcode|address|data -> 4|32|32
+#define MODEL_IMAGE_MIN         1024        // Initial capacity of the instruction memory
+#define MODEL_LOG_MIN           1024        // Initial capacity of the event log
+#define MODEL_CYCLE_LIMIT       10000000000ULL
+#define MODEL_CLOCK_PERIOD_NS   20          // 50 MHz clock of avalon_interface
+#define MODEL_RESET_NS          30          // First active clock edge after the reset
+
+// === Macros ===
+//
+#define MODEL_TIME_NS(cycle)    ((uint64_t) MODEL_RESET_NS + (uint64_t) (cycle) * MODEL_CLOCK_PERIOD_NS)
+
+// === Public API Functions ===
+//
+/*!
+* @brief Loads the compiled image like $readmemh: hexadecimal words with '_' separators,
+*           line and block comments, "@<address>" for the address of the next word.
+*
+* @param[in] p_path The path of the compiled image.
+*
+* @return MEMORY ALLOCATION: The instruction memory, NULL on error.
+*/
+modelImage_t *LoadImage (const char * const p_path);
+
+/*!
+* @brief Resets the master to the state after the reset of the HDL.
+*
+* @param[out] p_model The model.
+* @param[in] p_image The instruction memory.
+* @param[in] depthBits INSTR_LIMIT_SIZE of the HDL.
+* @param[in] p_slaveHook Slave driving the readdata input, NULL: readdata is 0.
+* @param[in] p_slave Context of the slave hook.
+*
+* @return void
+*/
+void ResetModel (avalonModel_t * const p_model, const modelImage_t * const p_image, const int depthBits,
+                 const slaveHook_t p_slaveHook, void * const p_slave);
+
+/*!
+* @brief Simulates one clock cycle: the combinational outputs of the current state,
+*           then the register update at the closing clock edge.
+*
+* @param[in,out] p_model The model.
+* @param[out] p_bus The signals of the cycle.
+*
+* @return Returns with true if the simulation is ready: the unknown instruction is reached.
+*/
+bool StepModel (avalonModel_t * const p_model, avalonBus_t * const p_bus);
+
+/*!
+* @brief Executes the repeat and end instructions in PC_INCR of avalon_master.
+*           Repeat pushes a block when the stack is not full, end jumps back
+*           and adds the steps to the offsets until the last iteration, then pops the block.
+*           End without open block and the other instructions are not affected.
+*
+* @param[in,out] p_loops The loop registers.
+* @param[in] p_instr The current instruction.
+* @param[in] pcNext Incremented program counter.
+*
+* @return The next program counter.
+*/
+uint32_t StepLoop (loopStack_t * const p_loops, const modelInstr_t * const p_instr, const uint32_t pcNext);
+
+/*!
+* @brief Simulates until the simulation is ready or the cycle limit is reached.
+*           Without slave and counters the idle spans (WAIT, setup, strobe, latency and hold countdowns)
+*           are skipped at once, the cycle of each bus event stays exact.
+*
+* @param[in,out] p_model The model.
+* @param[in] cycleLimit Maximum number of cycles.
+* @param[out] p_log The bus events are appended, optional.
+*
+* @return MEMORY ALLOCATION: Returns with true if the simulation is ready.
+*/
+bool RunModel (avalonModel_t * const p_model, const uint64_t cycleLimit, eventLog_t * const p_log);
+
+/*!
+* @brief Appends the bus event to the log.
+*
+* @param[in,out] p_log The event log.
+* @param[in] p_event The event.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool AppendEvent (eventLog_t * const p_log, const modelEvent_t * const p_event);
+
+/*!
+* @brief Clean up of the instruction memory.
+*
+* @param[in] p_image The image to be cleaned.
+*
+* @return void
+*/
+void CleanupImage (modelImage_t * const p_image);
+
+/*!
+* @brief Clean up of the event log.
+*
+* @param[in] p_log The log to be cleaned.
+*
+* @return void
+*/
+void CleanupLog (eventLog_t * const p_log);
+
+#endif // AVALON_MODEL_H
+
+/*** EOF ***/
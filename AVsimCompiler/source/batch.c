@@ -0,0 +1,320 @@
+/** @file batch.c
+*
+* @brief Compiles a set of Avalon Simulator sources in one process.
+*
+*/
+
+#include "batch.h"
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <glob.h>
+#endif // _WIN32
+
+// === Protected Functions ===
+//
+/*!
+* @brief Appends a source to the batch and generates its target path.
+*
+* @param[in] p_source Source path.
+* @param[in,out] p_batch The batch to be extended.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+static bool AddJob (const char * const p_source, batch_t * const p_batch)
+{
+    if (p_batch->size == p_batch->capacity)
+    {
+        const int capacity = (p_batch->capacity < BATCH_CAPACITY_MIN) ? BATCH_CAPACITY_MIN : 2 * p_batch->capacity;
+        batchJob_t * const p_jobs = (batchJob_t *) realloc(p_batch->p_jobs, capacity * sizeof(batchJob_t));
+        if (p_jobs == NULL)
+        {
+            perror("Unable to allocate memory for the batch.");
+            return false;
+        }
+        p_batch->p_jobs = p_jobs;
+        p_batch->capacity = capacity;
+    }
+
+    const size_t length = strlen(p_source);
+    batchJob_t * const p_job = &p_batch->p_jobs[p_batch->size];
+    memset(p_job, 0, sizeof(batchJob_t));
+    p_job->p_source = (char *) malloc(length + 1);
+    p_job->p_target = (char *) malloc(length + sizeof(TARGET_FILE_EXTENSION));
+    if ((p_job->p_source == NULL) || (p_job->p_target == NULL))
+    {
+        perror("Unable to allocate memory for the batch.");
+        free(p_job->p_source);
+        free(p_job->p_target);
+        return false;
+    }
+
+    memcpy(p_job->p_source, p_source, length + 1);
+    memcpy(p_job->p_target, p_source, length + 1);
+    strcat(RemoveExtension(p_job->p_target), TARGET_FILE_EXTENSION);
+    p_batch->size++;
+
+    return true;
+}
+
+/*!
+* @brief Appends each file matching the wildcard pattern to the batch.
+*
+* @param[in] p_pattern Wildcard pattern or a file path.
+* @param[in,out] p_batch The batch to be extended.
+*
+* @return Returns with true, if any source is matching.
+*/
+static bool CollectPattern (const char * const p_pattern, batch_t * const p_batch)
+{
+    bool b_isFound = false;
+
+#ifdef _WIN32
+    WIN32_FIND_DATAA findData;
+    char path[FILENAME_MAX];
+
+    HANDLE const findHandle = FindFirstFileA(p_pattern, &findData);
+    if (findHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    // The found names are relative to the folder of the pattern
+    int folderLength = 0;
+    for (int i = 0; p_pattern[i]; i++)
+    {
+        if ((p_pattern[i] == '/') || (p_pattern[i] == '\\'))
+        {
+            folderLength = i + 1;
+        }
+    }
+
+    do
+    {
+        if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        {
+            snprintf(path, sizeof(path), "%.*s%s", folderLength, p_pattern, findData.cFileName);
+            b_isFound |= AddJob(path, p_batch);
+        }
+    }
+    while (FindNextFileA(findHandle, &findData));
+    FindClose(findHandle);
+#else
+    glob_t matches;
+
+    if (glob(p_pattern, 0, NULL, &matches) != 0)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < matches.gl_pathc; i++)
+    {
+        struct stat fileStat;
+        if ((stat(matches.gl_pathv[i], &fileStat) == 0) && !S_ISDIR(fileStat.st_mode))
+        {
+            b_isFound |= AddJob(matches.gl_pathv[i], p_batch);
+        }
+    }
+    globfree(&matches);
+#endif // _WIN32
+
+    return b_isFound;
+}
+
+/*!
+* @brief Appends the sources of a folder, a pattern or a single file to the batch.
+*
+* @param[in] p_entry Folder, pattern or file path.
+* @param[in] p_extension Extension of the files collected from a folder.
+* @param[in,out] p_batch The batch to be extended.
+*
+* @return Returns with true, if any source is found.
+*/
+static bool CollectEntry (const char * const p_entry, const char * const p_extension, batch_t * const p_batch)
+{
+    struct stat fileStat;
+
+    if ((stat(p_entry, &fileStat) == 0) && S_ISDIR(fileStat.st_mode))
+    {
+        char pattern[FILENAME_MAX];
+        const size_t length = strlen(p_entry);
+        const bool b_hasSeparator = (length > 0) && ((p_entry[length - 1] == '/') || (p_entry[length - 1] == '\\'));
+
+        snprintf(pattern, sizeof(pattern), "%s%s*%s", p_entry, b_hasSeparator ? "" : "/", p_extension);
+        return CollectPattern(pattern, p_batch);
+    }
+
+    return CollectPattern(p_entry, p_batch);
+}
+
+/*!
+* @brief Appends the sources listed in the manifest file to the batch.
+*           Empty rows and rows started by INPUT_COMMENT are skipped.
+*
+* @param[in] p_path Manifest file path.
+* @param[in] p_extension Extension of the files collected from a folder.
+* @param[in,out] p_batch The batch to be extended.
+*
+* @return Returns with true, if any source is found.
+*/
+static bool CollectManifest (const char * const p_path, const char * const p_extension, batch_t * const p_batch)
+{
+    char entry[FILENAME_MAX];
+    bool b_isFound = false;
+
+    sourceText_t * const p_manifest = ReadFile(p_path);
+    if (p_manifest == NULL)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < p_manifest->param.rowSize; i++)
+    {
+        const char *p_text = p_manifest->p_lines[i].p_text;
+        int length = p_manifest->p_lines[i].length;
+
+        // Trim the surrounding white spaces
+        while ((length > 0) && isspace((unsigned char) *p_text))
+        {
+            p_text++;
+            length--;
+        }
+        while ((length > 0) && isspace((unsigned char) p_text[length - 1]))
+        {
+            length--;
+        }
+        if ((length == 0) || (*p_text == INPUT_COMMENT) || (length >= (int) sizeof(entry)))
+        {
+            continue;
+        }
+
+        memcpy(entry, p_text, length);
+        entry[length] = '\0';
+        if (CollectEntry(entry, p_extension, p_batch))
+        {
+            b_isFound = true;
+        }
+        else
+        {
+            fprintf(stderr, "No source is found: '%s'\n", entry);
+        }
+    }
+
+    CleanupText(p_manifest);
+
+    return b_isFound;
+}
+
+/*!
+* @brief Compiles one job of the batch.
+*
+* @param[in,out] p_context The batch.
+* @param[in] task Index of the job.
+*
+* @return void
+*/
+static void CompileJob (void *p_context, int task)
+{
+    batchJob_t * const p_job = &((batch_t *) p_context)->p_jobs[task];
+
+    sourceText_t * const p_source = ReadFile(p_job->p_source);
+    if (p_source == NULL)
+    {
+        return;
+    }
+
+    // The jobs are parallel, each program is compiled by a single thread
+    program_t * const p_program = CompileCode(p_source, 1);
+    textBuffer_t compiled = { NULL, 0, 0 };
+    if ((p_program != NULL) && EmitCode(p_program, &compiled))
+    {
+        p_job->progCount = p_program->progCount;
+        p_job->invalidCount = CountInvalid(p_program);
+        p_job->b_isCompiled = WriteFile(p_job->p_target, &compiled);
+    }
+
+    CleanupBuffer(&compiled);
+    CleanupProgram(p_program);
+    CleanupText(p_source);
+}
+
+// === Public API Functions ===
+//
+bool CollectSources (const char * const p_input, batch_t * const p_batch)
+{
+    return CollectFiles(p_input, SOURCE_FILE_EXTENSION, p_batch);
+}
+
+bool CollectFiles (const char * const p_input, const char * const p_extension, batch_t * const p_batch)
+{
+    if (p_input[0] == BATCH_MANIFEST)
+    {
+        return CollectManifest(p_input + 1, p_extension, p_batch);
+    }
+
+    return CollectEntry(p_input, p_extension, p_batch);
+}
+
+void CompileBatch (batch_t * const p_batch, const int jobs)
+{
+    RunParallel(jobs, p_batch->size, CompileJob, p_batch);
+}
+
+int GetBatchDepthBits (const batch_t * const p_batch)
+{
+    int progCount = 0;
+
+    for (int i = 0; i < p_batch->size; i++)
+    {
+        if (p_batch->p_jobs[i].progCount > progCount)
+        {
+            progCount = p_batch->p_jobs[i].progCount;
+        }
+    }
+
+    return GetDepthBits(progCount);
+}
+
+bool WriteBatchDefFile (const char * const p_path, const char * const p_subfolder, const batch_t * const p_batch,
+                        const int depthBits)
+{
+    FILE * const p_file = fopen(p_path, "w");
+
+    if (p_file == NULL)
+    {
+        perror("Error at output file opening.\n");
+        return false;
+    }
+
+    fprintf(p_file, BATCH_DEF_COUNT, p_batch->size);
+    fprintf(p_file, BATCH_DEF_DEPTH, (depthBits == INSTR_DEPTH_AUTO) ? GetBatchDepthBits(p_batch) : depthBits);
+    for (int i = 0; i < p_batch->size; i++)
+    {
+        fprintf(p_file, BATCH_DEF_PATH, i);
+        fprintf(p_file, "\"%s%s\"\n", p_subfolder, p_batch->p_jobs[i].p_target);
+    }
+    if (p_batch->size > 0)
+    {
+        fputs(BATCH_DEF_DEFAULT, p_file);
+    }
+
+    return fclose(p_file) == 0;
+}
+
+void CleanupBatch (batch_t * const p_batch)
+{
+    for (int i = 0; i < p_batch->size; i++)
+    {
+        free(p_batch->p_jobs[i].p_source);
+        free(p_batch->p_jobs[i].p_target);
+    }
+    free(p_batch->p_jobs);
+    p_batch->p_jobs = NULL;
+    p_batch->size = 0;
+    p_batch->capacity = 0;
+}
+
+/*** EOF ***/
@@ -0,0 +1,123 @@
+/** @file batch.h
+*
+* @brief Compiles a set of Avalon Simulator sources in one process.
+*
+*/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "file_access.h"
+#include "compile.h"
+#include "emit.h"
+#include "notify_invalid.h"
+#include "parallel.h"
+#include "common.h"
+
+// === Type Definitions ===
+//
+typedef struct batchJob
+{
+    char *p_source;         // Source path
+    char *p_target;         // Compiled path: the source path with TARGET_FILE_EXTENSION
+    int progCount;          // Number of valid instructions
+    int invalidCount;       // Number of invalid instructions
+    bool b_isCompiled;      // The target is written successfully
+} batchJob_t;
+
+typedef struct batch
+{
+    batchJob_t *p_jobs;
+    int size;
+    int capacity;
+} batch_t;
+
+// === Constant Definitions ===
+//
+#define BATCH_MANIFEST      '@'         // Manifest file prefix: one source, folder or pattern for each row
+#define BATCH_CAPACITY_MIN  64          // Initial size of the job list
+#define BATCH_DEF_PATH      "`define INSTRUCTION_PATH_%d  "
+#define BATCH_DEF_COUNT     "`define INSTRUCTION_COUNT  %d\n"
+#define BATCH_DEF_DEPTH     "`define INSTRUCTION_LIMIT_SIZE  %d\n"
+#define BATCH_DEF_DEFAULT   "`ifndef INSTRUCTION_PATH\n`define INSTRUCTION_PATH  `INSTRUCTION_PATH_0\n`endif\n"
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*!
+* @brief Collects the sources of the input to the batch.
+*           Input: a folder (each *.av inside), a wildcard pattern, a single file
+*           or a manifest file prefixed by BATCH_MANIFEST.
+*
+* @param[in] p_input Batch input.
+* @param[in,out] p_batch The collected jobs are appended.
+*
+* @return MEMORY ALLOCATION: Returns with true, if any source is found.
+*/
+bool CollectSources (const char * const p_input, batch_t * const p_batch);
+
+/*!
+* @brief Collects the files of the input to the batch like CollectSources,
+*           the folders are collected by the extension.
+*
+* @param[in] p_input Batch input.
+* @param[in] p_extension Extension of the files collected from a folder, e.g. TARGET_FILE_EXTENSION.
+* @param[in,out] p_batch The collected jobs are appended.
+*
+* @return MEMORY ALLOCATION: Returns with true, if any file is found.
+*/
+bool CollectFiles (const char * const p_input, const char * const p_extension, batch_t * const p_batch);
+
+/*!
+* @brief Compiles each job of the batch on the worker threads without console output.
+*
+* @param[in,out] p_batch The jobs to be compiled.
+* @param[in] jobs Worker threads, 0: one for each processor.
+*
+* @return void
+*/
+void CompileBatch (batch_t * const p_batch, const int jobs);
+
+/*!
+* @brief Returns with the instruction memory depth fitting the largest program of the batch.
+*
+* @param[in] p_batch The compiled batch.
+*
+* @return Address bits of the instruction memory, at least INSTR_DEPTH_BITS.
+*/
+int GetBatchDepthBits (const batch_t * const p_batch);
+
+/*!
+* @brief Writes one Verilog definition for each compiled program, the index is the position in the batch,
+*           and the instruction memory depth shared by the programs.
+*
+* @param[in] p_path The path of the Verilog definition file.
+* @param[in] p_subfolder Verilog project subfolder path of the compiled codes.
+* @param[in] p_batch The compiled batch.
+* @param[in] depthBits Address bits of the instruction memory, INSTR_DEPTH_AUTO: fitting the largest program.
+*
+* @return Returns with true in case of success.
+*/
+bool WriteBatchDefFile (const char * const p_path, const char * const p_subfolder, const batch_t * const p_batch,
+                        const int depthBits);
+
+/*!
+* @brief Clean up of the batch memory allocations.
+*
+* @param[in] p_batch The batch to be cleaned.
+*
+* @return void
+*/
+void CleanupBatch (batch_t * const p_batch);
+
+#endif // BATCH_H
+
+/*** EOF ***/
@@ -0,0 +1,551 @@
+/** @file cache.c
+*
+* @brief Incremental recompilation by a sidecar cache of per-line content hashes.
+*
+*/
+
+#include "cache.h"
+
+#include <sys/stat.h>
+
+// === Protected Functions ===
+//
+/*!
+* @brief Hashes the content of the source row word by word.
+*
+* @param[in] p_line Source row view.
+*
+* @return 64-bit content hash.
+*/
+static uint64_t HashLine (const textLine_t * const p_line)
+{
+    const char *p_text = p_line->p_text;
+    int length = p_line->length;
+    uint64_t hash = HASH_SEED ^ (uint64_t) length;
+    uint64_t word;
+
+    for (; length >= (int) sizeof(word); length -= (int) sizeof(word), p_text += sizeof(word))
+    {
+        memcpy(&word, p_text, sizeof(word));
+        hash = (hash ^ word) * HASH_MULTIPLIER;
+        hash ^= hash >> 32;
+    }
+    if (length > 0)
+    {
+        word = 0;
+        memcpy(&word, p_text, (size_t) length);
+        hash = (hash ^ word) * HASH_MULTIPLIER;
+    }
+
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= HASH_MULTIPLIER;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+/*!
+* @brief Returns with the modification time of the file.
+*
+* @param[in] p_path The path of the file.
+* @param[out] p_size The size of the file.
+*
+* @return Modification time, -1 if the file is not found.
+*/
+static int64_t GetFileTime (const char * const p_path, uint64_t * const p_size)
+{
+    struct stat fileStat;
+
+    if (stat(p_path, &fileStat) != 0)
+    {
+        return -1;
+    }
+    *p_size = (uint64_t) fileStat.st_size;
+
+    return (int64_t) fileStat.st_mtime;
+}
+
+/*!
+* @brief Loads the cache if it belongs to the current compiled file.
+*
+* @param[in] p_cachePath The path of the cache.
+* @param[in] p_targetPath The path of the compiled file.
+* @param[out] p_header The header of the cache.
+*
+* @return MEMORY ALLOCATION: The cache entries, NULL if the cache is missing or stale.
+*/
+static cacheEntry_t *LoadCache (const char * const p_cachePath, const char * const p_targetPath, cacheHeader_t * const p_header)
+{
+    uint64_t outputSize = 0;
+    const int64_t outputTime = GetFileTime(p_targetPath, &outputSize);
+
+    FILE * const p_file = fopen(p_cachePath, "rb");
+    if (p_file == NULL)
+    {
+        return NULL;
+    }
+
+    cacheEntry_t *p_entries = NULL;
+    if ((fread(p_header, sizeof(cacheHeader_t), 1, p_file) == 1) &&
+        !memcmp(p_header->magic, CACHE_MAGIC, sizeof(p_header->magic)) &&
+        (p_header->version == CACHE_VERSION) &&
+        (p_header->entrySize == sizeof(cacheEntry_t)) &&
+        (p_header->outputSize == outputSize) &&
+        (p_header->outputTime == outputTime))
+    {
+        p_entries = (cacheEntry_t *) malloc(((size_t) p_header->rowSize + 1) * sizeof(cacheEntry_t));
+        if ((p_entries != NULL) && (fread(p_entries, sizeof(cacheEntry_t), p_header->rowSize, p_file) != p_header->rowSize))
+        {
+            free(p_entries);
+            p_entries = NULL;
+        }
+    }
+    fclose(p_file);
+
+    return p_entries;
+}
+
+/*!
+* @brief Stores the cache of the compiled file.
+*
+* @param[in] p_cachePath The path of the cache.
+* @param[in] p_targetPath The path of the compiled file.
+* @param[in] p_entries The cache entries.
+* @param[in] rowSize Number of entries.
+* @param[in] pcWidth Decimal digits of the rendered program counters.
+*
+* @return void
+*/
+static void SaveCache (const char * const p_cachePath, const char * const p_targetPath, const cacheEntry_t * const p_entries,
+                       const int rowSize, const int pcWidth)
+{
+    cacheHeader_t header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.entrySize = sizeof(cacheEntry_t);
+    header.rowSize = (uint32_t) rowSize;
+    header.pcWidth = (uint32_t) pcWidth;
+    header.outputTime = GetFileTime(p_targetPath, &header.outputSize);
+
+    FILE * const p_file = fopen(p_cachePath, "wb");
+    if (p_file == NULL)
+    {
+        perror("Error at cache file opening.\n");
+        return;
+    }
+
+    if ((fwrite(&header, sizeof(header), 1, p_file) != 1) ||
+        (fwrite(p_entries, sizeof(cacheEntry_t), (size_t) rowSize, p_file) != (size_t) rowSize))
+    {
+        perror("Error at cache file writing.\n");
+        fclose(p_file);
+        remove(p_cachePath);
+        return;
+    }
+    fclose(p_file);
+}
+
+/*!
+* @brief Stores the rendered length of the rows in the cache entries.
+*
+* @param[in] p_output Rendered rows, each one is terminated by EOL_CHAR.
+* @param[out] p_entries Entries of the rendered rows.
+*
+* @return void
+*/
+static void MeasureRows (const textBuffer_t * const p_output, cacheEntry_t * const p_entries)
+{
+    const char *p_row = p_output->p_data;
+    const char * const p_end = p_output->p_data + p_output->size;
+
+    for (int i = 0; p_row < p_end; i++)
+    {
+        const char * const p_eol = (const char *) memchr(p_row, EOL_CHAR, (size_t) (p_end - p_row));
+        p_entries[i].outputLength = (uint32_t) (p_eol - p_row + 1);
+        p_row = p_eol + 1;
+    }
+}
+
+/*!
+* @brief Counts the valid instructions of the records.
+*
+* @param[in] p_records The records.
+* @param[in] stride Distance of the records in bytes.
+* @param[in] size Number of records.
+*
+* @return Number of valid instructions.
+*/
+static int CountValid (const uint8_t *p_records, const size_t stride, const int size)
+{
+    int progCount = 0;
+
+    for (int i = 0; i < size; i++, p_records += stride)
+    {
+        if (((const instrRecord_t *) p_records)->flags & RECORD_VALID)
+        {
+            progCount++;
+        }
+    }
+
+    return progCount;
+}
+
+/*!
+* @brief Allocates the cache entries of the source and hashes its rows.
+*
+* @param[in] p_source Mapped source text.
+*
+* @return MEMORY ALLOCATION: One entry for each row, NULL on error.
+*/
+static cacheEntry_t *HashRows (const sourceText_t * const p_source)
+{
+    const int rowSize = p_source->param.rowSize;
+
+    cacheEntry_t * const p_entries = (cacheEntry_t *) malloc(((size_t) rowSize + 1) * sizeof(cacheEntry_t));
+    if (p_entries == NULL)
+    {
+        perror("Unable to allocate memory for the cache.");
+        return NULL;
+    }
+    for (int i = 0; i < rowSize; i++)
+    {
+        p_entries[i].hash = HashLine(&p_source->p_lines[i]);
+    }
+
+    return p_entries;
+}
+
+/*!
+* @brief Compiles the changed rows between the unchanged beginning and end of the source,
+*           the records and the rendered lengths of the unchanged rows are reused.
+*           Every row is rendered again if the width of the program counters is changed.
+*
+* @param[in] p_source Mapped source text.
+* @param[in,out] p_entries Hashed entries of the source, the reused lengths are filled.
+* @param[in] p_cached Entries of the previous compilation.
+* @param[in] cachedSize Number of previous entries.
+* @param[in] cachedWidth Program counter width of the previous compilation.
+* @param[in] jobs Worker threads, 0: one for each processor.
+* @param[out] p_stats The changed rows.
+* @param[out] p_cachedLast Previous row after the last changed one.
+*
+* @return MEMORY ALLOCATION: The compiled program, NULL on error.
+*/
+static program_t *RecompileRows (const sourceText_t * const p_source, cacheEntry_t * const p_entries,
+                                 const cacheEntry_t * const p_cached, const int cachedSize, const int cachedWidth,
+                                 const int jobs, cacheStats_t * const p_stats, int * const p_cachedLast)
+{
+    const int rowSize = p_source->param.rowSize;
+    const int commonSize = (rowSize < cachedSize) ? rowSize : cachedSize;
+    int first = 0;
+    int suffix = 0;
+
+    // Unchanged rows at the beginning and at the end
+    while ((first < commonSize) && (p_entries[first].hash == p_cached[first].hash))
+    {
+        first++;
+    }
+    while ((suffix < commonSize - first) && (p_entries[rowSize - 1 - suffix].hash == p_cached[cachedSize - 1 - suffix].hash))
+    {
+        suffix++;
+    }
+    const int last = rowSize - suffix;
+    *p_cachedLast = cachedSize - suffix;
+    p_stats->changedFirst = first;
+    p_stats->changedLast = last;
+    p_stats->b_isChanged = (first < last) || (cachedSize != rowSize);
+
+    instrRecord_t * const p_records = (instrRecord_t *) malloc(((size_t) rowSize + 1) * sizeof(instrRecord_t));
+    for (int i = 0; (p_records != NULL) && (i < rowSize); i++)
+    {
+        if ((i < first) || (i >= last))
+        {
+            const cacheEntry_t * const p_entry = &p_cached[(i < first) ? i : i - last + *p_cachedLast];
+            p_records[i] = p_entry->record;
+            p_entries[i].outputLength = p_entry->outputLength;
+        }
+    }
+
+    program_t * const p_program = RecompileCode(p_source, p_records, first, last, jobs);
+    if (p_program != NULL)
+    {
+        // An edited repeat block may invalidate or restore unchanged rows
+        int changedFirst = first;
+        int changedLast = last;
+        for (int i = 0; i < rowSize; i++)
+        {
+            const int cachedRow = (i < first) ? i : i - last + *p_cachedLast;
+            if (((i < first) || (i >= last)) && (p_program->p_records[i].flags != p_cached[cachedRow].record.flags))
+            {
+                changedFirst = (i < changedFirst) ? i : changedFirst;
+                changedLast = (i >= changedLast) ? i + 1 : changedLast;
+            }
+        }
+        if ((changedFirst != first) || (changedLast != last))
+        {
+            p_stats->changedFirst = changedFirst;
+            p_stats->changedLast = changedLast;
+            p_stats->b_isChanged = true;
+            *p_cachedLast += changedLast - last;
+        }
+    }
+    if ((p_program != NULL) && (p_program->pcWidth != cachedWidth))
+    {
+        p_stats->changedFirst = 0;
+        p_stats->changedLast = rowSize;
+        p_stats->b_isChanged = true;
+        *p_cachedLast = cachedSize;
+    }
+
+    return p_program;
+}
+
+/*!
+* @brief Returns with the rendered size of the previous rows [first, last).
+*
+* @param[in] p_cached Entries of the previous compilation.
+* @param[in] first First row.
+* @param[in] last Row after the last one.
+*
+* @return Size in bytes.
+*/
+static size_t SumOutputLength (const cacheEntry_t * const p_cached, const int first, const int last)
+{
+    size_t size = 0;
+
+    for (int i = first; i < last; i++)
+    {
+        size += p_cached[i].outputLength;
+    }
+
+    return size;
+}
+
+/*!
+* @brief Renders the changed rows, and the following rows too if their program counters are shifted.
+*
+* @param[in] p_program The recompiled program.
+* @param[in] p_cached Entries of the previous compilation.
+* @param[in] p_stats The changed rows.
+* @param[in] cachedLast Previous row after the last changed one.
+* @param[in,out] p_entries Entries of the program, the rendered lengths are filled.
+* @param[out] p_head The changed rows.
+* @param[out] p_tail The following rows, empty if they are unchanged.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+static bool EmitChanged (const program_t * const p_program, const cacheEntry_t * const p_cached,
+                         const cacheStats_t * const p_stats, const int cachedLast,
+                         cacheEntry_t * const p_entries, textBuffer_t * const p_head, textBuffer_t * const p_tail)
+{
+    const int first = p_stats->changedFirst;
+    const int last = p_stats->changedLast;
+    const int cachedCount = CountValid((const uint8_t *) &p_cached[first].record, sizeof(cacheEntry_t), cachedLast - first);
+    const int changedCount = CountValid((const uint8_t *) &p_program->p_records[first], sizeof(instrRecord_t), last - first);
+
+    if (!EmitRange(p_program, first, last, p_head))
+    {
+        return false;
+    }
+    MeasureRows(p_head, &p_entries[first]);
+
+    // The program counters of the following rows are shifted
+    if (cachedCount != changedCount)
+    {
+        if (!EmitRange(p_program, last, p_program->rowSize, p_tail))
+        {
+            return false;
+        }
+        MeasureRows(p_tail, &p_entries[last]);
+    }
+
+    return true;
+}
+
+// === Public API Functions ===
+//
+program_t *CompileIncremental (const sourceText_t * const p_source, const char * const p_targetPath,
+                               const int jobs, cacheStats_t * const p_stats)
+{
+    const int rowSize = p_source->param.rowSize;
+    char cachePath[FILENAME_MAX];
+    cacheHeader_t header;
+    textBuffer_t head = { NULL, 0, 0 };
+    textBuffer_t tail = { NULL, 0, 0 };
+    program_t *p_program = NULL;
+    bool b_isWritten = true;
+
+    snprintf(cachePath, sizeof(cachePath), "%s%s", p_targetPath, CACHE_FILE_EXTENSION);
+    memset(p_stats, 0, sizeof(cacheStats_t));
+
+    cacheEntry_t * const p_entries = HashRows(p_source);
+    if (p_entries == NULL)
+    {
+        return NULL;
+    }
+
+    cacheEntry_t * const p_cached = LoadCache(cachePath, p_targetPath, &header);
+    if (p_cached == NULL)
+    {
+        // Full build
+        p_stats->b_isFullBuild = true;
+        p_stats->b_isChanged = true;
+        p_stats->changedLast = rowSize;
+        p_program = CompileCode(p_source, jobs);
+        b_isWritten = (p_program != NULL) && EmitCode(p_program, &head) && WriteFile(p_targetPath, &head);
+        if (b_isWritten)
+        {
+            MeasureRows(&head, p_entries);
+            p_stats->patchSize = head.size;
+        }
+    }
+    else
+    {
+        int cachedLast;
+        p_program = RecompileRows(p_source, p_entries, p_cached, (int) header.rowSize, (int) header.pcWidth, jobs, p_stats, &cachedLast);
+        if ((p_program != NULL) && p_stats->b_isChanged)
+        {
+            const size_t offset = SumOutputLength(p_cached, 0, p_stats->changedFirst);
+            const size_t cachedChange = SumOutputLength(p_cached, p_stats->changedFirst, cachedLast);
+
+            b_isWritten = EmitChanged(p_program, p_cached, p_stats, cachedLast, p_entries, &head, &tail);
+            if (b_isWritten && (tail.p_data == NULL) && (head.size != cachedChange))
+            {
+                // The following rows are shifted
+                b_isWritten = EmitRange(p_program, p_stats->changedLast, rowSize, &tail);
+                MeasureRows(&tail, &p_entries[p_stats->changedLast]);
+            }
+            if (b_isWritten)
+            {
+                // Same layout: the changed rows are overwritten in place
+                const size_t size = (tail.p_data == NULL) ? (size_t) header.outputSize : offset + head.size + tail.size;
+                b_isWritten = PatchFile(p_targetPath, offset, &head, &tail, size);
+            }
+            p_stats->patchOffset = offset;
+            p_stats->patchSize = head.size + tail.size;
+        }
+        free(p_cached);
+    }
+
+    if ((p_program != NULL) && b_isWritten)
+    {
+        for (int i = 0; i < rowSize; i++)
+        {
+            p_entries[i].record = p_program->p_records[i];
+        }
+        if (p_stats->b_isChanged)
+        {
+            SaveCache(cachePath, p_targetPath, p_entries, rowSize, p_program->pcWidth);
+        }
+    }
+    else
+    {
+        // The compiled file is not consistent with the cache anymore
+        remove(cachePath);
+        CleanupProgram(p_program);
+        p_program = NULL;
+    }
+
+    CleanupBuffer(&tail);
+    CleanupBuffer(&head);
+    free(p_entries);
+
+    return p_program;
+}
+
+program_t *RecompileState (const sourceText_t * const p_source, compileState_t * const p_state,
+                           const int jobs, cacheStats_t * const p_stats)
+{
+    const int rowSize = p_source->param.rowSize;
+    textBuffer_t output = { NULL, 0, 0 };
+    textBuffer_t head = { NULL, 0, 0 };
+    textBuffer_t tail = { NULL, 0, 0 };
+    program_t *p_program = NULL;
+    bool b_isCompiled = false;
+
+    memset(p_stats, 0, sizeof(cacheStats_t));
+    cacheEntry_t * const p_entries = HashRows(p_source);
+    if (p_entries == NULL)
+    {
+        return NULL;
+    }
+
+    if (p_state->p_entries == NULL)
+    {
+        // Full build
+        p_stats->b_isFullBuild = true;
+        p_stats->b_isChanged = true;
+        p_stats->changedLast = rowSize;
+        p_program = CompileCode(p_source, jobs);
+        b_isCompiled = (p_program != NULL) && EmitCode(p_program, &output);
+        if (b_isCompiled)
+        {
+            MeasureRows(&output, p_entries);
+            p_stats->patchSize = output.size;
+        }
+    }
+    else
+    {
+        int cachedLast;
+        p_program = RecompileRows(p_source, p_entries, p_state->p_entries, p_state->rowSize, p_state->pcWidth,
+                                  jobs, p_stats, &cachedLast);
+        if ((p_program != NULL) && EmitChanged(p_program, p_state->p_entries, p_stats, cachedLast, p_entries, &head, &tail))
+        {
+            // Unchanged beginning, the changed rows, then the following rows: rendered or unchanged
+            const size_t offset = SumOutputLength(p_state->p_entries, 0, p_stats->changedFirst);
+            const size_t suffix = offset + SumOutputLength(p_state->p_entries, p_stats->changedFirst, cachedLast);
+            const char * const p_suffix = (tail.p_data != NULL) ? tail.p_data : p_state->output.p_data + suffix;
+            const size_t suffixSize = (tail.p_data != NULL) ? tail.size : p_state->output.size - suffix;
+
+            output.capacity = offset + head.size + suffixSize + 1;
+            output.p_data = (char *) malloc(output.capacity);
+            b_isCompiled = (output.p_data != NULL);
+            if (b_isCompiled)
+            {
+                memcpy(output.p_data, p_state->output.p_data, offset);
+                memcpy(output.p_data + offset, head.p_data, head.size);
+                memcpy(output.p_data + offset + head.size, p_suffix, suffixSize);
+                output.size = offset + head.size + suffixSize;
+            }
+            p_stats->patchOffset = offset;
+            p_stats->patchSize = head.size + tail.size;
+        }
+    }
+
+    CleanupBuffer(&tail);
+    CleanupBuffer(&head);
+    if (!b_isCompiled)
+    {
+        CleanupBuffer(&output);
+        CleanupProgram(p_program);
+        free(p_entries);
+        return NULL;
+    }
+
+    // The new compilation becomes the resident state
+    for (int i = 0; i < rowSize; i++)
+    {
+        p_entries[i].record = p_program->p_records[i];
+    }
+    CleanupState(p_state);
+    p_state->p_entries = p_entries;
+    p_state->rowSize = rowSize;
+    p_state->pcWidth = p_program->pcWidth;
+    p_state->output = output;
+
+    return p_program;
+}
+
+void CleanupState (compileState_t * const p_state)
+{
+    free(p_state->p_entries);
+    p_state->p_entries = NULL;
+    p_state->rowSize = 0;
+    p_state->pcWidth = 0;
+    CleanupBuffer(&p_state->output);
+}
+
+/*** EOF ***/
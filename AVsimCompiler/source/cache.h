@@ -0,0 +1,115 @@
+/** @file cache.h
+*
+* @brief Incremental recompilation by a sidecar cache of per-line content hashes.
+*
+*/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "file_access.h"
+#include "compile.h"
+#include "emit.h"
+
+// === Type Definitions ===
+//
+typedef struct cacheHeader
+{
+    char magic[4];              // CACHE_MAGIC
+    uint32_t version;           // CACHE_VERSION
+    uint32_t entrySize;         // sizeof(cacheEntry_t)
+    uint32_t rowSize;           // Number of entries
+    uint32_t pcWidth;           // Decimal digits of the rendered program counters
+    uint32_t reserved;
+    uint64_t outputSize;        // Size of the compiled file
+    int64_t outputTime;         // Modification time of the compiled file
+} cacheHeader_t;
+
+typedef struct cacheEntry
+{
+    uint64_t hash;              // Content hash of the source row
+    instrRecord_t record;       // The compiled record of the row
+    uint32_t outputLength;      // Rendered length of the row with its EOL_CHAR
+} cacheEntry_t;
+
+typedef struct compileState
+{
+    cacheEntry_t *p_entries;    // One entry for each row of the last compilation
+    int rowSize;
+    int pcWidth;                // Decimal digits of the rendered program counters
+    textBuffer_t output;        // The last compiled code
+} compileState_t;
+
+typedef struct cacheStats
+{
+    bool b_isFullBuild;         // No usable cache: everything is compiled
+    bool b_isChanged;           // Any row is changed, inserted or removed
+    int changedFirst;           // Changed rows: [changedFirst, changedLast)
+    int changedLast;
+    size_t patchOffset;         // The compiled file is rewritten from this offset
+    size_t patchSize;           // Number of rewritten bytes
+} cacheStats_t;
+
+// === Constant Definitions ===
+//
+#define CACHE_FILE_EXTENSION    ".cache"        // Sidecar: <source>.mem.cache
+#define CACHE_MAGIC             "AVCC"
+#define CACHE_VERSION           4
+#define HASH_SEED               0x9E3779B97F4A7C15ULL
+#define HASH_MULTIPLIER         0xFF51AFD7ED558CCDULL
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*!
+* @brief Compiles the source with the help of the sidecar cache of the target:
+*           only the changed rows are lexed, the program counters are renumbered
+*           from the first change and the target is patched in place from there.
+*           Without a usable cache the whole source is compiled. The cache is updated.
+*
+* @param[in] p_source Mapped source text to be compiled.
+* @param[in] p_targetPath Path of the compiled file, the cache is stored next to it.
+* @param[in] jobs Worker threads, 0: one for each processor.
+* @param[out] p_stats The performed work.
+*
+* @return MEMORY ALLOCATION: The compiled program, NULL on error.
+*/
+program_t *CompileIncremental (const sourceText_t * const p_source, const char * const p_targetPath,
+                               const int jobs, cacheStats_t * const p_stats);
+
+/*!
+* @brief Compiles the source with the help of the resident state of its previous compilation:
+*           only the changed rows are lexed and rendered. The state is updated to the new
+*           compilation, the compiled code is stored in the state.
+*
+* @param[in] p_source Mapped source text to be compiled.
+* @param[in,out] p_state The resident state, empty before the first compilation.
+* @param[in] jobs Worker threads, 0: one for each processor.
+* @param[out] p_stats The performed work.
+*
+* @return MEMORY ALLOCATION: The compiled program, NULL on error (the state is kept).
+*/
+program_t *RecompileState (const sourceText_t * const p_source, compileState_t * const p_state,
+                           const int jobs, cacheStats_t * const p_stats);
+
+/*!
+* @brief Clean up of the resident state.
+*
+* @param[in] p_state The state to be cleaned.
+*
+* @return void
+*/
+void CleanupState (compileState_t * const p_state);
+
+#endif // CACHE_H
+
+/*** EOF ***/
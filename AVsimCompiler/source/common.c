@@ -22,10 +22,23 @@ char *ToUpperCase (char * const p_source, char * const p_target)
         p_target[i] = (char) toupper((int) p_source[i]);
         i++;
     }
-    p_target[i] ='\0';
-
-    return p_target;
-}
+    p_target[i] ='\0';
+
+    return p_target;
+}
+
+char *RemoveExtension (char * const p_path)
+{
+    char * const p_extension = strrchr(p_path, '.');
+
+    // The dot must belong to the file name, not to a folder
+    if ((p_extension != NULL) && (strpbrk(p_extension, "/\\") == NULL))
+    {
+        *p_extension = '\0';
+    }
+
+    return p_path;
+}
 
 
 /*** EOF ***/
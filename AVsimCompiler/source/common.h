@@ -7,7 +7,8 @@
 #ifndef COMMON_H
 #define COMMON_H
 
-#include <ctype.h>
+#include <ctype.h>
+#include <string.h>
 
 // === Type Definitions ===
 //
@@ -31,7 +32,16 @@
 *
 * @return Returns with p_target pointer.
 */
-char *ToUpperCase (char * const p_source, char * const p_target);
+char *ToUpperCase (char * const p_source, char * const p_target);
+
+/*!
+* @brief Removes the extension of the file name from the path if exists: ".*"
+*
+* @param[in,out] p_path Path to be truncated.
+*
+* @return Returns with p_path pointer.
+*/
+char *RemoveExtension (char * const p_path);
 
 
 #endif /* COMMON_H */
@@ -4,453 +4,625 @@
 *
 */
 
-#include "compile.h"
-
-// === Protected Functions ===
-//
+#include "compile.h"
 
+#include <ctype.h>
+
+// === Type Definitions ===
 //
-/*!
-* @brief Returns with TRUE, if the input character is alphanumeric
-*
-* @param[in] source The input character.
-*
-* @return True, if alphanumeric.
-*/
-static bool IsAlpha (const char source)
+typedef struct compileContext
 {
-    bool b_ret = true;
-    if ((source >= '0') && (source <= '9'))
-    {
-        // Valid
-    }
-    else if ((source >= 'A') && (source <= 'Z'))
-    {
-        // Valid
-    }
-    else if ((source >= 'a') && (source <= 'z'))
-    {
-        // Valid
-    }
-    else
-    {
-        b_ret = false;
-    }
+    program_t *p_program;
+    int first;              // Rows [first, last) are compiled, the others are kept
+    int last;
+    diagList_t *p_chunkErrors;  // Errors of each chunk
+} compileContext_t;
 
-    return b_ret;
-}
+// === Protected Functions ===
+//
 
 /*!
-* @brief Splits the source string to the instruction parameters such as:
-*           operating code, address, data and comment.
+* @brief Resolves the case folded operating code key.
 *
-* @param[in] p_source Raw data instruction string.
-* @param[out] p_instruction The splitted instruction result.
+* @param[in] key Operating code key of the lexer.
+* @param[out] p_value Operating code value in case of validity.
 *
-* @return Returns with true in case of success.
+* @return Returns with the IsValid value of the operating code.
 */
-static bool SplitInstruction (const char * const p_source, instruction_t * const p_instruction)
+static bool ValidateOpCode (const uint64_t key, uint8_t * const p_value)
 {
-    enum stateFSM
+    switch (key)
     {
-        st_OpCode,
-        st_Address,
-        st_Data,
-        st_Comment
-    };
-
-    char buffer[TEXT_BUFFER_LIMIT + 1] = {'\0'};
-    enum stateFSM state = st_OpCode;
-    bool b_readInstr = false;
-    bool b_nextState = false;
-    bool b_isComment = false;
-
-    int i = 0;
-    int j = 0;
-    bool alpha;
-    while (p_source[i])
-    {
-        // Splitting the opcode, address and data
-        //  handle comments different type via delimiter
-        if (state != st_Comment)
-        {
-            if ( (alpha = IsAlpha(p_source[i])) )
-            {
-                buffer[j] = p_source[i];
-                b_readInstr = true;
-                j++;
-            }
-            else if (b_readInstr)
-            {
-                b_readInstr = false;
-                b_nextState = true;
-                buffer[j] = '\0';
-                j = 0;
-            }
-            else if (INPUT_COMMENT == p_source[i])  // Just comment field is detected
-            {
-                p_instruction->b_justComment = true;
-                state = st_Comment;
-            }
-            else
-            {
-                // Skipping the input delimiters
-            }
-
-        }
-
-        // FSM for instruction splitting
-        switch (state)
-        {
-            case st_OpCode:
-                if (b_nextState)
-                {
-                    strcpy(p_instruction->opCode, buffer);
-                    state = st_Address;
-                    p_instruction->b_justComment = false;
-                    b_nextState = false;
-                }
-            break;
-            case st_Address:
-                if (b_nextState)
-                {
-                    strcpy(p_instruction->address, buffer);
-                    state = st_Data;
-                    b_nextState = false;
-                }
-            break;
-            case st_Data:
-                if (b_nextState)
-                {
-                    strcpy(p_instruction->data, buffer);
-                    state = st_Comment;
-                    b_nextState = false;
-                }
-            break;
-            case st_Comment:
-                if (p_source[i] == INPUT_COMMENT)
-                {
-                    b_isComment = true;
-                    break;
-                }
-                if (b_isComment)
-                {
-                    buffer[j] = p_source[i];
-                    j++;
-                    if (buffer[j] == '\0')
-                    {
-                        strcpy(p_instruction->comment, buffer);
-                    }
-                }
-            break;
-            default:
-            break;
-        }
-
-        i++;
-    }
-
-    // No comment is detected
-    if (!b_isComment)
-    {
-        strcpy(p_instruction->data, buffer);
-        strcpy(p_instruction->comment, "\0");
+        case KEY3('N', 'O', 'P'):
+            *p_value = nop;
+        break;
+        case KEY4('R', 'E', 'A', 'D'):
+            *p_value = read;
+        break;
+        case KEY5('W', 'R', 'I', 'T', 'E'):
+            *p_value = write;
+        break;
+        case KEY4('W', 'A', 'I', 'T'):
+            *p_value = wait;
+        break;
+        case KEY4('L', 'O', 'A', 'D'):
+            *p_value = load;
+        break;
+        case KEY6('R', 'E', 'P', 'E', 'A', 'T'):
+            *p_value = loop;
+        break;
+        case KEY3('E', 'N', 'D'):
+            *p_value = loopEnd;
+        break;
+        case KEY9('B', 'U', 'R', 'S', 'T', 'R', 'E', 'A', 'D'):
+            *p_value = burstRead;
+        break;
+        case KEY10('B', 'U', 'R', 'S', 'T', 'W', 'R', 'I', 'T', 'E'):
+            *p_value = burstWrite;
+        break;
+        case KEY4('B', 'E', 'A', 'T'):
+            *p_value = beat;
+        break;
+        default:
+            return false;
     }
 
-    return (state >= st_Data) ? true : false;
+    return true;
 }
 
 /*!
-* @brief Converts the program counter integer to the proper string comment format.
+* @brief Checks the iteration count of the repeat block and the length of the bursts.
 *
-* @param[out] p_pcReg Program counter output string.
-* @param[in] p_instruction Instruction input for validity checking:
-*               comments out the whole line in case of invalidity.
-* @param[in] n Program counter integer value to be converted.
+* @param[in] opCode The operating code.
+* @param[in] data The data of the instruction.
 *
-* @return void
-*/
-static void SetProgramCounter (char * const p_pcReg, const instruction_t * const p_instruction, int n)
+* @return Returns with false if the repeat or the burst is empty or the burst is too long.
+*/
+static bool ValidateCount (const uint8_t opCode, const uint32_t data)
 {
-    if (n > PC_REG_MAX)
-    {
-        sprintf(p_pcReg, "// > PC_REG_MAX");
-        return;
-    }
-    // Convert input number to string
-    p_pcReg[PC_REG_LSD] = (n % 10) + '0';       // Last significant digit
-    int i = 1;
-    while (n)
-    {
-        n /= (i * 10);
-        p_pcReg[PC_REG_LSD-i] = (n % 10) + '0';
-        i++;
-    }
-
-    // Comment out the Program Counter if invalid instruction is detected
-    if (!p_instruction->b_isValid)
-    {
-        p_pcReg[1] = '/';
-    }
-}
+    const uint32_t burstLength = data & ((UINT32_C(1) << BURST_STEP_BITS) - 1);
 
-/*!
-* @brief Validates the operating code via LUT.
-*
-* @param[in] p_opcode Operating code string in case sensitive format.
-*
-* @return Returns with the IsValid value of the operating code.
-*/
-static bool ValidateOpCode (char * const p_opcode)
-{
-    ToUpperCase(p_opcode, p_opcode);
-
-    for (int i = 0; i < (sizeof(OP_CODES_LUT) / sizeof(OP_CODES_LUT[0])); i++)
-    {
-        if (!strcmp(OP_CODES_LUT[i].p_name, p_opcode))  // Compare input with valid opcodes
-        {
-            return true;
-        }
+    switch (opCode)
+    {
+        case loop:
+            return data != 0;
+        case burstRead:
+            return (data != 0) && (data <= BURST_LIMIT);
+        case burstWrite:
+            return (burstLength != 0) && (burstLength <= BURST_LIMIT);
+        default:
+            return true;
     }
-
-    return false;
-}
+}
 
 /*!
-* @brief Validates the hexadecimal string data.
+* @brief Checks the mode bits of the LOAD address: only the pipelined, the waitrequest
+*           and the fast issue modes are defined, in any combination.
 *
-* @param[in] p_hexa Hexadecimal data string in case sensitive format.
+* @param[in] opCode The operating code.
+* @param[in] address The address of the instruction.
 *
-* @return Returns with IsValid value.
-*/
-static bool ValidateHexa (char * const p_hexa)
+* @return Returns with false if a reserved mode bit is set.
+*/
+static inline bool ValidateLoadMode (const uint8_t opCode, const uint32_t address)
 {
-    ToUpperCase(p_hexa, p_hexa);
-    // 8 Byte hexadecimal size is out of range
-    if (strlen(p_hexa) > strlen(HEX_DATA_PATTERN))
-    {
-        return false;
-    }
-
-    int i = 0;
-    while (p_hexa[i])
-    {
-        if ((p_hexa[i] < '0') || (p_hexa[i] > 'F')) return false;
-        if ((p_hexa[i] > '9') && (p_hexa[i] < 'A')) return false;
-        i++;
-    }
-
-    return true;
+    return (opCode != load) || !(address & LOAD_MODE_RESERVED);
 }
 
 /*!
-* @brief Sets string invalid.
+* @brief Records the error of the field at its column.
 *
-* @param[out] str
+* @param[in] p_line Source row view.
+* @param[in] p_instruction The lexed instruction.
+* @param[in] row Source row from 0.
+* @param[in] field Index of the field.
+* @param[in] reason The reason of the error, reasonNotHexa is refined by the length of the operand.
+* @param[in,out] p_errors The errors of the chunk.
 *
 * @return void
 */
-static inline void SetStrInvalid (char * const str)
+static void AddFieldError (const textLine_t * const p_line, const instruction_t * const p_instruction, const int row,
+                           const int field, diagReason_t reason, diagList_t * const p_errors)
 {
-    str[0] = INVALID;
-    str[1] = '\0';
+    const textLine_t * const p_field = &p_instruction->field[field];
+
+    if ((reason == reasonNotHexa) && (p_field->length > HEX_LIMIT))
+    {
+        reason = reasonTooLong;
+    }
+    AddDiagnostic(p_errors, row, (int) (p_field->p_text - p_line->p_text) + 1, (diagField_t) field, reason);
 }
 
 /*!
 * @brief Validates the instruction parameters such as:
-*           operating code, address, data and comment.
+*           operating code, address and data. The errors are recorded with their reasons.
 *
-* @param[out] p_instruction The valid/invalid instruction result.
+* @param[in] p_line Source row view.
+* @param[in] p_instruction The lexed instruction.
+* @param[out] p_record The valid/invalid instruction record.
+* @param[in] row Source row from 0.
+* @param[in,out] p_errors The errors of the chunk.
 *
 * @return Returns with the IsValid value of the instruction.
 */
-static bool ValidateInstruction (instruction_t * const p_instruction)
+static bool ValidateInstruction (const textLine_t * const p_line, const instruction_t * const p_instruction,
+                                 instrRecord_t * const p_record, const int row, diagList_t * const p_errors)
 {
-    bool b_isValid = true;
-
-    if (!ValidateOpCode(p_instruction->opCode))
+    if (!ValidateOpCode(p_instruction->opCodeKey, &p_record->opCode))
     {
-        SetStrInvalid(p_instruction->opCode);
-        b_isValid = false;
+        p_record->flags |= RECORD_ERR_OPCODE;
+        AddFieldError(p_line, p_instruction, row, FIELD_OPCODE, reasonUnknownOpCode, p_errors);
     }
 
-    if (!ValidateHexa(p_instruction->address))
+    if (p_instruction->b_isHexa[FIELD_ADDRESS] &&
+        ((p_record->flags & RECORD_ERR_OPCODE) || ValidateLoadMode(p_record->opCode, p_instruction->value[FIELD_ADDRESS])))
     {
-        SetStrInvalid(p_instruction->address);
-        b_isValid = false;
+        p_record->address = p_instruction->value[FIELD_ADDRESS];
+    }
+    else
+    {
+        p_record->flags |= RECORD_ERR_ADDRESS;
+        AddFieldError(p_line, p_instruction, row, FIELD_ADDRESS, p_instruction->b_isHexa[FIELD_ADDRESS] ? reasonLoadMode : reasonNotHexa,
+                      p_errors);
     }
 
-    if (!ValidateHexa(p_instruction->data))
+    if (p_instruction->b_isHexa[FIELD_DATA] &&
+        ((p_record->flags & RECORD_ERR_OPCODE) || ValidateCount(p_record->opCode, p_instruction->value[FIELD_DATA])))
+    {
+        p_record->data = p_instruction->value[FIELD_DATA];
+    }
+    else
     {
-        SetStrInvalid(p_instruction->data);
-        b_isValid = false;
+        p_record->flags |= RECORD_ERR_DATA;
+        AddFieldError(p_line, p_instruction, row, FIELD_DATA, !p_instruction->b_isHexa[FIELD_DATA] ? reasonNotHexa :
+                      ((p_record->opCode == loop) ? reasonZeroRepeat : reasonBurstLength), p_errors);
     }
 
-    p_instruction->b_isValid = b_isValid;
+    if (p_record->flags & RECORD_ERROR)
+    {
+        return false;
+    }
+    p_record->flags |= RECORD_VALID;
 
-    return b_isValid;
+    return true;
 }
 
 /*!
-* @brief Formats the valid hexadecimal address / data.
+* @brief Formats the valid address / data depending on the operating code.
 *
-* @param[in] p_instruction Hexadecimal address / data string to be formatted.
+* @param[out] p_record Valid instruction record to be formatted.
 *
 * @return void
-*/
-static void FormatAddressData (instruction_t * const p_instruction)
+*/
+static void FormatAddressData (instrRecord_t * const p_record)
 {
-    bool b_convertAddress = true;
-    bool b_convertData = true;
-    char hexa[] = HEX_DATA_PATTERN;
-    int j;
-    int hexLimit = (int) strlen(hexa);
-
     // Conversion logic depending on look-up table
-    j = (int) p_instruction->opCode[0] - '0';
-    switch (ADDRESS_DATA_LUT[j].type)
+    switch (ADDRESS_DATA_LUT[p_record->opCode].type)
     {
         case zeroAddressData:
-            b_convertAddress = false;
-            b_convertData = false;
+            p_record->address = 0;
+            p_record->data = 0;
         break;
         case zeroAddress:
-            b_convertAddress = false;
+            p_record->address = 0;
         break;
         case zeroData:
-            b_convertData = false;
+            p_record->data = 0;
         break;
         case fullAddressData:
             // NOP
         break;
         case lshdAddress:
-            b_convertAddress = false;
-            int instructionAddressSize = strlen(p_instruction->address);
-            hexa[HEX_LIMIT - 1] = p_instruction->address[instructionAddressSize - 1];
-            if (instructionAddressSize > 1)
-            {
-                hexa[HEX_LIMIT - 2] = p_instruction->address[instructionAddressSize - 2];
-            }
+            p_record->address &= LOAD_ADDRESS_MASK;
         break;
         default:
             // NOP
         break;
     }
+}
+
+/*!
+* @brief Encodes one source row to the packed instruction record.
+*
+* @param[in] p_line Source row view.
+* @param[out] p_record The encoded record.
+* @param[in] row Source row from 0.
+* @param[in,out] p_errors The errors of the chunk.
+*
+* @return Returns with true, if a valid instruction is compiled.
+*/
+static bool CompileRow (const textLine_t * const p_line, instrRecord_t * const p_record, const int row, diagList_t * const p_errors)
+{
+    instruction_t instruction;
+
+    memset(p_record, 0, sizeof(instrRecord_t));
+    if (!LexInstruction(p_line, &instruction))
+    {
+        // Skip dummy data or simple new line
+        return false;
+    }
+
+    if (instruction.b_hasComment)
+    {
+        p_record->flags |= RECORD_COMMENT;
+        p_record->commentStart = (uint32_t) (instruction.comment.p_text - p_line->p_text);
+        p_record->commentLength = (uint16_t) ((instruction.comment.length > COMMENT_LIMIT) ?
+                                              COMMENT_LIMIT : instruction.comment.length);
+    }
+
+    // Detect if line contains instructions not just comments
+    if (instruction.b_justComment)
+    {
+        return false;
+    }
+    p_record->flags |= RECORD_INSTRUCTION;
 
-    // Address conversion
-    if (b_convertAddress)
+    if (!ValidateInstruction(p_line, &instruction, p_record, row, p_errors))
     {
-        j = 0;
-        for (int i = hexLimit - strlen(p_instruction->address); i < hexLimit; i++)
+        return false;
+    }
+    FormatAddressData(p_record);
+
+    return true;
+}
+
+/*!
+* @brief Compiles the changed rows of one chunk and counts its valid instructions.
+*           The kept invalid rows are compiled again for their errors.
+*
+* @param[in,out] p_context The compile context.
+* @param[in] chunk Index of the chunk.
+*
+* @return void
+*/
+static void CompileChunk (void *p_context, int chunk)
+{
+    const compileContext_t * const p_compile = (const compileContext_t *) p_context;
+    program_t * const p_program = p_compile->p_program;
+    const textLine_t * const p_lines = p_program->p_source->p_lines;
+    const int first = chunk * p_program->chunkRows;
+    const int last = (first + p_program->chunkRows < p_program->rowSize) ? first + p_program->chunkRows : p_program->rowSize;
+
+    diagList_t * const p_errors = &p_compile->p_chunkErrors[chunk];
+    int progCount = 0;
+    for (int i = first; i < last; i++)
+    {
+        const bool b_isChanged = (i >= p_compile->first) && (i < p_compile->last);
+        if (b_isChanged || (p_program->p_records[i].flags & RECORD_ERROR & ~RECORD_ERR_SEQUENCE))
         {
-            hexa[i] = p_instruction->address[j];
-            j++;
+            CompileRow(&p_lines[i], &p_program->p_records[i], i, p_errors);
+        }
+        if (p_program->p_records[i].flags & RECORD_VALID)
+        {
+            progCount++;
         }
     }
-    strcpy(p_instruction->address, hexa);
+    p_program->p_chunkPC[chunk] = progCount;
+}
+
+/*!
+* @brief Invalidates the row of the repeat block or the burst, the error is recorded
+*           at the operating code.
+*
+* @param[in,out] p_program The compiled program.
+* @param[in] row Row of the instruction.
+* @param[in] error RECORD_ERR_NESTING or RECORD_ERR_BURST.
+* @param[in] reason The reason of the error.
+* @param[in,out] p_errors The errors of the sequence check.
+*
+* @return void
+*/
+static void InvalidateRow (program_t * const p_program, const int row, const uint8_t error, const diagReason_t reason,
+                           diagList_t * const p_errors)
+{
+    const textLine_t * const p_line = &p_program->p_source->p_lines[row];
+    int column = 0;
+
+    p_program->p_records[row].flags = (uint16_t) ((p_program->p_records[row].flags & ~RECORD_VALID) | error);
+    p_program->p_chunkPC[row / p_program->chunkRows]--;
 
-    // Data conversion
-    strcpy(hexa, HEX_DATA_PATTERN);
-    if (b_convertData)
+    while ((column < p_line->length) && !isalnum((unsigned char) p_line->p_text[column]))
     {
-        j = 0;
-        for (int i = hexLimit - strlen(p_instruction->data); i < hexLimit; i++)
+        column++;
+    }
+    AddDiagnostic(p_errors, row, column + 1, (error == RECORD_ERR_NESTING) ? diagNesting : diagBurst, reason);
+}
+
+/*!
+* @brief Matches the repeat and end instructions sequentially after the parallel compilation.
+*           Unmatched rows and blocks deeper than LOOP_DEPTH_LIMIT are invalidated.
+*           The sequence errors of the kept rows are cleared first, then checked again.
+*
+* @param[in,out] p_program The compiled program, the chunk instruction counts are corrected.
+* @param[in,out] p_errors The errors of the nesting.
+*
+* @return void
+*/
+static void CheckNesting (program_t * const p_program, diagList_t * const p_errors)
+{
+    int p_openRows[LOOP_DEPTH_LIMIT];
+    int depth = 0;
+
+    for (int i = 0; i < p_program->rowSize; i++)
+    {
+        instrRecord_t * const p_record = &p_program->p_records[i];
+        if (p_record->flags & RECORD_ERR_SEQUENCE)
+        {
+            p_record->flags &= (uint16_t) ~RECORD_ERR_SEQUENCE;
+            if (!(p_record->flags & RECORD_ERROR))
+            {
+                p_record->flags |= RECORD_VALID;
+                p_program->p_chunkPC[i / p_program->chunkRows]++;
+            }
+        }
+        if (!(p_record->flags & RECORD_VALID))
+        {
+            continue;
+        }
+
+        if (p_record->opCode == loop)
+        {
+            if (depth < LOOP_DEPTH_LIMIT)
+            {
+                p_openRows[depth] = i;
+            }
+            else
+            {
+                InvalidateRow(p_program, i, RECORD_ERR_NESTING, reasonTooDeep, p_errors);
+            }
+            depth++;
+        }
+        else if (p_record->opCode == loopEnd)
         {
-            hexa[i] = p_instruction->data[j];
-            j++;
+            if ((depth == 0) || (depth > LOOP_DEPTH_LIMIT))
+            {
+                InvalidateRow(p_program, i, RECORD_ERR_NESTING, (depth == 0) ? reasonUnmatchedEnd : reasonTooDeep, p_errors);
+            }
+            depth = (depth > 0) ? depth - 1 : 0;
         }
     }
-    strcpy(p_instruction->data, hexa);
+
+    // Repeat blocks without end
+    for (int i = 0; (i < depth) && (i < LOOP_DEPTH_LIMIT); i++)
+    {
+        InvalidateRow(p_program, p_openRows[i], RECORD_ERR_NESTING, reasonUnclosedRepeat, p_errors);
+    }
 }
 
 /*!
-* @brief Converts the instruction to the valid format.
+* @brief Matches the burst writes and their beats sequentially after the nesting check.
+*           A burst write is followed by one beat row for each beat,
+*           or by a single beat row of the pattern start if its pattern step is not 0.
+*           Incomplete bursts and the beat rows out of a burst are invalidated.
 *
-* @param[in] p_instruction Valid instruction to be formatted.
+* @param[in,out] p_program The compiled program, the chunk instruction counts are corrected.
+* @param[in,out] p_errors The errors of the bursts.
 *
 * @return void
-*/
-static void CompileInstruction (instruction_t * const p_instruction)
+*/
+static void CheckBursts (program_t * const p_program, diagList_t * const p_errors)
 {
-    // Compile Operating Code
-    char opCode[2] = {'\0'};
+    const instrRecord_t * const p_records = p_program->p_records;
 
-    // Compile the Operating Code
-    for (int i = 0; i < (sizeof(OP_CODES_LUT) / sizeof(OP_CODES_LUT[0])); i++)
+    for (int i = 0; i < p_program->rowSize; i++)
     {
-        if (!strcmp(OP_CODES_LUT[i].p_name, p_instruction->opCode))
+        if (!(p_records[i].flags & RECORD_VALID) || ((p_records[i].opCode != burstWrite) && (p_records[i].opCode != beat)))
+        {
+            continue;
+        }
+        if (p_records[i].opCode == beat)
         {
-            opCode[0] = OP_CODES_LUT[i].value;
-            strcpy(p_instruction->opCode, opCode);
+            InvalidateRow(p_program, i, RECORD_ERR_BURST, reasonStrayBeat, p_errors);
+            continue;
         }
+
+        const uint32_t data = p_records[i].data;
+        const uint32_t beatSize = (data >> BURST_STEP_BITS) ? 1 : (data & ((UINT32_C(1) << BURST_STEP_BITS) - 1));
+        uint32_t beatCount = 0;
+        int row = i + 1;
+        for (; (row < p_program->rowSize) && (beatCount < beatSize); row++)
+        {
+            if (p_records[row].flags & RECORD_VALID)
+            {
+                if (p_records[row].opCode != beat)
+                {
+                    break;
+                }
+                beatCount++;
+            }
+        }
+        if (beatCount < beatSize)
+        {
+            // The found beats are invalidated too, the next instruction is checked again
+            for (int k = i; k < row; k++)
+            {
+                if (p_records[k].flags & RECORD_VALID)
+                {
+                    InvalidateRow(p_program, k, RECORD_ERR_BURST, reasonMissingBeats, p_errors);
+                }
+            }
+        }
+        i = row - 1;
+    }
+}
+
+/*!
+* @brief Compiles the rows [first, last) of the records, the other rows are kept,
+*           then assigns the program counters of the chunks and joins the errors.
+*
+* @param[in] p_source Mapped source text to be compiled.
+* @param[in] p_records Records of the rows, the ownership is taken.
+* @param[in] first First row to be compiled.
+* @param[in] last Row after the last one to be compiled.
+* @param[in] jobs Worker threads, 0: one for each processor.
+*
+* @return MEMORY ALLOCATION: The compiled program, NULL on error.
+*/
+static program_t *CompileRange (const sourceText_t * const p_source, instrRecord_t * const p_records,
+                                const int first, const int last, const int jobs)
+{
+    program_t * const p_program = (program_t *) CountCalloc(1, sizeof(program_t));
+    if (p_program == NULL)
+    {
+        perror("Unable to allocate memory for compilation results.");
+        free(p_records);
+        return NULL;
+    }
+
+    const int rowSize = p_source->param.rowSize;
+    p_program->p_records = p_records;
+    p_program->p_source = p_source;
+    p_program->rowSize = rowSize;
+    p_program->jobs = jobs;
+
+    // A single thread compiles the whole source as one chunk
+    p_program->chunkRows = ((jobs == 1) || (rowSize < CHUNK_ROWS)) ? rowSize : CHUNK_ROWS;
+    if (p_program->chunkRows < 1)
+    {
+        p_program->chunkRows = 1;
+    }
+    p_program->chunkSize = (rowSize + p_program->chunkRows - 1) / p_program->chunkRows;
+    p_program->p_chunkPC = (int *) CountMalloc((p_program->chunkSize + 1) * sizeof(int));
+    diagList_t * const p_chunkErrors = (diagList_t *) CountCalloc((size_t) p_program->chunkSize + 1, sizeof(diagList_t));
+    if ((p_program->p_records == NULL) || (p_program->p_chunkPC == NULL) || (p_chunkErrors == NULL))
+    {
+        perror("Unable to allocate memory for compilation results.");
+        free(p_chunkErrors);
+        CleanupProgram(p_program);
+        return NULL;
+    }
+
+    compileContext_t compile = { p_program, first, last, p_chunkErrors };
+    RunParallel(jobs, p_program->chunkSize, CompileChunk, &compile);
+    EndPhase(p_source->dataSize, (uint64_t) (last - first));
+
+    // The nesting and the burst errors are in row order separately
+    diagList_t checkErrors[2];
+    memset(checkErrors, 0, sizeof(checkErrors));
+    BeginPhase(statsSequence);
+    CheckNesting(p_program, &checkErrors[0]);
+    CheckBursts(p_program, &checkErrors[1]);
+    NumberProgram(p_program);
+    const bool b_isMerged = MergeDiagnostics(p_chunkErrors, p_program->chunkSize, checkErrors, 2, &p_program->diagnostics);
+    EndPhase((uint64_t) rowSize * sizeof(instrRecord_t), (uint64_t) rowSize);
+
+    for (int i = 0; i < p_program->chunkSize; i++)
+    {
+        CleanupDiagnostics(&p_chunkErrors[i]);
+    }
+    CleanupDiagnostics(&checkErrors[0]);
+    CleanupDiagnostics(&checkErrors[1]);
+    free(p_chunkErrors);
+    if (!b_isMerged)
+    {
+        CleanupProgram(p_program);
+        return NULL;
     }
 
-    // Compile Hexadecimal address and data
-    FormatAddressData(p_instruction);
+    return p_program;
 }
-
+
 // === Public API Functions ===
 //
 /*!
-* @brief Compiles the input 1D string array to final Avalon Simulator format.
+* @brief Compiles the source line views to packed instruction records.
+*           The row chunks are compiled independently, the program counters
+*           of the chunks are assigned by the prefix sum of their instruction counts.
 *
-* @param[in] pp_source Raw data as string array to be compiled.
-* @param[in] p_textParam Text parameters: maximum size of row, number of raw.
+* @param[in] p_source Mapped source text to be compiled.
+* @param[in] jobs Worker threads, 0: one for each processor.
 *
-* @return MEMORY ALLOCATION: 1D string array with the fully compiled code.
-*/
-char **CompileCode (char **pp_source, const textSize_t * const p_textParam)
-{
-    char **pp_result = (char **) calloc(p_textParam->rowSize, sizeof(char *));
-    if (pp_result == NULL)
-    {
-        perror("Unable to allocate memory for compilation results.");
-        return NULL;
-    }
+* @return MEMORY ALLOCATION: The compiled program with one record for each source row.
+*/
+program_t *CompileCode (const sourceText_t * const p_source, const int jobs)
+{
+    BeginPhase(statsCompile);
+    const int rowSize = p_source->param.rowSize;
+    instrRecord_t * const p_records = (instrRecord_t *) CountMalloc((rowSize + 1) * sizeof(instrRecord_t));
+
+    return CompileRange(p_source, p_records, 0, rowSize, jobs);
+}
 
-    instruction_t instruction = {false, false, {'\0'}, {'\0'}, {'\0'}, {'\0'}};
-    char converted[TEXT_BUFFER_LIMIT + 1] = {'\0'};
+/*!
+* @brief Compiles the changed rows only, the records of the unchanged rows are reused.
+*
+* @param[in] p_source Mapped source text to be compiled.
+* @param[in] p_records Records of the rows, the unchanged ones are valid. The ownership is taken.
+* @param[in] first First changed row.
+* @param[in] last Row after the last changed one.
+* @param[in] jobs Worker threads, 0: one for each processor.
+*
+* @return MEMORY ALLOCATION: The compiled program with one record for each source row.
+*/
+program_t *RecompileCode (const sourceText_t * const p_source, instrRecord_t * const p_records,
+                          const int first, const int last, const int jobs)
+{
+    BeginPhase(statsCompile);
+
+    return CompileRange(p_source, p_records, first, last, jobs);
+}
+
+/*!
+* @brief Assigns the program counters of the chunks by the exclusive prefix sum of their instruction counts,
+*           then the number of instructions and the width of the program counter.
+*
+* @param[in,out] p_program The compiled program, p_chunkPC holds the instruction count of each chunk.
+*
+* @return void
+*/
+void NumberProgram (program_t * const p_program)
+{
     int progCount = 0;
-    char pcReg[] = PC_REG_PATTERN;
-
-    for (int i = 0; i < p_textParam->rowSize; i++)
-    {
-        if (SplitInstruction(pp_source[i], &instruction))
-        {
-            if (!instruction.b_justComment) // Detect if line contains instructions not just comments
-            {
-                if (ValidateInstruction(&instruction))
-                {
-                    CompileInstruction(&instruction);
-                }
 
-                strcpy(pcReg, PC_REG_PATTERN);
-                SetProgramCounter(pcReg, &instruction, progCount);
-                sprintf(converted, "%s%s%c%s%c%s%c%s%s", pcReg, instruction.opCode,OUTPUT_DELIM,
-                    instruction.address, OUTPUT_DELIM, instruction.data, ' ', OUTPUT_COMMENT, instruction.comment);
+    for (int i = 0; i < p_program->chunkSize; i++)
+    {
+        const int chunkCount = p_program->p_chunkPC[i];
+        p_program->p_chunkPC[i] = progCount;
+        progCount += chunkCount;
+    }
+    p_program->p_chunkPC[p_program->chunkSize] = progCount;
+    p_program->progCount = progCount;
 
-                if (instruction.b_isValid)
-                {
-                    progCount++;
-                }
-            }
-            else
-            {
-                sprintf(converted, "%s%s", OUTPUT_COMMENT, instruction.comment);
-            }
-        }
-        else
-        {
-            // Skip dummy data or simple new line
-            strcpy(converted, "");
-        }
+    // The widest program counter belongs to an invalid row after the last instruction
+    int pcWidth = 1;
+    for (int64_t limit = 10; limit <= progCount; limit *= 10)
+    {
+        pcWidth++;
+    }
+    p_program->pcWidth = (pcWidth < PC_WIDTH_MIN) ? PC_WIDTH_MIN : pcWidth;
+}
 
-        // Memory allocation for each lines
-        pp_result[i] = (char *) calloc(strlen(converted) + 1, sizeof(char));
-        strcpy(pp_result[i], converted);
+/*!
+* @brief Returns with the instruction memory depth needed by the program:
+*           one entry for each instruction and an empty one for the end of simulation.
+*
+* @param[in] progCount Number of valid instructions.
+*
+* @return Address bits of the instruction memory, at least INSTR_DEPTH_BITS.
+*/
+int GetDepthBits (const int progCount)
+{
+    int depthBits = INSTR_DEPTH_BITS;
+
+    while ((depthBits < INSTR_DEPTH_MAX) && (progCount >= (1 << depthBits)))
+    {
+        depthBits++;
     }
-
-    return pp_result;
+
+    return depthBits;
 }
-
+
+void CleanupProgram (program_t * const p_program)
+{
+    if (p_program == NULL)
+    {
+        return;
+    }
+
+    CleanupDiagnostics(&p_program->diagnostics);
+    free(p_program->p_chunkPC);
+    free(p_program->p_records);
+    free(p_program);
+}
+
 /*** EOF ***/
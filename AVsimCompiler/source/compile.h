@@ -12,9 +12,13 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-#include "file_access.h"
+#include "file_access.h"
+#include "lexer.h"
+#include "parallel.h"
 #include "common.h"
+#include "diagnostic.h"
 
 
 // === Constant Definitions ===
@@ -24,40 +28,92 @@
 #define READ                "READ"
 #define WRITE               "WRITE"
 #define WAIT                "WAIT"
-#define OPCODE_LIMIT        5
+#define REPEAT              "REPEAT"
+#define END                 "END"
+#define BURSTREAD           "BURSTREAD"
+#define BURSTWRITE          "BURSTWRITE"
+#define BEAT                "BEAT"
+#define OPCODE_LIMIT        10
 #define HEX_DATA_PATTERN    "00000000"
-#define HEX_LIMIT           8
 #define INVALID             'X'
-#define INPUT_ERROR         '/'
-#define INPUT_COMMENT       ';'
-#define OUTPUT_COMMENT      "//"
+#define INPUT_ERROR         '/'
+#define OUTPUT_COMMENT      "//"
 #define OUTPUT_DELIM        '_'
 #define INSTR_LIMIT         (1 + 2*HEX_LIMIT + 2)                       // 1_8_8 : opcode_address_data
-#define COMMENT_LIMIT       (TEXT_BUFFER_LIMIT - INSTR_LIMIT - 8 - 4)   // 8: PC_REG_PATTERN; 4: OUTPUT_COMMENT
-#define PC_REG_PATTERN      "/*000*/ "
-#define PC_REG_LSD          4
-#define PC_REG_MAX          999
+#define COMMENT_LIMIT       UINT16_MAX                                  // Longer comments are truncated
+#define PC_PREFIX           "/*"                                        // Program counter: /*<decimal>*/
+#define PC_SUFFIX           "*/ "
+#define PC_WIDTH_MIN        3                                           // Minimum number of decimal digits
+#define PC_REMOVED          '-'                                         // Digits of the program counter of a removed row
+#define INSTR_DEPTH_BITS    7                                           // Instruction memory depth of the HDL: 2^INSTR_LIMIT_SIZE
+#define INSTR_DEPTH_MAX     31
+#define INSTR_DEPTH_AUTO    0                                           // Depth is chosen by the program size
+#define CHUNK_ROWS          16384   // Rows of a parallel compilation chunk
+#define LOOP_DEPTH_LIMIT    4       // Nesting depth of the repeat blocks: LOOP_DEPTH of the HDL
+#define LOOP_STEP_BITS      16      // Repeat address: <address step><data step> of each iteration
+#define BURST_COUNT_BITS    8       // BURSTCOUNT_SIZE of the HDL
+#define BURST_LIMIT         (1 << (BURST_COUNT_BITS - 1))   // Maximum burst length of Avalon MM
+#define BURST_STEP_BITS     16      // Burst write data: <pattern step><burst length>
+#define LOAD_ADDRESS_MASK   0xFFFF  // Load address: <mode><setup>
+#define LOAD_MODE_MASK      0xFF00
+#define LOAD_MODE_PIPELINED 0x0100  // Pipelined reads completed by readdatavalid
+#define LOAD_MODE_WAITREQUEST 0x0200    // Transfers held by waitrequest, without AVALON_DELAY
+#define LOAD_MODE_FAST_ISSUE 0x0400     // Next read or write decoded at the end of the transfer
+#define LOAD_MODE_RESERVED  (LOAD_MODE_MASK & ~(LOAD_MODE_PIPELINED | LOAD_MODE_WAITREQUEST | LOAD_MODE_FAST_ISSUE))
+#define PENDING_READ_LIMIT  4       // Outstanding pipelined reads: PENDING_READS of the HDL
+
+// Record flags
+#define RECORD_INSTRUCTION  0x01    // Row contains an instruction
+#define RECORD_COMMENT      0x02    // Row contains a comment
+#define RECORD_VALID        0x04    // Instruction is compiled successfully
+#define RECORD_ERR_BURST    0x08    // Burst write without its beats or beat out of a burst
+#define RECORD_ERR_OPCODE   0x10    // Invalid operating code
+#define RECORD_ERR_ADDRESS  0x20    // Invalid hexadecimal address
+#define RECORD_ERR_DATA     0x40    // Invalid hexadecimal data
+#define RECORD_ERR_NESTING  0x80    // Unmatched or too deep repeat block
+#define RECORD_REMOVED      0x100   // Instruction removed by the peephole optimizer, echoed as a comment
+#define RECORD_ERROR        (RECORD_ERR_OPCODE | RECORD_ERR_ADDRESS | RECORD_ERR_DATA | RECORD_ERR_NESTING | RECORD_ERR_BURST)
+#define RECORD_ERR_SEQUENCE (RECORD_ERR_NESTING | RECORD_ERR_BURST)   // Checked after the parallel compilation
 
 // === Type Definitions ===
 //
-typedef enum
-{
-    nop = '0',
-    read,
-    write,
-    wait,
-    load
+typedef enum
+{
+    nop = 0,
+    read,
+    write,
+    wait,
+    load,
+    loop,                   // repeat: pushes the loop, address: steps, data: number of iterations
+    loopEnd,                // end: jumps back to the first instruction of the loop until the last iteration
+    burstRead,              // burstread: data: burst length
+    burstWrite,             // burstwrite: data: <pattern step><burst length>, followed by the beat rows
+    beat                    // beat: write data of a burst beat, the start of the pattern if its step is not 0
 } opCodeType_t;
 
-typedef struct instruction
+typedef struct instrRecord
+{
+    uint32_t address;
+    uint32_t data;
+    uint32_t commentStart;  // Comment slice of the source row, the row may exceed 64 KiB
+    uint16_t commentLength;
+    uint8_t opCode;
+    uint16_t flags;         // RECORD_*
+} instrRecord_t;
+
+typedef struct program
 {
-    bool b_isValid;
-    bool b_justComment;
-    char opCode[OPCODE_LIMIT + 1];
-    char address[HEX_LIMIT + 1];
-    char data[HEX_LIMIT + 1];
-    char comment[COMMENT_LIMIT + 1];
-} instruction_t;
+    const sourceText_t *p_source;
+    instrRecord_t *p_records;   // One packed record for each source row
+    int rowSize;
+    int progCount;              // Number of valid instructions
+    int pcWidth;                // Decimal digits of the program counter
+    int jobs;                   // Worker threads, 0: one for each processor
+    int chunkRows;              // Rows of a chunk
+    int chunkSize;              // Number of chunks
+    int *p_chunkPC;             // Program counter at the first row of each chunk
+    diagList_t diagnostics;     // Errors of the rows in row order, at most the error limit
+} program_t;
 
 typedef struct opCode
 {
@@ -71,7 +127,7 @@ typedef enum
     zeroAddress,
     zeroData,
     fullAddressData,
-    lshdAddress             // Least significant hexadecimal address
+    lshdAddress             // Least significant hexadecimal address: setup and mode of the load
 } hexType_t;
 
 typedef struct addressDataFormat
@@ -88,7 +144,12 @@ static opCode_t const OP_CODES_LUT[] =
     { "READ", read   },
     { "WRITE", write },
     { "WAIT", wait   },
-    { "LOAD", load   }
+    { "LOAD", load   },
+    { "REPEAT", loop },
+    { "END", loopEnd },
+    { "BURSTREAD", burstRead },
+    { "BURSTWRITE", burstWrite },
+    { "BEAT", beat }
 };
 
 static addressDataFormat_t const ADDRESS_DATA_LUT[] =
@@ -97,7 +158,12 @@ static addressDataFormat_t const ADDRESS_DATA_LUT[] =
     { read, zeroData         },
     { write, fullAddressData },
     { wait, zeroAddress      },
-    { load, lshdAddress      }
+    { load, lshdAddress      },
+    { loop, fullAddressData  },
+    { loopEnd, zeroAddressData },
+    { burstRead, fullAddressData },
+    { burstWrite, fullAddressData },
+    { beat, zeroAddress }
 };
 
 // === Macros ===
@@ -106,7 +172,12 @@ static addressDataFormat_t const ADDRESS_DATA_LUT[] =
 
 // === Public API Functions ===
 //
-char **CompileCode (char **pp_source, const textSize_t * const p_textParam); // MEMORY ALLOCATION
+program_t *CompileCode (const sourceText_t * const p_source, const int jobs);  // MEMORY ALLOCATION
+program_t *RecompileCode (const sourceText_t * const p_source, instrRecord_t * const p_records,
+                          const int first, const int last, const int jobs);     // MEMORY ALLOCATION
+void NumberProgram (program_t * const p_program);
+int GetDepthBits (const int progCount);
+void CleanupProgram (program_t * const p_program);
 
 #endif // COMPILE_H
 
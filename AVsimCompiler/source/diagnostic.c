@@ -0,0 +1,169 @@
+/** @file diagnostic.c
+*
+* @brief Structured diagnostics of the compilation: the row, the column, the field and the reason
+*           of each error, recorded by the validation in row order.
+*
+*/
+
+#include "diagnostic.h"
+#include "stats.h"
+
+// === Type Definitions ===
+//
+typedef struct diagConfig
+{
+    int limit;                  // Errors of a source, DIAG_LIMIT_NONE: each one
+    diagFormat_t format;
+} diagConfig_t;
+
+typedef struct diagCursor
+{
+    const diagList_t *p_list;   // Current list of the stream
+    const diagList_t *p_end;    // After the last list of the stream
+    int index;
+} diagCursor_t;
+
+// === Constant Definitions ===
+//
+// Set once by the options before the compilations
+static diagConfig_t s_config = { DIAG_LIMIT_DEFAULT, diagText };
+
+// === Protected Functions ===
+//
+static inline bool IsBefore (const diagnostic_t * const p_first, const diagnostic_t * const p_second)
+{
+    return (p_first->row < p_second->row) || ((p_first->row == p_second->row) && (p_first->field < p_second->field));
+}
+
+/*!
+* @brief Returns with the next error of the stream, the empty lists are skipped.
+*
+* @param[in,out] p_cursor The stream of the lists.
+*
+* @return The next error, NULL at the end of the stream.
+*/
+static const diagnostic_t *PeekCursor (diagCursor_t * const p_cursor)
+{
+    while ((p_cursor->p_list < p_cursor->p_end) && (p_cursor->index >= p_cursor->p_list->size))
+    {
+        p_cursor->p_list++;
+        p_cursor->index = 0;
+    }
+
+    return (p_cursor->p_list < p_cursor->p_end) ? &p_cursor->p_list->p_items[p_cursor->index] : NULL;
+}
+
+// === Public API Functions ===
+//
+void ConfigureDiagnostics (const int limit, const diagFormat_t format)
+{
+    s_config.limit = (limit < 0) ? DIAG_LIMIT_NONE : limit;
+    s_config.format = format;
+}
+
+int GetDiagnosticLimit (void)
+{
+    return s_config.limit;
+}
+
+diagFormat_t GetDiagnosticFormat (void)
+{
+    return s_config.format;
+}
+
+void AddDiagnostic (diagList_t * const p_list, const int row, const int column, const diagField_t field, const diagReason_t reason)
+{
+    const diagnostic_t item = { row, (uint16_t) ((column > UINT16_MAX) ? UINT16_MAX : column), (uint8_t) field, (uint8_t) reason };
+    const bool b_isFull = (s_config.limit != DIAG_LIMIT_NONE) && (p_list->size >= s_config.limit);
+
+    p_list->total++;
+    if (b_isFull && ((p_list->size == 0) || !IsBefore(&item, &p_list->p_items[p_list->size - 1])))
+    {
+        return;
+    }
+    if (!b_isFull && (p_list->size == p_list->capacity))
+    {
+        const int capacity = (p_list->capacity < DIAG_CAPACITY_MIN) ? DIAG_CAPACITY_MIN : 2 * p_list->capacity;
+        diagnostic_t * const p_items = (diagnostic_t *) CountRealloc(p_list->p_items, (size_t) capacity * sizeof(diagnostic_t));
+        if (p_items == NULL)
+        {
+            return;
+        }
+        p_list->p_items = p_items;
+        p_list->capacity = capacity;
+    }
+
+    // The rows come in order, except the repeat blocks left open at the end of the source.
+    // A full list drops its last error for an earlier one.
+    int position = b_isFull ? p_list->size - 1 : p_list->size++;
+    for (; (position > 0) && IsBefore(&item, &p_list->p_items[position - 1]); position--)
+    {
+        p_list->p_items[position] = p_list->p_items[position - 1];
+    }
+    p_list->p_items[position] = item;
+}
+
+bool MergeDiagnostics (const diagList_t * const p_chunks, const int chunkSize, const diagList_t * const p_checks,
+                       const int checkSize, diagList_t * const p_target)
+{
+    // The chunks follow each other in a single stream, each sequence check has its own one
+    diagCursor_t streams[checkSize + 1];
+    int stored = 0;
+
+    memset(p_target, 0, sizeof(diagList_t));
+    streams[0] = (diagCursor_t) { p_chunks, p_chunks + chunkSize, 0 };
+    for (int i = 0; i < chunkSize; i++)
+    {
+        stored += p_chunks[i].size;
+        p_target->total += p_chunks[i].total;
+    }
+    for (int i = 0; i < checkSize; i++)
+    {
+        streams[i + 1] = (diagCursor_t) { &p_checks[i], &p_checks[i + 1], 0 };
+        stored += p_checks[i].size;
+        p_target->total += p_checks[i].total;
+    }
+    if ((s_config.limit != DIAG_LIMIT_NONE) && (stored > s_config.limit))
+    {
+        stored = s_config.limit;
+    }
+    if (stored == 0)
+    {
+        return true;
+    }
+
+    p_target->p_items = (diagnostic_t *) CountMalloc((size_t) stored * sizeof(diagnostic_t));
+    if (p_target->p_items == NULL)
+    {
+        perror("Unable to allocate memory for the diagnostics.");
+        return false;
+    }
+    p_target->capacity = stored;
+
+    while (p_target->size < stored)
+    {
+        int first = -1;
+        const diagnostic_t *p_first = NULL;
+        for (int i = 0; i <= checkSize; i++)
+        {
+            const diagnostic_t * const p_next = PeekCursor(&streams[i]);
+            if ((p_next != NULL) && ((p_first == NULL) || IsBefore(p_next, p_first)))
+            {
+                first = i;
+                p_first = p_next;
+            }
+        }
+        p_target->p_items[p_target->size++] = *p_first;
+        streams[first].index++;
+    }
+
+    return true;
+}
+
+void CleanupDiagnostics (diagList_t * const p_list)
+{
+    free(p_list->p_items);
+    memset(p_list, 0, sizeof(diagList_t));
+}
+
+/*** EOF ***/
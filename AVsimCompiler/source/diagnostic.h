@@ -0,0 +1,119 @@
+/** @file diagnostic.h
+*
+* @brief Structured diagnostics of the compilation: the row, the column, the field and the reason
+*           of each error, recorded by the validation in row order.
+*
+*/
+
+#ifndef DIAGNOSTIC_H
+#define DIAGNOSTIC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// === Type Definitions ===
+//
+typedef enum
+{
+    diagOpCode = 0,
+    diagAddress,
+    diagData,
+    diagNesting,            // Repeat block of the row
+    diagBurst,              // Burst write and its beats
+    diagFieldLimit
+} diagField_t;
+
+typedef enum
+{
+    reasonUnknownOpCode = 0,
+    reasonNotHexa,          // Operand with a non-hexadecimal character
+    reasonTooLong,          // Operand longer than HEX_LIMIT digits
+    reasonZeroRepeat,       // Repeat block without iteration
+    reasonBurstLength,      // Empty burst or longer than BURST_LIMIT
+    reasonLoadMode,         // LOAD address with a reserved mode bit
+    reasonTooDeep,          // Repeat block deeper than LOOP_DEPTH_LIMIT, or its end
+    reasonUnmatchedEnd,     // End without repeat
+    reasonUnclosedRepeat,   // Repeat without end
+    reasonMissingBeats,     // Burst write followed by too few beat rows, or its beats
+    reasonStrayBeat,        // Beat out of a burst write
+    reasonLimit
+} diagReason_t;
+
+typedef enum
+{
+    diagText = 0,           // "=> ERROR at line ..." rows
+    diagJson                // One JSON object for each error and a summary
+} diagFormat_t;
+
+typedef struct diagnostic
+{
+    int32_t row;            // Source row from 0
+    uint16_t column;        // Column of the field from 1, saturated at UINT16_MAX
+    uint8_t field;          // diagField_t
+    uint8_t reason;         // diagReason_t
+} diagnostic_t;
+
+typedef struct diagList
+{
+    diagnostic_t *p_items;  // In row order
+    int size;               // Stored errors, at most the error limit
+    int capacity;
+    int total;              // Detected errors, the ones above the limit are counted only
+} diagList_t;
+
+// === Constant Definitions ===
+//
+#define DIAG_LIMIT_DEFAULT  100     // Reported errors of a source
+#define DIAG_LIMIT_NONE     0
+#define DIAG_CAPACITY_MIN   16
+
+// === Public API Functions ===
+//
+/*!
+* @brief Sets the error limit of each compiled source and the report format of NotifyInvalid.
+*
+* @param[in] limit Stored and reported errors of a source, DIAG_LIMIT_NONE: each one.
+* @param[in] format diagText or diagJson.
+*
+* @return void
+*/
+void ConfigureDiagnostics (const int limit, const diagFormat_t format);
+int GetDiagnosticLimit (void);
+diagFormat_t GetDiagnosticFormat (void);
+
+/*!
+* @brief Records an error. Called by the chunk workers on their own lists.
+*
+* @param[in,out] p_list The errors of the chunk or the sequence checks.
+* @param[in] row Source row from 0.
+* @param[in] column Column of the field from 1.
+* @param[in] field The invalid field.
+* @param[in] reason The reason of the error.
+*
+* @return void
+*/
+void AddDiagnostic (diagList_t * const p_list, const int row, const int column, const diagField_t field, const diagReason_t reason);
+
+/*!
+* @brief Joins the errors of the chunks and of the sequence checks in row order, limited by the error limit.
+*           Each list is in row order already.
+*
+* @param[in] p_chunks The errors of the chunks.
+* @param[in] chunkSize Number of the chunks.
+* @param[in] p_checks The errors of the sequence checks.
+* @param[in] checkSize Number of the sequence checks.
+* @param[out] p_target The errors of the program.
+*
+* @return Returns with true in case of success.
+*/
+bool MergeDiagnostics (const diagList_t * const p_chunks, const int chunkSize, const diagList_t * const p_checks,
+                       const int checkSize, diagList_t * const p_target);
+
+void CleanupDiagnostics (diagList_t * const p_list);
+
+#endif // DIAGNOSTIC_H
+
+/*** EOF ***/
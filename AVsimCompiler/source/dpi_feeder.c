@@ -0,0 +1,208 @@
+/** @file dpi_feeder.c
+*
+* @brief DPI-C instruction feeder: streams the program to avalon_master as the program counter advances.
+*
+*/
+
+#include "dpi_feeder.h"
+
+// === Global Variables ===
+//
+static instrFeeder_t *p_dpiFeeder = NULL;      // Feeder of the simulator process
+
+// === Protected Functions ===
+//
+/*!
+* @brief Returns with the instruction at the cursor and advances the cursor.
+*
+* @param[in,out] p_feeder The feeder.
+* @param[out] p_instr The instruction.
+*
+* @return Returns with false at the end of the program.
+*/
+static bool NextInstruction (instrFeeder_t * const p_feeder, modelInstr_t * const p_instr)
+{
+    if (p_feeder->p_image != NULL)
+    {
+        const modelImage_t * const p_image = p_feeder->p_image;
+        if ((p_feeder->cursorPC >= p_image->size) || !p_image->p_instr[p_feeder->cursorPC].b_isLoaded)
+        {
+            return false;
+        }
+        *p_instr = p_image->p_instr[p_feeder->cursorPC++];
+        return true;
+    }
+
+    // The invalid rows are commented out of the program like in the emitted image
+    const program_t * const p_program = p_feeder->p_program;
+    while ((p_feeder->row < p_program->rowSize) && !(p_program->p_records[p_feeder->row].flags & RECORD_VALID))
+    {
+        p_feeder->row++;
+    }
+    if (p_feeder->row == p_program->rowSize)
+    {
+        return false;
+    }
+    if ((p_feeder->cursorPC % FEEDER_PREFETCH == 0) && (p_feeder->cursorPC / FEEDER_PREFETCH == p_feeder->markSize))
+    {
+        p_feeder->p_markRows[p_feeder->markSize++] = p_feeder->row;
+    }
+    const instrRecord_t * const p_record = &p_program->p_records[p_feeder->row++];
+    p_instr->opCode = p_record->opCode;
+    p_instr->address = p_record->address;
+    p_instr->data = p_record->data;
+    p_instr->b_isLoaded = true;
+    p_feeder->cursorPC++;
+
+    return true;
+}
+
+/*!
+* @brief Refills the prefetch window from the program counter.
+*           The scan of the source restarts from the nearest marked row before the program counter.
+*
+* @param[in,out] p_feeder The feeder.
+* @param[in] pc First program counter of the window.
+*
+* @return void
+*/
+static void RefillWindow (instrFeeder_t * const p_feeder, const uint32_t pc)
+{
+    modelInstr_t instr;
+    const uint32_t mark = pc / FEEDER_PREFETCH;
+
+    if (p_feeder->p_image != NULL)
+    {
+        p_feeder->cursorPC = pc;
+    }
+    else if ((mark < p_feeder->markSize) && ((pc < p_feeder->cursorPC) || (mark * FEEDER_PREFETCH > p_feeder->cursorPC)))
+    {
+        p_feeder->row = p_feeder->p_markRows[mark];
+        p_feeder->cursorPC = mark * FEEDER_PREFETCH;
+    }
+
+    p_feeder->windowPC = pc;
+    p_feeder->windowSize = 0;
+    while (p_feeder->cursorPC < pc)
+    {
+        if (!NextInstruction(p_feeder, &instr))
+        {
+            return;
+        }
+    }
+    while ((p_feeder->windowSize < FEEDER_PREFETCH) && NextInstruction(p_feeder, &p_feeder->p_window[p_feeder->windowSize]))
+    {
+        p_feeder->windowSize++;
+    }
+}
+
+// === Public API Functions ===
+//
+instrFeeder_t *OpenFeeder (const char * const p_path)
+{
+    const size_t length = strlen(p_path);
+    const size_t extensionLength = sizeof(SOURCE_FILE_EXTENSION) - 1;
+
+    instrFeeder_t * const p_feeder = (instrFeeder_t *) calloc(1, sizeof(instrFeeder_t));
+    if (p_feeder == NULL)
+    {
+        perror("Unable to allocate memory for the instruction feeder.");
+        return NULL;
+    }
+
+    if ((length >= extensionLength) && !strcmp(p_path + length - extensionLength, SOURCE_FILE_EXTENSION))
+    {
+        // Compiled at time zero, there is no image
+        p_feeder->p_source = ReadFile(p_path);
+        p_feeder->p_program = (p_feeder->p_source != NULL) ? CompileCode(p_feeder->p_source, 0) : NULL;
+        if (p_feeder->p_program == NULL)
+        {
+            fprintf(stderr, "=> ERROR in '%s': unable to compile.\n", p_path);
+            CloseFeeder(p_feeder);
+            return NULL;
+        }
+        p_feeder->p_markRows = (int *) malloc(((size_t) p_feeder->p_program->progCount / FEEDER_PREFETCH + 1) * sizeof(int));
+        if (p_feeder->p_markRows == NULL)
+        {
+            perror("Unable to allocate memory for the instruction feeder.");
+            CloseFeeder(p_feeder);
+            return NULL;
+        }
+        NotifyInvalid(p_feeder->p_program);
+    }
+    else
+    {
+        p_feeder->p_image = LoadImage(p_path);
+        if (p_feeder->p_image == NULL)
+        {
+            fprintf(stderr, "No compiled image was detected: '%s'\n", p_path);
+            CloseFeeder(p_feeder);
+            return NULL;
+        }
+    }
+    RefillWindow(p_feeder, 0);
+
+    return p_feeder;
+}
+
+bool FetchFeeder (instrFeeder_t * const p_feeder, const uint32_t pc, modelInstr_t * const p_instr)
+{
+    if (pc - p_feeder->windowPC >= p_feeder->windowSize)
+    {
+        RefillWindow(p_feeder, pc);
+        if (p_feeder->windowSize == 0)
+        {
+            return false;
+        }
+    }
+    *p_instr = p_feeder->p_window[pc - p_feeder->windowPC];
+
+    return true;
+}
+
+void CloseFeeder (instrFeeder_t * const p_feeder)
+{
+    if (p_feeder == NULL)
+    {
+        return;
+    }
+
+    CleanupProgram(p_feeder->p_program);
+    CleanupText(p_feeder->p_source);
+    CleanupImage(p_feeder->p_image);
+    free(p_feeder->p_markRows);
+    free(p_feeder);
+}
+
+// === DPI-C Functions ===
+//
+int avsim_feeder_open (const char *p_path)
+{
+    CloseFeeder(p_dpiFeeder);
+    p_dpiFeeder = OpenFeeder(p_path);
+
+    return (p_dpiFeeder != NULL) ? 0 : -1;
+}
+
+int avsim_feeder_fetch (unsigned int pc, unsigned int *p_opCode, unsigned int *p_address, unsigned int *p_data)
+{
+    modelInstr_t instr;
+
+    if ((p_dpiFeeder == NULL) || !FetchFeeder(p_dpiFeeder, pc, &instr))
+    {
+        return 0;
+    }
+    *p_opCode = instr.opCode;
+    *p_address = instr.address;
+    *p_data = instr.data;
+
+    return 1;
+}
+
+void avsim_feeder_close (void)
+{
+    CloseFeeder(p_dpiFeeder);
+    p_dpiFeeder = NULL;
+}
+
+/*** EOF ***/
@@ -0,0 +1,92 @@
+/** @file dpi_feeder.h
+*
+* @brief DPI-C instruction feeder: streams the program to avalon_master as the program counter advances.
+*
+*/
+
+#ifndef DPI_FEEDER_H
+#define DPI_FEEDER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "file_access.h"
+#include "compile.h"
+#include "notify_invalid.h"
+#include "avalon_model.h"
+
+// === Constant Definitions ===
+//
+#define FEEDER_PREFETCH     256         // Instructions decoded ahead of the program counter
+
+// === Type Definitions ===
+//
+typedef struct instrFeeder
+{
+    // Instruction source: the compiled records of a .av source or a .mem image
+    sourceText_t *p_source;
+    program_t *p_program;
+    modelImage_t *p_image;
+    // Cursor of the next instruction to be prefetched
+    int row;                            // Next record of the source
+    uint32_t cursorPC;
+    // Rows of the source: p_markRows[k] is the record of the program counter k * FEEDER_PREFETCH
+    int *p_markRows;
+    uint32_t markSize;
+    // Prefetch window: p_window[i] is the instruction of windowPC + i
+    modelInstr_t p_window[FEEDER_PREFETCH];
+    uint32_t windowPC;
+    uint32_t windowSize;
+} instrFeeder_t;
+
+// === Public API Functions ===
+//
+/*!
+* @brief Opens the program: a *.av source is compiled in place, any other file is loaded as an image.
+*
+* @param[in] p_path Path of the source or the compiled image.
+*
+* @return MEMORY ALLOCATION: The feeder, NULL on error.
+*/
+instrFeeder_t *OpenFeeder (const char * const p_path);
+
+/*!
+* @brief Returns with the instruction at the program counter, the window is refilled on a miss.
+*
+* @param[in,out] p_feeder The feeder.
+* @param[in] pc Program counter.
+* @param[out] p_instr The instruction.
+*
+* @return Returns with false after the end of the program: the instruction is unknown.
+*/
+bool FetchFeeder (instrFeeder_t * const p_feeder, const uint32_t pc, modelInstr_t * const p_instr);
+
+/*!
+* @brief Clean up of the feeder.
+*
+* @param[in] p_feeder The feeder to be cleaned.
+*
+* @return void
+*/
+void CloseFeeder (instrFeeder_t * const p_feeder);
+
+// === DPI-C Functions ===
+//
+/* import "DPI-C" function int avsim_feeder_open (input string path);
+   Returns with 0 in case of success. */
+int avsim_feeder_open (const char *p_path);
+
+/* import "DPI-C" function int avsim_feeder_fetch (input int unsigned pc, output int unsigned opCode,
+                                                   output int unsigned address, output int unsigned data);
+   Returns with 0 after the end of the program. */
+int avsim_feeder_fetch (unsigned int pc, unsigned int *p_opCode, unsigned int *p_address, unsigned int *p_data);
+
+// import "DPI-C" function void avsim_feeder_close ();
+void avsim_feeder_close (void);
+
+#endif // DPI_FEEDER_H
+
+/*** EOF ***/
@@ -0,0 +1,298 @@
+/** @file emit.c
+*
+* @brief Renders the compiled instruction records to Avalon Simulator text format.
+*
+*/
+
+#include "emit.h"
+
+// === Type Definitions ===
+//
+typedef struct emitContext
+{
+    const program_t *p_program;
+    textBuffer_t *p_output;
+    size_t *p_chunkSize;        // Rendered size of each chunk
+} emitContext_t;
+
+// === Protected Functions ===
+//
+/*!
+* @brief Writes the zero padded decimal value, two digits at a time.
+*
+* @param[out] p_target Output position.
+* @param[in] value Value to be converted.
+* @param[in] width Number of digits, at least the digits of the value.
+*
+* @return The position after the number.
+*/
+static char *EmitDecimal (char * const p_target, uint32_t value, const int width)
+{
+    char *p_digit = p_target + width;
+
+    while (value >= 100)
+    {
+        p_digit -= 2;
+        memcpy(p_digit, &DIGIT_PAIRS[(value % 100) * 2], 2);
+        value /= 100;
+    }
+    if (value >= 10)
+    {
+        p_digit -= 2;
+        memcpy(p_digit, &DIGIT_PAIRS[value * 2], 2);
+    }
+    else
+    {
+        *--p_digit = (char) ('0' + value);
+    }
+    while (p_digit > p_target)
+    {
+        *--p_digit = '0';
+    }
+
+    return p_target + width;
+}
+
+/*!
+* @brief Writes the program counter in the proper comment format.
+*
+* @param[out] p_target Output position.
+* @param[in] flags Record flags: the whole line is commented out if the instruction is invalid or removed.
+* @param[in] n Program counter integer value to be converted.
+* @param[in] width Decimal digits of the program counter.
+*
+* @return The position after the program counter.
+*/
+static char *EmitProgramCounter (char *p_target, const uint16_t flags, const int n, const int width)
+{
+    memcpy(p_target, PC_PREFIX, sizeof(PC_PREFIX) - 1);
+
+    // Comment out the Program Counter if invalid instruction is detected
+    if (!(flags & RECORD_VALID))
+    {
+        p_target[1] = INPUT_ERROR;
+    }
+
+    // The removed instruction has no program counter
+    if (flags & RECORD_REMOVED)
+    {
+        memset(p_target + sizeof(PC_PREFIX) - 1, PC_REMOVED, (size_t) width);
+        p_target += sizeof(PC_PREFIX) - 1 + width;
+    }
+    else
+    {
+        p_target = EmitDecimal(p_target + sizeof(PC_PREFIX) - 1, (uint32_t) n, width);
+    }
+    memcpy(p_target, PC_SUFFIX, sizeof(PC_SUFFIX) - 1);
+
+    return p_target + sizeof(PC_SUFFIX) - 1;
+}
+
+/*!
+* @brief Writes the invalid field in uppercase format or the INVALID mark.
+*
+* @param[out] p_target Output position.
+* @param[in] p_field Source view of the field.
+* @param[in] b_isInvalid The field is marked as INVALID.
+*
+* @return The position after the field.
+*/
+static char *EmitField (char *p_target, const textLine_t * const p_field, const bool b_isInvalid)
+{
+    if (b_isInvalid)
+    {
+        *p_target++ = INVALID;
+        return p_target;
+    }
+
+    for (int i = 0; i < p_field->length; i++)
+    {
+        *p_target++ = (char) toupper((int) p_field->p_text[i]);
+    }
+
+    return p_target;
+}
+
+/*!
+* @brief Writes the instruction fields of the row.
+*
+* @param[out] p_target Output position.
+* @param[in] p_record The compiled record of the row.
+* @param[in] p_line Source view of the row, used for the invalid fields.
+*
+* @return The position after the instruction.
+*/
+static char *EmitInstruction (char *p_target, const instrRecord_t * const p_record, const textLine_t * const p_line)
+{
+    if (p_record->flags & (RECORD_VALID | RECORD_REMOVED))
+    {
+        *p_target++ = HEX_DIGITS[p_record->opCode];
+        *p_target++ = OUTPUT_DELIM;
+        p_target = EmitHexa(p_target, p_record->address);
+        *p_target++ = OUTPUT_DELIM;
+        return EmitHexa(p_target, p_record->data);
+    }
+
+    // Invalid rows are echoed as the source fields
+    instruction_t instruction;
+    LexInstruction(p_line, &instruction);
+    p_target = EmitField(p_target, &instruction.field[FIELD_OPCODE], p_record->flags & (RECORD_ERR_OPCODE | RECORD_ERR_SEQUENCE));
+    *p_target++ = OUTPUT_DELIM;
+    p_target = EmitField(p_target, &instruction.field[FIELD_ADDRESS], p_record->flags & RECORD_ERR_ADDRESS);
+    *p_target++ = OUTPUT_DELIM;
+
+    return EmitField(p_target, &instruction.field[FIELD_DATA], p_record->flags & RECORD_ERR_DATA);
+}
+
+/*!
+* @brief Renders the rows [first, last) of the program.
+*
+* @param[out] p_target Output position.
+* @param[in] p_program The compiled program.
+* @param[in] first First row to be rendered.
+* @param[in] last Row after the last one to be rendered.
+* @param[in] progCount Program counter of the first row.
+*
+* @return The position after the rendered rows.
+*/
+static char *EmitRows (char *p_target, const program_t * const p_program, const int first, const int last, int progCount)
+{
+    const sourceText_t * const p_source = p_program->p_source;
+
+    for (int i = first; i < last; i++)
+    {
+        const instrRecord_t * const p_record = &p_program->p_records[i];
+        const textLine_t * const p_line = &p_source->p_lines[i];
+
+        if (p_record->flags & (RECORD_INSTRUCTION | RECORD_REMOVED))
+        {
+            p_target = EmitProgramCounter(p_target, p_record->flags, progCount, p_program->pcWidth);
+            p_target = EmitInstruction(p_target, p_record, p_line);
+            *p_target++ = ' ';
+            if (p_record->flags & RECORD_VALID)
+            {
+                progCount++;
+            }
+        }
+
+        if (p_record->flags & (RECORD_INSTRUCTION | RECORD_COMMENT | RECORD_REMOVED))
+        {
+            memcpy(p_target, OUTPUT_COMMENT, sizeof(OUTPUT_COMMENT) - 1);
+            p_target += sizeof(OUTPUT_COMMENT) - 1;
+            memcpy(p_target, p_line->p_text + p_record->commentStart, p_record->commentLength);
+            p_target += p_record->commentLength;
+        }
+
+        *p_target++ = EOL_CHAR;
+    }
+
+    return p_target;
+}
+
+/*!
+* @brief Returns with the output offset reserved for the first row of the chunk:
+*           the source offset of the row and the generated overhead of the previous rows.
+*
+* @param[in] p_program The compiled program.
+* @param[in] chunk Index of the chunk.
+*
+* @return Offset in the output buffer.
+*/
+static size_t GetChunkOffset (const program_t * const p_program, const int chunk)
+{
+    const sourceText_t * const p_source = p_program->p_source;
+    const int first = chunk * p_program->chunkRows;
+
+    if (first >= p_program->rowSize)
+    {
+        return p_source->dataSize + (size_t) p_program->rowSize * EMIT_ROW_OVERHEAD;
+    }
+
+    return (size_t) (p_source->p_lines[first].p_text - p_source->p_data) + (size_t) first * EMIT_ROW_OVERHEAD;
+}
+
+/*!
+* @brief Renders the rows of one chunk to its reserved output region.
+*
+* @param[in,out] p_context The emit context.
+* @param[in] chunk Index of the chunk.
+*
+* @return void
+*/
+static void EmitChunk (void *p_context, int chunk)
+{
+    emitContext_t * const p_emit = (emitContext_t *) p_context;
+    const program_t * const p_program = p_emit->p_program;
+    const int first = chunk * p_program->chunkRows;
+    const int last = (first + p_program->chunkRows < p_program->rowSize) ? first + p_program->chunkRows : p_program->rowSize;
+
+    char * const p_start = p_emit->p_output->p_data + GetChunkOffset(p_program, chunk);
+    char * const p_end = EmitRows(p_start, p_program, first, last, p_program->p_chunkPC[chunk]);
+    p_emit->p_chunkSize[chunk] = (size_t) (p_end - p_start);
+}
+
+// === Public API Functions ===
+//
+bool EmitCode (const program_t * const p_program, textBuffer_t * const p_output)
+{
+    const sourceText_t * const p_source = p_program->p_source;
+    emitContext_t emit = { p_program, p_output, NULL };
+
+    // Every row fits to its source size and the generated overhead
+    p_output->capacity = p_source->dataSize + (size_t) p_program->rowSize * EMIT_ROW_OVERHEAD;
+    p_output->p_data = (char *) CountMalloc(p_output->capacity);
+    p_output->size = 0;
+    emit.p_chunkSize = (size_t *) CountMalloc((p_program->chunkSize + 1) * sizeof(size_t));
+    if ((p_output->p_data == NULL) || (emit.p_chunkSize == NULL))
+    {
+        perror("Unable to allocate memory for the compiled code.");
+        free(emit.p_chunkSize);
+        CleanupBuffer(p_output);
+        return false;
+    }
+
+    RunParallel(p_program->jobs, p_program->chunkSize, EmitChunk, &emit);
+
+    // Join the rendered chunks in order, the regions never overlap backward
+    for (int i = 0; i < p_program->chunkSize; i++)
+    {
+        memmove(p_output->p_data + p_output->size, p_output->p_data + GetChunkOffset(p_program, i), emit.p_chunkSize[i]);
+        p_output->size += emit.p_chunkSize[i];
+    }
+    free(emit.p_chunkSize);
+
+    return true;
+}
+
+bool EmitRange (const program_t * const p_program, const int first, const int last, textBuffer_t * const p_output)
+{
+    const sourceText_t * const p_source = p_program->p_source;
+    const size_t start = (first < p_program->rowSize) ? (size_t) (p_source->p_lines[first].p_text - p_source->p_data) : p_source->dataSize;
+    const size_t end = (last < p_program->rowSize) ? (size_t) (p_source->p_lines[last].p_text - p_source->p_data) : p_source->dataSize;
+
+    p_output->capacity = end - start + (size_t) (last - first) * EMIT_ROW_OVERHEAD + 1;
+    p_output->p_data = (char *) CountMalloc(p_output->capacity);
+    p_output->size = 0;
+    if (p_output->p_data == NULL)
+    {
+        perror("Unable to allocate memory for the compiled code.");
+        return false;
+    }
+
+    // Program counter of the first row: the base of its chunk and the valid rows before it
+    const int chunkFirst = (first / p_program->chunkRows) * p_program->chunkRows;
+    int progCount = p_program->p_chunkPC[first / p_program->chunkRows];
+    for (int i = chunkFirst; i < first; i++)
+    {
+        if (p_program->p_records[i].flags & RECORD_VALID)
+        {
+            progCount++;
+        }
+    }
+
+    p_output->size = (size_t) (EmitRows(p_output->p_data, p_program, first, last, progCount) - p_output->p_data);
+
+    return true;
+}
+
+/*** EOF ***/
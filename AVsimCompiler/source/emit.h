@@ -0,0 +1,68 @@
+/** @file emit.h
+*
+* @brief Renders the compiled instruction records to Avalon Simulator text format.
+*
+*/
+
+#ifndef EMIT_H
+#define EMIT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "file_access.h"
+#include "compile.h"
+#include "hex_convert.h"
+
+// === Type Definitions ===
+//
+
+
+// === Constant Definitions ===
+//
+#define EMIT_ROW_OVERHEAD   48      // Upper limit of the generated characters beside the source text of a row
+#define HEX_DIGITS          "0123456789ABCDEF"
+#define DIGIT_PAIRS         "00010203040506070809" \
+                            "10111213141516171819" \
+                            "20212223242526272829" \
+                            "30313233343536373839" \
+                            "40414243444546474849" \
+                            "50515253545556575859" \
+                            "60616263646566676869" \
+                            "70717273747576777879" \
+                            "80818283848586878889" \
+                            "90919293949596979899"
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*!
+* @brief Renders every record of the compiled program to the output text buffer.
+*           The chunks are rendered in parallel by the workers of the compilation.
+*
+* @param[in] p_program The compiled program.
+* @param[out] p_output Rendered text, each row is terminated by EOL_CHAR.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool EmitCode (const program_t * const p_program, textBuffer_t * const p_output);
+
+/*!
+* @brief Renders the rows [first, last) of the compiled program to the output text buffer.
+*
+* @param[in] p_program The compiled program.
+* @param[in] first First row to be rendered.
+* @param[in] last Row after the last one to be rendered.
+* @param[out] p_output Rendered text, each row is terminated by EOL_CHAR.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool EmitRange (const program_t * const p_program, const int first, const int last, textBuffer_t * const p_output);
+
+#endif // EMIT_H
+
+/*** EOF ***/
@@ -6,123 +6,322 @@
 
 #include "file_access.h"
 
+#ifdef _WIN32
+# include <windows.h>
+# include <io.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif // _WIN32
+
+// === Constant Definitions ===
+//
+static const char EMPTY_TEXT[] = "";   // View of the empty files, they are not mapped
+
 // === Protected Functions ===
-//
+//
 /*
-** @brief Calculates the maximum rowLength and rows in a text file.
+** @brief Maps the whole file read-only to the memory. An empty file is not mapped,
+*           its view is empty.
 *
 * @param[in] p_path The path of the text file.
-* @param[out] p_textParam Text size parameters: bufferSize, rowSize.
+* @param[out] p_source The data view (and the mapping handle on Windows) to be set.
+*
+* @return Returns with true in case of success.
+*/
+static bool MapFile (const char * const p_path, sourceText_t * const p_source)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(p_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    if (fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        p_source->p_data = EMPTY_TEXT;
+        p_source->dataSize = 0;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+    {
+        return false;
+    }
+
+    p_source->p_data = (const char *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (p_source->p_data == NULL)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    p_source->p_mapHandle = mapping;
+    p_source->dataSize = (size_t) fileSize.QuadPart;
+#else
+    const int file = open(p_path, O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(file, &fileStat) < 0)
+    {
+        close(file);
+        return false;
+    }
+    if (fileStat.st_size == 0)
+    {
+        close(file);
+        p_source->p_data = EMPTY_TEXT;
+        p_source->dataSize = 0;
+        return true;
+    }
+
+    void * const p_map = mmap(NULL, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (p_map == MAP_FAILED)
+    {
+        return false;
+    }
+    madvise(p_map, (size_t) fileStat.st_size, MADV_SEQUENTIAL);
+
+    p_source->p_data = (const char *) p_map;
+    p_source->dataSize = (size_t) fileStat.st_size;
+#endif // _WIN32
+
+    return true;
+}
+
+/*
+** @brief Releases the file mapping.
+*
+* @param[in] p_source The mapped source text.
 *
 * @return void
-*/
-static void GetTextParam (char const * const p_path, textSize_t * const p_textParam)
+*/
+static void UnmapFile (sourceText_t * const p_source)
 {
-    p_textParam->bufferSize = 0;
-    p_textParam->rowSize = 0;
-    FILE * const p_file = fopen(p_path, "r");
-
-    if (p_file == NULL)
+    if ((p_source->p_data == NULL) || (p_source->p_data == EMPTY_TEXT))
     {
-        fprintf(stderr, "Unable to open file: %s.\n", p_path);
-        return;
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(p_source->p_data);
+    CloseHandle(p_source->p_mapHandle);
+#else
+    munmap((void *) p_source->p_data, p_source->dataSize);
+#endif // _WIN32
+    p_source->p_data = NULL;
+}
+
+/*
+** @brief Builds the line index and calculates the maximum rowLength in one pass.
+*
+* @param[out] p_source Mapped source text: p_lines and param are set.
+*
+* @return Returns with true in case of success.
+*/
+static bool IndexLines (sourceText_t * const p_source)
+{
+    size_t capacity = p_source->dataSize / LINE_AVERAGE_SIZE + LINE_INDEX_MIN;
+    textLine_t *p_lines = (textLine_t *) CountMalloc(capacity * sizeof(textLine_t));
+    if (p_lines == NULL)
+    {
+        return false;
     }
 
-    int currRowLenght;
-    char textBuffer[TEXT_BUFFER_LIMIT + 2];     // + '\n' + '\0'
-    while ( NULL != fgets (textBuffer, TEXT_BUFFER_LIMIT + 2, p_file))
+    const char *p_curr = p_source->p_data;
+    const char * const p_end = p_source->p_data + p_source->dataSize;
+    size_t rows = 0;
+    int bufferSize = 0;
+
+    while (p_curr < p_end)
     {
-        p_textParam->rowSize++;
-        currRowLenght = strlen(textBuffer);
-        if (currRowLenght > p_textParam->bufferSize)
+        // Search the end of the row, the last row might not be terminated
+        const char *p_eol = (const char *) memchr(p_curr, EOL_CHAR, (size_t) (p_end - p_curr));
+        const char * const p_next = (p_eol == NULL) ? p_end : p_eol + 1;
+        if (p_eol == NULL)
+        {
+            p_eol = p_end;
+        }
+        // Remove the carriage return of Windows style line endings
+        if ((p_eol > p_curr) && (p_eol[-1] == CR_CHAR))
         {
-            p_textParam->bufferSize = currRowLenght;
-        }
+            p_eol--;
+        }
+
+        if (rows == capacity)
+        {
+            capacity *= 2;
+            textLine_t * const p_grown = (textLine_t *) CountRealloc(p_lines, capacity * sizeof(textLine_t));
+            if (p_grown == NULL)
+            {
+                free(p_lines);
+                return false;
+            }
+            p_lines = p_grown;
+        }
+
+        p_lines[rows].p_text = p_curr;
+        p_lines[rows].length = (int) (p_eol - p_curr);
+        if (p_lines[rows].length > bufferSize)
+        {
+            bufferSize = p_lines[rows].length;
+        }
+        rows++;
+        p_curr = p_next;
     }
-
-    fclose(p_file);
+
+    p_source->p_lines = p_lines;
+    p_source->param.rowSize = (int) rows;
+    p_source->param.bufferSize = bufferSize;
+
+    return true;
 }
-
+
+/*
+** @brief Writes the text buffer to the file, an empty buffer is not written.
+*
+* @param[in] p_file The opened file.
+* @param[in] p_text The text buffer.
+*
+* @return Returns with true in case of success.
+*/
+static bool WriteBuffer (FILE * const p_file, const textBuffer_t * const p_text)
+{
+    return (p_text->size == 0) || (fwrite(p_text->p_data, 1, p_text->size, p_file) == p_text->size);
+}
+
+/*
+** @brief Sets the position of the file, beyond 2 GiB too.
+*
+* @param[in] p_file The opened file.
+* @param[in] offset Position from the beginning of the file.
+*
+* @return Returns with true in case of success.
+*/
+static bool SeekFile (FILE * const p_file, const size_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(p_file, (__int64) offset, SEEK_SET) == 0;
+#else
+    return fseeko(p_file, (off_t) offset, SEEK_SET) == 0;
+#endif // _WIN32
+}
+
 // === Public Functions ===
-//
-char ** const ReadFile (const char * const p_path, textSize_t * const p_textParam)
-{
-    FILE * const p_file  = fopen(p_path, "r");
-
-    if (p_file == NULL)
-    {
-        fprintf(stderr, "Unable to open file: %s.\n", p_path);
-        return NULL;
-    }
+//
+sourceText_t *ReadFile (const char * const p_path)
+{
+    sourceText_t * const p_source = (sourceText_t *) CountCalloc(1, sizeof(sourceText_t));
+    if (p_source == NULL)
+    {
+        perror("Unable to allocate reading buffer memory.\n");
+        return NULL;
+    }
+
+    if (!MapFile(p_path, p_source))
+    {
+        fprintf(stderr, "Unable to open file: %s.\n", p_path);
+        free(p_source);
+        return NULL;
+    }
 
-    // Determining the line buffer lenght and the number of rows
-    GetTextParam(p_path, p_textParam);
-    if ((p_textParam->bufferSize == 0) || (p_textParam->rowSize == 0))
+    // Determining the line views, the line buffer lenght and the number of rows
+    if (!IndexLines(p_source))
     {
         fprintf(stderr, "Unable to determine file size parameters: %s.\n", p_path);
-        fclose(p_file);
+        CleanupText(p_source);
         return NULL;
-    }
+    }
 
-    char ** const pp_getText = (char **) calloc(p_textParam->rowSize, sizeof (char *));
-    char textBuffer[p_textParam->bufferSize + 2];
+    return p_source;
+}
 
-    int lastChar;
-    int i = 0;
-    while ((NULL != fgets (textBuffer, p_textParam->bufferSize + 2, p_file)) && (i < p_textParam->rowSize))
-    {
-        pp_getText[i] = (char *) calloc(strlen (textBuffer) + 1, sizeof(char));
-        if (!pp_getText[i])
-        {
-            perror("Unable to allocate reading buffer memory.\n");
-            return NULL;
-        }
-        // Remove the new line characters at the end
-        lastChar = (int) (strlen(textBuffer) - 1);
-        if (textBuffer[lastChar] == '\n')
-        {
-            textBuffer[lastChar] = '\0';
-            // Decrement buffer size if containing new line character
-            if ((lastChar + 1) == p_textParam->bufferSize)
-            {
-                p_textParam->bufferSize--;
-            }
-        }
-        strcpy(pp_getText[i], textBuffer);
-        i++;
-    }
-
-    fclose(p_file);
-
-    return pp_getText;
+bool WriteFile (const char * const p_path, const textBuffer_t * const p_text)
+{
+    FILE * const p_file = fopen(p_path, "wb");
+
+    if (p_file == NULL)
+    {
+        perror("Error at output file opening.\n");
+        return false;
+    }
+
+    const bool b_isWritten = WriteBuffer(p_file, p_text);
+    if (!b_isWritten)
+    {
+        perror("Error at output file writing.\n");
+    }
+
+    return (fclose(p_file) == 0) && b_isWritten;
 }
 
-void WriteFile (const char * const p_path, char **pp_data, const int rows, bool b_addEOL)
-{
-    FILE * const p_file = fopen(p_path, "w");
-
-    if (p_file == NULL)
-    {
-        perror("Error at output file opening.\n");
-        return;
-    }
-
-    int i;
-    for (i = 0; i < rows; i++)
+bool PatchFile (const char * const p_path, const size_t offset, const textBuffer_t * const p_head,
+                       const textBuffer_t * const p_tail, const size_t size)
+{
+    FILE * const p_file = fopen(p_path, "r+b");
+    if (p_file == NULL)
     {
-        if (b_addEOL)
-        {
-            fprintf(p_file, "%s%c", pp_data[i], EOL_CHAR);
-        }
-        else
-        {
-            fprintf(p_file, "%s", pp_data[i]);
-        }
-    }
-
-    fclose(p_file);
+        perror("Error at output file opening.\n");
+        return false;
+    }
+
+    bool b_isWritten = SeekFile(p_file, offset) && WriteBuffer(p_file, p_head) &&
+                       ((p_tail == NULL) || WriteBuffer(p_file, p_tail));
+    b_isWritten = (fflush(p_file) == 0) && b_isWritten;
+#ifdef _WIN32
+    b_isWritten = b_isWritten && (_chsize_s(_fileno(p_file), (__int64) size) == 0);
+#else
+    b_isWritten = b_isWritten && (ftruncate(fileno(p_file), (off_t) size) == 0);
+#endif // _WIN32
+    if (!b_isWritten)
+    {
+        perror("Error at output file writing.\n");
+    }
+
+    return (fclose(p_file) == 0) && b_isWritten;
 }
-
+
+bool WriteFileAtomic (const char * const p_path, const textBuffer_t * const p_text)
+{
+    char tempPath[FILENAME_MAX];
+
+    snprintf(tempPath, sizeof(tempPath), "%s%s", p_path, TEMP_FILE_EXTENSION);
+    if (!WriteFile(tempPath, p_text))
+    {
+        remove(tempPath);
+        return false;
+    }
+
+#ifdef _WIN32
+    const bool b_isRenamed = MoveFileExA(tempPath, p_path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool b_isRenamed = rename(tempPath, p_path) == 0;
+#endif // _WIN32
+    if (!b_isRenamed)
+    {
+        perror("Error at output file renaming.\n");
+        remove(tempPath);
+    }
+
+    return b_isRenamed;
+}
+
 void WriteVerilogDefFile (const char * const p_path, char *p_define, char *p_subfolder, char *p_data, bool b_append)
 {
     char fileAttribute[] = "w";
@@ -140,23 +339,44 @@ void WriteVerilogDefFile (const char * const p_path, char *p_define, char *p_sub
         return;
     }
 
-    fprintf(p_file, "%s\"%s%s\"\n", p_define, p_subfolder, p_data);
-
-    fclose(p_file);
-}
-
-void CleanupText (char **pp_stringArray, int rows)
-{
-    int i;
-    for (i = 0; i < rows; i++)
-    {
-        if (NULL != pp_stringArray[i])
-        {
-            free(pp_stringArray[i]);
-        }
-    }
+    fprintf(p_file, "%s\"%s%s\"\n", p_define, p_subfolder, p_data);
+
+    fclose(p_file);
+}
+
+void WriteVerilogDefValue (const char * const p_path, const char * const p_define, const int value, const bool b_append)
+{
+    FILE * const p_file = fopen(p_path, b_append ? "a" : "w");
+
+    if (p_file == NULL)
+    {
+        perror("Error at output file opening.\n");
+        return;
+    }
+
+    fprintf(p_file, "%s%d\n", p_define, value);
+
+    fclose(p_file);
+}
 
-   free(pp_stringArray);
+void CleanupText (sourceText_t * const p_source)
+{
+    if (p_source == NULL)
+    {
+        return;
+    }
+
+    UnmapFile(p_source);
+    free(p_source->p_lines);
+    free(p_source);
+}
+
+void CleanupBuffer (textBuffer_t * const p_text)
+{
+    free(p_text->p_data);
+    p_text->p_data = NULL;
+    p_text->size = 0;
+    p_text->capacity = 0;
 }
 
 /*** EOF ***/
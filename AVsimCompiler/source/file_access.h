@@ -3,16 +3,18 @@
 * @brief Reading/writing an array of strings from/to a text file.
 *
 */
-
-#ifndef FILE_ACCESS_H
+
+#ifndef FILE_ACCESS_H
 #define FILE_ACCESS_H
 
-#include <stdio.h>
-#include <stddef.h>
-#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 
+#include "stats.h"
+
 // === Type Definitions ===
 //
 typedef struct textSize
@@ -21,10 +23,40 @@ typedef struct textSize
     int rowSize;
 } textSize_t;
 
+typedef struct textLine
+{
+    const char *p_text;     // Points into the mapped file, NOT zero terminated
+    int length;             // Without the end of line characters
+} textLine_t;
+
+typedef struct sourceText
+{
+    const char *p_data;     // Read-only view of the whole file
+    size_t dataSize;
+    textLine_t *p_lines;    // Line index: one entry for each row
+    textSize_t param;       // bufferSize: longest row, rowSize: number of rows
+#ifdef _WIN32
+    void *p_mapHandle;
+#endif // _WIN32
+} sourceText_t;
+
+typedef struct textBuffer
+{
+    char *p_data;           // Rows terminated by EOL_CHAR
+    size_t size;
+    size_t capacity;
+} textBuffer_t;
+
 // === Constant Definitions ===
 //
 #define TEXT_BUFFER_LIMIT   100
 #define EOL_CHAR            '\n'
+#define CR_CHAR             '\r'
+#define LINE_INDEX_MIN      1024    // Initial size of the line index
+#define LINE_AVERAGE_SIZE   32      // Estimated row length for the line index preallocation
+#define SOURCE_FILE_EXTENSION   ".av"
+#define TARGET_FILE_EXTENSION   ".mem"
+#define TEMP_FILE_EXTENSION     ".tmp"
 
 
 // === Macros ===
@@ -34,26 +66,48 @@ typedef struct textSize
 // === Public API Functions ===
 //
 /*
-** @brief Reading each lines to 1D array of strings from a text file.
+** @brief Maps the text file to memory and indexes its lines in a single pass.
 *
 * @param[in] p_path The path of the text file.
-* @param[out] textSize parameters: bufferSize, rowSize.
 *
-* @return MEMORY ALLOCATION -> String array of text lines
-*/
-char ** const ReadFile (const char * const p_path, textSize_t * const p_textParam);           // MEMORY ALLOCATION
+* @return MEMORY ALLOCATION -> Source text with zero-copy line views, NULL on error.
+*/
+sourceText_t *ReadFile (const char * const p_path);                                          // MEMORY ALLOCATION
 
 /*
-** @brief Writing 1D array of strings to a text file.
+** @brief Writing the text buffer to a text file at once.
 *
 * @param[in] p_path The path of the text file.
-* @param[in] pp_data The string array to be written.
-* @param[in] rows The size of the pp_data 1D array.
-* @param[in] b_dEOL Add end of line character (e.g. '\n').
+* @param[in] p_text The text buffer to be written.
 *
-* @return void
-*/
-void WriteFile (const char * const p_path, char **pp_data, const int rows, bool b_addEOL);
+* @return Returns with true in case of success.
+*/
+bool WriteFile (const char * const p_path, const textBuffer_t * const p_text);
+
+/*
+** @brief Rewrites the text file from the offset and sets its final size.
+*
+* @param[in] p_path The path of the text file.
+* @param[in] offset First byte to be rewritten.
+* @param[in] p_head Rendered rows written from the offset.
+* @param[in] p_tail Rendered rows written after p_head, optional.
+* @param[in] size Final size of the file.
+*
+* @return Returns with true in case of success.
+*/
+bool PatchFile (const char * const p_path, const size_t offset, const textBuffer_t * const p_head,
+                const textBuffer_t * const p_tail, const size_t size);
+
+/*
+** @brief Writes the text buffer to a temporary file next to the text file, then renames it:
+*           the readers see either the previous or the new content.
+*
+* @param[in] p_path The path of the text file.
+* @param[in] p_text The text buffer to be written.
+*
+* @return Returns with true in case of success.
+*/
+bool WriteFileAtomic (const char * const p_path, const textBuffer_t * const p_text);
 
 /*
 ** @brief Writes the Verilog Definition File.
@@ -69,15 +123,35 @@ void WriteFile (const char * const p_path, char **pp_data, const int rows, bool
 void WriteVerilogDefFile (const char * const p_path, char *p_define, char *p_subfolder, char *p_data, bool b_append);
 
 /*
-** @brief Clean up of 1D string array memory allocation.
+** @brief Writes a numeric definition to the Verilog Definition File.
+*
+* @param[in] p_path The path of the text file.
+* @param[in] p_define The definition string constant.
+* @param[in] value The definition value.
+* @param[in] b_append Append file at the end.
+*
+* @return void
+*/
+void WriteVerilogDefValue (const char * const p_path, const char * const p_define, const int value, const bool b_append);
+
+/*
+** @brief Unmaps the source file and releases its line index.
+*
+* @param[in] p_source The source text to be cleaned.
+*
+* @return void
+*/
+void CleanupText (sourceText_t * const p_source);
+
+/*
+** @brief Clean up of the text buffer memory allocation.
 *
-* @param[in] pp_stringArray The string array to be cleaned.
-* @param[in] rows The size of the pp_stringArray 1D array.
+* @param[in] p_text The text buffer to be cleaned.
 *
 * @return void
-*/
-void CleanupText (char **pp_stringArray, int rows);
-
-#endif // FILE_ACCESS_H
+*/
+void CleanupBuffer (textBuffer_t * const p_text);
+
+#endif // FILE_ACCESS_H
 
 /*** EOF ***/
@@ -0,0 +1,224 @@
+/** @file file_watch.c
+*
+* @brief Notifies the changes of the files in the watched folders.
+*           inotify is used on Linux, the other systems are polled.
+*
+*/
+
+#include "file_watch.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <errno.h>
+# include <time.h>
+# include <unistd.h>
+# ifdef __linux__
+#  include <poll.h>
+#  include <sys/inotify.h>
+# endif // __linux__
+#endif // _WIN32
+
+// === Protected Functions ===
+//
+/*!
+* @brief Suspends the caller.
+*
+* @param[in] timeout Time in milliseconds.
+*
+* @return void
+*/
+static void SleepMs (const int timeout)
+{
+#ifdef _WIN32
+    Sleep((DWORD) timeout);
+#else
+    struct timespec duration = { timeout / 1000, (long) (timeout % 1000) * 1000000L };
+    nanosleep(&duration, NULL);
+#endif // _WIN32
+}
+
+/*!
+* @brief Takes the next buffered notification.
+*
+* @param[in,out] p_watch The file watch.
+* @param[out] p_folder Index of the folder of the changed file.
+* @param[out] p_name File name of the changed file.
+* @param[in] nameSize Size of the file name buffer.
+*
+* @return True, if a file notification is found.
+*/
+static bool NextEvent (fileWatch_t * const p_watch, int * const p_folder, char * const p_name, const size_t nameSize)
+{
+#ifdef __linux__
+    while (p_watch->eventPosition < p_watch->eventSize)
+    {
+        const struct inotify_event * const p_event = (const struct inotify_event *) (p_watch->p_events + p_watch->eventPosition);
+        p_watch->eventPosition += (int) (sizeof(struct inotify_event) + p_event->len);
+
+        if ((p_event->len == 0) || (p_event->mask & IN_ISDIR))
+        {
+            continue;
+        }
+        for (int i = 0; i < p_watch->folderSize; i++)
+        {
+            if (p_watch->p_folders[i].id == p_event->wd)
+            {
+                *p_folder = i;
+                snprintf(p_name, nameSize, "%s", p_event->name);
+                return true;
+            }
+        }
+    }
+#else
+    (void) p_watch;
+    (void) p_folder;
+    (void) p_name;
+    (void) nameSize;
+#endif // __linux__
+
+    return false;
+}
+
+// === Public API Functions ===
+//
+void OpenWatch (fileWatch_t * const p_watch)
+{
+    memset(p_watch, 0, sizeof(fileWatch_t));
+    p_watch->handle = -1;
+
+#ifdef __linux__
+    p_watch->p_events = (char *) malloc(WATCH_EVENT_BUFFER);
+    if (p_watch->p_events != NULL)
+    {
+        p_watch->handle = inotify_init1(IN_CLOEXEC);
+    }
+    if (p_watch->handle < 0)
+    {
+        perror("File change notification is not available, polling.");
+    }
+#endif // __linux__
+}
+
+int AddWatchFolder (fileWatch_t * const p_watch, const char * const p_folder)
+{
+    size_t length = strlen(p_folder);
+
+    // Remove the trailing separators
+    while ((length > 1) && ((p_folder[length - 1] == '/') || (p_folder[length - 1] == '\\')))
+    {
+        length--;
+    }
+    for (int i = 0; i < p_watch->folderSize; i++)
+    {
+        if ((strlen(p_watch->p_folders[i].p_path) == length) && !strncmp(p_watch->p_folders[i].p_path, p_folder, length))
+        {
+            return i;
+        }
+    }
+
+    watchFolder_t * const p_folders = (watchFolder_t *) realloc(p_watch->p_folders, (p_watch->folderSize + 1) * sizeof(watchFolder_t));
+    if (p_folders == NULL)
+    {
+        perror("Unable to allocate memory for the file watch.");
+        return -1;
+    }
+    p_watch->p_folders = p_folders;
+
+    watchFolder_t * const p_new = &p_folders[p_watch->folderSize];
+    p_new->p_path = (char *) malloc(length + 1);
+    if (p_new->p_path == NULL)
+    {
+        perror("Unable to allocate memory for the file watch.");
+        return -1;
+    }
+    memcpy(p_new->p_path, p_folder, length);
+    p_new->p_path[length] = '\0';
+    p_new->id = -1;
+
+#ifdef __linux__
+    if (p_watch->handle >= 0)
+    {
+        p_new->id = inotify_add_watch(p_watch->handle, p_new->p_path, IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (p_new->id < 0)
+        {
+            perror("Unable to watch the folder.");
+        }
+    }
+#endif // __linux__
+
+    return p_watch->folderSize++;
+}
+
+int WaitFileChange (fileWatch_t * const p_watch, int * const p_folder, char * const p_name, const size_t nameSize, const int timeout)
+{
+    if (NextEvent(p_watch, p_folder, p_name, nameSize))
+    {
+        return WATCH_CHANGED;
+    }
+
+#ifdef __linux__
+    if (p_watch->handle >= 0)
+    {
+        struct pollfd pollHandle = { p_watch->handle, POLLIN, 0 };
+        const int ready = poll(&pollHandle, 1, timeout);
+        if (ready <= 0)
+        {
+            return (ready == 0) ? WATCH_TIMEOUT : WATCH_ERROR;
+        }
+
+        const ssize_t size = read(p_watch->handle, p_watch->p_events, WATCH_EVENT_BUFFER);
+        if (size <= 0)
+        {
+            return ((size < 0) && (errno != EINTR) && (errno != EAGAIN)) ? WATCH_ERROR : WATCH_TIMEOUT;
+        }
+        p_watch->eventSize = (int) size;
+        p_watch->eventPosition = 0;
+
+        return NextEvent(p_watch, p_folder, p_name, nameSize) ? WATCH_CHANGED : WATCH_TIMEOUT;
+    }
+#endif // __linux__
+
+    // Polling: the caller checks the files after the timeout
+    SleepMs(timeout);
+
+    return WATCH_TIMEOUT;
+}
+
+void CloseWatch (fileWatch_t * const p_watch)
+{
+#ifdef __linux__
+    if (p_watch->handle >= 0)
+    {
+        close(p_watch->handle);
+    }
+#endif // __linux__
+
+    for (int i = 0; i < p_watch->folderSize; i++)
+    {
+        free(p_watch->p_folders[i].p_path);
+    }
+    free(p_watch->p_folders);
+    free(p_watch->p_events);
+    memset(p_watch, 0, sizeof(fileWatch_t));
+    p_watch->handle = -1;
+}
+
+int64_t GetTimeStamp (void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return (int64_t) (counter.QuadPart * 1000000 / frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif // _WIN32
+}
+
+/*** EOF ***/
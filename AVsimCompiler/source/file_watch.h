@@ -0,0 +1,97 @@
+/** @file file_watch.h
+*
+* @brief Notifies the changes of the files in the watched folders.
+*
+*/
+
+#ifndef FILE_WATCH_H
+#define FILE_WATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// === Type Definitions ===
+//
+typedef struct watchFolder
+{
+    char *p_path;           // Folder path without trailing separator
+    int id;                 // Watch descriptor of the folder
+} watchFolder_t;
+
+typedef struct fileWatch
+{
+    int handle;             // Notification descriptor, -1: polling
+    watchFolder_t *p_folders;
+    int folderSize;
+    char *p_events;         // Buffered notifications
+    int eventSize;
+    int eventPosition;
+} fileWatch_t;
+
+// === Constant Definitions ===
+//
+#define WATCH_EVENT_BUFFER  16384   // Size of the notification buffer
+#define WATCH_CHANGED       1       // A file is changed
+#define WATCH_TIMEOUT       0       // No change during the timeout
+#define WATCH_ERROR         -1      // Error or interruption
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*
+** @brief Opens the change notification, falls back to polling if it is not supported.
+*
+* @param[out] p_watch The file watch.
+*
+* @return void
+*/
+void OpenWatch (fileWatch_t * const p_watch);
+
+/*
+** @brief Watches the files of the folder, the same folder is watched once.
+*
+* @param[in,out] p_watch The file watch.
+* @param[in] p_folder Folder path.
+*
+* @return MEMORY ALLOCATION -> Index of the folder, -1 on error.
+*/
+int AddWatchFolder (fileWatch_t * const p_watch, const char * const p_folder);
+
+/*
+** @brief Waits for the next written or renamed file of the watched folders.
+*
+* @param[in,out] p_watch The file watch.
+* @param[out] p_folder Index of the folder of the changed file.
+* @param[out] p_name File name of the changed file.
+* @param[in] nameSize Size of the file name buffer.
+* @param[in] timeout Maximum waiting time in milliseconds.
+*
+* @return WATCH_CHANGED, WATCH_TIMEOUT or WATCH_ERROR.
+*/
+int WaitFileChange (fileWatch_t * const p_watch, int * const p_folder, char * const p_name, const size_t nameSize, const int timeout);
+
+/*
+** @brief Closes the file watch.
+*
+* @param[in] p_watch The file watch.
+*
+* @return void
+*/
+void CloseWatch (fileWatch_t * const p_watch);
+
+/*
+** @brief Returns with a monotonic time stamp.
+*
+* @return Time in microseconds.
+*/
+int64_t GetTimeStamp (void);
+
+#endif // FILE_WATCH_H
+
+/*** EOF ***/
@@ -19,7 +19,64 @@ static inline const char *GetGuide (void)
 \n\
   I. Input arguments:\n\
        - (1) *.av source to be compiled [by default: \"instruction.av\"]\n\
-       - (2) Verilog definition subfolder path [by default that is in the root]\n\
+       - (2) Verilog definition subfolder path [by default that is in the root]\n\
+       - Options (anywhere among the arguments):\n\
+           -j, --jobs <N>: compile with N worker threads, 0: one for each processor [by default: 1]\n\
+           -b, --batch <input>: compiles many sources, the only argument is the Verilog definition subfolder path\n\
+               <input>: folder (each *.av inside), wildcard pattern or @<manifest> (one folder/pattern/file each row)\n\
+               Each program is compiled to \"<source>.mem\" [by default on each processor].\n\
+               \"avsim_define.v\": `INSTRUCTION_COUNT, `INSTRUCTION_PATH_<index> and `INSTRUCTION_PATH of index 0.\n\
+           -i, --incremental: recompiles the changed rows only and patches \"<source>.mem\" in place,\n\
+               by the \"<source>.mem.cache\" sidecar, without printing the source and the compiled code.\n\
+           -w, --watch <input>: recompiles the saved sources until Ctrl+C, repeat it for more inputs,\n\
+               the only argument is the Verilog definition subfolder path.\n\
+               <input>: source, folder (each *.av inside, the new ones too) or wildcard pattern\n\
+               The changed rows are recompiled, \"<source>.mem\" is replaced atomically (temporary file + rename).\n\
+           -d, --depth <bits>: instruction memory of the HDL has 2^bits entries, the larger programs are errors\n\
+               [by default: the smallest depth of at least 7 bits fitting the program and the end of simulation].\n\
+               \"avsim_define.v\": `INSTRUCTION_LIMIT_SIZE sets INSTR_LIMIT_SIZE of the HDL.\n\
+           -r, --run <image>: simulates the compiled \"<source>.mem\" on the native model of avalon_master\n\
+               until the end of the program, and prints the bus transactions:\n\
+               <time> ns /*<PC>*/ READ <address> => <readdata> | WRITE <address> <= <writedata>\n\
+               The time is the clock edge closing the cycle (50 MHz, the first edge after reset: 30 ns).\n\
+               The idle spans (WAIT, setup, strobe, latency and hold countdowns) are skipped at once, exactly.\n\
+               <image>: folder (each *.mem inside), wildcard pattern or @<manifest>: the images are simulated\n\
+               8 together [by default on each processor], with readdata 0, into \"<image>.log\" each.\n\
+           -t, --trace: with --run, prints the signals of avalon_master in each cycle instead.\n\
+           -s, --slave <model>[@<base>[:<span>]]: with --run of a single image, attaches a slave model\n\
+               to the address window base..base+span-1 (hexadecimal), repeat it for more slaves.\n\
+               <model>: \"div_avalon\" (built-in, span 8) or a shared object exporting AvsimSlaveOps.\n\
+               The slaves are stepped in each cycle, the idle spans are not skipped then.\n\
+           -S, --stats, --stats-json: wall time, processed bytes and lines, heap allocations of each phase\n\
+               of a single source compilation: read, echo, compile, sequence (repeat / burst checks),\n\
+               optimize, emit, estimate, print, write and notify. Printed as a table at the end,\n\
+               or as a single line JSON object for the dashboards. Without it the phases are not measured.\n\
+           -O, --optimize: peephole optimization of a single source, without --incremental.\n\
+               The consecutive NOP / WAIT instructions become a single WAIT of the same cycles, the LOADs\n\
+               of the active timing word and the LOADs overwritten before any transfer are removed.\n\
+               The bus transactions keep their order and data. The removed rows are echoed as\n\
+               //---*/ <instruction> //<comment>, the saved instructions and cycles are printed.\n\
+           -c, --cycles: static cycle estimate by the cycle table of avalon_master without simulation.\n\
+               The LOAD state, the fast issue, the pipelined reads and the repeat blocks are followed,\n\
+               the waitrequest of the slave is assumed never asserted. Each executed row of the compiled\n\
+               code gets /*@<first start cycle> +<cycles>[ x<executions>]*/, then the run time and\n\
+               the most expensive lines are printed after the compilation.\n\
+           -p, --profile <dump>: performance counters of avalon_master (PERF_COUNTERS of the HDL).\n\
+               With --run of a single image, the native model writes the counters into <dump>,\n\
+               the testbench writes the same dump at simReady if AVSIM_PERF_DUMP is defined as its path.\n\
+               With a source, the dump is printed after the compilation: bus utilization, cycles of the\n\
+               fetch/setup/strobe/stall/latency/hold/wait/control phases, retired instructions by opcode,\n\
+               the longest stall and instruction, then the cycles of each executed source line.\n\
+           -e, --max-errors <N>: reports the first N errors of each source, 0: each one [by default: 100],\n\
+               then the number of the unreported ones. The errors are recorded by the compilation:\n\
+               line, column, field (opcode, address, data, nesting, burst) and reason.\n\
+           --errors-json: reports the errors as JSON objects, one in each row of std_err:\n\
+               {\"line\":<N>,\"column\":<N>,\"field\":\"<field>\",\"reason\":\"<reason>\",\"message\":\"<text>\"},\n\
+               closed by {\"errors\":<detected>,\"reported\":<reported>}.\n\
+       - DPI-C feeder: the library of the DPI target streams the instructions to avalon_interface.v\n\
+           as the program counter advances, if AVSIM_DPI_FEEDER is defined in the HDL simulator.\n\
+           `INSTRUCTION_SOURCE (\"<source>.av\", compiled at time zero) or `INSTRUCTION_PATH is opened,\n\
+           INSTR_LIMIT_SIZE is 31 bits, there is no instruction table.\n\
        - Compiled file output: \"<source>.mem\" stored in the root directory.\n\
        - Verilog definition file output: \"avsim_define.v\" stored in the root directory.\n\
   II. Acceptable Operating Codes (case-insensitive):\n\
@@ -28,6 +85,17 @@ static inline const char *GetGuide (void)
        - 3. write: Writes the data to the specific address\n\
        - 4. wait: Waiting until the specified cycles defined by the data\n\
        - 5. load: Loading the timing parameters (see later)\n\
+       - 6. repeat: Repeats the instructions until the matching end, data: number of iterations (at least 1)\n\
+              address: <address step><data step> (2 Byte each), added to the address of read / write\n\
+              and to the data of write after each iteration. Nesting depth: 4 blocks.\n\
+       - 7. end: Closes the innermost repeat block, address and data are 0\n\
+       - 8. burstread: Reads a burst from the address, data: burst length (1-128)\n\
+              The beats are captured one each cycle after the ReadLatency, the other timings are not used.\n\
+       - 9. burstwrite: Writes a burst to the address, one beat each cycle\n\
+              data: <pattern step><burst length> (2 Byte each), burst length: 1-128\n\
+              Pattern step 0: the burst length of beat rows follow with the write data of each beat.\n\
+              Otherwise a single beat row follows with the first write data, incremented by the step each beat.\n\
+       - 10. beat: Write data of the burst beat, address is 0\n\
   III. Input Source Format:\n\
       - 1. Instruction: <opcode> <hexadecimal address> <hexadecimal data>\n\
       - 2. Comment: ; <any comments>\n\
@@ -37,16 +105,37 @@ static inline const char *GetGuide (void)
   IV. Limits:\n\
        - 1. Each line (including the comment) is limited to 100 character.\n\
        - 2. 4 Byte address and data in hexadecimal format.\n\
-       - 3. Maximum value of program counter: 999.\n\
+       - 3. Program counter: 31 bits, printed with at least 3 decimal digits, wider for the larger programs.\n\
   V. Timing settings: 1 Byte format with the usage of LOAD operating code.\n\
        - 1. data: <Hold><ReadLatency><WriteWait><ReadWait> (MSB --> LSB)\n\
-       - 2. address: 0x000000<Setup> (MSB --> LSB)\n\
+       - 2. address: 0x0000<Mode><Setup> (MSB --> LSB)\n\
        - 3. Example: \"load 11 2233aa01 ; setting avalon timing parameters\"\n\
               => Setup: 0x11, ReadWait: 0x01, WriteWait: 0xaa, ReadLatency: 0x33, Hold: 0x22\n\
+       - 4. Mode bit 0: pipelined reads, e.g. \"load 100 00030000\"\n\
+              => A read is issued in every cycle, up to 4 reads are outstanding.\n\
+              => The data is captured at readdatavalid, the watch shows the program counter of the read.\n\
+              => Any other instruction waits for the outstanding reads.\n\
+       - 5. Mode bit 1: waitrequest flow control, e.g. \"load 200 00000000\"\n\
+              => ReadWait and WriteWait are replaced by the waitrequest of the slave.\n\
+              => The next instruction is fetched after the transfer, without the fixed Avalon delay.\n\
+              => The modes are set by each load: \"load 0 ...\" returns to the fixed timing.\n\
+       - 6. Mode bit 2: fast issue, e.g. \"load 400 00000000\"\n\
+              => The instruction after a read or write is decoded in the last cycle of the transfer,\n\
+                 the next read or write starts at once. NOP and LOAD are completed in FETCH.\n\
+              => The modes can be combined, the mode bits 3..7 are reserved: ADDRESS error.\n\
+       - 7. Cycles of the instructions (S: Setup, RW/WW: ReadWait/WriteWait, L: ReadLatency, H: Hold,\n\
+            D: Avalon delay = 25, W: cycles held by waitrequest):\n\
+              => fixed timing: NOP 2, READ S+RW+L+D+3, WRITE S+WW+H+D+3, LOAD 3, WAIT n: n+2,\n\
+                 REPEAT and END 2, BURSTREAD N: max(L,1)+N+D+2, BURSTWRITE N: N+D+2 (the beat rows included)\n\
+              => waitrequest: READ S+W+L+3, WRITE S+W+H+3\n\
+              => fast issue: NOP 1, LOAD 1, READ S+RW+L+1, WRITE S+WW+H+1,\n\
+                 plus 1 FETCH cycle if the read or write does not follow a read or write\n\
   VI. Input Source Format Error Handling:\n\
       - 1. The specific line of the compiled output will be commented out in case of any source error.\n\
-      - 2. Compiler is able to distinguish the 3 different type of errors: opcode, address, data.\n\
+      - 2. Compiler is able to distinguish the 5 different type of errors: opcode, address, data, nesting, burst.\n\
              There will be placed an 'X' key where the input error is occurred.\n\
+      - 3. Nesting: unmatched repeat / end, or deeper blocks than the limit.\n\
+      - 4. Burst: burst write without all of its beat rows, or beat row out of a burst write.\n\
   VII. Source Example:\n\
       ; Initialization\n\
       load 0 00020001 ; Timing parameters: ReadWait = 1, ReadLatency = 2\n\
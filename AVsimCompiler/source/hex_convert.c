@@ -0,0 +1,143 @@
+/** @file hex_convert.c
+*
+* @brief Vectorized hexadecimal operand conversion in both directions.
+*
+*/
+
+#include "hex_convert.h"
+
+// === Protected Functions ===
+//
+/*!
+* @brief Loads the operand into the low bytes of a zero padded 8 byte word.
+*
+* @param[in] p_text First digit of the operand.
+* @param[in] length Number of the digits: 1 - HEX_LIMIT.
+*
+* @return The loaded word; first digit is the least significant byte.
+*/
+static inline uint64_t LoadOperand (const char * const p_text, const int length)
+{
+    uint64_t word = 0;
+
+    // The operand may end the buffer: nothing is read after its last digit
+    memcpy(&word, p_text, (size_t) length);
+
+    return word;
+}
+
+#ifdef HEX_SSE2
+/*!
+* @brief SSE2 kernel: validates and converts the loaded operand.
+*
+* @param[in] word The operand, zero padded above length.
+* @param[in] length Number of the digits: 1 - HEX_LIMIT.
+* @param[out] p_value Converted value.
+*
+* @return Returns with true, if each digit is valid.
+*/
+static inline bool ParseHexaSSE2 (const uint64_t word, const int length, uint32_t * const p_value)
+{
+    const __m128i chars = _mm_loadl_epi64((const __m128i *) &word);
+    const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+
+    // Character ranges: '0'-'9' and case folded 'a'-'f' (signed compare rejects >= 0x80)
+    const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                          _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    const __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                          _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    const int validMask = _mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha));
+    if ((validMask & ((1 << length) - 1)) != ((1 << length) - 1))
+    {
+        return false;
+    }
+
+    // Nibble value: low 4 bits, +9 for letters; the zero padding gives zero nibbles
+    __m128i nibbles = _mm_add_epi8(_mm_and_si128(chars, _mm_set1_epi8(0x0F)),
+                                   _mm_and_si128(isAlpha, _mm_set1_epi8(9)));
+    nibbles = _mm_and_si128(nibbles, _mm_or_si128(isDigit, isAlpha));
+
+    // Merge the digit pairs to bytes: (first << 4) | second
+    const __m128i pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+                                       _mm_srli_epi16(nibbles, 8));
+    const uint32_t bytes = (uint32_t) _mm_cvtsi128_si32(_mm_packus_epi16(pairs, pairs));
+
+    // The first digit is the most significant one, drop the padding digits
+    *p_value = __builtin_bswap32(bytes) >> (4 * (HEX_LIMIT - length));
+
+    return true;
+}
+#else
+/*!
+* @brief Scalar kernel: validates and converts the loaded operand.
+*
+* @param[in] word The operand, zero padded above length.
+* @param[in] length Number of the digits: 1 - HEX_LIMIT.
+* @param[out] p_value Converted value.
+*
+* @return Returns with true, if each digit is valid.
+*/
+static inline bool ParseHexaScalar (uint64_t word, const int length, uint32_t * const p_value)
+{
+    uint32_t value = 0;
+    uint32_t digit;
+
+    for (int i = 0; i < length; i++)
+    {
+        digit = (uint32_t) (word & 0xFF);
+        if ((digit - '0') <= 9)
+        {
+            digit -= '0';
+        }
+        else if (((digit | 0x20) - 'a') <= 5)
+        {
+            digit = (digit | 0x20) - 'a' + 10;
+        }
+        else
+        {
+            return false;
+        }
+        value = (value << 4) | digit;
+        word >>= 8;
+    }
+    *p_value = value;
+
+    return true;
+}
+#endif // HEX_SSE2
+
+// === Public API Functions ===
+//
+bool ParseHexa (const char * const p_text, const int length, uint32_t * const p_value)
+{
+    // 8 Byte hexadecimal size is out of range
+    if ((length <= 0) || (length > HEX_LIMIT))
+    {
+        return false;
+    }
+
+#ifdef HEX_SSE2
+    return ParseHexaSSE2(LoadOperand(p_text, length), length, p_value);
+#else
+    return ParseHexaScalar(LoadOperand(p_text, length), length, p_value);
+#endif // HEX_SSE2
+}
+
+char *EmitHexa (char * const p_target, const uint32_t value)
+{
+    // Spread the nibbles to bytes: the least significant nibble goes to the lowest byte
+    uint64_t nibbles = value;
+    nibbles = ((nibbles & 0x00000000FFFF0000ULL) << 16) | (nibbles & 0x000000000000FFFFULL);
+    nibbles = ((nibbles & 0x0000FF000000FF00ULL) << 8)  | (nibbles & 0x000000FF000000FFULL);
+    nibbles = ((nibbles & 0x00F000F000F000F0ULL) << 4)  | (nibbles & 0x000F000F000F000FULL);
+
+    // '0' + nibble, +7 for the letters: bit 7 of (nibble + 0x76) is set above 9
+    const uint64_t letters = ((nibbles + 0x7676767676767676ULL) >> 7) & 0x0101010101010101ULL;
+    const uint64_t digits = __builtin_bswap64(nibbles + 0x3030303030303030ULL + 7 * letters);
+
+    memcpy(p_target, &digits, HEX_LIMIT);
+
+    return p_target + HEX_LIMIT;
+}
+
+/*** EOF ***/
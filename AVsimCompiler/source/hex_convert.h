@@ -0,0 +1,57 @@
+/** @file hex_convert.h
+*
+* @brief Vectorized hexadecimal operand conversion in both directions.
+*
+*/
+
+#ifndef HEX_CONVERT_H
+#define HEX_CONVERT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))) && !defined(HEX_NO_SIMD)
+# define HEX_SSE2
+# include <emmintrin.h>
+#endif
+
+// === Type Definitions ===
+//
+
+
+// === Constant Definitions ===
+//
+#define HEX_LIMIT           8       // 4 Byte hexadecimal operands
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*!
+* @brief Validates and converts a case insensitive hexadecimal operand of up to 8 digits.
+*
+* @param[in] p_text First digit of the operand.
+* @param[in] length Number of the digits.
+* @param[out] p_value Converted value, valid only in case of success.
+*
+* @return Returns with true, if each character is a hexadecimal digit.
+*/
+bool ParseHexa (const char * const p_text, const int length, uint32_t * const p_value);
+
+/*!
+* @brief Writes the 32-bit value as 8 uppercase hexadecimal digits without branches.
+*
+* @param[out] p_target Output position, not terminated.
+* @param[in] value Value to be converted.
+*
+* @return The position after the hexadecimal digits.
+*/
+char *EmitHexa (char * const p_target, const uint32_t value);
+
+#endif // HEX_CONVERT_H
+
+/*** EOF ***/
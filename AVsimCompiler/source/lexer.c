@@ -0,0 +1,130 @@
+/** @file lexer.c
+*
+* @brief Table-driven single pass lexer of the Avalon Simulator source rows.
+*
+*/
+
+#include "lexer.h"
+
+// === Constant Definitions ===
+//
+// Character class LUT: key code | class bits | hexadecimal value
+static const uint16_t CHAR_CLASS_LUT[256] =
+{
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0x00
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0x10
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0x20
+    0x1B30, 0x1C31, 0x1D32, 0x1E33, 0x1F34, 0x2035, 0x2136, 0x2237, 0x2338, 0x2439, 0x0000, 0x0040, 0x0000, 0x0000, 0x0000, 0x0000,  // 0x30
+    0x0000, 0x013A, 0x023B, 0x033C, 0x043D, 0x053E, 0x063F, 0x0720, 0x0820, 0x0920, 0x0A20, 0x0B20, 0x0C20, 0x0D20, 0x0E20, 0x0F20,  // 0x40
+    0x1020, 0x1120, 0x1220, 0x1320, 0x1420, 0x1520, 0x1620, 0x1720, 0x1820, 0x1920, 0x1A20, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0x50
+    0x0000, 0x013A, 0x023B, 0x033C, 0x043D, 0x053E, 0x063F, 0x0720, 0x0820, 0x0920, 0x0A20, 0x0B20, 0x0C20, 0x0D20, 0x0E20, 0x0F20,  // 0x60
+    0x1020, 0x1120, 0x1220, 0x1320, 0x1420, 0x1520, 0x1620, 0x1720, 0x1820, 0x1920, 0x1A20, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0x70
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0x80
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0x90
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0xA0
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0xB0
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0xC0
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0xD0
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // 0xE0
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000   // 0xF0
+};
+
+// === Protected Functions ===
+//
+/*!
+* @brief Stores the completed field of the row.
+*
+* @param[out] p_instruction The lexed instruction.
+* @param[in] field Index of the field.
+* @param[in] p_start Start of the field in the row.
+* @param[in] length Length of the field.
+* @param[in] key Case folded key of the field.
+*
+* @return void
+*/
+static inline void CloseField (instruction_t * const p_instruction, const int field, const char * const p_start,
+                               const int length, const uint64_t key)
+{
+    // Extra fields are skipped
+    if (field >= FIELD_LIMIT)
+    {
+        return;
+    }
+
+    p_instruction->field[field].p_text = p_start;
+    p_instruction->field[field].length = length;
+    if (field == FIELD_OPCODE)
+    {
+        p_instruction->opCodeKey = (length <= KEY_LIMIT) ? key : 0;
+    }
+    else
+    {
+        // The operands are converted as a whole
+        p_instruction->b_isHexa[field] = ParseHexa(p_start, length, &p_instruction->value[field]);
+    }
+}
+
+// === Public API Functions ===
+//
+bool LexInstruction (const textLine_t * const p_source, instruction_t * const p_instruction)
+{
+    const uint8_t * const p_text = (const uint8_t *) p_source->p_text;
+    const int length = p_source->length;
+    int field = -1;             // Index of the field under reading
+    int start = -1;             // Start of the field under reading
+    uint64_t key = 0;
+    uint16_t charClass;
+    int i;
+
+    memset(p_instruction, 0, sizeof(instruction_t));
+
+    for (i = 0; i < length; i++)
+    {
+        charClass = CHAR_CLASS_LUT[p_text[i]];
+
+        if (charClass & CC_ALNUM)
+        {
+            if (start < 0)
+            {
+                start = i;
+                field++;
+                key = 0;
+            }
+            // Case folding of the opcode key
+            key = (key << KEY_BITS) | (charClass >> CC_KEY_SHIFT);
+            continue;
+        }
+
+        if (start >= 0)
+        {
+            CloseField(p_instruction, field, (const char *) &p_text[start], i - start, key);
+            start = -1;
+        }
+
+        if (charClass & CC_COMMENT)
+        {
+            p_instruction->b_hasComment = true;
+            p_instruction->comment.p_text = (const char *) &p_text[i + 1];
+            p_instruction->comment.length = length - i - 1;
+            break;
+        }
+    }
+
+    // The end of the row closes the last field too
+    if (start >= 0)
+    {
+        CloseField(p_instruction, field, (const char *) &p_text[start], i - start, key);
+    }
+    p_instruction->fieldSize = field + 1;
+
+    // Just comment field is detected
+    if ((field < 0) && p_instruction->b_hasComment)
+    {
+        p_instruction->b_justComment = true;
+        return true;
+    }
+
+    return (p_instruction->fieldSize >= FIELD_LIMIT) ? true : false;
+}
+
+/*** EOF ***/
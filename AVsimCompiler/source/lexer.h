@@ -0,0 +1,79 @@
+/** @file lexer.h
+*
+* @brief Table-driven single pass lexer of the Avalon Simulator source rows.
+*
+*/
+
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "file_access.h"
+#include "hex_convert.h"
+
+// === Constant Definitions ===
+//
+#define FIELD_OPCODE        0
+#define FIELD_ADDRESS       1
+#define FIELD_DATA          2
+#define FIELD_LIMIT         3       // opcode, address, data
+#define INPUT_COMMENT       ';'
+
+// Character class bits of the LUT
+#define CC_HEX_VALUE        0x000F  // Value of the hexadecimal digit
+#define CC_HEX              0x0010  // Hexadecimal digit
+#define CC_ALNUM            0x0020  // Alphanumeric: part of a field
+#define CC_COMMENT          0x0040  // Comment delimiter
+#define CC_KEY_SHIFT        8       // Case folded key code: 'A'-'Z' => 1-26, '0'-'9' => 27-36
+#define KEY_BITS            6
+#define KEY_LIMIT           10      // Maximum number of characters of an opcode key
+
+// === Type Definitions ===
+//
+typedef struct instruction
+{
+    bool b_justComment;
+    bool b_hasComment;
+    int fieldSize;                      // Number of detected fields
+    textLine_t field[FIELD_LIMIT];      // Views of the fields in the source row
+    uint64_t opCodeKey;                 // Case folded opcode, 0 if too long
+    uint32_t value[FIELD_LIMIT];        // Hexadecimal value of the operand fields
+    bool b_isHexa[FIELD_LIMIT];         // Operand field is a valid hexadecimal number
+    textLine_t comment;
+} instruction_t;
+
+// === Macros ===
+//
+// Compile time opcode keys, identical to the case folded keys of the lexer
+#define KEY_CODE(c)                 ((uint64_t) (((c) >= 'A') ? ((c) - 'A' + 1) : ((c) - '0' + 27)))
+#define KEY1(a)                     KEY_CODE(a)
+#define KEY2(a, b)                  ((KEY1(a) << KEY_BITS) | KEY_CODE(b))
+#define KEY3(a, b, c)               ((KEY2(a, b) << KEY_BITS) | KEY_CODE(c))
+#define KEY4(a, b, c, d)            ((KEY3(a, b, c) << KEY_BITS) | KEY_CODE(d))
+#define KEY5(a, b, c, d, e)         ((KEY4(a, b, c, d) << KEY_BITS) | KEY_CODE(e))
+#define KEY6(a, b, c, d, e, f)      ((KEY5(a, b, c, d, e) << KEY_BITS) | KEY_CODE(f))
+#define KEY9(a, b, c, d, e, f, g, h, i) \
+                                    ((KEY5(a, b, c, d, e) << (4 * KEY_BITS)) | KEY4(f, g, h, i))
+#define KEY10(a, b, c, d, e, f, g, h, i, j) \
+                                    ((KEY5(a, b, c, d, e) << (5 * KEY_BITS)) | KEY5(f, g, h, i, j))
+
+// === Public API Functions ===
+//
+/*!
+* @brief Splits and classifies the source row in a single pass:
+*           operating code key, hexadecimal address, data and comment.
+*
+* @param[in] p_source Raw data instruction row.
+* @param[out] p_instruction The lexed instruction with the views of the row.
+*
+* @return Returns with true in case of an instruction or a comment row.
+*/
+bool LexInstruction (const textLine_t * const p_source, instruction_t * const p_instruction);
+
+#endif // LEXER_H
+
+/*** EOF ***/
@@ -12,8 +12,13 @@
 // === Protected Function Prototypes ===
 //
 static inline void StartDisplay (const char * const p_sourcePath, const char * const p_targetPath, const char * const p_verilogDefPath);
+static bool ParseOptions (int *p_argc, char **pp_argv, options_t * const p_options);
+static int RunBatch (int argc, char **pp_argv, const options_t * const p_options);
+static int RunIncremental (sourceText_t * const p_source, const char * const p_targetPath, const options_t * const p_options);
+static bool WriteDepthDef (const program_t * const p_program, const options_t * const p_options);
 static bool GeneratePathes (int argc, char **pp_argv, char *p_source, char *p_target, char *p_verilogWork);
-static inline void PrintText (char ** const pp_source, int size);
+static inline void PrintText (const sourceText_t * const p_source);
+static inline void PrintBuffer (const textBuffer_t * const p_text);
 
 // === MAIN ===
 //
@@ -36,52 +41,168 @@ int main (int argc, char **pp_argv)
     char sourceFile[FILE_NAME_LENGTH_LIMIT + 1] = {'\0'};
     char targetFile[FILE_NAME_LENGTH_LIMIT + 1] = {'\0'};
     char verilogWorkFolder[FILE_NAME_LENGTH_LIMIT + 1] = {'\0'};
+    char *watchInputs[argc];
+    char *slaveSpecs[argc];
+    options_t options = { JOBS_UNSET, NULL, false, watchInputs, 0, INSTR_DEPTH_AUTO, NULL, false, slaveSpecs, 0, NULL, false, false, statsOff,
+                          DIAG_LIMIT_DEFAULT, diagText };
 
     // Handle command line input parameters
+    if (!ParseOptions(&argc, pp_argv, &options))
+    {
+        fprintf(stderr, "Invalid option, see '%s help'.\n", pp_argv[0]);
+        return -1;
+    }
+    ConfigureDiagnostics(options.errorLimit, options.errorFormat);
+    if (options.p_runImage != NULL)
+    {
+        return RunSimulation(options.p_runImage, options.depthBits, options.b_isTraced,
+                             (options.jobs == JOBS_UNSET) ? DEFAULT_BATCH_JOBS : options.jobs,
+                             options.pp_slaveSpecs, options.slaveSize, options.p_profilePath);
+    }
+    if (options.p_batchInput != NULL)
+    {
+        return RunBatch(argc, pp_argv, &options);
+    }
+    if (options.watchSize > 0)
+    {
+        snprintf(verilogWorkFolder, sizeof(verilogWorkFolder), "%s%s", (argc > 1) ? pp_argv[1] : "", (argc > 1) ? "/" : "");
+        return WatchSources(options.watchSize, options.pp_watchInputs, verilogWorkFolder, VERILOG_DEF_FILE,
+                            (options.jobs == JOBS_UNSET) ? DEFAULT_JOBS : options.jobs, options.depthBits);
+    }
+    if (options.jobs == JOBS_UNSET)
+    {
+        options.jobs = DEFAULT_JOBS;
+    }
     if (!GeneratePathes(argc, pp_argv, sourceFile, targetFile, verilogWorkFolder))
     {
-        perror("Undefined I/O file pathes.");
+        fputs("Undefined I/O file pathes.\n", stderr);
         return -1;
     }
     StartDisplay(sourceFile, targetFile, VERILOG_DEF_FILE);
 
     // Read source file
-    textSize_t textParam;
-    char ** const pp_source = ReadFile(sourceFile, &textParam);
-    if (pp_source == NULL)
+    EnableStats(options.statsFormat != statsOff);
+    BeginPhase(statsRead);
+    sourceText_t * const p_source = ReadFile(sourceFile);
+    if (p_source == NULL)
     {
         perror("No source file was detected.");
         return -1;
     }
+    EndPhase(p_source->dataSize, (uint64_t) p_source->param.rowSize);
 
     // Create Verilog Definition File
-    WriteVerilogDefFile(VERILOG_DEF_FILE, VERILOG_DEF, verilogWorkFolder, targetFile, false);
+    WriteVerilogDefFile(VERILOG_DEF_FILE, VERILOG_DEF, verilogWorkFolder, targetFile, false);
+
+    // Recompile the changed rows only without console echo
+    if (options.b_isIncremental)
+    {
+        return RunIncremental(p_source, targetFile, &options);
+    }
 
     // Print source file to the console
+    BeginPhase(statsEcho);
     printf("--- The input source's raw data: '%s' ---\n", sourceFile);
-    PrintText(pp_source, textParam.rowSize);
-
-    // Compile the input
-    char **pp_compiled = CompileCode(pp_source, &textParam);
-
-    // Print the compiled code to the console
-    printf("\n--- The compiled code: '%s' ---\n", targetFile);
-    PrintText(pp_compiled, textParam.rowSize);
-
-    //Write the compiled code to the target file
-    WriteFile(targetFile, pp_compiled, textParam.rowSize, true);
-
-    // Detect the invalid parameters and print to the console
-    puts("");
-    NotifyInvalid (pp_compiled, textParam.rowSize);
-
-    // Dismiss previous memory allocations
-    CleanupText(pp_source, textParam.rowSize);
-    CleanupText(pp_compiled, textParam.rowSize);
+    PrintText(p_source);
+    EndPhase(p_source->dataSize, (uint64_t) p_source->param.rowSize);
+
+    // Compile the input
+    program_t * const p_program = CompileCode(p_source, options.jobs);
+    textBuffer_t compiled = { NULL, 0, 0 };
+    programTiming_t timing = { NULL, NULL, NULL, 0, 0 };
+    peepholeStats_t peephole;
+    const uint64_t records = (uint64_t) p_source->param.rowSize * sizeof(instrRecord_t);
+    bool b_isCompiled = (p_program != NULL);
+    if (b_isCompiled && options.b_isOptimized)
+    {
+        BeginPhase(statsOptimize);
+        b_isCompiled = OptimizeProgram(p_program, &peephole);
+        EndPhase(records, (uint64_t) p_program->rowSize);
+    }
+    if (b_isCompiled)
+    {
+        BeginPhase(statsEmit);
+        b_isCompiled = EmitCode(p_program, &compiled);
+        EndPhase(compiled.size, (uint64_t) p_program->rowSize);
+    }
+    if (b_isCompiled && options.b_isEstimated)
+    {
+        BeginPhase(statsEstimate);
+        b_isCompiled = AnalyzeTiming(p_program, &timing) && AnnotateTiming(p_program, &timing, &compiled);
+        EndPhase(records, (uint64_t) p_program->rowSize);
+    }
+    if (!b_isCompiled)
+    {
+        CleanupTiming(&timing);
+        CleanupBuffer(&compiled);
+        CleanupProgram(p_program);
+        CleanupText(p_source);
+        return -1;
+    }
+
+    // Print the compiled code to the console
+    BeginPhase(statsPrint);
+    printf("\n--- The compiled code: '%s' ---\n", targetFile);
+    PrintBuffer(&compiled);
+    EndPhase(compiled.size, (uint64_t) p_program->rowSize);
+
+    //Write the compiled code to the target file
+    BeginPhase(statsWrite);
+    WriteFile(targetFile, &compiled);
+    EndPhase(compiled.size, (uint64_t) p_program->rowSize);
+
+    // Detect the invalid parameters and print to the console
+    BeginPhase(statsNotify);
+    puts("");
+    NotifyInvalid (p_program);
+    EndPhase(records, (uint64_t) p_program->rowSize);
+    const bool b_isFitting = WriteDepthDef(p_program, &options);
+
+    // Removed instructions and saved cycles
+    if (options.b_isOptimized)
+    {
+        puts("");
+        PrintPeephole(&peephole);
+    }
+
+    // Estimated run time and the most expensive lines
+    if (options.b_isEstimated)
+    {
+        puts("");
+        PrintTiming(&timing, p_program);
+        CleanupTiming(&timing);
+    }
+
+    // Cycle profile of the source lines from the dump of the testbench or the native model
+    perfCounters_t perf;
+    const bool b_isProfiled = (options.p_profilePath == NULL) || ReadPerfDump(options.p_profilePath, &perf);
+    if ((options.p_profilePath != NULL) && b_isProfiled)
+    {
+        puts("");
+        PrintProfile(&perf, p_program);
+        CleanupPerf(&perf);
+    }
+
+    // Time and allocations of the phases
+    if (options.statsFormat != statsOff)
+    {
+        puts("");
+        PrintStats(stdout, options.statsFormat);
+    }
+
+    // Dismiss previous memory allocations
+    CleanupBuffer(&compiled);
+    CleanupProgram(p_program);
+    CleanupText(p_source);
+
+    if (!b_isFitting || !b_isProfiled)
+    {
+        return -1;
+    }
 
 #endif // TEST_ON
-
-    return 0;
+
+    return 0;
 }
 
 // === Protected Functions ===
@@ -106,7 +227,282 @@ static inline void StartDisplay (const char * const p_sourcePath, const char * c
     printf("Verilog definition file: '%s'\n\n", p_verilogDefPath);
 }
 
-//
+/*!
+* @brief Processes the options and removes them from the input arguments,
+*           only the positional arguments are kept in their original order.
+*
+* @param[in,out] p_argc Number of standard I/O arguments.
+* @param[in,out] pp_argv Standard I/O arguments.
+* @param[out] p_options The parsed options.
+*
+* @return Valid, if each option is recognized with a proper value.
+*/
+static bool ParseOptions (int *p_argc, char **pp_argv, options_t * const p_options)
+{
+    int argc = 1;
+
+    for (int i = 1; i < *p_argc; i++)
+    {
+        if (!strcmp(pp_argv[i], OPTION_JOBS) || !strcmp(pp_argv[i], OPTION_JOBS_SHORT))
+        {
+            char *p_end;
+            if (++i >= *p_argc)
+            {
+                return false;
+            }
+            const long jobs = strtol(pp_argv[i], &p_end, 10);
+            if ((*p_end != '\0') || (p_end == pp_argv[i]) || (jobs < 0) || (jobs > JOBS_LIMIT))
+            {
+                return false;
+            }
+            p_options->jobs = (int) jobs;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_BATCH) || !strcmp(pp_argv[i], OPTION_BATCH_SHORT))
+        {
+            if (++i >= *p_argc)
+            {
+                return false;
+            }
+            p_options->p_batchInput = pp_argv[i];
+        }
+        else if (!strcmp(pp_argv[i], OPTION_INCREMENTAL) || !strcmp(pp_argv[i], OPTION_INCREMENTAL_SHORT))
+        {
+            p_options->b_isIncremental = true;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_WATCH) || !strcmp(pp_argv[i], OPTION_WATCH_SHORT))
+        {
+            if (++i >= *p_argc)
+            {
+                return false;
+            }
+            p_options->pp_watchInputs[p_options->watchSize++] = pp_argv[i];
+        }
+        else if (!strcmp(pp_argv[i], OPTION_DEPTH) || !strcmp(pp_argv[i], OPTION_DEPTH_SHORT))
+        {
+            char *p_end;
+            if (++i >= *p_argc)
+            {
+                return false;
+            }
+            const long depthBits = strtol(pp_argv[i], &p_end, 10);
+            if ((*p_end != '\0') || (p_end == pp_argv[i]) || (depthBits < 1) || (depthBits > INSTR_DEPTH_MAX))
+            {
+                return false;
+            }
+            p_options->depthBits = (int) depthBits;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_RUN) || !strcmp(pp_argv[i], OPTION_RUN_SHORT))
+        {
+            if (++i >= *p_argc)
+            {
+                return false;
+            }
+            p_options->p_runImage = pp_argv[i];
+        }
+        else if (!strcmp(pp_argv[i], OPTION_TRACE) || !strcmp(pp_argv[i], OPTION_TRACE_SHORT))
+        {
+            p_options->b_isTraced = true;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_SLAVE) || !strcmp(pp_argv[i], OPTION_SLAVE_SHORT))
+        {
+            if (++i >= *p_argc)
+            {
+                return false;
+            }
+            p_options->pp_slaveSpecs[p_options->slaveSize++] = pp_argv[i];
+        }
+        else if (!strcmp(pp_argv[i], OPTION_STATS) || !strcmp(pp_argv[i], OPTION_STATS_SHORT))
+        {
+            p_options->statsFormat = statsTable;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_STATS_JSON))
+        {
+            p_options->statsFormat = statsJson;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_MAX_ERRORS) || !strcmp(pp_argv[i], OPTION_MAX_ERRORS_SHORT))
+        {
+            char *p_end;
+            if (++i >= *p_argc)
+            {
+                return false;
+            }
+            const long errorLimit = strtol(pp_argv[i], &p_end, 10);
+            if ((*p_end != '\0') || (p_end == pp_argv[i]) || (errorLimit < 0) || (errorLimit > INT32_MAX))
+            {
+                return false;
+            }
+            p_options->errorLimit = (int) errorLimit;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_ERRORS_JSON))
+        {
+            p_options->errorFormat = diagJson;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_OPTIMIZE) || !strcmp(pp_argv[i], OPTION_OPTIMIZE_SHORT))
+        {
+            p_options->b_isOptimized = true;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_CYCLES) || !strcmp(pp_argv[i], OPTION_CYCLES_SHORT))
+        {
+            p_options->b_isEstimated = true;
+        }
+        else if (!strcmp(pp_argv[i], OPTION_PROFILE) || !strcmp(pp_argv[i], OPTION_PROFILE_SHORT))
+        {
+            if (++i >= *p_argc)
+            {
+                return false;
+            }
+            p_options->p_profilePath = pp_argv[i];
+        }
+        else
+        {
+            pp_argv[argc++] = pp_argv[i];
+        }
+    }
+    *p_argc = argc;
+
+    return true;
+}
+
+/*!
+* @brief Batch mode: compiles each collected source without console echo
+*           and writes one Verilog definition for each program.
+*
+* @param[in] argc Number of positional arguments.
+* @param[in] pp_argv Positional arguments: (1) Verilog working subfolder.
+* @param[in] p_options The parsed options.
+*
+* @return 0, if each program is compiled and written.
+*/
+static int RunBatch (int argc, char **pp_argv, const options_t * const p_options)
+{
+    char verilogWorkFolder[FILE_NAME_LENGTH_LIMIT + 1] = {'\0'};
+    batch_t batch = { NULL, 0, 0 };
+    int progCount = 0;
+    int invalidCount = 0;
+    int failedCount = 0;
+
+    if (argc > 1)
+    {
+        snprintf(verilogWorkFolder, sizeof(verilogWorkFolder), "%s/", pp_argv[1]);
+    }
+    if (argc > 2)
+    {
+        fputs("Too many input arguments.\n", stderr);
+    }
+    StartDisplay(p_options->p_batchInput, "<source>" TARGET_FILE_EXTENSION, VERILOG_DEF_FILE);
+
+    if (!CollectSources(p_options->p_batchInput, &batch))
+    {
+        fprintf(stderr, "No source was detected: '%s'\n", p_options->p_batchInput);
+        CleanupBatch(&batch);
+        return -1;
+    }
+
+    CompileBatch(&batch, (p_options->jobs == JOBS_UNSET) ? DEFAULT_BATCH_JOBS : p_options->jobs);
+
+    // Report the erroneous programs only
+    for (int i = 0; i < batch.size; i++)
+    {
+        const batchJob_t * const p_job = &batch.p_jobs[i];
+        if (!p_job->b_isCompiled)
+        {
+            fprintf(stderr, "=> ERROR in '%s': unable to compile.\n", p_job->p_source);
+            failedCount++;
+        }
+        else if ((p_options->depthBits != INSTR_DEPTH_AUTO) && (GetDepthBits(p_job->progCount) > p_options->depthBits))
+        {
+            fprintf(stderr, "=> ERROR in '%s': %d instruction(s) exceed the instruction memory of 2^%d entries.\n",
+                    p_job->p_source, p_job->progCount, p_options->depthBits);
+            failedCount++;
+        }
+        if (p_job->b_isCompiled && p_job->invalidCount)
+        {
+            fprintf(stderr, "=> ERROR in '%s': %d invalid instruction(s).\n", p_job->p_source, p_job->invalidCount);
+        }
+        progCount += p_job->progCount;
+        invalidCount += p_job->invalidCount;
+    }
+
+    if (!WriteBatchDefFile(VERILOG_DEF_FILE, verilogWorkFolder, &batch, p_options->depthBits))
+    {
+        failedCount++;
+    }
+    printf("Batch: %d program(s), %d instruction(s), %d invalid instruction(s), %d failure(s).\n",
+           batch.size, progCount, invalidCount, failedCount);
+    CleanupBatch(&batch);
+
+    return failedCount ? -1 : 0;
+}
+
+/*!
+* @brief Incremental mode: compiles the source by the cache of the target
+*           and reports the recompiled rows instead of the console echo.
+*
+* @param[in] p_source The source text, cleaned up at return.
+* @param[in] p_targetPath Target file path.
+* @param[in] p_options The parsed options.
+*
+* @return 0 in case of success.
+*/
+static int RunIncremental (sourceText_t * const p_source, const char * const p_targetPath, const options_t * const p_options)
+{
+    cacheStats_t stats;
+
+    program_t * const p_program = CompileIncremental(p_source, p_targetPath, p_options->jobs, &stats);
+    if (p_program == NULL)
+    {
+        CleanupText(p_source);
+        return -1;
+    }
+
+    if (stats.b_isFullBuild)
+    {
+        printf("Full build: %d row(s), %zu byte(s) written.\n", p_program->rowSize, stats.patchSize);
+    }
+    else
+    {
+        printf("Incremental build: %d of %d row(s) recompiled, %zu byte(s) patched from offset %zu.\n",
+               stats.changedLast - stats.changedFirst, p_program->rowSize, stats.patchSize, stats.patchOffset);
+    }
+    NotifyInvalid(p_program);
+    const bool b_isFitting = WriteDepthDef(p_program, p_options);
+
+    CleanupProgram(p_program);
+    CleanupText(p_source);
+
+    return b_isFitting ? 0 : -1;
+}
+
+/*!
+* @brief Appends the instruction memory depth to the Verilog Definition File
+*           and checks if the program fits to it.
+*
+* @param[in] p_program The compiled program.
+* @param[in] p_options The parsed options.
+*
+* @return Valid, if each instruction and the end of simulation fit to the instruction memory.
+*/
+static bool WriteDepthDef (const program_t * const p_program, const options_t * const p_options)
+{
+    const int depthBits = GetDepthBits(p_program->progCount);
+
+    if (p_options->depthBits == INSTR_DEPTH_AUTO)
+    {
+        WriteVerilogDefValue(VERILOG_DEF_FILE, VERILOG_DEPTH_DEF, depthBits, true);
+        return true;
+    }
+
+    WriteVerilogDefValue(VERILOG_DEF_FILE, VERILOG_DEPTH_DEF, p_options->depthBits, true);
+    if (depthBits > p_options->depthBits)
+    {
+        fprintf(stderr, "=> ERROR: %d instruction(s) exceed the instruction memory of 2^%d entries, at least %d address bit(s) are needed.\n",
+                p_program->progCount, p_options->depthBits, depthBits);
+        return false;
+    }
+
+    return true;
+}
+
 /*!
 * @brief Generates the file path depending on the input argument
 *
@@ -127,53 +523,74 @@ static bool GeneratePathes (int argc, char **pp_argv, char *p_source, char *p_ta
     if (argc > 1)
     {
         // Set source path by 2nd input argument
-        strcpy(p_source, pp_argv[1]);
-        // Remove file extension if exists: ".*"
-        int i = 0;
-        while (p_source[i])
+        if (strlen(pp_argv[1]) > FILE_NAME_LENGTH_LIMIT)
         {
-            if (p_source[i] == '.')
-            {
-                p_source[i] = '\0';
-                break;
-            }
-            i++;
+            fputs("Too long source file path.\n", stderr);
+            return false;
         }
+        snprintf(p_source, FILE_NAME_LENGTH_LIMIT + 1, "%s", pp_argv[1]);
+        // Remove file extension if exists: ".*"
+        RemoveExtension(p_source);
 
         // Set Verilog Working Subfolder by 3rd input argument
-        if (argc >= 2)
+        if (argc > 2)
         {
-            snprintf(p_verilogWork, FILE_NAME_LENGTH_LIMIT, "%s/", pp_argv[2]);
+            snprintf(p_verilogWork, FILE_NAME_LENGTH_LIMIT + 1, "%s/", pp_argv[2]);
         }
 
-        if (argc > 2)
+        if (argc > 3)
         {
-            perror("Too many input arguments.");
+            fputs("Too many input arguments.\n", stderr);
         }
     }
 
-    // Format source and compiled target code pathes
-    snprintf(p_target, FILE_NAME_LENGTH_LIMIT, "%s%s", p_source, TARGET_FILE_EXTENSION);
-    snprintf(p_source, FILE_NAME_LENGTH_LIMIT, "%s%s", p_source, SOURCE_FILE_EXTENSION);
+    // Format source and compiled target code pathes, the truncated ones are refused
+    const size_t length = strlen(p_source);
+    const int targetLength = snprintf(p_target, FILE_NAME_LENGTH_LIMIT + 1, "%s%s", p_source, TARGET_FILE_EXTENSION);
+    const int sourceLength = snprintf(p_source + length, FILE_NAME_LENGTH_LIMIT + 1 - length, "%s", SOURCE_FILE_EXTENSION);
+    if ( (targetLength < 0) || (targetLength > FILE_NAME_LENGTH_LIMIT) ||
+         (sourceLength < 0) || (length + (size_t) sourceLength > FILE_NAME_LENGTH_LIMIT) )
+    {
+        fputs("Too long source file path.\n", stderr);
+        return false;
+    }
+
+    return true;
+}
 
-    return ( (p_source == NULL) ||
-             (p_target == NULL) ||
-             (p_verilogWork == NULL) ) ? false : true;
+/*!
+* @brief Prints the source line views to the standard output.
+*
+* @param[in] p_source Source text input.
+*
+* @return void.
+*/
+static inline void PrintText (const sourceText_t * const p_source)
+{
+    for (int i = 0; i < p_source->param.rowSize; i++)
+    {
+        printf("%d. %.*s\n", i + 1, p_source->p_lines[i].length, p_source->p_lines[i].p_text);
+    }
 }
 
 /*!
-* @brief Prints the 1D string array input to the standard output.
+* @brief Prints the rows of the text buffer to the standard output.
 *
-* @param[in] pp_source 1D string array input.
-* @param[in] size Size of the string array.
+* @param[in] p_text Text buffer input, each row is terminated by EOL_CHAR.
 *
 * @return void.
 */
-static inline void PrintText (char ** const pp_source, int size)
+static inline void PrintBuffer (const textBuffer_t * const p_text)
 {
-    for (int i = 0; i < size; i++)
+    const char *p_row = p_text->p_data;
+    const char * const p_end = p_text->p_data + p_text->size;
+    const char *p_eol;
+
+    for (int i = 1; p_row < p_end; i++)
     {
-        printf("%d. %s\n", i + 1, pp_source[i]);
+        p_eol = (const char *) memchr(p_row, EOL_CHAR, (size_t) (p_end - p_row));
+        printf("%d. %.*s\n", i, (int) (p_eol - p_row), p_row);
+        p_row = p_eol + 1;
     }
 }
 
@@ -8,9 +8,16 @@
 #define MAIN_H
 
 #include "file_access.h"
-#include "compile.h"
+#include "compile.h"
+#include "emit.h"
 #include "notify_invalid.h"
-#include "help.h"
+#include "batch.h"
+#include "cache.h"
+#include "watch.h"
+#include "simulation.h"
+#include "timing.h"
+#include "peephole.h"
+#include "help.h"
 
 
 // === Testing ===
@@ -22,18 +29,67 @@
 
 // === Type Definitions ===
 //
+typedef struct options
+{
+    int jobs;                               // Worker threads, 0: one for each processor
+    const char *p_batchInput;               // Batch mode: folder, pattern or manifest
+    bool b_isIncremental;                   // Recompiles the changed rows by the cache of the target
+    char **pp_watchInputs;                  // Watch mode: sources, folders or patterns
+    int watchSize;
+    int depthBits;                          // Instruction memory depth, INSTR_DEPTH_AUTO: fitting the program
+    const char *p_runImage;                 // Run mode: compiled image to be simulated
+    bool b_isTraced;                        // Run mode: prints the signals of each cycle
+    char **pp_slaveSpecs;                   // Run mode: slave models attached to the master
+    int slaveSize;
+    const char *p_profilePath;              // Dump of the performance counters: written by --run, printed by the compile
+    bool b_isEstimated;                     // Static cycle estimate of the compiled code
+    bool b_isOptimized;                     // Peephole optimization of the compiled code
+    statsFormat_t statsFormat;              // Phase statistics of the compilation
+    int errorLimit;                         // Reported errors of a source, DIAG_LIMIT_NONE: each one
+    diagFormat_t errorFormat;               // Report of the errors: text or JSON
+} options_t;
 
 
 // === Constant Definitions ===
 //
-#define FILE_NAME_LENGTH_LIMIT      20
+#define FILE_NAME_LENGTH_LIMIT      FILENAME_MAX
 #define SOURCE_FILE_NAME            "instruction"
-#define SOURCE_FILE_EXTENSION       ".av"
-#define TARGET_FILE_EXTENSION       ".mem"
 #define VERILOG_DEF                 "`define INSTRUCTION_PATH  "
-#define VERILOG_DEF_FILE            "avsim_define.v"
+#define VERILOG_DEF_FILE            "avsim_define.v"
+#define VERILOG_DEPTH_DEF           "`define INSTRUCTION_LIMIT_SIZE  "
 #define RELEASE_DATE                "11-11-2019"
 #define VERSION                     "v2"
+#define OPTION_JOBS                 "--jobs"
+#define OPTION_JOBS_SHORT           "-j"
+#define OPTION_BATCH                "--batch"
+#define OPTION_BATCH_SHORT          "-b"
+#define OPTION_INCREMENTAL          "--incremental"
+#define OPTION_INCREMENTAL_SHORT    "-i"
+#define OPTION_WATCH                "--watch"
+#define OPTION_WATCH_SHORT          "-w"
+#define OPTION_DEPTH                "--depth"
+#define OPTION_DEPTH_SHORT          "-d"
+#define OPTION_RUN                  "--run"
+#define OPTION_RUN_SHORT            "-r"
+#define OPTION_TRACE                "--trace"
+#define OPTION_TRACE_SHORT          "-t"
+#define OPTION_SLAVE                "--slave"
+#define OPTION_SLAVE_SHORT          "-s"
+#define OPTION_PROFILE              "--profile"
+#define OPTION_PROFILE_SHORT        "-p"
+#define OPTION_CYCLES               "--cycles"
+#define OPTION_CYCLES_SHORT         "-c"
+#define OPTION_OPTIMIZE             "--optimize"
+#define OPTION_OPTIMIZE_SHORT       "-O"
+#define OPTION_STATS                "--stats"
+#define OPTION_STATS_SHORT          "-S"
+#define OPTION_STATS_JSON           "--stats-json"
+#define OPTION_MAX_ERRORS           "--max-errors"
+#define OPTION_MAX_ERRORS_SHORT     "-e"
+#define OPTION_ERRORS_JSON          "--errors-json"
+#define DEFAULT_JOBS                1       // Single source: one thread
+#define DEFAULT_BATCH_JOBS          0       // Batch: one thread for each processor
+#define JOBS_UNSET                  -1
 
 // === Macros ===
 //
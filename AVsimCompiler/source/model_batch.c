@@ -0,0 +1,532 @@
+/** @file model_batch.c
+*
+* @brief Lane-parallel simulation of many compiled images on the model of the Avalon master.
+*
+*/
+
+#include "model_batch.h"
+
+// === Type Definitions ===
+//
+typedef struct batchContext
+{
+    modelRun_t *p_runs;
+    int size;
+    uint64_t cycleLimit;
+    laneMasks_t (*p_step)(laneGroup_t * const p_group);     // Kernel of the lanes
+} batchContext_t;
+
+// === Constant Definitions ===
+//
+// Set by SelectModelKernel before the batches, modelKernelAuto: not resolved yet
+static modelKernel_t s_kernel = modelKernelAuto;
+
+// === Protected Functions ===
+//
+/*!
+* @brief Loads the instruction at the program counter of the lane.
+*
+* @param[in,out] p_group The lane group.
+* @param[in] lane Index of the lane.
+*
+* @return void
+*/
+static void FetchLane (laneGroup_t * const p_group, const int lane)
+{
+    const modelImage_t * const p_image = p_group->p_runs[lane]->p_image;
+    const uint32_t pc = p_group->pc[lane];
+
+    if ((pc < p_image->size) && p_image->p_instr[pc].b_isLoaded)
+    {
+        // The offsets of the repeat blocks apply to the bus transfers
+        const uint8_t opCode = p_image->p_instr[pc].opCode;
+        const bool b_isTransfer = (opCode == read) || (opCode == write);
+        p_group->opCode[lane] = opCode;
+        p_group->address[lane] = p_image->p_instr[pc].address + (b_isTransfer ? p_group->loops[lane].addressOffset : 0);
+        p_group->data[lane] = p_image->p_instr[pc].data + ((opCode == write) ? p_group->loops[lane].dataOffset : 0);
+    }
+    else
+    {
+        p_group->opCode[lane] = MODEL_OPCODE_UNKNOWN;
+        p_group->address[lane] = 0;
+        p_group->data[lane] = 0;
+    }
+}
+
+/*!
+* @brief Resets the lane to the state after the reset of the HDL, then starts the program,
+*           or leaves the lane idle at the end of simulation without program.
+*
+* @param[in,out] p_group The lane group.
+* @param[in] lane Index of the lane.
+* @param[in] p_run The program, NULL: idle lane.
+*
+* @return void
+*/
+static void StartLane (laneGroup_t * const p_group, const int lane, modelRun_t * const p_run)
+{
+    uint32_t * const p_registers[] =
+    {
+        p_group->pc, p_group->setup, p_group->readWait, p_group->writeWait, p_group->hold, p_group->readLatency,
+        p_group->setupStore, p_group->readWaitStore, p_group->writeWaitStore, p_group->holdStore,
+        p_group->readLatencyStore, p_group->waitCount, p_group->wait
+    };
+
+    for (int i = 0; i < (int) (sizeof(p_registers) / sizeof(p_registers[0])); i++)
+    {
+        p_registers[i][lane] = 0;
+    }
+    memset(&p_group->loops[lane], 0, sizeof(loopStack_t));
+    p_group->p_runs[lane] = p_run;
+    p_group->cycle[lane] = 0;
+    p_group->instrCount[lane] = 0;
+
+    if (p_run == NULL)
+    {
+        p_group->state[lane] = stPcIncr;
+        p_group->opCode[lane] = MODEL_OPCODE_UNKNOWN;
+        p_group->pcMask[lane] = 0;
+        return;
+    }
+    p_group->state[lane] = stFetch;
+    p_group->pcMask[lane] = (uint32_t) ((UINT64_C(1) << p_run->depthBits) - 1);
+    FetchLane(p_group, lane);
+}
+
+/*!
+* @brief Simulates the program on the scalar model: the lanes step the single transfers only.
+*
+* @param[in,out] p_run The program, the log and the results are filled.
+* @param[in] cycleLimit Maximum number of cycles.
+*
+* @return void
+*/
+static void RunScalar (modelRun_t * const p_run, const uint64_t cycleLimit)
+{
+    avalonModel_t model;
+
+    ResetModel(&model, p_run->p_image, p_run->depthBits, NULL, NULL);
+    p_run->b_isReady = RunModel(&model, cycleLimit, &p_run->log);
+    p_run->b_isFailed = !p_run->b_isReady && (model.cycle < cycleLimit);
+    p_run->cycle = model.cycle;
+    p_run->instrCount = model.instrCount;
+}
+
+/*!
+* @brief Returns with the next program of the lanes, the programs out of MODEL_LANE_OPCODES
+*           are simulated on the scalar model meanwhile.
+*
+* @param[in] p_batch The batch context.
+* @param[in,out] p_next Index of the next program of the task.
+* @param[in] last Index after the last program of the task.
+*
+* @return The program, NULL: idle lane.
+*/
+static modelRun_t *TakeRun (const batchContext_t * const p_batch, int * const p_next, const int last)
+{
+    while (*p_next < last)
+    {
+        modelRun_t * const p_run = &p_batch->p_runs[(*p_next)++];
+        if (!(p_run->p_image->opCodeMask & ~MODEL_LANE_OPCODES) && !p_run->p_image->loadModes)
+        {
+            return p_run;
+        }
+        RunScalar(p_run, p_batch->cycleLimit);
+    }
+
+    return NULL;
+}
+
+/*!
+* @brief Fast-forward over the idle span of the lane, like SkipIdleCycles of the model.
+*
+* @param[in,out] p_group The lane group.
+* @param[in] lane Index of the lane.
+* @param[in] cycleLimit Maximum number of cycles.
+*
+* @return void
+*/
+static void SkipLane (laneGroup_t * const p_group, const int lane, const uint64_t cycleLimit)
+{
+    const uint64_t cycleLeft = cycleLimit - p_group->cycle[lane];
+    uint64_t span;
+
+    switch (p_group->state[lane])
+    {
+        case stWait:
+            span = (uint32_t) (p_group->wait[lane] - 1 - p_group->waitCount[lane]);
+            span = (span < cycleLeft) ? span : cycleLeft;
+            p_group->waitCount[lane] += (uint32_t) span;
+            p_group->cycle[lane] += span;
+        return;
+        case stReadTiming:
+        case stWriteTiming:
+            span = (uint64_t) p_group->setup[lane] +
+                   ((p_group->state[lane] == stReadTiming) ? p_group->readWait[lane] : p_group->writeWait[lane]);
+            if (span < cycleLeft)
+            {
+                p_group->setup[lane] = 0;
+                p_group->readWait[lane] = (p_group->state[lane] == stReadTiming) ? 0 : p_group->readWait[lane];
+                p_group->writeWait[lane] = (p_group->state[lane] == stWriteTiming) ? 0 : p_group->writeWait[lane];
+                p_group->cycle[lane] += span;
+            }
+        return;
+        case stReadLatency:
+            if (p_group->readLatency[lane] < cycleLeft)
+            {
+                p_group->cycle[lane] += p_group->readLatency[lane];
+                p_group->readLatency[lane] = 0;
+            }
+        return;
+        case stWriteHold:
+            if (p_group->hold[lane] < cycleLeft)
+            {
+                p_group->cycle[lane] += p_group->hold[lane];
+                p_group->hold[lane] = 0;
+            }
+        return;
+        default:
+            // Active state
+        return;
+    }
+}
+
+#ifdef MODEL_AVX2
+/*!
+* @brief AVX2 kernel: simulates one clock cycle of each lane by masked updates.
+*           Compiled for AVX2 without -mavx2, called only if the processor supports it.
+*
+* @param[in,out] p_group The lane group.
+*
+* @return The lanes with bus event, incremented program counter or at the end of the program.
+*/
+__attribute__((target("avx2")))
+static laneMasks_t StepLanesAvx2 (laneGroup_t * const p_group)
+{
+#   define LOAD_LANES(field)        _mm256_loadu_si256((const __m256i *) p_group->field)
+#   define STORE_LANES(field, x)    _mm256_storeu_si256((__m256i *) p_group->field, (x))
+#   define EQUAL(x, value)          _mm256_cmpeq_epi32((x), _mm256_set1_epi32(value))
+#   define AND_NOT(x, y)            _mm256_andnot_si256((y), (x))   // x & ~y
+#   define SELECT(x, y, mask)       _mm256_blendv_epi8((x), (y), (mask))
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i state = LOAD_LANES(state);
+    const __m256i opCode = LOAD_LANES(opCode);
+    const __m256i setup = LOAD_LANES(setup);
+    const __m256i readWait = LOAD_LANES(readWait);
+    const __m256i writeWait = LOAD_LANES(writeWait);
+    const __m256i hold = LOAD_LANES(hold);
+    const __m256i readLatency = LOAD_LANES(readLatency);
+    const __m256i waitCount = LOAD_LANES(waitCount);
+    const __m256i waitLimit = LOAD_LANES(wait);
+    laneMasks_t masks;
+
+    const __m256i isFetch = EQUAL(state, stFetch);
+    const __m256i isReadTiming = EQUAL(state, stReadTiming);
+    const __m256i isReadLatency = EQUAL(state, stReadLatency);
+    const __m256i isWriteTiming = EQUAL(state, stWriteTiming);
+    const __m256i isWriteHold = EQUAL(state, stWriteHold);
+    const __m256i isWait = EQUAL(state, stWait);
+    const __m256i isLoad = EQUAL(state, stLoad);
+    const __m256i isPcIncr = EQUAL(state, stPcIncr);
+    const __m256i isReady = EQUAL(opCode, MODEL_OPCODE_UNKNOWN);
+
+    // Countdowns: setup, then the strobe, then the latency or hold
+    const __m256i isSetup = AND_NOT(_mm256_or_si256(isReadTiming, isWriteTiming), EQUAL(setup, 0));
+    const __m256i isStrobe = AND_NOT(_mm256_or_si256(isReadTiming, isWriteTiming), isSetup);
+    const __m256i isReadWait = AND_NOT(_mm256_and_si256(isStrobe, isReadTiming), EQUAL(readWait, 0));
+    const __m256i isReadEnd = AND_NOT(_mm256_and_si256(isStrobe, isReadTiming), isReadWait);
+    const __m256i isLatencyStart = AND_NOT(isReadEnd, EQUAL(readLatency, 0));
+    const __m256i isLatency = AND_NOT(isReadLatency, EQUAL(readLatency, 0));
+    const __m256i isWriteWait = AND_NOT(_mm256_and_si256(isStrobe, isWriteTiming), EQUAL(writeWait, 0));
+    const __m256i isWriteEnd = AND_NOT(_mm256_and_si256(isStrobe, isWriteTiming), isWriteWait);
+    const __m256i isHoldStart = AND_NOT(isWriteEnd, EQUAL(hold, 0));
+    const __m256i isHold = AND_NOT(isWriteHold, EQUAL(hold, 0));
+    const __m256i isReadDataEN = _mm256_or_si256(AND_NOT(isReadEnd, isLatencyStart), AND_NOT(isReadLatency, isLatency));
+    const __m256i isWaitEnd = _mm256_and_si256(isWait, _mm256_cmpeq_epi32(waitCount, _mm256_add_epi32(waitLimit, _mm256_set1_epi32(-1))));
+    const __m256i isNext = AND_NOT(isPcIncr, isReady);
+
+    // FETCH: the operating code selects the next state and the timing copies
+    const __m256i isReadFetch = _mm256_and_si256(isFetch, EQUAL(opCode, read));
+    const __m256i isWriteFetch = _mm256_and_si256(isFetch, EQUAL(opCode, write));
+    const __m256i fetchState = SELECT(_mm256_permutevar8x32_epi32(_mm256_setr_epi32(stPcIncr, stReadTiming, stWriteTiming,
+                                                                                  stWait, stLoad, stPcIncr, stPcIncr, stPcIncr), opCode),
+                                      _mm256_set1_epi32(stPcIncr), _mm256_cmpgt_epi32(opCode, _mm256_set1_epi32(load)));
+
+    // Decrement by adding the all-ones masks
+    STORE_LANES(setup, SELECT(_mm256_add_epi32(setup, isSetup), LOAD_LANES(setupStore), _mm256_or_si256(isReadFetch, isWriteFetch)));
+    STORE_LANES(readWait, SELECT(_mm256_add_epi32(readWait, isReadWait), LOAD_LANES(readWaitStore), isReadFetch));
+    STORE_LANES(readLatency, SELECT(_mm256_add_epi32(readLatency, _mm256_or_si256(isLatencyStart, isLatency)),
+                                    LOAD_LANES(readLatencyStore), isReadFetch));
+    STORE_LANES(writeWait, SELECT(_mm256_add_epi32(writeWait, isWriteWait), LOAD_LANES(writeWaitStore), isWriteFetch));
+    STORE_LANES(hold, SELECT(_mm256_add_epi32(hold, _mm256_or_si256(isHoldStart, isHold)), LOAD_LANES(holdStore), isWriteFetch));
+    STORE_LANES(wait, SELECT(waitLimit, SELECT(_mm256_set1_epi32(AVALON_DELAY), LOAD_LANES(data), EQUAL(opCode, wait)), isFetch));
+    STORE_LANES(waitCount, _mm256_and_si256(_mm256_sub_epi32(waitCount, _mm256_set1_epi32(-1)), isWait));
+
+    // LOAD: the timing copies are latched from the instruction
+    const __m256i data = LOAD_LANES(data);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    STORE_LANES(setupStore, SELECT(LOAD_LANES(setupStore), _mm256_and_si256(LOAD_LANES(address), byteMask), isLoad));
+    STORE_LANES(holdStore, SELECT(LOAD_LANES(holdStore), _mm256_srli_epi32(data, 24), isLoad));
+    STORE_LANES(readLatencyStore, SELECT(LOAD_LANES(readLatencyStore), _mm256_and_si256(_mm256_srli_epi32(data, 16), byteMask), isLoad));
+    STORE_LANES(writeWaitStore, SELECT(LOAD_LANES(writeWaitStore), _mm256_and_si256(_mm256_srli_epi32(data, 8), byteMask), isLoad));
+    STORE_LANES(readWaitStore, SELECT(LOAD_LANES(readWaitStore), _mm256_and_si256(data, byteMask), isLoad));
+
+    const __m256i pc = LOAD_LANES(pc);
+    STORE_LANES(pc, SELECT(pc, _mm256_and_si256(_mm256_sub_epi32(pc, _mm256_set1_epi32(-1)), LOAD_LANES(pcMask)), isNext));
+
+    // Next state
+    __m256i stateNext = SELECT(state, fetchState, isFetch);
+    stateNext = SELECT(stateNext, _mm256_set1_epi32(stReadLatency), isLatencyStart);
+    stateNext = SELECT(stateNext, _mm256_set1_epi32(stWriteHold), isHoldStart);
+    stateNext = SELECT(stateNext, _mm256_set1_epi32(stWait),
+                       _mm256_or_si256(isReadDataEN, _mm256_or_si256(AND_NOT(isWriteEnd, isHoldStart), AND_NOT(isWriteHold, isHold))));
+    stateNext = SELECT(stateNext, _mm256_set1_epi32(stPcIncr), _mm256_or_si256(isWaitEnd, isLoad));
+    stateNext = SELECT(stateNext, zero, isNext);
+    STORE_LANES(state, stateNext);
+
+    // Idle span of the next cycle: WAIT before its last cycle, or a nonzero countdown
+    const __m256i isWaitIdle = AND_NOT(EQUAL(stateNext, stWait),
+                                       _mm256_cmpeq_epi32(LOAD_LANES(waitCount), _mm256_add_epi32(LOAD_LANES(wait), _mm256_set1_epi32(-1))));
+    const __m256i isReadIdle = AND_NOT(EQUAL(stateNext, stReadTiming), EQUAL(_mm256_or_si256(LOAD_LANES(setup), LOAD_LANES(readWait)), 0));
+    const __m256i isWriteIdle = AND_NOT(EQUAL(stateNext, stWriteTiming), EQUAL(_mm256_or_si256(LOAD_LANES(setup), LOAD_LANES(writeWait)), 0));
+    const __m256i isLatencyIdle = AND_NOT(EQUAL(stateNext, stReadLatency), EQUAL(LOAD_LANES(readLatency), 0));
+    const __m256i isHoldIdle = AND_NOT(EQUAL(stateNext, stWriteHold), EQUAL(LOAD_LANES(hold), 0));
+    const __m256i isIdle = _mm256_or_si256(_mm256_or_si256(isWaitIdle, isReadIdle),
+                                           _mm256_or_si256(isWriteIdle, _mm256_or_si256(isLatencyIdle, isHoldIdle)));
+
+    masks.read = (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(isReadDataEN));
+    masks.event = masks.read | (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(isWriteEnd));
+    masks.next = (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(isNext));
+    masks.ready = (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(isPcIncr, isReady)));
+    masks.idle = (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(isIdle));
+
+    return masks;
+#   undef LOAD_LANES
+#   undef STORE_LANES
+#   undef EQUAL
+#   undef AND_NOT
+#   undef SELECT
+}
+#endif // MODEL_AVX2
+
+/*!
+* @brief Scalar kernel: simulates one clock cycle of each lane by branch-free updates.
+*
+* @param[in,out] p_group The lane group.
+*
+* @return The lanes with bus event, incremented program counter or at the end of the program.
+*/
+static laneMasks_t StepLanesScalar (laneGroup_t * const p_group)
+{
+    static const uint8_t FETCH_STATE[MODEL_OPCODE_UNKNOWN + 1] =
+    {
+        stPcIncr, stReadTiming, stWriteTiming, stWait, stLoad, stPcIncr, stPcIncr, stPcIncr, stPcIncr,
+        stPcIncr, stPcIncr, stPcIncr, stPcIncr, stPcIncr, stPcIncr, stPcIncr, stPcIncr
+    };
+    laneMasks_t masks = { 0, 0, 0, 0, 0 };
+
+    for (int i = 0; i < MODEL_LANES; i++)
+    {
+        const uint32_t state = p_group->state[i];
+        const uint32_t opCode = p_group->opCode[i];
+        const bool b_isTiming = (state == stReadTiming) || (state == stWriteTiming);
+        const bool b_isSetup = b_isTiming && p_group->setup[i];
+        const bool b_isStrobe = b_isTiming && !p_group->setup[i];
+        const bool b_isReadWait = b_isStrobe && (state == stReadTiming) && p_group->readWait[i];
+        const bool b_isReadEnd = b_isStrobe && (state == stReadTiming) && !p_group->readWait[i];
+        const bool b_isLatencyStart = b_isReadEnd && p_group->readLatency[i];
+        const bool b_isLatency = (state == stReadLatency) && p_group->readLatency[i];
+        const bool b_isWriteWait = b_isStrobe && (state == stWriteTiming) && p_group->writeWait[i];
+        const bool b_isWriteEnd = b_isStrobe && (state == stWriteTiming) && !p_group->writeWait[i];
+        const bool b_isHoldStart = b_isWriteEnd && p_group->hold[i];
+        const bool b_isHold = (state == stWriteHold) && p_group->hold[i];
+        const bool b_isReadDataEN = (b_isReadEnd && !b_isLatencyStart) || ((state == stReadLatency) && !b_isLatency);
+        const bool b_isWaitEnd = (state == stWait) && (p_group->waitCount[i] == p_group->wait[i] - 1);
+        const bool b_isReady = (opCode == MODEL_OPCODE_UNKNOWN);
+        const bool b_isNext = (state == stPcIncr) && !b_isReady;
+        const bool b_isReadFetch = (state == stFetch) && (opCode == read);
+        const bool b_isWriteFetch = (state == stFetch) && (opCode == write);
+        uint32_t stateNext = state;
+
+        p_group->setup[i] = (b_isReadFetch || b_isWriteFetch) ? p_group->setupStore[i] : p_group->setup[i] - b_isSetup;
+        p_group->readWait[i] = b_isReadFetch ? p_group->readWaitStore[i] : p_group->readWait[i] - b_isReadWait;
+        p_group->readLatency[i] = b_isReadFetch ? p_group->readLatencyStore[i] :
+                                  p_group->readLatency[i] - (b_isLatencyStart || b_isLatency);
+        p_group->writeWait[i] = b_isWriteFetch ? p_group->writeWaitStore[i] : p_group->writeWait[i] - b_isWriteWait;
+        p_group->hold[i] = b_isWriteFetch ? p_group->holdStore[i] : p_group->hold[i] - (b_isHoldStart || b_isHold);
+        if (state == stFetch)
+        {
+            p_group->wait[i] = (opCode == wait) ? p_group->data[i] : AVALON_DELAY;
+            stateNext = FETCH_STATE[opCode];
+        }
+        p_group->waitCount[i] = (state == stWait) ? p_group->waitCount[i] + 1 : 0;
+        if (state == stLoad)
+        {
+            p_group->setupStore[i] = p_group->address[i] & 0xFF;
+            p_group->holdStore[i] = p_group->data[i] >> 24;
+            p_group->readLatencyStore[i] = (p_group->data[i] >> 16) & 0xFF;
+            p_group->writeWaitStore[i] = (p_group->data[i] >> 8) & 0xFF;
+            p_group->readWaitStore[i] = p_group->data[i] & 0xFF;
+        }
+        p_group->pc[i] = b_isNext ? (p_group->pc[i] + 1) & p_group->pcMask[i] : p_group->pc[i];
+
+        stateNext = b_isLatencyStart ? stReadLatency : stateNext;
+        stateNext = b_isHoldStart ? stWriteHold : stateNext;
+        stateNext = (b_isReadDataEN || (b_isWriteEnd && !b_isHoldStart) || ((state == stWriteHold) && !b_isHold)) ? stWait : stateNext;
+        stateNext = (b_isWaitEnd || (state == stLoad)) ? stPcIncr : stateNext;
+        p_group->state[i] = b_isNext ? stFetch : stateNext;
+
+        // Idle span of the next cycle: WAIT before its last cycle, or a nonzero countdown
+        const bool b_isIdle = ((stateNext == stWait) && (p_group->waitCount[i] != p_group->wait[i] - 1)) ||
+                              ((stateNext == stReadTiming) && (p_group->setup[i] || p_group->readWait[i])) ||
+                              ((stateNext == stWriteTiming) && (p_group->setup[i] || p_group->writeWait[i])) ||
+                              ((stateNext == stReadLatency) && p_group->readLatency[i]) ||
+                              ((stateNext == stWriteHold) && p_group->hold[i]);
+
+        masks.read |= (uint32_t) b_isReadDataEN << i;
+        masks.event |= (uint32_t) (b_isReadDataEN || b_isWriteEnd) << i;
+        masks.next |= (uint32_t) b_isNext << i;
+        masks.ready |= (uint32_t) ((state == stPcIncr) && b_isReady) << i;
+        masks.idle |= (uint32_t) b_isIdle << i;
+    }
+
+    return masks;
+}
+
+static inline bool IsAvx2Supported (void)
+{
+#ifdef MODEL_AVX2
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif // MODEL_AVX2
+}
+
+/*!
+* @brief Simulates the programs of one worker task, each lane takes the next program when it is finished.
+*
+* @param[in,out] p_context The batch context.
+* @param[in] task Index of the task.
+*
+* @return void
+*/
+static void RunGroup (void *p_context, int task)
+{
+    const batchContext_t * const p_batch = (const batchContext_t *) p_context;
+    const int last = ((task + 1) * MODEL_BATCH_PROGRAMS < p_batch->size) ? (task + 1) * MODEL_BATCH_PROGRAMS : p_batch->size;
+    int next = task * MODEL_BATCH_PROGRAMS;
+    uint32_t activeMask = 0;
+    laneGroup_t group;
+
+    memset(&group, 0, sizeof(group));
+    for (int i = 0; i < MODEL_LANES; i++)
+    {
+        StartLane(&group, i, TakeRun(p_batch, &next, last));
+        activeMask |= (uint32_t) (group.p_runs[i] != NULL) << i;
+    }
+
+    while (activeMask)
+    {
+        const laneMasks_t masks = p_batch->p_step(&group);
+
+        // Bus transactions: the readdata input is 0
+        for (uint32_t lanes = masks.event & activeMask; lanes; lanes &= lanes - 1)
+        {
+            const int i = __builtin_ctz(lanes);
+            const bool b_isRead = (masks.read >> i) & 1;
+            const modelEvent_t event =
+            {
+                group.cycle[i], group.pc[i], group.address[i], b_isRead ? 0 : group.data[i],
+                b_isRead ? eventRead : eventWrite
+            };
+            if (!group.p_runs[i]->b_isFailed && !AppendEvent(&group.p_runs[i]->log, &event))
+            {
+                group.p_runs[i]->b_isFailed = true;
+            }
+        }
+        for (uint32_t lanes = masks.next & activeMask; lanes; lanes &= lanes - 1)
+        {
+            const int i = __builtin_ctz(lanes);
+            if ((group.opCode[i] == loop) || (group.opCode[i] == loopEnd))
+            {
+                const modelInstr_t instr = { group.address[i], group.data[i], (uint8_t) group.opCode[i], true };
+                group.pc[i] = StepLoop(&group.loops[i], &instr, group.pc[i]);
+            }
+            group.instrCount[i]++;
+            FetchLane(&group, i);
+        }
+        for (int i = 0; i < MODEL_LANES; i++)
+        {
+            group.cycle[i]++;
+        }
+        for (uint32_t lanes = masks.idle & activeMask; lanes; lanes &= lanes - 1)
+        {
+            SkipLane(&group, __builtin_ctz(lanes), p_batch->cycleLimit);
+        }
+
+        // Finished lanes: the end of the program or the cycle limit
+        for (uint32_t lanes = activeMask; lanes; lanes &= lanes - 1)
+        {
+            const int i = __builtin_ctz(lanes);
+            const bool b_isReady = (masks.ready >> i) & 1;
+            if (!b_isReady && (group.cycle[i] < p_batch->cycleLimit))
+            {
+                continue;
+            }
+
+            modelRun_t * const p_run = group.p_runs[i];
+            p_run->cycle = group.cycle[i];
+            p_run->instrCount = group.instrCount[i];
+            p_run->b_isReady = b_isReady;
+            StartLane(&group, i, TakeRun(p_batch, &next, last));
+            activeMask &= ~((uint32_t) (group.p_runs[i] == NULL) << i);
+        }
+    }
+}
+
+// === Public API Functions ===
+//
+bool RunModelBatch (modelRun_t * const p_runs, const int size, const uint64_t cycleLimit, const int jobs)
+{
+    batchContext_t batch = { p_runs, size, cycleLimit, StepLanesScalar };
+    bool b_isLogged = true;
+
+#ifdef MODEL_AVX2
+    if (GetModelKernel() == modelKernelAvx2)
+    {
+        batch.p_step = StepLanesAvx2;
+    }
+#endif // MODEL_AVX2
+
+    RunParallel(jobs, (size + MODEL_BATCH_PROGRAMS - 1) / MODEL_BATCH_PROGRAMS, RunGroup, &batch);
+    for (int i = 0; i < size; i++)
+    {
+        b_isLogged = b_isLogged && !p_runs[i].b_isFailed;
+    }
+
+    return b_isLogged;
+}
+
+bool SelectModelKernel (const modelKernel_t kernel)
+{
+    if ((kernel == modelKernelAvx2) && !IsAvx2Supported())
+    {
+        return false;
+    }
+    s_kernel = (kernel == modelKernelAuto) ? (IsAvx2Supported() ? modelKernelAvx2 : modelKernelScalar) : kernel;
+
+    return true;
+}
+
+modelKernel_t GetModelKernel (void)
+{
+    if (s_kernel == modelKernelAuto)
+    {
+        SelectModelKernel(modelKernelAuto);
+    }
+
+    return s_kernel;
+}
+
+/*** EOF ***/
@@ -0,0 +1,128 @@
+/** @file model_batch.h
+*
+* @brief Lane-parallel simulation of many compiled images on the model of the Avalon master.
+*
+*/
+
+#ifndef MODEL_BATCH_H
+#define MODEL_BATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "avalon_model.h"
+#include "parallel.h"
+
+// The AVX2 kernel is built for each x86 target and selected at run time
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(MODEL_NO_SIMD)
+# define MODEL_AVX2
+# include <immintrin.h>
+#endif
+
+// === Constant Definitions ===
+//
+#define MODEL_LANES             8           // Programs stepped together: 8 x 32-bit lanes of AVX2
+#define MODEL_BATCH_PROGRAMS    64          // Programs of a worker task, the lanes are refilled from them
+#define MODEL_OPCODE_UNKNOWN    0x10        // Unknown instruction: end of the program
+#define MODEL_LANE_OPCODES      ((UINT32_C(1) << burstRead) - 1)    // Operating codes stepped on the lanes
+
+// === Type Definitions ===
+//
+typedef enum
+{
+    modelKernelAuto = 0,            // AVX2 if the processor supports it, scalar otherwise
+    modelKernelScalar,
+    modelKernelAvx2
+} modelKernel_t;
+
+typedef struct modelRun
+{
+    const modelImage_t *p_image;    // Image of the program
+    int depthBits;                  // INSTR_LIMIT_SIZE of the program
+    eventLog_t log;                 // Bus transactions of the program
+    uint64_t cycle;                 // Number of simulated cycles
+    uint64_t instrCount;            // Number of executed instructions
+    bool b_isReady;                 // The end of the program is reached within the cycle limit
+    bool b_isFailed;                // The log could not be stored
+} modelRun_t;
+
+typedef struct laneGroup
+{
+    // Registers of avalon_master, one lane for each program
+    uint32_t state[MODEL_LANES];
+    uint32_t pc[MODEL_LANES];
+    uint32_t setup[MODEL_LANES];
+    uint32_t readWait[MODEL_LANES];
+    uint32_t writeWait[MODEL_LANES];
+    uint32_t hold[MODEL_LANES];
+    uint32_t readLatency[MODEL_LANES];
+    uint32_t setupStore[MODEL_LANES];
+    uint32_t readWaitStore[MODEL_LANES];
+    uint32_t writeWaitStore[MODEL_LANES];
+    uint32_t holdStore[MODEL_LANES];
+    uint32_t readLatencyStore[MODEL_LANES];
+    uint32_t waitCount[MODEL_LANES];
+    uint32_t wait[MODEL_LANES];
+    // Instruction at the program counter
+    uint32_t opCode[MODEL_LANES];   // MODEL_OPCODE_UNKNOWN: end of the program
+    uint32_t address[MODEL_LANES];
+    uint32_t data[MODEL_LANES];
+    uint32_t pcMask[MODEL_LANES];
+    loopStack_t loops[MODEL_LANES];     // Repeat blocks: executed out of the kernel when the program counter steps
+    // Lane assignment
+    modelRun_t *p_runs[MODEL_LANES];    // NULL: idle lane
+    uint64_t cycle[MODEL_LANES];        // Cycle of the program, the idle spans are skipped per lane
+    uint64_t instrCount[MODEL_LANES];
+} laneGroup_t;
+
+typedef struct laneMasks
+{
+    uint32_t event;                 // Read data capture or last cycle of the write strobe
+    uint32_t read;                  // Read data capture
+    uint32_t next;                  // The program counter is incremented
+    uint32_t ready;                 // The end of the program is reached
+    uint32_t idle;                  // The next cycle starts an idle span: WAIT or a countdown
+} laneMasks_t;
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*!
+* @brief Simulates each program until its end or the cycle limit. The programs are
+*           stepped in groups of MODEL_LANES lanes, each finished lane takes the next program.
+*           The programs with bursts or load modes are simulated on the scalar model by the same worker.
+*           The readdata input is 0, there is no slave: the idle spans are skipped
+*           like by RunModel.
+*
+* @param[in,out] p_runs The programs, the logs and the results are filled.
+* @param[in] size Number of programs.
+* @param[in] cycleLimit Maximum number of cycles of a program.
+* @param[in] jobs Worker threads, 0: one for each processor.
+*
+* @return MEMORY ALLOCATION: Returns with true if each log could be stored.
+*/
+bool RunModelBatch (modelRun_t * const p_runs, const int size, const uint64_t cycleLimit, const int jobs);
+
+/*!
+* @brief Selects the kernel of RunModelBatch, set before the batches.
+*
+* @param[in] kernel The kernel, modelKernelAuto: by the processor.
+*
+* @return Returns with false if the build or the processor does not support the kernel, the selection is kept.
+*/
+bool SelectModelKernel (const modelKernel_t kernel);
+
+/*!
+* @brief Returns with the kernel of RunModelBatch: modelKernelScalar or modelKernelAvx2.
+*/
+modelKernel_t GetModelKernel (void);
+
+#endif // MODEL_BATCH_H
+
+/*** EOF ***/
@@ -1,6 +1,6 @@
 /** @file notify_invalid.c
 *
-* @brief Checks for invalid compiles and notifies via std error.
+* @brief Reports the errors recorded by the compilation via std error.
 *
 */
 
@@ -13,46 +13,70 @@
 // === Public API Functions ===
 //
 /*!
-* @brief This function...
+* @brief Reports the errors recorded by the compilation, at most the error limit of them.
+*           The text report prints a row for each error, the JSON report an object for each error
+*           and a summary object, one in each row.
 *
-* @param[in] num1 pp_source Compiled string array to be checked.
-* @param[in] num2 length The size of the 1D string array input.
+* @param[in] p_program Compiled program to be reported.
 *
 * @return void
-*/
-void NotifyInvalid (char ** const pp_source, const int length)
+*/
+void NotifyInvalid (const program_t * const p_program)
 {
-    bool b_invalid = false;
-    int j = 0;
-    int z = 0;
-
-    for (int i = 0; i < length; i++)
+    const diagList_t * const p_errors = &p_program->diagnostics;
+    const bool b_isJson = (GetDiagnosticFormat() == diagJson);
+
+    for (int i = 0; i < p_errors->size; i++)
     {
-        // Detect Instruction error
-        if (PC_REG_PATTERN[1] != pp_source[i][1])
+        const diagnostic_t * const p_error = &p_errors->p_items[i];
+        const srcError * const p_field = &ERROR_LUT[p_error->field];
+        const srcReason * const p_reason = &REASON_LUT[p_error->reason];
+        if (b_isJson)
         {
-            j = 2;
-            z = 0;
-            while (pp_source[i][j])
-            {
-                if (pp_source[i][j] == OUTPUT_DELIM)
-                {
-                    z++;
-                }
-                if (pp_source[i][j] == INVALID)
-                {
-                    fprintf(stderr, "%s %d.: Instruction '%s' error.\n", ERROR_MSG, i + 1, ERROR_LUT[z].p_message);
-                    b_invalid = true;
-                }
-                j++;
-            }
-        }
-    }
-
-    if (!b_invalid)
-    {
-        perror("Successfully compiled without error.");
-    }
+            fprintf(stderr, "{\"line\":%d,\"column\":%u,\"field\":\"%s\",\"reason\":\"%s\",\"message\":\"%s\"}\n",
+                    p_error->row + 1, p_error->column, p_field->p_key, p_reason->p_key, p_reason->p_message);
+        }
+        else
+        {
+            fprintf(stderr, "%s %d, column %u: Instruction '%s' error: %s.\n", ERROR_MSG, p_error->row + 1, p_error->column,
+                    p_field->p_message, p_reason->p_message);
+        }
+    }
+
+    if (b_isJson)
+    {
+        fprintf(stderr, "{\"errors\":%d,\"reported\":%d}\n", p_errors->total, p_errors->size);
+    }
+    else if (p_errors->total > p_errors->size)
+    {
+        fprintf(stderr, "%s %d more error(s) are not reported.\n", ERROR_LIMIT_MSG, p_errors->total - p_errors->size);
+    }
+    else if (p_errors->total == 0)
+    {
+        perror("Successfully compiled without error.");
+    }
+}
+
+/*!
+* @brief Counts the invalid instructions of the compiled records without reporting.
+*
+* @param[in] p_program Compiled program to be checked.
+*
+* @return Number of invalid instructions.
+*/
+int CountInvalid (const program_t * const p_program)
+{
+    int invalidCount = 0;
+
+    for (int i = 0; i < p_program->rowSize; i++)
+    {
+        if (p_program->p_records[i].flags & RECORD_ERROR)
+        {
+            invalidCount++;
+        }
+    }
+
+    return invalidCount;
 }
 
 /*** EOF ***/
@@ -1,6 +1,6 @@
 /** @file notify_invalid.h
 *
-* @brief Checks for invalid compiles and notifies via std_err.
+* @brief Reports the errors recorded by the compilation via std_err.
 *
 */
 
@@ -14,28 +14,47 @@
 
 // === Type Definitions ===
 //
-typedef enum
+typedef struct
 {
-    opCode,
-    address,
-    data
-} error_t;
+    char *p_message;
+    diagField_t field;
+    char *p_key;            // Name in the JSON report
+} srcError;
 
 typedef struct
 {
+    char *p_key;            // Name in the JSON report
     char *p_message;
-    error_t error;
-} srcError;
+    diagReason_t reason;
+} srcReason;
 
 // === Constant Definitions ===
 //
 #define ERROR_MSG   "=> ERROR at line"
+#define ERROR_LIMIT_MSG "=> ERROR limit reached:"
 
 static srcError const ERROR_LUT[] =
 {
-    { "OPCODE", opCode },
-    { "ADDRESS", address },
-    { "DATA", data },
+    { "OPCODE", diagOpCode, "opcode" },
+    { "ADDRESS", diagAddress, "address" },
+    { "DATA", diagData, "data" },
+    { "NESTING", diagNesting, "nesting" },
+    { "BURST", diagBurst, "burst" },
+};
+
+static srcReason const REASON_LUT[] =
+{
+    { "unknown_opcode", "unknown operating code", reasonUnknownOpCode },
+    { "not_hexadecimal", "not a hexadecimal number", reasonNotHexa },
+    { "too_long", "longer than 8 hexadecimal digits", reasonTooLong },
+    { "zero_repeat", "repeat block without iteration", reasonZeroRepeat },
+    { "burst_length", "burst length out of 1..128", reasonBurstLength },
+    { "load_mode", "reserved LOAD mode bits", reasonLoadMode },
+    { "too_deep", "repeat block deeper than 4 levels", reasonTooDeep },
+    { "unmatched_end", "end without repeat", reasonUnmatchedEnd },
+    { "unclosed_repeat", "repeat without end", reasonUnclosedRepeat },
+    { "missing_beats", "burst write without its beats", reasonMissingBeats },
+    { "stray_beat", "beat out of a burst write", reasonStrayBeat },
 };
 
 // === Macros ===
@@ -44,7 +63,8 @@ static srcError const ERROR_LUT[] =
 
 // === Public API Functions ===
 //
-void NotifyInvalid (char **pp_source, const int length);
+void NotifyInvalid (const program_t * const p_program);
+int CountInvalid (const program_t * const p_program);
 
 #endif // NOTIFY_INVALID_H
 
@@ -0,0 +1,108 @@
+/** @file parallel.c
+*
+* @brief Minimal worker pool running indexed tasks on several threads.
+*
+*/
+
+#include "parallel.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <unistd.h>
+#endif // _WIN32
+
+// === Type Definitions ===
+//
+typedef struct workerPool
+{
+    atomic_int nextTask;
+    int taskSize;
+    parallelTask_t p_task;
+    void *p_context;
+} workerPool_t;
+
+// === Protected Functions ===
+//
+/*!
+* @brief Worker thread: processes the tasks until none is left.
+*
+* @param[in] p_arg The shared worker pool.
+*
+* @return NULL
+*/
+static void *Worker (void *p_arg)
+{
+    workerPool_t * const p_pool = (workerPool_t *) p_arg;
+    int task;
+
+    while ((task = atomic_fetch_add(&p_pool->nextTask, 1)) < p_pool->taskSize)
+    {
+        p_pool->p_task(p_pool->p_context, task);
+    }
+
+    return NULL;
+}
+
+// === Public API Functions ===
+//
+int GetProcessorCount (void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const int count = (int) systemInfo.dwNumberOfProcessors;
+#else
+    const int count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif // _WIN32
+
+    return (count > 0) ? count : 1;
+}
+
+void RunParallel (int jobs, const int taskSize, parallelTask_t p_task, void * const p_context)
+{
+    workerPool_t pool;
+    pthread_t threads[JOBS_LIMIT];
+    int threadSize = 0;
+
+    if (jobs <= 0)
+    {
+        jobs = GetProcessorCount();
+    }
+    if (jobs > taskSize)
+    {
+        jobs = taskSize;
+    }
+    if (jobs > JOBS_LIMIT)
+    {
+        jobs = JOBS_LIMIT;
+    }
+
+    atomic_init(&pool.nextTask, 0);
+    pool.taskSize = taskSize;
+    pool.p_task = p_task;
+    pool.p_context = p_context;
+
+    // The caller is the first worker, it runs alone if no thread can be started
+    for (int i = 1; i < jobs; i++)
+    {
+        if (pthread_create(&threads[threadSize], NULL, Worker, &pool) != 0)
+        {
+            perror("Unable to start worker thread.");
+            break;
+        }
+        threadSize++;
+    }
+
+    Worker(&pool);
+
+    for (int i = 0; i < threadSize; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+/*** EOF ***/
@@ -0,0 +1,49 @@
+/** @file parallel.h
+*
+* @brief Minimal worker pool running indexed tasks on several threads.
+*
+*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// === Type Definitions ===
+//
+typedef void (*parallelTask_t) (void *p_context, int task);
+
+// === Constant Definitions ===
+//
+#define JOBS_LIMIT          256     // Maximum number of worker threads
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*!
+* @brief Returns with the number of online processors.
+*
+* @return Number of processors, at least 1.
+*/
+int GetProcessorCount (void);
+
+/*!
+* @brief Runs the tasks 0..taskSize-1 on the worker threads, each worker takes the next
+*           unprocessed task. Returns after every task is finished.
+*
+* @param[in] jobs Number of worker threads including the caller, 0: one for each processor.
+* @param[in] taskSize Number of tasks.
+* @param[in] p_task Task function.
+* @param[in] p_context Shared context of the tasks.
+*
+* @return void
+*/
+void RunParallel (int jobs, const int taskSize, parallelTask_t p_task, void * const p_context);
+
+#endif // PARALLEL_H
+
+/*** EOF ***/
@@ -0,0 +1,328 @@
+/** @file peephole.c
+*
+* @brief Peephole optimizer of the compiled program: merges the delays and removes the needless LOADs
+*           without changing the sequence of the Avalon transactions.
+*
+*/
+
+#include "peephole.h"
+
+// === Type Definitions ===
+//
+typedef struct loadState
+{
+    bool b_isKnown;             // The timing word is the same in each execution of the row
+    uint32_t address;           // Active LOAD: mode|setup
+    uint32_t data;              // hold|readLatency|writeWait|readWait
+} loadState_t;
+
+// === Protected Functions ===
+//
+static inline bool IsLive (const instrRecord_t * const p_record)
+{
+    return (p_record->flags & RECORD_INSTRUCTION) && (p_record->flags & RECORD_VALID);
+}
+
+/*!
+* @brief Removes the instruction of the row, the record is kept for the emitted comment.
+*
+* @param[in,out] p_record The record of the row.
+* @param[in,out] p_counter Counter of the rule.
+*
+* @return void
+*/
+static void RemoveRow (instrRecord_t * const p_record, uint32_t * const p_counter)
+{
+    p_record->flags = (uint16_t) ((p_record->flags & ~(RECORD_INSTRUCTION | RECORD_VALID)) | RECORD_REMOVED);
+    (*p_counter)++;
+}
+
+/*!
+* @brief Checks whether the repeat block of the row contains a LOAD.
+*
+* @param[in] p_program The compiled program.
+* @param[in] row Row of the REPEAT.
+*
+* @return Returns with true if no LOAD is executed in the block.
+*/
+static bool IsLoadFree (const program_t * const p_program, const int row)
+{
+    int depth = 0;
+
+    for (int i = row; i < p_program->rowSize; i++)
+    {
+        const instrRecord_t * const p_record = &p_program->p_records[i];
+        if (!IsLive(p_record))
+        {
+            continue;
+        }
+        if (p_record->opCode == load)
+        {
+            return false;
+        }
+        if (p_record->opCode == loop)
+        {
+            depth++;
+        }
+        else if ((p_record->opCode == loopEnd) && (--depth == 0))
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+/*!
+* @brief Checks whether the LOAD is overwritten before use: only NOP / WAIT instructions follow it
+*           until the next LOAD or the end of the program. A repeat block boundary ends the search.
+*
+* @param[in] p_program The compiled program.
+* @param[in] row Row of the LOAD.
+*
+* @return Returns with true if the LOAD has no effect on the transactions.
+*/
+static bool IsDeadLoad (const program_t * const p_program, const int row)
+{
+    for (int i = row + 1; i < p_program->rowSize; i++)
+    {
+        const instrRecord_t * const p_record = &p_program->p_records[i];
+        if (!IsLive(p_record))
+        {
+            continue;
+        }
+        if (p_record->opCode == load)
+        {
+            return true;
+        }
+        if ((p_record->opCode != nop) && (p_record->opCode != wait))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+* @brief Follows the LOAD state through a REPEAT: each iteration starts with the state
+*           of the previous END, that is the same as before the block if the block contains no LOAD.
+*           After the END the state of the last iteration is kept, the block has at least one.
+*
+* @param[in] p_program The compiled program.
+* @param[in] row Row of the REPEAT.
+* @param[in,out] p_state The LOAD state.
+*
+* @return void
+*/
+static inline void EnterBlock (const program_t * const p_program, const int row, loadState_t * const p_state)
+{
+    p_state->b_isKnown = p_state->b_isKnown && IsLoadFree(p_program, row);
+}
+
+/*!
+* @brief Removes the dead and the redundant LOAD instructions.
+*
+* @param[in,out] p_program The compiled program.
+* @param[in,out] p_stats The statistics of the optimization.
+*
+* @return void
+*/
+static void RemoveLoads (program_t * const p_program, peepholeStats_t * const p_stats)
+{
+    // Reset state of avalon_master: fixed timing without setup, wait, latency and hold
+    loadState_t state = { true, 0, 0 };
+
+    for (int i = 0; i < p_program->rowSize; i++)
+    {
+        instrRecord_t * const p_record = &p_program->p_records[i];
+        if (!IsLive(p_record))
+        {
+            continue;
+        }
+        if (p_record->opCode == loop)
+        {
+            EnterBlock(p_program, i, &state);
+        }
+        else if (p_record->opCode == load)
+        {
+            if (IsDeadLoad(p_program, i))
+            {
+                RemoveRow(p_record, &p_stats->deadLoads);
+            }
+            else if (state.b_isKnown && (state.address == p_record->address) && (state.data == p_record->data))
+            {
+                RemoveRow(p_record, &p_stats->redundantLoads);
+            }
+            else
+            {
+                state.b_isKnown = true;
+                state.address = p_record->address;
+                state.data = p_record->data;
+            }
+        }
+    }
+}
+
+/*!
+* @brief Returns with the cycles of the NOP / WAIT instruction by the cycle table of avalon_master.
+*
+* @param[in] p_record The record of the instruction.
+* @param[in] p_state The LOAD state: the NOP lasts a single cycle in fast issue mode.
+*
+* @return Cycles of the delay, 0 if it is not a delay or its cycles are unknown.
+*/
+static uint64_t GetDelay (const instrRecord_t * const p_record, const loadState_t * const p_state)
+{
+    if (p_record->opCode == wait)
+    {
+        // FETCH, the counter and PC_INCR, WAIT 0 counts through the whole counter
+        return ((uint64_t) (p_record->data - 1) + 1) + 2;
+    }
+    if ((p_record->opCode == nop) && p_state->b_isKnown)
+    {
+        return (p_state->address & LOAD_MODE_FAST_ISSUE) ? 1 : 2;
+    }
+
+    return 0;
+}
+
+/*!
+* @brief Merges the consecutive NOP / WAIT instructions into the WAIT of the first one.
+*           The merged WAIT lasts exactly as long as the sequence: the outstanding reads are waited
+*           by the first instruction of the sequence in both cases.
+*
+* @param[in,out] p_program The compiled program.
+* @param[in,out] p_stats The statistics of the optimization.
+*
+* @return void
+*/
+static void MergeDelays (program_t * const p_program, peepholeStats_t * const p_stats)
+{
+    loadState_t state = { true, 0, 0 };
+
+    for (int i = 0; i < p_program->rowSize; i++)
+    {
+        instrRecord_t * const p_head = &p_program->p_records[i];
+        if (!IsLive(p_head))
+        {
+            continue;
+        }
+        if (p_head->opCode == loop)
+        {
+            EnterBlock(p_program, i, &state);
+        }
+        else if (p_head->opCode == load)
+        {
+            state.b_isKnown = true;
+            state.address = p_head->address;
+            state.data = p_head->data;
+        }
+
+        uint64_t delay = GetDelay(p_head, &state);
+        if (delay == 0)
+        {
+            continue;
+        }
+
+        // The longest sequence which fits to a single WAIT
+        int last = i;
+        int members = 1;
+        for (int k = i + 1; k < p_program->rowSize; k++)
+        {
+            if (!IsLive(&p_program->p_records[k]))
+            {
+                continue;
+            }
+            const uint64_t next = GetDelay(&p_program->p_records[k], &state);
+            if ((next == 0) || (delay + next - 2 > UINT32_MAX))
+            {
+                break;
+            }
+            delay += next;
+            last = k;
+            members++;
+        }
+
+        // WAIT 0 would count through the whole counter
+        if ((members > 1) && (delay > 2))
+        {
+            p_head->opCode = wait;
+            p_head->address = 0;
+            p_head->data = (uint32_t) (delay - 2);
+            for (int k = i + 1; k <= last; k++)
+            {
+                if (IsLive(&p_program->p_records[k]))
+                {
+                    RemoveRow(&p_program->p_records[k], &p_stats->mergedDelays);
+                }
+            }
+        }
+        i = last;
+    }
+}
+
+/*!
+* @brief Counts the instructions of the chunks again, then assigns the program counters.
+*
+* @param[in,out] p_program The compiled program.
+*
+* @return void
+*/
+static void RenumberProgram (program_t * const p_program)
+{
+    for (int i = 0; i < p_program->chunkSize; i++)
+    {
+        const int first = i * p_program->chunkRows;
+        const int last = (first + p_program->chunkRows < p_program->rowSize) ? first + p_program->chunkRows : p_program->rowSize;
+        int chunkCount = 0;
+        for (int k = first; k < last; k++)
+        {
+            chunkCount += IsLive(&p_program->p_records[k]);
+        }
+        p_program->p_chunkPC[i] = chunkCount;
+    }
+    NumberProgram(p_program);
+}
+
+static bool EstimateCycles (const program_t * const p_program, uint64_t * const p_cycles)
+{
+    programTiming_t timing = { NULL, NULL, NULL, 0, 0 };
+    const bool b_isEstimated = AnalyzeTiming(p_program, &timing);
+
+    *p_cycles = timing.cycles;
+    CleanupTiming(&timing);
+
+    return b_isEstimated;
+}
+
+// === Public API Functions ===
+//
+bool OptimizeProgram (program_t * const p_program, peepholeStats_t * const p_stats)
+{
+    memset(p_stats, 0, sizeof(peepholeStats_t));
+    p_stats->progCount = (uint32_t) p_program->progCount;
+    if (!EstimateCycles(p_program, &p_stats->cyclesBefore))
+    {
+        return false;
+    }
+
+    // The dead LOADs are removed first, the delays are merged by the remaining LOAD state
+    RemoveLoads(p_program, p_stats);
+    MergeDelays(p_program, p_stats);
+    RenumberProgram(p_program);
+
+    return EstimateCycles(p_program, &p_stats->cyclesAfter);
+}
+
+void PrintPeephole (const peepholeStats_t * const p_stats)
+{
+    const uint32_t removed = p_stats->mergedDelays + p_stats->redundantLoads + p_stats->deadLoads;
+
+    printf("--- Peephole optimization: %u of %u instruction(s) removed, %" PRIu64 " of %" PRIu64 " cycle(s) saved ---\n",
+           removed, p_stats->progCount, p_stats->cyclesBefore - p_stats->cyclesAfter, p_stats->cyclesBefore);
+    printf("Merged NOP / WAIT: %u, redundant LOAD: %u, dead LOAD: %u\n",
+           p_stats->mergedDelays, p_stats->redundantLoads, p_stats->deadLoads);
+}
+
+/*** EOF ***/
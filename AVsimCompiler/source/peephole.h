@@ -0,0 +1,62 @@
+/** @file peephole.h
+*
+* @brief Peephole optimizer of the compiled program: merges the delays and removes the needless LOADs
+*           without changing the sequence of the Avalon transactions.
+*
+*/
+
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "compile.h"
+#include "timing.h"
+
+// === Type Definitions ===
+//
+typedef struct peepholeStats
+{
+    uint32_t mergedDelays;      // NOP / WAIT folded into the WAIT of the first delay
+    uint32_t redundantLoads;    // LOAD of the active timing word
+    uint32_t deadLoads;         // LOAD overwritten before any instruction depending on it
+    uint32_t progCount;         // Number of instructions before the optimization
+    uint64_t cyclesBefore;      // Static cycle estimate before and after the optimization
+    uint64_t cyclesAfter;
+} peepholeStats_t;
+
+// === Public API Functions ===
+//
+/*!
+* @brief Rewrites the validated program in place:
+*           - the consecutive NOP / WAIT instructions become a single WAIT of the same cycles,
+*           - a LOAD is removed if the next instruction after the NOP / WAIT ones is a LOAD too,
+*           - a LOAD is removed if its timing word is active already.
+*           The removed rows keep their record with RECORD_REMOVED, each record stays at its source row,
+*           so the errors and the profiles still refer to the source lines. The LOAD state is followed
+*           into a repeat block only if the block contains no LOAD.
+*
+* @param[in,out] p_program The compiled program, the program counters are assigned again.
+* @param[out] p_stats The removed instructions and the saved cycles.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool OptimizeProgram (program_t * const p_program, peepholeStats_t * const p_stats);
+
+/*!
+* @brief Prints the removed instructions and the saved cycles.
+*
+* @param[in] p_stats The statistics of the optimization.
+*
+* @return void
+*/
+void PrintPeephole (const peepholeStats_t * const p_stats);
+
+#endif // PEEPHOLE_H
+
+/*** EOF ***/
@@ -0,0 +1,282 @@
+/** @file profile.c
+*
+* @brief Performance counters of avalon_master: the dump of the testbench or the native model,
+*           and the cycle profile of the source lines.
+*
+*/
+
+#include "profile.h"
+
+// === Protected Functions ===
+//
+/*!
+* @brief Ensures that the profile holds the program counter, the new entries are zero.
+*
+* @param[in,out] p_perf The counters.
+* @param[in] pc The program counter.
+*
+* @return MEMORY ALLOCATION: Returns with false if the memory allocation failed.
+*/
+static bool ReservePC (perfCounters_t * const p_perf, const uint32_t pc)
+{
+    if (pc < p_perf->pcSize)
+    {
+        return true;
+    }
+
+    uint32_t size = (p_perf->pcSize < PERF_PC_MIN) ? PERF_PC_MIN : p_perf->pcSize;
+    while (size <= pc)
+    {
+        size *= 2;
+    }
+    uint64_t * const p_pcCycles = (uint64_t *) realloc(p_perf->p_pcCycles, size * sizeof(uint64_t));
+    if (p_pcCycles == NULL)
+    {
+        perror("Unable to allocate memory for the profile.");
+        return false;
+    }
+    p_perf->p_pcCycles = p_pcCycles;
+    uint64_t * const p_pcCount = (uint64_t *) realloc(p_perf->p_pcCount, size * sizeof(uint64_t));
+    if (p_pcCount == NULL)
+    {
+        perror("Unable to allocate memory for the profile.");
+        return false;
+    }
+    p_perf->p_pcCount = p_pcCount;
+    memset(p_perf->p_pcCycles + p_perf->pcSize, 0, (size - p_perf->pcSize) * sizeof(uint64_t));
+    memset(p_perf->p_pcCount + p_perf->pcSize, 0, (size - p_perf->pcSize) * sizeof(uint64_t));
+    p_perf->pcSize = size;
+
+    return true;
+}
+
+/*!
+* @brief Parses one record of the dump.
+*
+* @param[in] p_line The line of the record.
+* @param[in,out] p_perf The counters.
+*
+* @return Returns with false if the record is invalid.
+*/
+static bool ParsePerfRecord (const char * const p_line, perfCounters_t * const p_perf)
+{
+    char key[16];
+    uint64_t first;
+    uint64_t second = 0;
+    uint64_t third = 0;
+
+    const int fields = sscanf(p_line, "%15s %" SCNu64 " %" SCNu64 " %" SCNu64, key, &first, &second, &third);
+    if (fields < 2)
+    {
+        return false;
+    }
+    if (!strcmp(key, "cycles"))
+    {
+        p_perf->cycles = first;
+    }
+    else if (!strcmp(key, "bus") && (fields == 3))
+    {
+        p_perf->busCycles = first;
+        p_perf->dataCycles = second;
+    }
+    else if (!strcmp(key, "phase") && (fields == 3) && (first < perfPhaseLimit))
+    {
+        p_perf->phaseCycles[first] = second;
+    }
+    else if (!strcmp(key, "opcode") && (fields == 3) && (first < OPCODE_LIMIT))
+    {
+        p_perf->opCodeCount[first] = second;
+    }
+    else if (!strcmp(key, "stall") && (fields == 3))
+    {
+        p_perf->longestStall = first;
+        p_perf->stallPC = (uint32_t) second;
+    }
+    else if (!strcmp(key, "longest") && (fields == 3))
+    {
+        p_perf->longestSpan = first;
+        p_perf->longestPC = (uint32_t) second;
+    }
+    else if (!strcmp(key, "pc") && (fields == 4) && (first < (UINT64_C(1) << INSTR_DEPTH_MAX)))
+    {
+        if (!ReservePC(p_perf, (uint32_t) first))
+        {
+            return false;
+        }
+        p_perf->p_pcCycles[first] = second;
+        p_perf->p_pcCount[first] = third;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+* @brief Returns with the source row of the program counter.
+*
+* @param[in] p_program The compiled program.
+* @param[in] pc The program counter.
+*
+* @return Index of the row, -1 if the program counter is out of the program.
+*/
+static int FindRow (const program_t * const p_program, const uint32_t pc)
+{
+    uint32_t progCount = 0;
+
+    for (int i = 0; i < p_program->rowSize; i++)
+    {
+        const uint16_t flags = p_program->p_records[i].flags;
+        if ((flags & RECORD_INSTRUCTION) && (flags & RECORD_VALID) && (progCount++ == pc))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static inline double Percent (const uint64_t part, const uint64_t total)
+{
+    return total ? 100.0 * (double) part / (double) total : 0.0;
+}
+
+// === Public API Functions ===
+//
+bool InitPerf (perfCounters_t * const p_perf, const uint32_t pcSize)
+{
+    memset(p_perf, 0, sizeof(perfCounters_t));
+
+    return (pcSize == 0) || ReservePC(p_perf, pcSize - 1);
+}
+
+bool WritePerfDump (const char * const p_path, const perfCounters_t * const p_perf)
+{
+    FILE * const p_file = fopen(p_path, "w");
+    if (p_file == NULL)
+    {
+        perror("Error at output file opening.\n");
+        return false;
+    }
+
+    fprintf(p_file, "%s\ncycles %" PRIu64 "\nbus %" PRIu64 " %" PRIu64 "\n", PERF_DUMP_HEADER,
+            p_perf->cycles, p_perf->busCycles, p_perf->dataCycles);
+    for (int i = 0; i < perfPhaseLimit; i++)
+    {
+        fprintf(p_file, "phase %d %" PRIu64 "\n", i, p_perf->phaseCycles[i]);
+    }
+    for (int i = 0; i < OPCODE_LIMIT; i++)
+    {
+        fprintf(p_file, "opcode %d %" PRIu64 "\n", i, p_perf->opCodeCount[i]);
+    }
+    fprintf(p_file, "stall %" PRIu64 " %u\nlongest %" PRIu64 " %u\n",
+            p_perf->longestStall, p_perf->stallPC, p_perf->longestSpan, p_perf->longestPC);
+    for (uint32_t pc = 0; pc < p_perf->pcSize; pc++)
+    {
+        if (p_perf->p_pcCycles[pc] || p_perf->p_pcCount[pc])
+        {
+            fprintf(p_file, "pc %u %" PRIu64 " %" PRIu64 "\n", pc, p_perf->p_pcCycles[pc], p_perf->p_pcCount[pc]);
+        }
+    }
+    fclose(p_file);
+
+    return true;
+}
+
+bool ReadPerfDump (const char * const p_path, perfCounters_t * const p_perf)
+{
+    char line[PERF_LINE_LIMIT];
+    int row = 0;
+
+    memset(p_perf, 0, sizeof(perfCounters_t));
+    FILE * const p_file = fopen(p_path, "r");
+    if (p_file == NULL)
+    {
+        fprintf(stderr, "No performance counter dump was detected: '%s'\n", p_path);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        row++;
+        if ((line[0] == '#') || (line[strspn(line, " \t\r\n")] == '\0'))
+        {
+            continue;
+        }
+        if (!ParsePerfRecord(line, p_perf))
+        {
+            fprintf(stderr, "=> ERROR in '%s' at line %d.: invalid performance counter record.\n", p_path, row);
+            fclose(p_file);
+            CleanupPerf(p_perf);
+            return false;
+        }
+    }
+    fclose(p_file);
+
+    return true;
+}
+
+void PrintProfile (const perfCounters_t * const p_perf, const program_t * const p_program)
+{
+    static const char * const PHASE_NAMES[perfPhaseLimit] =
+    {
+        "fetch", "setup", "strobe", "stall", "latency", "hold", "wait", "control"
+    };
+    const int longestRow = FindRow(p_program, p_perf->longestPC);
+    uint64_t retired = 0;
+
+    printf("--- Cycle profile: %" PRIu64 " cycle(s), bus busy %.1f %%, data transfer %.1f %% ---\n",
+           p_perf->cycles, Percent(p_perf->busCycles, p_perf->cycles), Percent(p_perf->dataCycles, p_perf->cycles));
+    for (int i = 0; i < perfPhaseLimit; i++)
+    {
+        printf("%-8s %12" PRIu64 " cycle(s) %5.1f %%\n", PHASE_NAMES[i], p_perf->phaseCycles[i],
+               Percent(p_perf->phaseCycles[i], p_perf->cycles));
+    }
+    for (int i = 0; i < (int) (sizeof(OP_CODES_LUT) / sizeof(OP_CODES_LUT[0])); i++)
+    {
+        if (p_perf->opCodeCount[OP_CODES_LUT[i].value])
+        {
+            printf("%-10s %10" PRIu64 " instruction(s)\n", OP_CODES_LUT[i].p_name, p_perf->opCodeCount[OP_CODES_LUT[i].value]);
+            retired += p_perf->opCodeCount[OP_CODES_LUT[i].value];
+        }
+    }
+    printf("Retired: %" PRIu64 " instruction(s), longest stall: %" PRIu64 " cycle(s) at /*%u*/\n",
+           retired, p_perf->longestStall, p_perf->stallPC);
+    if (longestRow >= 0)
+    {
+        printf("Longest instruction: %" PRIu64 " cycle(s) at line %d. /*%u*/\n", p_perf->longestSpan, longestRow + 1, p_perf->longestPC);
+    }
+
+    // Executed instructions in source order
+    puts("\n  line      pc       cycles  share        count  source");
+    uint32_t pc = 0;
+    for (int i = 0; i < p_program->rowSize; i++)
+    {
+        const uint16_t flags = p_program->p_records[i].flags;
+        if (!(flags & RECORD_INSTRUCTION) || !(flags & RECORD_VALID))
+        {
+            continue;
+        }
+        if ((pc < p_perf->pcSize) && (p_perf->p_pcCycles[pc] || p_perf->p_pcCount[pc]))
+        {
+            const textLine_t * const p_line = &p_program->p_source->p_lines[i];
+            printf("%6d. /*%*u*/ %12" PRIu64 " %5.1f %% %12" PRIu64 "  %.*s\n", i + 1, p_program->pcWidth, pc,
+                   p_perf->p_pcCycles[pc], Percent(p_perf->p_pcCycles[pc], p_perf->cycles), p_perf->p_pcCount[pc],
+                   p_line->length, p_line->p_text);
+        }
+        pc++;
+    }
+}
+
+void CleanupPerf (perfCounters_t * const p_perf)
+{
+    free(p_perf->p_pcCycles);
+    free(p_perf->p_pcCount);
+    p_perf->p_pcCycles = NULL;
+    p_perf->p_pcCount = NULL;
+    p_perf->pcSize = 0;
+}
+
+/*** EOF ***/
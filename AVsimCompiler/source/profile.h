@@ -0,0 +1,89 @@
+/** @file profile.h
+*
+* @brief Performance counters of avalon_master: the dump of the testbench or the native model,
+*           and the cycle profile of the source lines.
+*
+*/
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "compile.h"
+#include "avalon_model.h"
+
+// === Constant Definitions ===
+//
+/* Dump of the counters, one decimal record in each line:
+     cycles <cycles>
+     bus <chipselect cycles> <data cycles>
+     phase <perfPhase_t> <cycles>
+     opcode <operating code> <retired instructions>
+     stall <longest held command> <pc>
+     longest <longest instruction> <pc>
+     pc <pc> <cycles> <retired count>     executed program counters only */
+#define PERF_DUMP_HEADER    "# avsim perf 1"
+#define PERF_LINE_LIMIT     128
+#define PERF_PC_MIN         1024        // Initial capacity of the program counters read from a dump
+
+// === Public API Functions ===
+//
+/*!
+* @brief Clears the counters and allocates the profile of the program counters.
+*
+* @param[out] p_perf The counters.
+* @param[in] pcSize Number of the profiled program counters from 0.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool InitPerf (perfCounters_t * const p_perf, const uint32_t pcSize);
+
+/*!
+* @brief Writes the counters into the dump file, the format of the testbench.
+*
+* @param[in] p_path The path of the dump.
+* @param[in] p_perf The counters.
+*
+* @return Returns with true in case of success.
+*/
+bool WritePerfDump (const char * const p_path, const perfCounters_t * const p_perf);
+
+/*!
+* @brief Reads the dump of the testbench or the native model.
+*
+* @param[in] p_path The path of the dump.
+* @param[out] p_perf The counters.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool ReadPerfDump (const char * const p_path, perfCounters_t * const p_perf);
+
+/*!
+* @brief Prints the bus utilization, the phases and the retired instructions,
+*           then the cycles of each executed instruction at its source line.
+*
+* @param[in] p_perf The counters.
+* @param[in] p_program The compiled program of the dump.
+*
+* @return void
+*/
+void PrintProfile (const perfCounters_t * const p_perf, const program_t * const p_program);
+
+/*!
+* @brief Clean up of the profile of the program counters.
+*
+* @param[in,out] p_perf The counters.
+*
+* @return void
+*/
+void CleanupPerf (perfCounters_t * const p_perf);
+
+#endif // PROFILE_H
+
+/*** EOF ***/
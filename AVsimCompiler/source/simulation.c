@@ -0,0 +1,301 @@
+/** @file simulation.c
+*
+* @brief Run mode: executes the compiled image on the native model of the Avalon master.
+*
+*/
+
+#include "simulation.h"
+
+#include <sys/stat.h>
+
+// === Protected Functions ===
+//
+/*!
+* @brief Simulates the model cycle by cycle and prints the signals of each cycle.
+*
+* @param[in,out] p_model The model.
+* @param[in] cycleLimit Maximum number of cycles.
+*
+* @return Returns with true if the simulation is ready.
+*/
+static bool TraceModel (avalonModel_t * const p_model, const uint64_t cycleLimit)
+{
+    avalonBus_t bus;
+    bool b_isReady = false;
+    const slaveBus_t * const p_slaves = (p_model->p_slaveHook == SlaveBusHook) ? (const slaveBus_t *) p_model->p_slave : NULL;
+
+    fputs(TRACE_HEADER, stdout);
+    while (!b_isReady && (p_model->cycle < cycleLimit))
+    {
+        const uint64_t cycle = p_model->cycle;
+        b_isReady = StepModel(p_model, &bus);
+        printf("%" PRIu64 " %" PRIu64 " %u %u %u %u %u %08X %08X %08X %u %u %u %u %u\n", MODEL_TIME_NS(cycle), cycle,
+               bus.state, bus.pc, bus.b_chipselect, bus.b_read, bus.b_write, bus.address, bus.writedata, bus.readdataWatch,
+               bus.watchPC, bus.burstcount, bus.b_beginBurst, bus.b_waitrequest, (p_slaves != NULL) && GetSlaveIrq(p_slaves));
+    }
+
+    return b_isReady;
+}
+
+/*!
+* @brief Prints the bus transactions of the simulation.
+*
+* @param[in] p_file The output stream.
+* @param[in] p_log The event log.
+*
+* @return void
+*/
+static void PrintLog (FILE * const p_file, const eventLog_t * const p_log)
+{
+    for (size_t i = 0; i < p_log->size; i++)
+    {
+        const modelEvent_t * const p_event = &p_log->p_events[i];
+        fprintf(p_file, "%12" PRIu64 " ns /*%u*/ %-5s %08X %s %08X\n", MODEL_TIME_NS(p_event->cycle), p_event->pc,
+                (p_event->type == eventRead) ? READ : WRITE, p_event->address,
+                (p_event->type == eventRead) ? "=>" : "<=", p_event->data);
+    }
+}
+
+/*!
+* @brief Checks the image against the instruction memory of the HDL.
+*
+* @param[in] p_imagePath The compiled image.
+* @param[in] p_image The instruction memory.
+* @param[in] depthBits INSTR_LIMIT_SIZE of the HDL, INSTR_DEPTH_AUTO: fitting the image.
+*
+* @return INSTR_LIMIT_SIZE of the simulation, 0 if the image does not fit.
+*/
+static int GetModelDepthBits (const char * const p_imagePath, const modelImage_t * const p_image, const int depthBits)
+{
+    // The HDL drops the words out of the instruction memory
+    const int imageDepthBits = GetDepthBits((int) p_image->size);
+    const int modelDepthBits = (depthBits == INSTR_DEPTH_AUTO) ? imageDepthBits : depthBits;
+    if (imageDepthBits > modelDepthBits)
+    {
+        fprintf(stderr, "=> ERROR in '%s': %u word(s) exceed the instruction memory of 2^%d entries.\n",
+                p_imagePath, p_image->size, modelDepthBits);
+        return 0;
+    }
+
+    return modelDepthBits;
+}
+
+/*!
+* @brief Writes the bus transactions of the image into <image>.log.
+*
+* @param[in] p_imagePath The compiled image.
+* @param[in] p_log The event log.
+*
+* @return Returns with true in case of success.
+*/
+static bool WriteLogFile (const char * const p_imagePath, const eventLog_t * const p_log)
+{
+    char path[FILENAME_MAX];
+
+    snprintf(path, sizeof(path), "%s%s", p_imagePath, LOG_FILE_EXTENSION);
+    FILE * const p_file = fopen(path, "w");
+    if (p_file == NULL)
+    {
+        perror("Error at output file opening.\n");
+        return false;
+    }
+    PrintLog(p_file, p_log);
+    fclose(p_file);
+
+    return true;
+}
+
+/*!
+* @brief Batch run: simulates the images of a folder, a pattern or a manifest together
+*           and writes the bus transactions of each image into <image>.log.
+*
+* @param[in] p_input Folder, wildcard pattern or @manifest.
+* @param[in] depthBits INSTR_LIMIT_SIZE of the HDL, INSTR_DEPTH_AUTO: fitting each image.
+* @param[in] jobs Worker threads, 0: one for each processor.
+*
+* @return 0, if each simulation is ready within the cycle limit.
+*/
+static int RunBatchSimulation (const char * const p_input, const int depthBits, const int jobs)
+{
+    batch_t batch = { NULL, 0, 0 };
+    int failedCount = 0;
+    int readyCount = 0;
+    int size = 0;
+    uint64_t cycles = 0;
+
+    // The folders are collected by their images
+    if (!CollectFiles(p_input, TARGET_FILE_EXTENSION, &batch))
+    {
+        fprintf(stderr, "No compiled image was detected: '%s'\n", p_input);
+        CleanupBatch(&batch);
+        return -1;
+    }
+
+    // The runs are packed, pp_paths[i] is the image of p_runs[i]
+    modelRun_t * const p_runs = (modelRun_t *) calloc(batch.size, sizeof(modelRun_t));
+    const char ** const pp_paths = (const char **) malloc(batch.size * sizeof(const char *));
+    if ((p_runs == NULL) || (pp_paths == NULL))
+    {
+        perror("Unable to allocate memory for the batch.");
+        free(p_runs);
+        free(pp_paths);
+        CleanupBatch(&batch);
+        return -1;
+    }
+    for (int i = 0; i < batch.size; i++)
+    {
+        const char * const p_imagePath = batch.p_jobs[i].p_target;
+        modelImage_t * const p_image = LoadImage(p_imagePath);
+        if (p_image == NULL)
+        {
+            fprintf(stderr, "No compiled image was detected: '%s'\n", p_imagePath);
+            failedCount++;
+            continue;
+        }
+        const int modelDepthBits = GetModelDepthBits(p_imagePath, p_image, depthBits);
+        if (modelDepthBits == 0)
+        {
+            CleanupImage(p_image);
+            failedCount++;
+            continue;
+        }
+        p_runs[size].p_image = p_image;
+        p_runs[size].depthBits = modelDepthBits;
+        pp_paths[size++] = p_imagePath;
+    }
+
+    const int64_t start = GetTimeStamp();
+    RunModelBatch(p_runs, size, MODEL_CYCLE_LIMIT, jobs);
+    const double seconds = (double) (GetTimeStamp() - start) / 1e6;
+
+    // Report the erroneous programs only
+    for (int i = 0; i < size; i++)
+    {
+        const modelRun_t * const p_run = &p_runs[i];
+        if (p_run->b_isReady)
+        {
+            readyCount++;
+        }
+        else
+        {
+            fprintf(stderr, "=> ERROR in '%s': stopped after %" PRIu64 " instruction(s), %" PRIu64 " cycle(s).\n",
+                    pp_paths[i], p_run->instrCount, p_run->cycle);
+        }
+        if (!p_run->b_isReady || p_run->b_isFailed || !WriteLogFile(pp_paths[i], &p_run->log))
+        {
+            failedCount++;
+        }
+        cycles += p_run->cycle;
+        CleanupLog(&p_runs[i].log);
+        CleanupImage((modelImage_t *) p_run->p_image);
+    }
+    printf("Batch run: %d program(s), %d ready, %" PRIu64 " cycle(s) in %.3f s (%.1f Mcycle/s).\n",
+           batch.size, readyCount, cycles, seconds, (seconds > 0.0) ? (double) cycles / seconds / 1e6 : 0.0);
+
+    free(p_runs);
+    free(pp_paths);
+    CleanupBatch(&batch);
+
+    return failedCount ? -1 : 0;
+}
+
+/*!
+* @brief Simulates a single image.
+*
+* @param[in] p_imagePath The compiled image.
+* @param[in] depthBits INSTR_LIMIT_SIZE of the HDL, INSTR_DEPTH_AUTO: fitting the image.
+* @param[in] b_isTraced Prints the signals of each cycle instead of the transactions.
+* @param[in] pp_slaveSpecs Slave models: "<model>[@<base>[:<span>]]".
+* @param[in] slaveSize Number of slave models, 0: readdata is 0.
+* @param[in] p_profilePath Dump of the performance counters, NULL: no counters.
+*
+* @return 0, if the simulation is ready within the cycle limit.
+*/
+static int RunSingleSimulation (const char * const p_imagePath, const int depthBits, const bool b_isTraced,
+                                char ** const pp_slaveSpecs, const int slaveSize, const char * const p_profilePath)
+{
+    avalonModel_t model;
+    eventLog_t log = { NULL, 0, 0 };
+    slaveBus_t slaves = { NULL, 0, 0 };
+    perfCounters_t perf;
+
+    modelImage_t * const p_image = LoadImage(p_imagePath);
+    if (p_image == NULL)
+    {
+        fprintf(stderr, "No compiled image was detected: '%s'\n", p_imagePath);
+        return -1;
+    }
+
+    const int modelDepthBits = GetModelDepthBits(p_imagePath, p_image, depthBits);
+    if (modelDepthBits == 0)
+    {
+        CleanupImage(p_image);
+        return -1;
+    }
+    for (int i = 0; i < slaveSize; i++)
+    {
+        if (!AttachSlave(&slaves, pp_slaveSpecs[i]))
+        {
+            CleanupSlaves(&slaves);
+            CleanupImage(p_image);
+            return -1;
+        }
+    }
+    if (!InitPerf(&perf, (p_profilePath != NULL) ? p_image->size : 0))
+    {
+        CleanupSlaves(&slaves);
+        CleanupImage(p_image);
+        return -1;
+    }
+    ResetSlaves(&slaves);
+    ResetModel(&model, p_image, modelDepthBits, slaveSize ? SlaveBusHook : NULL, slaveSize ? &slaves : NULL);
+    model.p_perf = (p_profilePath != NULL) ? &perf : NULL;
+
+    const clock_t start = clock();
+    const bool b_isReady = b_isTraced ? TraceModel(&model, MODEL_CYCLE_LIMIT) : RunModel(&model, MODEL_CYCLE_LIMIT, &log);
+    const double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    PrintLog(stdout, &log);
+    if (b_isReady)
+    {
+        printf("Simulation ready: %" PRIu64 " instruction(s), %" PRIu64 " cycle(s), %" PRIu64 " ns",
+               model.instrCount, model.cycle, model.cycle * MODEL_CLOCK_PERIOD_NS);
+    }
+    else
+    {
+        printf("Simulation stopped at /*%u*/: %" PRIu64 " instruction(s), %" PRIu64 " cycle(s), %" PRIu64 " ns",
+               model.pc, model.instrCount, model.cycle, model.cycle * MODEL_CLOCK_PERIOD_NS);
+    }
+    printf(" in %.3f s (%.1f Mcycle/s).\n", seconds, (seconds > 0.0) ? (double) model.cycle / seconds / 1e6 : 0.0);
+    const bool b_isDumped = (p_profilePath == NULL) || WritePerfDump(p_profilePath, &perf);
+
+    CleanupPerf(&perf);
+    CleanupLog(&log);
+    CleanupSlaves(&slaves);
+    CleanupImage(p_image);
+
+    return (b_isReady && b_isDumped) ? 0 : -1;
+}
+
+// === Public API Functions ===
+//
+int RunSimulation (const char * const p_input, const int depthBits, const bool b_isTraced, const int jobs,
+                   char ** const pp_slaveSpecs, const int slaveSize, const char * const p_profilePath)
+{
+    struct stat fileStat;
+
+    if ((stat(p_input, &fileStat) == 0) && S_ISREG(fileStat.st_mode))
+    {
+        return RunSingleSimulation(p_input, depthBits, b_isTraced, pp_slaveSpecs, slaveSize, p_profilePath);
+    }
+    if (b_isTraced || slaveSize || (p_profilePath != NULL))
+    {
+        fprintf(stderr, "%s needs a single compiled image: '%s'\n",
+                b_isTraced ? "Tracing" : (slaveSize ? "Slave model" : "Profile"), p_input);
+        return -1;
+    }
+
+    return RunBatchSimulation(p_input, depthBits, jobs);
+}
+
+/*** EOF ***/
@@ -0,0 +1,59 @@
+/** @file simulation.h
+*
+* @brief Run mode: executes the compiled image on the native model of the Avalon master.
+*
+*/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include "avalon_model.h"
+#include "model_batch.h"
+#include "batch.h"
+#include "file_watch.h"
+#include "slave_model.h"
+#include "profile.h"
+
+// === Type Definitions ===
+//
+
+
+// === Constant Definitions ===
+//
+#define TRACE_HEADER        "# time_ns cycle state pc chipselect read write address writedata readdataWatch readdataWatchPC burstcount beginbursttransfer waitrequest irq\n"
+#define LOG_FILE_EXTENSION  ".log"      // Batch run: bus transactions of <image> in <image>.log
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*!
+* @brief Loads the compiled image and simulates it until the end of the program,
+*           then prints the bus transactions and the summary.
+*           Folder, wildcard pattern or @manifest input: each image is simulated
+*           by the lane-parallel batch, the transactions are written to <image>.log.
+*
+* @param[in] p_input The compiled image, or the images of a batch.
+* @param[in] depthBits INSTR_LIMIT_SIZE of the HDL, INSTR_DEPTH_AUTO: fitting the image.
+* @param[in] b_isTraced Prints the signals of each cycle instead of the transactions.
+* @param[in] jobs Worker threads of a batch, 0: one for each processor.
+* @param[in] pp_slaveSpecs Slave models of a single image: "<model>[@<base>[:<span>]]".
+* @param[in] slaveSize Number of slave models, 0: readdata is 0.
+* @param[in] p_profilePath Dump of the performance counters of a single image, NULL: no counters.
+*
+* @return 0, if each simulation is ready within the cycle limit.
+*/
+int RunSimulation (const char * const p_input, const int depthBits, const bool b_isTraced, const int jobs,
+                   char ** const pp_slaveSpecs, const int slaveSize, const char * const p_profilePath);
+
+#endif // SIMULATION_H
+
+/*** EOF ***/
@@ -0,0 +1,150 @@
+/** @file slave_div.c
+*
+* @brief Built-in slave model of div_avalon: the radix-2 integer divider wrapped to Avalon MM.
+*
+*/
+
+#include "slave_div.h"
+
+// === Protected Functions ===
+//
+static void *CreateDiv (void)
+{
+    return calloc(1, sizeof(divAvalon_t));
+}
+
+static void ResetDiv (void *p_context)
+{
+    memset(p_context, 0, sizeof(divAvalon_t));
+}
+
+/*!
+* @brief Read multiplexing logic of div_avalon.
+*
+* @param[in] p_context The model.
+* @param[in] offset div_address.
+*
+* @return div_readdata.
+*/
+static uint32_t ReadDiv (void *p_context, const uint32_t offset)
+{
+    const divAvalon_t * const p_div = (const divAvalon_t *) p_context;
+
+    switch (offset & (DIV_SPAN - 1))
+    {
+        case DIV_GET_QUOTIENT:
+        return p_div->quotientLow;
+        case DIV_GET_REMAINDER:
+        return p_div->remainderHigh;
+        case DIV_GET_READY:
+        return p_div->state == divIdle;
+        default:
+        return p_div->b_doneTrg;
+    }
+}
+
+static void WriteDiv (void *p_context, const uint32_t offset, const uint32_t data)
+{
+    divAvalon_t * const p_div = (divAvalon_t *) p_context;
+
+    p_div->b_isWritten = true;
+    p_div->writeOffset = offset & (DIV_SPAN - 1);
+    p_div->writeData = data;
+}
+
+/*!
+* @brief Clock edge of div_avalon: the FSMD of div and the registers of the wrapper,
+*           computed from the values before the edge.
+*
+* @param[in,out] p_context The model.
+*
+* @return void
+*/
+static void TickDiv (void *p_context)
+{
+    divAvalon_t * const p_div = (divAvalon_t *) p_context;
+    const bool b_isWritten = p_div->b_isWritten;
+    const uint32_t offset = p_div->writeOffset;
+    // Compare and subtract circuit
+    const bool b_quotientBit = (p_div->remainderHigh >= p_div->divisorReg);
+    const uint32_t remainderTmp = b_quotientBit ? p_div->remainderHigh - p_div->divisorReg : p_div->remainderHigh;
+    bool b_setDoneTrg = false;
+
+    // Next-state logic of div: start is a latch set by str_trg
+    if (b_isWritten && (offset == DIV_START))
+    {
+        p_div->b_isStarted = true;
+    }
+    switch (p_div->state)
+    {
+        case divIdle:
+            if (p_div->b_isStarted)
+            {
+                p_div->remainderHigh = 0;
+                p_div->quotientLow = p_div->dividend;
+                p_div->divisorReg = p_div->divisor;
+                p_div->index = DIV_WIDTH + 1;
+                p_div->state = divOp;
+            }
+        break;
+        case divOp:
+            p_div->remainderHigh = (remainderTmp << 1) | (p_div->quotientLow >> (DIV_WIDTH - 1));
+            p_div->quotientLow = (p_div->quotientLow << 1) | b_quotientBit;
+            p_div->index = (p_div->index - 1) & DIV_INDEX_MASK;
+            if (p_div->index == 1)
+            {
+                p_div->state = divLast;
+            }
+        break;
+        case divLast:
+            p_div->remainderHigh = remainderTmp;
+            p_div->quotientLow = (p_div->quotientLow << 1) | b_quotientBit;
+            p_div->state = divDone;
+        break;
+        default:
+            // Done
+            b_setDoneTrg = true;
+            p_div->b_isStarted = false;
+            p_div->state = divIdle;
+        break;
+    }
+
+    // Registers of div_avalon
+    if (b_isWritten && (offset == DIV_SET_DIVIDEND))
+    {
+        p_div->dividend = p_div->writeData;
+    }
+    if (b_isWritten && (offset == DIV_SET_DIVISOR))
+    {
+        p_div->divisor = p_div->writeData;
+    }
+    if (b_setDoneTrg)
+    {
+        p_div->b_doneTrg = true;
+    }
+    else if (b_isWritten && (offset == DIV_DONE_TRG))
+    {
+        p_div->b_doneTrg = false;
+    }
+    p_div->b_isWritten = false;
+}
+
+static bool GetDivIrq (const void *p_context)
+{
+    return ((const divAvalon_t *) p_context)->b_doneTrg;
+}
+
+// === Public API Functions ===
+//
+const slaveOps_t *GetDivAvalonOps (void)
+{
+    static const slaveOps_t DIV_OPS =
+    {
+        SLAVE_API_VERSION, DIV_NAME, DIV_SPAN,
+        CreateDiv, ResetDiv, ReadDiv, WriteDiv, TickDiv, GetDivIrq, NULL, free
+    };
+
+    return &DIV_OPS;
+}
+
+/*** EOF ***/
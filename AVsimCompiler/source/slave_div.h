@@ -0,0 +1,72 @@
+/** @file slave_div.h
+*
+* @brief Built-in slave model of div_avalon: the radix-2 integer divider wrapped to Avalon MM.
+*
+*/
+
+#ifndef SLAVE_DIV_H
+#define SLAVE_DIV_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "slave_model.h"
+
+// === Type Definitions ===
+//
+typedef enum
+{
+    divIdle = 0,
+    divOp,
+    divLast,
+    divDone
+} divState_t;
+
+typedef struct divAvalon
+{
+    // Registers of div_avalon
+    uint32_t dividend;
+    uint32_t divisor;
+    bool b_doneTrg;
+    // Registers of div
+    uint8_t state;
+    uint8_t index;              // n_reg: CBIT wide
+    uint32_t remainderHigh;     // rh_reg
+    uint32_t quotientLow;       // rl_reg
+    uint32_t divisorReg;        // d_reg
+    bool b_isStarted;           // start: latched by str_trg until the done state
+    // Write of the current cycle
+    bool b_isWritten;
+    uint32_t writeOffset;
+    uint32_t writeData;
+} divAvalon_t;
+
+// === Constant Definitions ===
+//
+#define DIV_NAME            "div_avalon"
+#define DIV_WIDTH           32          // W
+#define DIV_INDEX_MASK      0x3F        // CBIT = 6
+#define DIV_SPAN            8           // div_address: 3 bits
+#define DIV_SET_DIVIDEND    0x0
+#define DIV_SET_DIVISOR     0x1
+#define DIV_START           0x2
+#define DIV_GET_QUOTIENT    0x3
+#define DIV_GET_REMAINDER   0x4
+#define DIV_GET_READY       0x5
+#define DIV_DONE_TRG        0x6
+
+// === Public API Functions ===
+//
+/*!
+* @brief Returns with the callbacks of the div_avalon model.
+*           Register map 0x00-0x06 as in the HDL, the other offsets read done_trg.
+*           The division takes W + 3 cycles after the start, done_trg drives the interrupt.
+*
+* @return The callbacks of the model.
+*/
+const slaveOps_t *GetDivAvalonOps (void);
+
+#endif // SLAVE_DIV_H
+
+/*** EOF ***/
@@ -0,0 +1,281 @@
+/** @file slave_model.c
+*
+* @brief Transaction-level slave models attached to the native model of the Avalon master.
+*
+*/
+
+#include "slave_model.h"
+#include "slave_div.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <dlfcn.h>
+#endif // _WIN32
+
+// === Protected Functions ===
+//
+/*!
+* @brief Returns with the callbacks of the built-in model.
+*
+* @param[in] p_name Name of the model.
+* @param[in] length Length of the name.
+*
+* @return The callbacks, NULL if there is no such built-in model.
+*/
+static const slaveOps_t *FindBuiltinSlave (const char * const p_name, const size_t length)
+{
+    static const slaveEntry_t BUILTIN_SLAVES[] = { GetDivAvalonOps };
+
+    for (size_t i = 0; i < sizeof(BUILTIN_SLAVES) / sizeof(BUILTIN_SLAVES[0]); i++)
+    {
+        const slaveOps_t * const p_ops = BUILTIN_SLAVES[i]();
+        if ((strlen(p_ops->p_name) == length) && !strncmp(p_ops->p_name, p_name, length))
+        {
+            return p_ops;
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+* @brief Closes the shared object.
+*
+* @param[in] p_library Handle of the shared object.
+*
+* @return void
+*/
+static void CloseSlaveLibrary (void * const p_library)
+{
+#ifdef _WIN32
+    FreeLibrary((HMODULE) p_library);
+#else
+    dlclose(p_library);
+#endif // _WIN32
+}
+
+/*!
+* @brief Loads the callbacks of the shared object.
+*
+* @param[in] p_path Path of the shared object.
+* @param[out] pp_library Handle of the shared object.
+*
+* @return The callbacks, NULL on error.
+*/
+static const slaveOps_t *LoadSlaveLibrary (const char * const p_path, void ** const pp_library)
+{
+    slaveEntry_t p_entry;
+
+#ifdef _WIN32
+    *pp_library = (void *) LoadLibraryA(p_path);
+    if (*pp_library == NULL)
+    {
+        fprintf(stderr, "=> ERROR: unable to load the slave model: error %lu\n", (unsigned long) GetLastError());
+        return NULL;
+    }
+    *(FARPROC *) &p_entry = GetProcAddress((HMODULE) *pp_library, SLAVE_ENTRY_SYMBOL);
+#else
+    *pp_library = dlopen(p_path, RTLD_NOW | RTLD_LOCAL);
+    if (*pp_library == NULL)
+    {
+        fprintf(stderr, "=> ERROR: unable to load the slave model: %s\n", dlerror());
+        return NULL;
+    }
+    *(void **) &p_entry = dlsym(*pp_library, SLAVE_ENTRY_SYMBOL);
+#endif // _WIN32
+    const slaveOps_t * const p_ops = (p_entry != NULL) ? p_entry() : NULL;
+    if ((p_ops == NULL) || (p_ops->apiVersion != SLAVE_API_VERSION) || (p_ops->p_create == NULL) ||
+        (p_ops->p_read == NULL) || (p_ops->p_write == NULL) || (p_ops->p_tick == NULL))
+    {
+        fprintf(stderr, "=> ERROR in '%s': no slave model of API version %d.\n", p_path, SLAVE_API_VERSION);
+        CloseSlaveLibrary(*pp_library);
+        *pp_library = NULL;
+        return NULL;
+    }
+
+    return p_ops;
+}
+
+/*!
+* @brief Parses the hexadecimal field of the slave specification.
+*
+* @param[in] p_text Start of the field.
+* @param[in] terminator Character after the field, or '\0'.
+* @param[out] p_value Value of the field.
+*
+* @return The position after the terminator, NULL if the field is invalid.
+*/
+static const char *ParseSpecField (const char * const p_text, const char terminator, uint32_t * const p_value)
+{
+    char *p_end;
+
+    const unsigned long long value = strtoull(p_text, &p_end, 16);
+    if ((p_end == p_text) || (value > UINT32_MAX) || ((*p_end != terminator) && (*p_end != '\0')))
+    {
+        return NULL;
+    }
+    *p_value = (uint32_t) value;
+
+    return (*p_end != '\0') ? p_end + 1 : p_end;
+}
+
+/*!
+* @brief Destroys the context of the slave and closes its shared object.
+*
+* @param[in,out] p_instance The slave.
+*
+* @return void
+*/
+static void ReleaseSlave (slaveInstance_t * const p_instance)
+{
+    if ((p_instance->p_context != NULL) && (p_instance->p_ops->p_destroy != NULL))
+    {
+        p_instance->p_ops->p_destroy(p_instance->p_context);
+    }
+    if (p_instance->p_library != NULL)
+    {
+        CloseSlaveLibrary(p_instance->p_library);
+    }
+    p_instance->p_context = NULL;
+    p_instance->p_library = NULL;
+}
+
+// === Public API Functions ===
+//
+bool AttachSlave (slaveBus_t * const p_bus, const char * const p_spec)
+{
+    slaveInstance_t slave = { NULL, NULL, 0, 0, NULL };
+    const char * const p_base = strchr(p_spec, SLAVE_BASE_SEPARATOR);
+    const size_t nameLength = (p_base != NULL) ? (size_t) (p_base - p_spec) : strlen(p_spec);
+    char path[FILENAME_MAX];
+
+    // Built-in model or shared object
+    slave.p_ops = FindBuiltinSlave(p_spec, nameLength);
+    if (slave.p_ops == NULL)
+    {
+        snprintf(path, sizeof(path), "%.*s", (int) nameLength, p_spec);
+        slave.p_ops = LoadSlaveLibrary(path, &slave.p_library);
+        if (slave.p_ops == NULL)
+        {
+            return false;
+        }
+    }
+
+    // Address window
+    slave.span = slave.p_ops->span;
+    if (p_base != NULL)
+    {
+        const char * const p_span = ParseSpecField(p_base + 1, SLAVE_SPAN_SEPARATOR, &slave.base);
+        if ((p_span == NULL) || ((*p_span != '\0') && (ParseSpecField(p_span, '\0', &slave.span) == NULL)))
+        {
+            fprintf(stderr, "=> ERROR: invalid slave address window: '%s'\n", p_spec);
+            ReleaseSlave(&slave);
+            return false;
+        }
+    }
+    bool b_isValid = (slave.span > 0) && ((uint64_t) slave.base + slave.span <= (UINT64_C(1) << 32));
+    for (int i = 0; b_isValid && (i < p_bus->size); i++)
+    {
+        const slaveInstance_t * const p_other = &p_bus->p_slaves[i];
+        b_isValid = ((uint64_t) slave.base + slave.span <= p_other->base) ||
+                    ((uint64_t) p_other->base + p_other->span <= slave.base);
+    }
+    if (!b_isValid)
+    {
+        fprintf(stderr, "=> ERROR: the address window of the slave is empty or overlapping: '%s'\n", p_spec);
+        ReleaseSlave(&slave);
+        return false;
+    }
+
+    if (p_bus->size == p_bus->capacity)
+    {
+        const int capacity = (p_bus->capacity < SLAVE_BUS_MIN) ? SLAVE_BUS_MIN : 2 * p_bus->capacity;
+        slaveInstance_t * const p_slaves = (slaveInstance_t *) realloc(p_bus->p_slaves, (size_t) capacity * sizeof(slaveInstance_t));
+        if (p_slaves == NULL)
+        {
+            perror("Unable to allocate memory for the slave bus.");
+            ReleaseSlave(&slave);
+            return false;
+        }
+        p_bus->p_slaves = p_slaves;
+        p_bus->capacity = capacity;
+    }
+    slave.p_context = slave.p_ops->p_create();
+    if (slave.p_context == NULL)
+    {
+        perror("Unable to allocate memory for the slave model.");
+        ReleaseSlave(&slave);
+        return false;
+    }
+    p_bus->p_slaves[p_bus->size++] = slave;
+
+    return true;
+}
+
+void ResetSlaves (slaveBus_t * const p_bus)
+{
+    for (int i = 0; i < p_bus->size; i++)
+    {
+        if (p_bus->p_slaves[i].p_ops->p_reset != NULL)
+        {
+            p_bus->p_slaves[i].p_ops->p_reset(p_bus->p_slaves[i].p_context);
+        }
+    }
+}
+
+uint32_t SlaveBusHook (void *p_slave, avalonBus_t * const p_bus)
+{
+    slaveBus_t * const p_slaveBus = (slaveBus_t *) p_slave;
+    uint32_t readdata = 0;
+
+    for (int i = 0; i < p_slaveBus->size; i++)
+    {
+        const slaveInstance_t * const p_instance = &p_slaveBus->p_slaves[i];
+        const uint32_t offset = p_bus->address + p_bus->beat - p_instance->base;
+
+        // The readdata follows the address like the HDL, the write needs chipselect.
+        // The beats of the bursts are transferred to the consecutive offsets.
+        if (offset < p_instance->span)
+        {
+            readdata = p_instance->p_ops->p_read(p_instance->p_context, offset);
+            p_bus->b_waitrequest = p_bus->b_chipselect && (p_instance->p_ops->p_waitrequest != NULL) &&
+                                   p_instance->p_ops->p_waitrequest(p_instance->p_context, offset);
+            if (p_bus->b_chipselect && p_bus->b_write && !p_bus->b_waitrequest)
+            {
+                p_instance->p_ops->p_write(p_instance->p_context, offset, p_bus->writedata);
+            }
+        }
+        p_instance->p_ops->p_tick(p_instance->p_context);
+    }
+
+    return readdata;
+}
+
+bool GetSlaveIrq (const slaveBus_t * const p_bus)
+{
+    for (int i = 0; i < p_bus->size; i++)
+    {
+        const slaveInstance_t * const p_instance = &p_bus->p_slaves[i];
+        if ((p_instance->p_ops->p_irq != NULL) && p_instance->p_ops->p_irq(p_instance->p_context))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void CleanupSlaves (slaveBus_t * const p_bus)
+{
+    for (int i = 0; i < p_bus->size; i++)
+    {
+        ReleaseSlave(&p_bus->p_slaves[i]);
+    }
+    free(p_bus->p_slaves);
+    p_bus->p_slaves = NULL;
+    p_bus->size = 0;
+    p_bus->capacity = 0;
+}
+
+/*** EOF ***/
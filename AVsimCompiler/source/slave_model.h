@@ -0,0 +1,121 @@
+/** @file slave_model.h
+*
+* @brief Transaction-level slave models attached to the native model of the Avalon master.
+*
+*/
+
+#ifndef SLAVE_MODEL_H
+#define SLAVE_MODEL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "avalon_model.h"
+
+// === Type Definitions ===
+//
+/* Callbacks of a slave model. The context is created for each attached instance.
+   In each cycle the readdata is taken by read, then at the closing clock edge
+   write is called if the master writes into the window, then tick updates the registers.
+   The register values before the edge have to be used by write and tick, like the HDL.
+   While waitrequest is asserted the write is not accepted, the master holds the command. */
+typedef struct slaveOps
+{
+    int apiVersion;                                                 // SLAVE_API_VERSION
+    const char *p_name;
+    uint32_t span;                                                  // Default size of the address window
+    void *(*p_create) (void);                                       // NULL on error
+    void (*p_reset) (void *p_context);
+    uint32_t (*p_read) (void *p_context, const uint32_t offset);    // Combinational, without side effect
+    void (*p_write) (void *p_context, const uint32_t offset, const uint32_t data);
+    void (*p_tick) (void *p_context);
+    bool (*p_irq) (const void *p_context);                          // NULL: no interrupt line
+    bool (*p_waitrequest) (const void *p_context, const uint32_t offset);   // Combinational, NULL: no waitrequest
+    void (*p_destroy) (void *p_context);
+} slaveOps_t;
+
+// Entry point of the shared object: const slaveOps_t *AvsimSlaveOps (void)
+typedef const slaveOps_t *(*slaveEntry_t) (void);
+
+typedef struct slaveInstance
+{
+    const slaveOps_t *p_ops;
+    void *p_context;
+    uint32_t base;                  // Address window: base .. base + span - 1
+    uint32_t span;
+    void *p_library;                // Handle of the shared object, NULL: built-in
+} slaveInstance_t;
+
+typedef struct slaveBus
+{
+    slaveInstance_t *p_slaves;
+    int size;
+    int capacity;
+} slaveBus_t;
+
+// === Constant Definitions ===
+//
+#define SLAVE_API_VERSION       2
+#define SLAVE_ENTRY_SYMBOL      "AvsimSlaveOps"
+#define SLAVE_BASE_SEPARATOR    '@'         // <model>@<base>:<span>, hexadecimal
+#define SLAVE_SPAN_SEPARATOR    ':'
+#define SLAVE_BUS_MIN           4           // Initial capacity of the slave bus
+
+// === Public API Functions ===
+//
+/*!
+* @brief Attaches a slave model to the bus: "<model>[@<base>[:<span>]]", hexadecimal window.
+*           <model> is the name of a built-in model or the path of a shared object
+*           exporting SLAVE_ENTRY_SYMBOL.
+*
+* @param[in,out] p_bus The slave bus.
+* @param[in] p_spec The slave specification.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool AttachSlave (slaveBus_t * const p_bus, const char * const p_spec);
+
+/*!
+* @brief Resets each slave to the state after the reset of the HDL.
+*
+* @param[in,out] p_bus The slave bus.
+*
+* @return void
+*/
+void ResetSlaves (slaveBus_t * const p_bus);
+
+/*!
+* @brief Slave hook of the master model: the readdata and the waitrequest of the slave decoding the address,
+*           then the clock edge of each slave.
+*
+* @param[in,out] p_slave The slave bus.
+* @param[in,out] p_bus The signals of the master in the cycle, b_waitrequest is driven.
+*
+* @return The readdata of the cycle, 0 out of the windows.
+*/
+uint32_t SlaveBusHook (void *p_slave, avalonBus_t * const p_bus);
+
+/*!
+* @brief Returns with the interrupt line of the bus: OR of the slave interrupts.
+*
+* @param[in] p_bus The slave bus.
+*
+* @return Returns with true if any interrupt is pending.
+*/
+bool GetSlaveIrq (const slaveBus_t * const p_bus);
+
+/*!
+* @brief Clean up of the slave bus: the contexts and the shared objects.
+*
+* @param[in] p_bus The bus to be cleaned.
+*
+* @return void
+*/
+void CleanupSlaves (slaveBus_t * const p_bus);
+
+#endif // SLAVE_MODEL_H
+
+/*** EOF ***/
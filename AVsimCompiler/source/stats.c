@@ -0,0 +1,170 @@
+/** @file stats.c
+*
+* @brief Phase statistics of the compiler: wall time, processed bytes and lines,
+*           heap allocations of each phase by the counting allocator hooks.
+*
+*/
+
+#include "stats.h"
+#include "file_watch.h"
+
+#include <stdatomic.h>
+
+// === Type Definitions ===
+//
+typedef struct phaseStats
+{
+    int64_t time;               // Wall time [us]
+    uint64_t bytes;
+    uint64_t lines;
+    _Atomic uint64_t allocCount;    // Counted by the chunk workers too
+    _Atomic uint64_t allocBytes;
+    bool b_isEntered;
+} phaseStats_t;
+
+typedef struct compileStats
+{
+    bool b_isEnabled;
+    int active;                 // Running phase, statsPhaseLimit: none
+    int64_t start;              // Time stamp of the running phase [us]
+    phaseStats_t phases[statsPhaseLimit];
+} compileStats_t;
+
+// === Constant Definitions ===
+//
+static const char * const PHASE_NAMES[statsPhaseLimit] =
+{
+    "read", "echo", "compile", "sequence", "optimize", "emit", "estimate", "print", "write", "notify"
+};
+
+// The phases are switched by the main thread between the parallel runs,
+// the allocations of the chunk workers are counted in the running phase
+static compileStats_t s_stats = { false, statsPhaseLimit, 0, { { 0, 0, 0, 0, 0, false } } };
+
+// === Protected Functions ===
+//
+static inline void CountAllocation (const size_t size)
+{
+    if (s_stats.b_isEnabled && (s_stats.active < statsPhaseLimit))
+    {
+        atomic_fetch_add_explicit(&s_stats.phases[s_stats.active].allocCount, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&s_stats.phases[s_stats.active].allocBytes, size, memory_order_relaxed);
+    }
+}
+
+static inline double PerSecond (const uint64_t amount, const int64_t time)
+{
+    return (time > 0) ? (double) amount * 1e6 / (double) time : 0.0;
+}
+
+// === Public API Functions ===
+//
+void EnableStats (const bool b_isEnabled)
+{
+    memset(&s_stats, 0, sizeof(compileStats_t));
+    s_stats.active = statsPhaseLimit;
+    s_stats.b_isEnabled = b_isEnabled;
+}
+
+void BeginPhase (const statsPhase_t phase)
+{
+    if (!s_stats.b_isEnabled)
+    {
+        return;
+    }
+
+    EndPhase(0, 0);
+    s_stats.active = phase;
+    s_stats.phases[phase].b_isEntered = true;
+    s_stats.start = GetTimeStamp();
+}
+
+void EndPhase (const uint64_t bytes, const uint64_t lines)
+{
+    if (!s_stats.b_isEnabled || (s_stats.active == statsPhaseLimit))
+    {
+        return;
+    }
+
+    phaseStats_t * const p_phase = &s_stats.phases[s_stats.active];
+    p_phase->time += GetTimeStamp() - s_stats.start;
+    p_phase->bytes += bytes;
+    p_phase->lines += lines;
+    s_stats.active = statsPhaseLimit;
+}
+
+void *CountMalloc (const size_t size)
+{
+    CountAllocation(size);
+
+    return malloc(size);
+}
+
+void *CountCalloc (const size_t count, const size_t size)
+{
+    CountAllocation(count * size);
+
+    return calloc(count, size);
+}
+
+void *CountRealloc (void * const p_memory, const size_t size)
+{
+    CountAllocation(size);
+
+    return realloc(p_memory, size);
+}
+
+void PrintStats (FILE * const p_file, const statsFormat_t format)
+{
+    int64_t totalTime = 0;
+    uint64_t totalCount = 0;
+    uint64_t totalBytes = 0;
+
+    EndPhase(0, 0);
+    for (int i = 0; i < statsPhaseLimit; i++)
+    {
+        totalTime += s_stats.phases[i].time;
+        totalCount += atomic_load(&s_stats.phases[i].allocCount);
+        totalBytes += atomic_load(&s_stats.phases[i].allocBytes);
+    }
+
+    if (format == statsJson)
+    {
+        // Single line for the dashboards: {"phases":[...],"time_us":<total>,...}
+        fprintf(p_file, "{\"phases\":[");
+        bool b_isFirst = true;
+        for (int i = 0; i < statsPhaseLimit; i++)
+        {
+            const phaseStats_t * const p_phase = &s_stats.phases[i];
+            if (!p_phase->b_isEntered)
+            {
+                continue;
+            }
+            fprintf(p_file, "%s{\"name\":\"%s\",\"time_us\":%" PRId64 ",\"bytes\":%" PRIu64 ",\"lines\":%" PRIu64
+                   ",\"lines_per_s\":%.0f,\"allocs\":%" PRIu64 ",\"alloc_bytes\":%" PRIu64 "}",
+                   b_isFirst ? "" : ",", PHASE_NAMES[i], p_phase->time, p_phase->bytes, p_phase->lines,
+                   PerSecond(p_phase->lines, p_phase->time), atomic_load(&p_phase->allocCount), atomic_load(&p_phase->allocBytes));
+            b_isFirst = false;
+        }
+        fprintf(p_file, "],\"time_us\":%" PRId64 ",\"allocs\":%" PRIu64 ",\"alloc_bytes\":%" PRIu64 "}\n",
+               totalTime, totalCount, totalBytes);
+        return;
+    }
+
+    fprintf(p_file, "--- Compiler statistics: %.3f ms, %" PRIu64 " allocation(s), %" PRIu64 " byte(s) allocated ---\n",
+           (double) totalTime / 1000.0, totalCount, totalBytes);
+    fputs("phase        time [ms]        bytes     MB/s        lines      lines/s   allocs  alloc bytes\n", p_file);
+    for (int i = 0; i < statsPhaseLimit; i++)
+    {
+        const phaseStats_t * const p_phase = &s_stats.phases[i];
+        if (p_phase->b_isEntered)
+        {
+            fprintf(p_file, "%-9s %12.3f %12" PRIu64 " %8.1f %12" PRIu64 " %12.0f %8" PRIu64 " %12" PRIu64 "\n",
+                   PHASE_NAMES[i], (double) p_phase->time / 1000.0, p_phase->bytes, PerSecond(p_phase->bytes, p_phase->time) / 1e6,
+                   p_phase->lines, PerSecond(p_phase->lines, p_phase->time), atomic_load(&p_phase->allocCount),
+                   atomic_load(&p_phase->allocBytes));
+        }
+    }
+}
+
+/*** EOF ***/
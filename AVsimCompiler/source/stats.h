@@ -0,0 +1,96 @@
+/** @file stats.h
+*
+* @brief Phase statistics of the compiler: wall time, processed bytes and lines,
+*           heap allocations of each phase by the counting allocator hooks.
+*
+*/
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+// === Type Definitions ===
+//
+typedef enum
+{
+    statsRead = 0,          // ReadFile: mapping and line split of the source
+    statsEcho,              // PrintText: console echo of the source
+    statsCompile,           // CompileCode: lexing, validation and formatting of the rows in chunks
+    statsSequence,          // CompileCode: repeat nesting, burst checks and program counters
+    statsOptimize,          // OptimizeProgram
+    statsEmit,              // EmitCode
+    statsEstimate,          // AnalyzeTiming, AnnotateTiming
+    statsPrint,             // PrintBuffer: console echo of the compiled code
+    statsWrite,             // WriteFile
+    statsNotify,            // NotifyInvalid
+    statsPhaseLimit
+} statsPhase_t;
+
+typedef enum
+{
+    statsOff = 0,
+    statsTable,
+    statsJson
+} statsFormat_t;
+
+// === Public API Functions ===
+//
+/*!
+* @brief Clears the statistics and switches them on or off. While they are off,
+*           the phase marks return at once and the allocator hooks call the C library directly.
+*
+* @param[in] b_isEnabled The phases and the allocations are recorded.
+*
+* @return void
+*/
+void EnableStats (const bool b_isEnabled);
+
+/*!
+* @brief Closes the running phase, then starts the next one. The phases may be entered more times,
+*           their counters are accumulated.
+*
+* @param[in] phase The next phase.
+*
+* @return void
+*/
+void BeginPhase (const statsPhase_t phase);
+
+/*!
+* @brief Closes the running phase.
+*
+* @param[in] bytes Bytes processed by the phase.
+* @param[in] lines Lines processed by the phase.
+*
+* @return void
+*/
+void EndPhase (const uint64_t bytes, const uint64_t lines);
+
+/*!
+* @brief Allocator hooks: malloc, calloc and realloc counted in the running phase.
+*           Thread safe, the chunk workers may call them within the phase.
+*
+* @return MEMORY ALLOCATION: The allocated memory, NULL on error.
+*/
+void *CountMalloc (const size_t size);
+void *CountCalloc (const size_t count, const size_t size);
+void *CountRealloc (void * const p_memory, const size_t size);
+
+/*!
+* @brief Prints the phases as a table or as a single JSON object.
+*
+* @param[in] p_file The output, stdout for the console.
+* @param[in] format statsTable or statsJson.
+*
+* @return void
+*/
+void PrintStats (FILE * const p_file, const statsFormat_t format);
+
+#endif // STATS_H
+
+/*** EOF ***/
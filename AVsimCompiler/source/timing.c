@@ -0,0 +1,462 @@
+/** @file timing.c
+*
+* @brief Static cycle estimate of the compiled program: follows the LOAD state of avalon_master
+*           through the program and predicts the cycles of each instruction without simulation.
+*
+*/
+
+#include "timing.h"
+
+// === Type Definitions ===
+//
+typedef struct timingState
+{
+    uint32_t loadAddress;       // Last LOAD: mode|setup
+    uint32_t loadData;          // hold|readLatency|writeWait|readWait
+    bool b_isChained;           // Fast issue: the READ / WRITE is issued by the previous one without FETCH
+    uint64_t pendingDue[PENDING_READ_LIMIT];    // readdatavalid of the outstanding pipelined reads
+    uint32_t pendingHead;
+    uint32_t pendingCount;
+} timingState_t;
+
+typedef struct loopSnapshot
+{
+    // Counters at the end of the previous iteration of the block
+    bool b_isValid;
+    uint32_t firstPC;           // First instruction of the block
+    uint32_t loadAddress;       // LOAD state at the end of the iteration
+    uint32_t loadData;
+    uint64_t cycle;
+    uint64_t *p_cycles;         // Counters of the rows of the block
+    uint64_t *p_count;
+    uint32_t capacity;
+} loopSnapshot_t;
+
+// === Protected Functions ===
+//
+/*!
+* @brief Collects the valid instructions in the order of the program counter.
+*
+* @param[in] p_program The compiled program.
+* @param[out] p_size Number of the instructions.
+*
+* @return MEMORY ALLOCATION: The instructions, NULL on error.
+*/
+static modelInstr_t *CollectInstructions (const program_t * const p_program, uint32_t * const p_size)
+{
+    modelInstr_t * const p_instr = (modelInstr_t *) CountMalloc(((size_t) p_program->progCount + 1) * sizeof(modelInstr_t));
+    uint32_t pc = 0;
+
+    if (p_instr == NULL)
+    {
+        perror("Unable to allocate memory for the cycle estimate.");
+        return NULL;
+    }
+    for (int i = 0; i < p_program->rowSize; i++)
+    {
+        const instrRecord_t * const p_record = &p_program->p_records[i];
+        if ((p_record->flags & RECORD_INSTRUCTION) && (p_record->flags & RECORD_VALID))
+        {
+            p_instr[pc].address = p_record->address;
+            p_instr[pc].data = p_record->data;
+            p_instr[pc].opCode = p_record->opCode;
+            p_instr[pc++].b_isLoaded = true;
+        }
+    }
+    *p_size = pc;
+
+    return p_instr;
+}
+
+/*!
+* @brief FETCH of the next instruction: the pipelined read waits for a free response slot,
+*           the other instructions wait for each outstanding read.
+*
+* @param[in,out] p_state The LOAD state and the outstanding reads.
+* @param[in] cycle First cycle of the FETCH.
+* @param[in] b_isReadIssue The instruction is a pipelined read.
+*
+* @return The cycle when the FETCH proceeds.
+*/
+static uint64_t WaitPending (timingState_t * const p_state, uint64_t cycle, const bool b_isReadIssue)
+{
+    // The response leaves the FIFO at the end of its readdatavalid cycle
+    while (p_state->pendingCount && (p_state->pendingDue[p_state->pendingHead] < cycle))
+    {
+        p_state->pendingHead = (p_state->pendingHead + 1) % PENDING_READ_LIMIT;
+        p_state->pendingCount--;
+    }
+
+    if (b_isReadIssue && (p_state->pendingCount == PENDING_READ_LIMIT))
+    {
+        cycle = p_state->pendingDue[p_state->pendingHead] + 1;
+        p_state->pendingHead = (p_state->pendingHead + 1) % PENDING_READ_LIMIT;
+        p_state->pendingCount--;
+    }
+    else if (!b_isReadIssue && p_state->pendingCount)
+    {
+        const uint64_t lastDue = p_state->pendingDue[(p_state->pendingHead + p_state->pendingCount - 1) % PENDING_READ_LIMIT];
+        cycle = (lastDue + 1 > cycle) ? lastDue + 1 : cycle;
+        p_state->pendingCount = 0;
+    }
+
+    return cycle;
+}
+
+/*!
+* @brief Predicts the cycles of the instruction by the cycle table of avalon_master.
+*
+* @param[in,out] p_state The LOAD state and the outstanding reads.
+* @param[in] p_instr The instruction.
+* @param[in] start First cycle of the instruction.
+*
+* @return First cycle of the next instruction.
+*/
+static uint64_t StepTiming (timingState_t * const p_state, const modelInstr_t * const p_instr, const uint64_t start)
+{
+    const uint32_t mode = p_state->loadAddress & LOAD_MODE_MASK;
+    const bool b_isFastIssue = (mode & LOAD_MODE_FAST_ISSUE) != 0;
+    const bool b_isWaitrequest = (mode & LOAD_MODE_WAITREQUEST) != 0;
+    const bool b_isChained = p_state->b_isChained;
+    const uint64_t setup = (uint8_t) p_state->loadAddress;
+    const uint64_t hold = (uint8_t) (p_state->loadData >> 24);
+    const uint64_t readLatency = (uint8_t) (p_state->loadData >> 16);
+    const uint64_t writeWait = b_isWaitrequest ? 0 : (uint8_t) (p_state->loadData >> 8);
+    const uint64_t readWait = b_isWaitrequest ? 0 : (uint8_t) p_state->loadData;
+    // WAIT of AVALON_DELAY and PC_INCR, in waitrequest mode PC_INCR only
+    const uint64_t transferEnd = b_isWaitrequest ? 1 : AVALON_DELAY + 1;
+    const uint32_t burstCount = p_instr->data & ((UINT32_C(1) << BURST_COUNT_BITS) - 1);
+    const uint64_t beats = burstCount ? burstCount : 1;
+
+    p_state->b_isChained = false;
+    if ((p_instr->opCode == read) && (mode & LOAD_MODE_PIPELINED))
+    {
+        // Issued in FETCH, the response follows at least one cycle later
+        const uint64_t issue = WaitPending(p_state, start, true);
+        p_state->pendingDue[(p_state->pendingHead + p_state->pendingCount) % PENDING_READ_LIMIT] =
+            issue + (readLatency ? readLatency : 1);
+        p_state->pendingCount++;
+        return issue + 1;
+    }
+
+    const uint64_t fetch = WaitPending(p_state, start, false);
+    switch (p_instr->opCode)
+    {
+        case nop:
+        return fetch + (b_isFastIssue ? 1 : 2);
+        case read:
+            // The fast issue ends in the last cycle of the transfer, the next READ / WRITE is not FETCHed
+            p_state->b_isChained = b_isFastIssue;
+        return fetch + !b_isChained + setup + readWait + 1 + readLatency + (b_isFastIssue ? 0 : transferEnd);
+        case write:
+            p_state->b_isChained = b_isFastIssue;
+        return fetch + !b_isChained + setup + writeWait + 1 + hold + (b_isFastIssue ? 0 : transferEnd);
+        case wait:
+            // WAIT 0 counts through the whole counter
+        return fetch + 1 + ((uint64_t) (p_instr->data - 1) + 1) + 1;
+        case load:
+            p_state->loadAddress = p_instr->address;
+            p_state->loadData = p_instr->data;
+        return fetch + (b_isFastIssue ? 1 : 3);
+        case burstRead:
+            // The first beat follows the command at least one cycle later
+        return fetch + 1 + (readLatency ? readLatency : 1) + beats + transferEnd;
+        case burstWrite:
+        return fetch + 1 + beats + transferEnd;
+        default:
+            // REPEAT, END: FETCH and PC_INCR
+        return fetch + 2;
+    }
+}
+
+/*!
+* @brief END of a repeat block jumping back. If the LOAD state at the end of the iteration
+*           is the same as at the end of the previous one, the remaining iterations repeat
+*           the last one: their counters are added at once and the block is left.
+*
+* @param[in,out] p_timing The estimate.
+* @param[in,out] p_loops The loop registers.
+* @param[in,out] p_snapshot Counters of the previous iteration of the innermost block.
+* @param[in] p_state The LOAD state.
+* @param[in] p_instr The END instruction.
+* @param[in,out] p_cycle The cycle after the END.
+* @param[in,out] p_pc Program counter of the END, then the next program counter.
+*
+* @return MEMORY ALLOCATION: Returns with false if the memory allocation failed.
+*/
+static bool RepeatBlock (programTiming_t * const p_timing, loopStack_t * const p_loops, loopSnapshot_t * const p_snapshot,
+                         const timingState_t * const p_state, const modelInstr_t * const p_instr,
+                         uint64_t * const p_cycle, uint32_t * const p_pc)
+{
+    const uint32_t top = p_loops->level - 1;
+    const uint32_t first = p_loops->returnPC[top];
+    const uint32_t rows = *p_pc + 1 - first;
+
+    if (p_snapshot->b_isValid && (p_snapshot->firstPC == first) &&
+        (p_snapshot->loadAddress == p_state->loadAddress) && (p_snapshot->loadData == p_state->loadData))
+    {
+        const uint64_t remaining = p_loops->count[top] - 1;
+        for (uint32_t i = 0; i < rows; i++)
+        {
+            p_timing->p_cycles[first + i] += remaining * (p_timing->p_cycles[first + i] - p_snapshot->p_cycles[i]);
+            p_timing->p_count[first + i] += remaining * (p_timing->p_count[first + i] - p_snapshot->p_count[i]);
+        }
+        *p_cycle += remaining * (*p_cycle - p_snapshot->cycle);
+        p_loops->count[top] = 1;
+        p_snapshot->b_isValid = false;
+    }
+    else
+    {
+        if (rows > p_snapshot->capacity)
+        {
+            uint64_t * const p_cycles = (uint64_t *) CountRealloc(p_snapshot->p_cycles, rows * sizeof(uint64_t));
+            if (p_cycles != NULL)
+            {
+                p_snapshot->p_cycles = p_cycles;
+            }
+            uint64_t * const p_count = (uint64_t *) CountRealloc(p_snapshot->p_count, rows * sizeof(uint64_t));
+            if (p_count != NULL)
+            {
+                p_snapshot->p_count = p_count;
+            }
+            if ((p_cycles == NULL) || (p_count == NULL))
+            {
+                perror("Unable to allocate memory for the cycle estimate.");
+                return false;
+            }
+            p_snapshot->capacity = rows;
+        }
+        memcpy(p_snapshot->p_cycles, p_timing->p_cycles + first, rows * sizeof(uint64_t));
+        memcpy(p_snapshot->p_count, p_timing->p_count + first, rows * sizeof(uint64_t));
+        p_snapshot->b_isValid = true;
+        p_snapshot->firstPC = first;
+        p_snapshot->loadAddress = p_state->loadAddress;
+        p_snapshot->loadData = p_state->loadData;
+        p_snapshot->cycle = *p_cycle;
+    }
+    *p_pc = StepLoop(p_loops, p_instr, *p_pc + 1);
+
+    return true;
+}
+
+// === Public API Functions ===
+//
+bool AnalyzeTiming (const program_t * const p_program, programTiming_t * const p_timing)
+{
+    timingState_t state;
+    loopStack_t loops;
+    loopSnapshot_t snapshots[LOOP_DEPTH_LIMIT];
+    uint64_t cycle = 0;
+    uint32_t pc = 0;
+    uint32_t size;
+    bool b_isValid = true;
+
+    memset(p_timing, 0, sizeof(programTiming_t));
+    modelInstr_t * const p_instr = CollectInstructions(p_program, &size);
+    if (p_instr == NULL)
+    {
+        return false;
+    }
+    p_timing->size = size;
+    p_timing->p_cycles = (uint64_t *) CountCalloc((size_t) size + 1, sizeof(uint64_t));
+    p_timing->p_count = (uint64_t *) CountCalloc((size_t) size + 1, sizeof(uint64_t));
+    p_timing->p_start = (uint64_t *) CountCalloc((size_t) size + 1, sizeof(uint64_t));
+    if ((p_timing->p_cycles == NULL) || (p_timing->p_count == NULL) || (p_timing->p_start == NULL))
+    {
+        perror("Unable to allocate memory for the cycle estimate.");
+        free(p_instr);
+        CleanupTiming(p_timing);
+        return false;
+    }
+    memset(&state, 0, sizeof(state));
+    memset(&loops, 0, sizeof(loops));
+    memset(snapshots, 0, sizeof(snapshots));
+
+    while (b_isValid && (pc < size))
+    {
+        const modelInstr_t * const p_current = &p_instr[pc];
+        const uint64_t next = StepTiming(&state, p_current, cycle);
+
+        if (p_timing->p_count[pc]++ == 0)
+        {
+            p_timing->p_start[pc] = cycle;
+        }
+        p_timing->p_cycles[pc] += next - cycle;
+        cycle = next;
+
+        switch (p_current->opCode)
+        {
+            case burstWrite:
+                // The BEAT rows are not fetched
+                pc += 1 + ((p_current->data >> BURST_STEP_BITS) ? 1 : (p_current->data & ((UINT32_C(1) << BURST_COUNT_BITS) - 1)));
+            break;
+            case loop:
+                if (loops.level < LOOP_DEPTH_LIMIT)
+                {
+                    snapshots[loops.level].b_isValid = false;
+                }
+                pc = StepLoop(&loops, p_current, pc + 1);
+            break;
+            case loopEnd:
+                if (loops.level && (loops.count[loops.level - 1] > 1))
+                {
+                    b_isValid = RepeatBlock(p_timing, &loops, &snapshots[loops.level - 1], &state, p_current, &cycle, &pc);
+                }
+                else
+                {
+                    pc = StepLoop(&loops, p_current, pc + 1);
+                }
+            break;
+            default:
+                pc++;
+            break;
+        }
+    }
+    // The unknown instruction: FETCH after the outstanding reads, then simReady in PC_INCR
+    p_timing->cycles = WaitPending(&state, cycle, false) + 2;
+
+    for (int i = 0; i < LOOP_DEPTH_LIMIT; i++)
+    {
+        free(snapshots[i].p_cycles);
+        free(snapshots[i].p_count);
+    }
+    free(p_instr);
+    if (!b_isValid)
+    {
+        CleanupTiming(p_timing);
+    }
+
+    return b_isValid;
+}
+
+bool AnnotateTiming (const program_t * const p_program, const programTiming_t * const p_timing, textBuffer_t * const p_code)
+{
+    textBuffer_t annotated = { NULL, 0, p_code->size + (size_t) p_program->progCount * TIMING_NOTE_LIMIT + 1 };
+    const char *p_row = p_code->p_data;
+    const char * const p_end = p_code->p_data + p_code->size;
+    uint32_t pc = 0;
+
+    annotated.p_data = (char *) CountMalloc(annotated.capacity);
+    if (annotated.p_data == NULL)
+    {
+        perror("Unable to allocate memory for the compiled code.");
+        return false;
+    }
+
+    for (int i = 0; (i < p_program->rowSize) && (p_row < p_end); i++)
+    {
+        const char *p_rowEnd = (const char *) memchr(p_row, EOL_CHAR, (size_t) (p_end - p_row));
+        p_rowEnd = (p_rowEnd != NULL) ? p_rowEnd + 1 : p_end;
+        const uint16_t flags = p_program->p_records[i].flags;
+        const char *p_comment = p_rowEnd;
+
+        if ((flags & RECORD_INSTRUCTION) && (flags & RECORD_VALID))
+        {
+            if ((pc < p_timing->size) && p_timing->p_count[pc])
+            {
+                // Before the comment of the row: /*PC*/ <instruction> //<comment>
+                for (p_comment = p_row + sizeof(PC_PREFIX) - 1; p_comment + 1 < p_rowEnd; p_comment++)
+                {
+                    if (!strncmp(p_comment, OUTPUT_COMMENT, sizeof(OUTPUT_COMMENT) - 1))
+                    {
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                p_comment = p_rowEnd;
+            }
+        }
+
+        memcpy(annotated.p_data + annotated.size, p_row, (size_t) (p_comment - p_row));
+        annotated.size += (size_t) (p_comment - p_row);
+        if (p_comment != p_rowEnd)
+        {
+            annotated.size += (size_t) snprintf(annotated.p_data + annotated.size, TIMING_NOTE_LIMIT, "/*@%" PRIu64 " +%" PRIu64,
+                                                p_timing->p_start[pc], p_timing->p_cycles[pc]);
+            if (p_timing->p_count[pc] != 1)
+            {
+                annotated.size += (size_t) snprintf(annotated.p_data + annotated.size, TIMING_NOTE_LIMIT, " x%" PRIu64,
+                                                    p_timing->p_count[pc]);
+            }
+            memcpy(annotated.p_data + annotated.size, "*/ ", 3);
+            annotated.size += 3;
+            memcpy(annotated.p_data + annotated.size, p_comment, (size_t) (p_rowEnd - p_comment));
+            annotated.size += (size_t) (p_rowEnd - p_comment);
+        }
+        if ((flags & RECORD_INSTRUCTION) && (flags & RECORD_VALID))
+        {
+            pc++;
+        }
+        p_row = p_rowEnd;
+    }
+
+    CleanupBuffer(p_code);
+    *p_code = annotated;
+
+    return true;
+}
+
+void PrintTiming (const programTiming_t * const p_timing, const program_t * const p_program)
+{
+    int topRow[TIMING_TOP_LINES];
+    uint32_t topPC[TIMING_TOP_LINES];
+    int topSize = 0;
+    uint32_t pc = 0;
+
+    // The most expensive executed instructions in descending order, the BEAT rows are not executed
+    for (int i = 0; i < p_program->rowSize; i++)
+    {
+        const uint16_t flags = p_program->p_records[i].flags;
+        if (!(flags & RECORD_INSTRUCTION) || !(flags & RECORD_VALID))
+        {
+            continue;
+        }
+        if (p_timing->p_count[pc])
+        {
+            // The smaller entries are moved down, the last one drops out of a full list
+            int k = (topSize < TIMING_TOP_LINES) ? topSize++ : TIMING_TOP_LINES;
+            while ((k > 0) && (p_timing->p_cycles[topPC[k - 1]] < p_timing->p_cycles[pc]))
+            {
+                if (k < TIMING_TOP_LINES)
+                {
+                    topPC[k] = topPC[k - 1];
+                    topRow[k] = topRow[k - 1];
+                }
+                k--;
+            }
+            if (k < TIMING_TOP_LINES)
+            {
+                topPC[k] = pc;
+                topRow[k] = i;
+            }
+        }
+        pc++;
+    }
+
+    printf("--- Cycle estimate: %" PRIu64 " cycle(s), %" PRIu64 " ns until simReady ---\n",
+           p_timing->cycles, p_timing->cycles * MODEL_CLOCK_PERIOD_NS);
+    puts("  line      pc       cycles  share        count  source");
+    for (int k = 0; k < topSize; k++)
+    {
+        const textLine_t * const p_line = &p_program->p_source->p_lines[topRow[k]];
+        const uint64_t cycles = p_timing->p_cycles[topPC[k]];
+        printf("%6d. /*%*u*/ %12" PRIu64 " %5.1f %% %12" PRIu64 "  %.*s\n", topRow[k] + 1, p_program->pcWidth, topPC[k],
+               cycles, p_timing->cycles ? 100.0 * (double) cycles / (double) p_timing->cycles : 0.0,
+               p_timing->p_count[topPC[k]], p_line->length, p_line->p_text);
+    }
+}
+
+void CleanupTiming (programTiming_t * const p_timing)
+{
+    free(p_timing->p_cycles);
+    free(p_timing->p_count);
+    free(p_timing->p_start);
+    p_timing->p_cycles = NULL;
+    p_timing->p_count = NULL;
+    p_timing->p_start = NULL;
+    p_timing->size = 0;
+}
+
+/*** EOF ***/
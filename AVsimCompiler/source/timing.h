@@ -0,0 +1,87 @@
+/** @file timing.h
+*
+* @brief Static cycle estimate of the compiled program: follows the LOAD state of avalon_master
+*           through the program and predicts the cycles of each instruction without simulation.
+*
+*/
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "file_access.h"
+#include "compile.h"
+#include "avalon_model.h"
+
+// === Type Definitions ===
+//
+typedef struct programTiming
+{
+    uint64_t *p_cycles;     // Cycles of each program counter in all of its executions
+    uint64_t *p_count;      // Executions of each program counter, 0: BEAT rows
+    uint64_t *p_start;      // Cycle of the first execution
+    uint32_t size;          // Number of valid instructions
+    uint64_t cycles;        // Cycles until simReady, like the native model
+} programTiming_t;
+
+// === Constant Definitions ===
+//
+#define TIMING_NOTE_LIMIT   72          // Upper limit of the annotation of a row: three 20 digit numbers
+#define TIMING_TOP_LINES    10          // Most expensive lines of the summary
+
+// === Public API Functions ===
+//
+/*!
+* @brief Predicts the cycles of each instruction by the cycle table of avalon_master:
+*           the timing and the modes of the current LOAD, the fast issue chains,
+*           the outstanding pipelined reads and the iterations of the repeat blocks.
+*           The waitrequest of the slave is never asserted. The iterations of a block
+*           starting in the same LOAD state are not walked again, they are multiplied.
+*
+* @param[in] p_program The compiled program.
+* @param[out] p_timing The estimate.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool AnalyzeTiming (const program_t * const p_program, programTiming_t * const p_timing);
+
+/*!
+* @brief Annotates the rows of the compiled code: a block comment of "@<first start cycle> +<cycles>[ x<executions>]"
+*           before the comment of each executed instruction.
+*
+* @param[in] p_program The compiled program.
+* @param[in] p_timing The estimate.
+* @param[in,out] p_code The compiled code of EmitCode, replaced by the annotated code.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+bool AnnotateTiming (const program_t * const p_program, const programTiming_t * const p_timing, textBuffer_t * const p_code);
+
+/*!
+* @brief Prints the estimated run time and the most expensive source lines.
+*
+* @param[in] p_timing The estimate.
+* @param[in] p_program The compiled program.
+*
+* @return void
+*/
+void PrintTiming (const programTiming_t * const p_timing, const program_t * const p_program);
+
+/*!
+* @brief Clean up of the estimate.
+*
+* @param[in,out] p_timing The estimate.
+*
+* @return void
+*/
+void CleanupTiming (programTiming_t * const p_timing);
+
+#endif // TIMING_H
+
+/*** EOF ***/
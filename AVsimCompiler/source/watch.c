@@ -0,0 +1,367 @@
+/** @file watch.c
+*
+* @brief Watch mode: recompiles the Avalon Simulator sources when they are saved.
+*
+*/
+
+#include "watch.h"
+
+#include <signal.h>
+#include <sys/stat.h>
+
+// === Global Variables ===
+//
+static volatile sig_atomic_t watchInterrupted = 0;
+
+// === Protected Functions ===
+//
+/*!
+* @brief Signal handler: finishes the watch.
+*
+* @param[in] signal The received signal.
+*
+* @return void
+*/
+static void InterruptWatch (int signal)
+{
+    (void) signal;
+    watchInterrupted = 1;
+}
+
+/*!
+* @brief Returns with the modification time and the size of the file.
+*
+* @param[in] p_path The path of the file.
+* @param[out] p_time Modification time.
+* @param[out] p_size Size of the file.
+*
+* @return True, if the file exists.
+*/
+static bool GetFileState (const char * const p_path, int64_t * const p_time, int64_t * const p_size)
+{
+    struct stat fileStat;
+
+    if (stat(p_path, &fileStat) != 0)
+    {
+        return false;
+    }
+    *p_time = (int64_t) fileStat.st_mtime;
+    *p_size = (int64_t) fileStat.st_size;
+
+    return true;
+}
+
+/*!
+* @brief Watches the folder.
+*
+* @param[in,out] p_set The watch set.
+* @param[in] p_folder Folder path.
+* @param[in] b_isCollecting Each new source of the folder is added.
+*
+* @return Index of the folder, -1 on error.
+*/
+static int WatchFolder (watchSet_t * const p_set, const char * const p_folder, const bool b_isCollecting)
+{
+    const int folderSize = p_set->watch.folderSize;
+    const int folder = AddWatchFolder(&p_set->watch, p_folder);
+
+    if (folder == folderSize)
+    {
+        bool * const p_isCollecting = (bool *) realloc(p_set->p_isCollecting, (folderSize + 1) * sizeof(bool));
+        if (p_isCollecting == NULL)
+        {
+            perror("Unable to allocate memory for the file watch.");
+            return -1;
+        }
+        p_set->p_isCollecting = p_isCollecting;
+        p_isCollecting[folder] = false;
+    }
+    if (folder >= 0)
+    {
+        p_set->p_isCollecting[folder] |= b_isCollecting;
+    }
+
+    return folder;
+}
+
+/*!
+* @brief Creates the resident program of the batch job and watches its folder.
+*
+* @param[in,out] p_set The watch set.
+* @param[in] job Index of the batch job.
+*
+* @return MEMORY ALLOCATION: Returns with true in case of success.
+*/
+static bool AddProgram (watchSet_t * const p_set, const int job)
+{
+    char folder[FILENAME_MAX];
+    const char * const p_source = p_set->batch.p_jobs[job].p_source;
+
+    watchProgram_t * const p_programs = (watchProgram_t *) realloc(p_set->p_programs, p_set->batch.capacity * sizeof(watchProgram_t));
+    if (p_programs == NULL)
+    {
+        perror("Unable to allocate memory for the file watch.");
+        return false;
+    }
+    p_set->p_programs = p_programs;
+
+    // Split the source path to folder and file name
+    const char *p_name = p_source;
+    for (const char *p_char = p_source; *p_char; p_char++)
+    {
+        if ((*p_char == '/') || (*p_char == '\\'))
+        {
+            p_name = p_char + 1;
+        }
+    }
+    if (p_name == p_source)
+    {
+        snprintf(folder, sizeof(folder), ".");
+    }
+    else
+    {
+        snprintf(folder, sizeof(folder), "%.*s", (int) (p_name - p_source - 1), p_source);
+    }
+
+    watchProgram_t * const p_program = &p_programs[job];
+    memset(p_program, 0, sizeof(watchProgram_t));
+    p_program->p_name = p_name;
+    p_program->folder = WatchFolder(p_set, (folder[0] != '\0') ? folder : "/", false);
+    p_program->fileTime = -1;
+
+    return p_program->folder >= 0;
+}
+
+/*!
+* @brief Recompiles the program by its resident state and replaces the compiled code atomically.
+*
+* @param[in,out] p_set The watch set.
+* @param[in] job Index of the batch job.
+*
+* @return void
+*/
+static void BuildProgram (watchSet_t * const p_set, const int job)
+{
+    const int64_t start = GetTimeStamp();
+    batchJob_t * const p_job = &p_set->batch.p_jobs[job];
+    watchProgram_t * const p_watched = &p_set->p_programs[job];
+    cacheStats_t stats;
+
+    GetFileState(p_job->p_source, &p_watched->fileTime, &p_watched->fileSize);
+    sourceText_t * const p_source = ReadFile(p_job->p_source);
+    if (p_source == NULL)
+    {
+        return;
+    }
+
+    program_t * const p_program = RecompileState(p_source, &p_watched->state, p_set->jobs, &stats);
+    if ((p_program != NULL) && stats.b_isChanged)
+    {
+        p_job->b_isCompiled = WriteFileAtomic(p_job->p_target, &p_watched->state.output);
+        p_job->progCount = p_program->progCount;
+        p_job->invalidCount = CountInvalid(p_program);
+
+        printf("'%s' -> '%s': %d of %d row(s) recompiled, %d instruction(s) in %.2f ms.\n",
+               p_job->p_source, p_job->p_target, stats.changedLast - stats.changedFirst,
+               p_program->rowSize, p_program->progCount, (double) (GetTimeStamp() - start) / 1000.0);
+        if (p_job->invalidCount)
+        {
+            NotifyInvalid(p_program);
+        }
+        if ((p_set->depthBits != INSTR_DEPTH_AUTO) && (GetDepthBits(p_program->progCount) > p_set->depthBits))
+        {
+            fprintf(stderr, "=> ERROR in '%s': %d instruction(s) exceed the instruction memory of 2^%d entries.\n",
+                    p_job->p_source, p_program->progCount, p_set->depthBits);
+        }
+        fflush(stdout);
+    }
+
+    CleanupProgram(p_program);
+    CleanupText(p_source);
+}
+
+/*!
+* @brief Rewrites the Verilog definition file if forced or the instruction memory depth is changed.
+*
+* @param[in,out] p_set The watch set.
+* @param[in] b_isForced The batch is changed.
+*
+* @return void
+*/
+static void UpdateDefFile (watchSet_t * const p_set, const bool b_isForced)
+{
+    const int depthBits = (p_set->depthBits == INSTR_DEPTH_AUTO) ? GetBatchDepthBits(&p_set->batch) : p_set->depthBits;
+
+    if (b_isForced || (depthBits != p_set->defDepthBits))
+    {
+        WriteBatchDefFile(p_set->p_defPath, p_set->p_subfolder, &p_set->batch, depthBits);
+        p_set->defDepthBits = depthBits;
+    }
+}
+
+/*!
+* @brief Recompiles the changed programs of the folders without change notification.
+*
+* @param[in,out] p_set The watch set.
+*
+* @return void
+*/
+static void PollPrograms (watchSet_t * const p_set)
+{
+    int64_t fileTime;
+    int64_t fileSize;
+
+    for (int i = 0; i < p_set->batch.size; i++)
+    {
+        const watchProgram_t * const p_watched = &p_set->p_programs[i];
+        if ((p_set->watch.p_folders[p_watched->folder].id < 0) &&
+            GetFileState(p_set->batch.p_jobs[i].p_source, &fileTime, &fileSize) &&
+            ((fileTime != p_watched->fileTime) || (fileSize != p_watched->fileSize)))
+        {
+            BuildProgram(p_set, i);
+            UpdateDefFile(p_set, false);
+        }
+    }
+}
+
+// === Public API Functions ===
+//
+int OpenWatchSet (watchSet_t * const p_set, const int inputSize, char ** const pp_inputs, const char * const p_subfolder,
+                  const char * const p_defPath, const int jobs, const int depthBits)
+{
+    int result = 0;
+
+    memset(p_set, 0, sizeof(watchSet_t));
+    p_set->p_subfolder = p_subfolder;
+    p_set->p_defPath = p_defPath;
+    p_set->jobs = jobs;
+    p_set->depthBits = depthBits;
+    OpenWatch(&p_set->watch);
+
+    // Collect the initial sources, the folders are watched for new sources too
+    for (int i = 0; i < inputSize; i++)
+    {
+        struct stat fileStat;
+        const bool b_isFolder = (stat(pp_inputs[i], &fileStat) == 0) && S_ISDIR(fileStat.st_mode);
+
+        if (b_isFolder && (WatchFolder(p_set, pp_inputs[i], true) < 0))
+        {
+            result = -1;
+        }
+        if (!CollectSources(pp_inputs[i], &p_set->batch) && !b_isFolder)
+        {
+            fprintf(stderr, "No source is found: '%s'\n", pp_inputs[i]);
+        }
+    }
+    for (int i = 0; (result == 0) && (i < p_set->batch.size); i++)
+    {
+        if (!AddProgram(p_set, i))
+        {
+            result = -1;
+            break;
+        }
+        BuildProgram(p_set, i);
+    }
+    if ((result != 0) || (p_set->watch.folderSize == 0))
+    {
+        fputs("Nothing to watch.\n", stderr);
+        CleanupWatchSet(p_set);
+        return -1;
+    }
+    UpdateDefFile(p_set, true);
+
+    return 0;
+}
+
+void HandleWatchChange (watchSet_t * const p_set, const int folder, const char * const p_name)
+{
+    char path[FILENAME_MAX];
+
+    for (int i = 0; i < p_set->batch.size; i++)
+    {
+        if ((p_set->p_programs[i].folder == folder) && !strcmp(p_set->p_programs[i].p_name, p_name))
+        {
+            BuildProgram(p_set, i);
+            UpdateDefFile(p_set, false);
+            return;
+        }
+    }
+
+    // New source in a collected folder
+    const size_t length = strlen(p_name);
+    const size_t extensionLength = sizeof(SOURCE_FILE_EXTENSION) - 1;
+    if (!p_set->p_isCollecting[folder] || (length <= extensionLength) ||
+        strcmp(p_name + length - extensionLength, SOURCE_FILE_EXTENSION))
+    {
+        return;
+    }
+
+    const int pathLength = snprintf(path, sizeof(path), "%s/%s", p_set->watch.p_folders[folder].p_path, p_name);
+    if ((pathLength < 0) || ((size_t) pathLength >= sizeof(path)))
+    {
+        fprintf(stderr, "=> ERROR in '%s': too long path, the source is not watched.\n", p_name);
+        return;
+    }
+    const int job = p_set->batch.size;
+    if (CollectSources(path, &p_set->batch) && AddProgram(p_set, job))
+    {
+        BuildProgram(p_set, job);
+        UpdateDefFile(p_set, true);
+    }
+}
+
+void CleanupWatchSet (watchSet_t * const p_set)
+{
+    for (int i = 0; (p_set->p_programs != NULL) && (i < p_set->batch.size); i++)
+    {
+        CleanupState(&p_set->p_programs[i].state);
+    }
+    free(p_set->p_programs);
+    free(p_set->p_isCollecting);
+    CleanupBatch(&p_set->batch);
+    CloseWatch(&p_set->watch);
+}
+
+int WatchSources (const int inputSize, char ** const pp_inputs, const char * const p_subfolder,
+                  const char * const p_defPath, const int jobs, const int depthBits)
+{
+    watchSet_t set;
+    char name[FILENAME_MAX];
+    int folder;
+    int result = 0;
+
+    if (OpenWatchSet(&set, inputSize, pp_inputs, p_subfolder, p_defPath, jobs, depthBits) != 0)
+    {
+        return -1;
+    }
+
+    printf("Watching %d source(s) in %d folder(s)%s, press Ctrl+C to finish.\n", set.batch.size,
+           set.watch.folderSize, (set.watch.handle < 0) ? " by polling" : "");
+    fflush(stdout);
+
+    signal(SIGINT, InterruptWatch);
+    while (!watchInterrupted)
+    {
+        const int change = WaitFileChange(&set.watch, &folder, name, sizeof(name), WATCH_POLL_MS);
+        if (change == WATCH_CHANGED)
+        {
+            HandleWatchChange(&set, folder, name);
+        }
+        else if (change == WATCH_TIMEOUT)
+        {
+            PollPrograms(&set);
+        }
+        else if (!watchInterrupted)
+        {
+            perror("Unable to watch the sources.");
+            result = -1;
+            break;
+        }
+    }
+
+    CleanupWatchSet(&set);
+
+    return result;
+}
+
+/*** EOF ***/
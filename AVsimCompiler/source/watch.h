@@ -0,0 +1,112 @@
+/** @file watch.h
+*
+* @brief Watch mode: recompiles the Avalon Simulator sources when they are saved.
+*
+*/
+
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "file_access.h"
+#include "file_watch.h"
+#include "compile.h"
+#include "cache.h"
+#include "batch.h"
+#include "notify_invalid.h"
+
+// === Type Definitions ===
+//
+typedef struct watchProgram
+{
+    int folder;                 // Index of the watched folder
+    const char *p_name;         // File name inside the source path of the batch job
+    compileState_t state;       // Resident state of the last compilation
+    int64_t fileTime;           // Modification time and size of the compiled source
+    int64_t fileSize;
+} watchProgram_t;
+
+typedef struct watchSet
+{
+    batch_t batch;              // The watched sources
+    watchProgram_t *p_programs; // One resident program for each batch job
+    fileWatch_t watch;
+    bool *p_isCollecting;       // Each new source of the folder is added
+    const char *p_subfolder;    // Verilog project subfolder path of the compiled codes
+    const char *p_defPath;      // Verilog definition file
+    int jobs;
+    int depthBits;              // Instruction memory depth, INSTR_DEPTH_AUTO: fitting the largest program
+    int defDepthBits;           // Depth of the written Verilog definition file
+} watchSet_t;
+
+// === Constant Definitions ===
+//
+#define WATCH_POLL_MS       50      // Polling period without change notification
+
+// === Macros ===
+//
+
+
+// === Public API Functions ===
+//
+/*!
+* @brief Compiles the sources, writes the Verilog definition file and opens the watch of their folders.
+*
+* @param[out] p_set The watch set.
+* @param[in] inputSize Number of inputs.
+* @param[in] pp_inputs Source files, folders (each *.av inside, new ones too) or patterns.
+* @param[in] p_subfolder Verilog project subfolder path of the compiled codes.
+* @param[in] p_defPath Verilog definition file.
+* @param[in] jobs Worker threads, 0: one for each processor.
+* @param[in] depthBits Address bits of the instruction memory, INSTR_DEPTH_AUTO: fitting the largest program.
+*
+* @return MEMORY ALLOCATION: 0 in case of success, -1 if there is nothing to watch: the set is cleaned.
+*/
+int OpenWatchSet (watchSet_t * const p_set, const int inputSize, char ** const pp_inputs, const char * const p_subfolder,
+                  const char * const p_defPath, const int jobs, const int depthBits);
+
+/*!
+* @brief Handles the changed file: recompiles its program or adds it as a new program of a collected folder,
+*           then updates the Verilog definition file.
+*
+* @param[in,out] p_set The watch set.
+* @param[in] folder Index of the folder of the changed file.
+* @param[in] p_name File name of the changed file.
+*
+* @return void
+*/
+void HandleWatchChange (watchSet_t * const p_set, const int folder, const char * const p_name);
+
+/*!
+* @brief Clean up of the watch set.
+*
+* @param[in] p_set The watch set to be cleaned.
+*
+* @return void
+*/
+void CleanupWatchSet (watchSet_t * const p_set);
+
+/*!
+* @brief Compiles the sources, then recompiles each one when it is saved
+*           until interrupted. The compiled code is replaced atomically.
+*
+* @param[in] inputSize Number of inputs.
+* @param[in] pp_inputs Source files, folders (each *.av inside, new ones too) or patterns.
+* @param[in] p_subfolder Verilog project subfolder path of the compiled codes.
+* @param[in] p_defPath Verilog definition file.
+* @param[in] jobs Worker threads, 0: one for each processor.
+* @param[in] depthBits Address bits of the instruction memory, INSTR_DEPTH_AUTO: fitting the largest program.
+*
+* @return 0, if the watch is finished by interruption.
+*/
+int WatchSources (const int inputSize, char ** const pp_inputs, const char * const p_subfolder,
+                  const char * const p_defPath, const int jobs, const int depthBits);
+
+#endif // WATCH_H
+
+/*** EOF ***/
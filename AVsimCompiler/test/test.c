@@ -9,22 +9,46 @@
 // === Protected Functions ===
 //
 /*!
-* @brief Prints the 1D string array input to the standard output
+* @brief Prints the source line views to the standard output
 *
-* @param[in] pp_source 1D string array input.
-* @param[in] size Size of the string array.
+* @param[in] p_source Source text input.
 *
 * @return void.
 */
-static inline void PrintText (char ** const pp_source, int size)
+static inline void PrintText (const sourceText_t * const p_source)
 {
     int i;
-    for (i=0; i < size; i++)
+    for (i=0; i < p_source->param.rowSize; i++)
     {
-        printf("%d. %s\n", i + 1, pp_source[i]);
+        printf("%d. %.*s\n", i + 1, p_source->p_lines[i].length, p_source->p_lines[i].p_text);
     }
 }
 
+/*!
+* @brief Writes the source rows into the file, the rows are repeated up to the requested number.
+*
+* @param[in] p_path Path of the file.
+* @param[in] pp_rows Source rows.
+* @param[in] rowSize Number of the source rows.
+* @param[in] count Number of the written rows.
+*
+* @return Returns with true in case of success.
+*/
+static bool WriteRows (const char * const p_path, const char * const * const pp_rows, const int rowSize, const int count)
+{
+    FILE * const p_file = fopen(p_path, "w");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        fprintf(p_file, "%s\n", pp_rows[i % rowSize]);
+    }
+
+    return fclose(p_file) == 0;
+}
+
 /*!
 * @brief Reading File Test Procedure.
 *
@@ -32,14 +56,39 @@ static inline void PrintText (char ** const pp_source, int size)
 */
 static void FileReadTest (void)
 {
-    textSize_t testParam = {0, 0};
-    char ** const pp_sourceText = ReadFile(TEST_SOURCE_FILE, &testParam);
+    sourceText_t * const p_sourceText = ReadFile(TEST_SOURCE_FILE);
+    if (p_sourceText == NULL)
+    {
+        return;
+    }
     printf("--- Source File Reading Test '%s'| Maximum length of rows: %d; Number of rows: %d ---\n",
-           TEST_SOURCE_FILE, testParam.bufferSize, testParam.rowSize);
-    PrintText(pp_sourceText, testParam.rowSize);
+           TEST_SOURCE_FILE, p_sourceText->param.bufferSize, p_sourceText->param.rowSize);
+    PrintText(p_sourceText);
 
     puts("");
-    CleanupText(pp_sourceText, testParam.rowSize);
+    CleanupText(p_sourceText);
+}
+
+/*!
+* @brief Empty File Test Procedure: an empty file has to be read as a text without rows,
+*           compiled and emitted without instructions.
+*
+* @return void.
+*/
+static void EmptyFileTest (void)
+{
+    WriteRows(TEST_EMPTY_FILE, NULL, 0, 0);
+    sourceText_t * const p_emptyText = ReadFile(TEST_EMPTY_FILE);
+    program_t * const p_program = (p_emptyText != NULL) ? CompileCode(p_emptyText, 1) : NULL;
+    textBuffer_t targetText = { NULL, 0, 0 };
+    const bool b_isEmpty = (p_program != NULL) && (p_emptyText->dataSize == 0) && (p_emptyText->param.rowSize == 0) &&
+                           (p_program->progCount == 0) && EmitCode(p_program, &targetText) && (targetText.size == 0);
+    printf("--- Empty File Reading Test '%s' ---\n", TEST_EMPTY_FILE);
+    printf("%s: %d row(s)\n\n", b_isEmpty ? "VALID" : "INVALID", (p_emptyText != NULL) ? p_emptyText->param.rowSize : -1);
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_emptyText);
+    remove(TEST_EMPTY_FILE);
 }
 
 /*!
@@ -49,19 +98,1738 @@ static void FileReadTest (void)
 */
 static void CompileTest (void)
 {
-    textSize_t testParam = {0, 0};
-    char ** const pp_sourceText = ReadFile(TEST_SOURCE_FILE, &testParam);
+    sourceText_t * const p_sourceText = ReadFile(TEST_SOURCE_FILE);
+    if (p_sourceText == NULL)
+    {
+        return;
+    }
     printf("--- Compiling Test '%s'| Maximum length of rows: %d; Number of rows: %d ---\n",
-           TEST_SOURCE_FILE, testParam.bufferSize, testParam.rowSize);
+           TEST_SOURCE_FILE, p_sourceText->param.bufferSize, p_sourceText->param.rowSize);
 
-    char ** const pp_targetText = CompileCode(pp_sourceText, &testParam);
-    PrintText(pp_targetText, testParam.rowSize);
-    puts("");
+    program_t * const p_program = CompileCode(p_sourceText, 1);
+    textBuffer_t targetText = { NULL, 0, 0 };
+    if ((p_program != NULL) && EmitCode(p_program, &targetText))
+    {
+        printf("Record size: %d bytes; Number of instructions: %d\n",
+               (int) sizeof(instrRecord_t), p_program->progCount);
+        fwrite(targetText.p_data, 1, targetText.size, stdout);
+        puts("");
+
+        NotifyInvalid(p_program);
+    }
+
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+}
+
+/*!
+* @brief Long Row Test Procedure: the comment after more than 64 KiB of the row has to be sliced exactly.
+*
+* @return void.
+*/
+static void LongRowTest (void)
+{
+    static const char COMMENT[] = " far comment";
+
+    FILE * const p_file = fopen(TEST_LONG_ROW_FILE, "w");
+    if (p_file == NULL)
+    {
+        return;
+    }
+    fprintf(p_file, "read 1 0%*s;%s\n", TEST_LONG_ROW_SPACES, "", COMMENT);
+    fclose(p_file);
+
+    sourceText_t * const p_sourceText = ReadFile(TEST_LONG_ROW_FILE);
+    program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+    const instrRecord_t * const p_record = (p_program != NULL) ? &p_program->p_records[0] : NULL;
+    const bool b_isSliced = (p_record != NULL) && (p_record->flags & RECORD_COMMENT) &&
+                            (p_record->commentStart == sizeof("read 1 0;") - 1 + TEST_LONG_ROW_SPACES) &&
+                            (p_record->commentLength == sizeof(COMMENT) - 1) &&
+                            !memcmp(p_sourceText->p_lines[0].p_text + p_record->commentStart, COMMENT, sizeof(COMMENT) - 1);
+    printf("--- Long Row Test | Spaces before the comment: %d ---\n", TEST_LONG_ROW_SPACES);
+    printf("%s: comment at column %u\n\n", b_isSliced ? "VALID" : "INVALID", (p_record != NULL) ? p_record->commentStart : 0);
+
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+    remove(TEST_LONG_ROW_FILE);
+}
+
+/*!
+* @brief Hexadecimal Conversion Test Procedure: compares the kernels with the C library.
+*
+* @return void.
+*/
+static void HexConvertTest (void)
+{
+    static const char * const OPERANDS[] = { "0", "a", "F", "1235fe", "2233AA01", "ffffffff", "fffh", "1ga4f", "123456789", "7fFfFfFf" };
+    char expected[HEX_LIMIT + 1];
+    char emitted[HEX_LIMIT + 1] = {'\0'};
+    char *p_end;
+    uint32_t value;
+    int errors = 0;
+
+    puts("--- Hexadecimal Conversion Test ---");
+    for (int i = 0; i < (int) (sizeof(OPERANDS) / sizeof(OPERANDS[0])); i++)
+    {
+        const int length = (int) strlen(OPERANDS[i]);
+        const bool b_isHexa = ParseHexa(OPERANDS[i], length, &value);
+        const unsigned long reference = strtoul(OPERANDS[i], &p_end, 16);
+        const bool b_isReference = (*p_end == '\0') && (length <= HEX_LIMIT);
+
+        if ((b_isHexa != b_isReference) || (b_isHexa && (value != (uint32_t) reference)))
+        {
+            printf("ParseHexa mismatch: '%s'\n", OPERANDS[i]);
+            errors++;
+            continue;
+        }
+        if (b_isHexa)
+        {
+            snprintf(expected, sizeof(expected), "%08X", value);
+            EmitHexa(emitted, value);
+            if (strcmp(expected, emitted))
+            {
+                printf("EmitHexa mismatch: '%s' != '%s'\n", emitted, expected);
+                errors++;
+            }
+        }
+    }
+    printf("%d error(s)\n\n", errors);
+}
+
+/*!
+* @brief Lexer Throughput Test Procedure: compiles a generated large source.
+*
+* @return void.
+*/
+static void LexerThroughputTest (void)
+{
+    static const char * const SOURCE_ROWS[] =
+    {
+        "write 0 1235fe  ; setting the dividend",
+        "Read 5 0",
+        "LOAD 11 2233aa01 ; timing",
+        "wait 0 5",
+        "; comment only row",
+        "write 1ga4f ffff ; invalid address",
+        "nop 0 0",
+        ""
+    };
+    const int sourceRowSize = (int) (sizeof(SOURCE_ROWS) / sizeof(SOURCE_ROWS[0]));
+
+    if (!WriteRows(TEST_LEXER_FILE, SOURCE_ROWS, sourceRowSize, TEST_LEXER_ROWS))
+    {
+        return;
+    }
+
+    const clock_t start = clock();
+    sourceText_t * const p_sourceText = ReadFile(TEST_LEXER_FILE);
+    program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+    const double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    program_t * const p_parallel = (p_sourceText != NULL) ? CompileCode(p_sourceText, 0) : NULL;
+
+    if (p_program != NULL)
+    {
+        const double megaBytes = (double) p_sourceText->dataSize / (1024.0 * 1024.0);
+        printf("--- Lexer Throughput Test '%s'| Number of rows: %d; Number of instructions: %d ---\n",
+               TEST_LEXER_FILE, p_program->rowSize, p_program->progCount);
+        printf("%.1f MB in %.3f s: %.1f MB/s\n", megaBytes, seconds, (seconds > 0.0) ? megaBytes / seconds : 0.0);
+    }
+
+    // The parallel compilation must be identical to the serial one
+    textBuffer_t serialText = { NULL, 0, 0 };
+    textBuffer_t parallelText = { NULL, 0, 0 };
+    if ((p_parallel != NULL) && EmitCode(p_program, &serialText) && EmitCode(p_parallel, &parallelText))
+    {
+        const bool b_isIdentical = (serialText.size == parallelText.size) &&
+                                   !memcmp(serialText.p_data, parallelText.p_data, serialText.size);
+        printf("Parallel compilation on %d processor(s), %d chunk(s): %s\n\n",
+               GetProcessorCount(), p_parallel->chunkSize, b_isIdentical ? "identical" : "MISMATCH");
+    }
+
+    CleanupBuffer(&parallelText);
+    CleanupBuffer(&serialText);
+    CleanupProgram(p_parallel);
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+    remove(TEST_LEXER_FILE);
+}
+
+/*!
+* @brief Model Test Procedure: simulates the compiled division example on the native model
+*           of the Avalon master without slave, then compares the cycles with the HDL.
+*           Then the div_avalon slave model has to return the quotient and the remainder.
+*
+* @return void.
+*/
+static void ModelTest (void)
+{
+    static const char * const SOURCE_ROWS[] =
+    {
+        "load 0 00000001 ; Set ReadWait to 1",
+        "read 5 0        ; Check module availability",
+        "write 0 9d      ; Set Dividend: 157",
+        "write 1 3       ; Set Divisor: 3",
+        "write 2 1       ; Start the module",
+        "wait 0 5        ; Wait for completion",
+        "read 5 0        ; Check division is finished",
+        "write 6 0       ; Clear IRQ",
+        "read 3 0        ; Get quotient",
+        "read 4 0        ; Get reminder"
+    };
+    const int sourceRowSize = (int) (sizeof(SOURCE_ROWS) / sizeof(SOURCE_ROWS[0]));
+
+    if (!WriteRows(TEST_MODEL_FILE, SOURCE_ROWS, sourceRowSize, sourceRowSize))
+    {
+        return;
+    }
+
+    // Compile to the image in place of the source
+    sourceText_t * const p_sourceText = ReadFile(TEST_MODEL_FILE);
+    program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+    textBuffer_t targetText = { NULL, 0, 0 };
+    const bool b_isCompiled = (p_program != NULL) && EmitCode(p_program, &targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+    if (!b_isCompiled || !WriteFile(TEST_MODEL_FILE, &targetText))
+    {
+        CleanupBuffer(&targetText);
+        return;
+    }
+    CleanupBuffer(&targetText);
+
+    modelImage_t * const p_image = LoadImage(TEST_MODEL_FILE);
+    if (p_image != NULL)
+    {
+        avalonModel_t model;
+        eventLog_t log = { NULL, 0, 0 };
+
+        ResetModel(&model, p_image, INSTR_DEPTH_BITS, NULL, NULL);
+        const bool b_isReady = RunModel(&model, MODEL_CYCLE_LIMIT, &log);
+        printf("--- Model Test '%s'| Number of instructions: %u ---\n", TEST_MODEL_FILE, p_image->size);
+        printf("%s: %llu cycle(s), %d bus event(s)\n\n",
+               (b_isReady && (model.cycle == TEST_MODEL_CYCLES) && (log.size == TEST_MODEL_EVENTS)) ? "VALID" : "INVALID",
+               (unsigned long long) model.cycle, (int) log.size);
+
+        // Each copy in the batch has to match the single simulation, on each kernel
+        const modelKernel_t kernels[] = { modelKernelScalar, modelKernelAvx2 };
+        const char * const p_kernelNames[] = { "scalar", "AVX2" };
+        const modelKernel_t kernelDefault = GetModelKernel();
+        for (int kernel = 0; kernel < (int) (sizeof(kernels) / sizeof(kernels[0])); kernel++)
+        {
+            printf("--- Model Batch Test | Kernel: %s | Number of programs: %d ---\n", p_kernelNames[kernel], TEST_MODEL_BATCH);
+            if (!SelectModelKernel(kernels[kernel]))
+            {
+                printf("Skipped: the kernel is not supported by the build or the processor.\n\n");
+                continue;
+            }
+
+            modelRun_t runs[TEST_MODEL_BATCH];
+            int matchCount = 0;
+            memset(runs, 0, sizeof(runs));
+            for (int i = 0; i < TEST_MODEL_BATCH; i++)
+            {
+                runs[i].p_image = p_image;
+                runs[i].depthBits = INSTR_DEPTH_BITS;
+            }
+            const bool b_isLogged = RunModelBatch(runs, TEST_MODEL_BATCH, MODEL_CYCLE_LIMIT, 0);
+            for (int i = 0; i < TEST_MODEL_BATCH; i++)
+            {
+                bool b_isMatching = runs[i].b_isReady && (runs[i].cycle == model.cycle) && (runs[i].log.size == log.size);
+                for (size_t k = 0; b_isMatching && (k < log.size); k++)
+                {
+                    const modelEvent_t * const p_event = &runs[i].log.p_events[k];
+                    b_isMatching = (p_event->cycle == log.p_events[k].cycle) && (p_event->pc == log.p_events[k].pc) &&
+                                   (p_event->address == log.p_events[k].address) && (p_event->data == log.p_events[k].data) &&
+                                   (p_event->type == log.p_events[k].type);
+                }
+                matchCount += b_isMatching;
+                CleanupLog(&runs[i].log);
+            }
+            printf("%s: %d matching program(s)\n\n", (b_isLogged && (matchCount == TEST_MODEL_BATCH)) ? "VALID" : "INVALID", matchCount);
+        }
+        SelectModelKernel(kernelDefault);
+
+        // The last two reads are the quotient and the remainder
+        slaveBus_t slaves = { NULL, 0, 0 };
+        eventLog_t slaveLog = { NULL, 0, 0 };
+        if (AttachSlave(&slaves, "div_avalon"))
+        {
+            ResetSlaves(&slaves);
+            ResetModel(&model, p_image, INSTR_DEPTH_BITS, SlaveBusHook, &slaves);
+            const bool b_isSlaveReady = RunModel(&model, MODEL_CYCLE_LIMIT, &slaveLog);
+            const bool b_isDivided = b_isSlaveReady && (model.cycle == TEST_MODEL_CYCLES) && (slaveLog.size == log.size) &&
+                                     (slaveLog.p_events[slaveLog.size - 2].data == TEST_MODEL_QUOTIENT) &&
+                                     (slaveLog.p_events[slaveLog.size - 1].data == TEST_MODEL_REMAINDER);
+            printf("--- Slave Model Test | div_avalon ---\n");
+            printf("%s: %llu cycle(s), irq %d\n\n", b_isDivided ? "VALID" : "INVALID",
+                   (unsigned long long) model.cycle, GetSlaveIrq(&slaves));
+        }
+        CleanupLog(&slaveLog);
+        CleanupSlaves(&slaves);
+
+        CleanupLog(&log);
+        CleanupImage(p_image);
+    }
+    remove(TEST_MODEL_FILE);
+}
+
+/*!
+* @brief Feeder Test Procedure: streams a generated program from the source and from the image,
+*           forward, after a backward jump and backward, and compares them with the loaded image.
+*
+* @return void.
+*/
+static void FeederTest (void)
+{
+    static const char * const SOURCE_ROWS[] =
+    {
+        "write 1ga4f ffff ; invalid address, commented out",
+        "load 0 00000001",
+        "write 0 1235fe  ; setting the dividend",
+        "read 5 0",
+        "wait 0 5",
+        "; comment only row"
+    };
+    const int sourceRowSize = (int) (sizeof(SOURCE_ROWS) / sizeof(SOURCE_ROWS[0]));
+
+    if (!WriteRows(TEST_FEEDER_FILE SOURCE_FILE_EXTENSION, SOURCE_ROWS, sourceRowSize, TEST_FEEDER_ROWS))
+    {
+        return;
+    }
+
+    sourceText_t * const p_sourceText = ReadFile(TEST_FEEDER_FILE SOURCE_FILE_EXTENSION);
+    program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+    textBuffer_t targetText = { NULL, 0, 0 };
+    const bool b_isCompiled = (p_program != NULL) && EmitCode(p_program, &targetText) &&
+                              WriteFile(TEST_FEEDER_FILE TARGET_FILE_EXTENSION, &targetText);
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+
+    modelImage_t * const p_image = b_isCompiled ? LoadImage(TEST_FEEDER_FILE TARGET_FILE_EXTENSION) : NULL;
+    instrFeeder_t * const p_sourceFeeder = OpenFeeder(TEST_FEEDER_FILE SOURCE_FILE_EXTENSION);
+    instrFeeder_t * const p_imageFeeder = OpenFeeder(TEST_FEEDER_FILE TARGET_FILE_EXTENSION);
+    if ((p_image != NULL) && (p_sourceFeeder != NULL) && (p_imageFeeder != NULL))
+    {
+        int errors = 0;
+        for (int pass = 0; pass < 3; pass++)
+        {
+            // The end of the program is fetched too, the last pass steps backward
+            for (uint32_t k = 0; k <= p_image->size; k++)
+            {
+                const uint32_t pc = (pass < 2) ? k : p_image->size - k;
+                modelInstr_t sourceInstr;
+                modelInstr_t imageInstr;
+                const bool b_isSource = FetchFeeder(p_sourceFeeder, pc, &sourceInstr);
+                const bool b_isImage = FetchFeeder(p_imageFeeder, pc, &imageInstr);
+                const bool b_isLoaded = (pc < p_image->size);
+                const modelInstr_t * const p_expected = &p_image->p_instr[b_isLoaded ? pc : 0];
+
+                errors += (b_isSource != b_isLoaded) || (b_isImage != b_isLoaded) ||
+                          (b_isLoaded && ((sourceInstr.opCode != p_expected->opCode) || (sourceInstr.address != p_expected->address) ||
+                                          (sourceInstr.data != p_expected->data) || (imageInstr.opCode != p_expected->opCode) ||
+                                          (imageInstr.address != p_expected->address) || (imageInstr.data != p_expected->data)));
+            }
+        }
+        printf("--- Feeder Test '%s'| Number of instructions: %u; Prefetch window: %d ---\n",
+               TEST_FEEDER_FILE SOURCE_FILE_EXTENSION, p_image->size, FEEDER_PREFETCH);
+        printf("%s: %d error(s)\n\n", errors ? "INVALID" : "VALID", errors);
+    }
+
+    CloseFeeder(p_imageFeeder);
+    CloseFeeder(p_sourceFeeder);
+    CleanupImage(p_image);
+    remove(TEST_FEEDER_FILE SOURCE_FILE_EXTENSION);
+    remove(TEST_FEEDER_FILE TARGET_FILE_EXTENSION);
+}
+
+/*!
+* @brief Compiles the source rows to the image in place of the source.
+*
+* @param[in] p_path Path of the image.
+* @param[in] pp_rows Source rows.
+* @param[in] rowSize Number of rows.
+* @param[out] p_invalidCount Number of the invalid instructions.
+*
+* @return MEMORY ALLOCATION: The loaded image, NULL on error.
+*/
+static modelImage_t *CompileRows (const char * const p_path, const char * const * const pp_rows, const int rowSize,
+                                  int * const p_invalidCount)
+{
+    if (!WriteRows(p_path, pp_rows, rowSize, rowSize))
+    {
+        return NULL;
+    }
+
+    sourceText_t * const p_sourceText = ReadFile(p_path);
+    program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+    textBuffer_t targetText = { NULL, 0, 0 };
+    const bool b_isCompiled = (p_program != NULL) && EmitCode(p_program, &targetText) && WriteFile(p_path, &targetText);
+    *p_invalidCount = (p_program != NULL) ? CountInvalid(p_program) : 0;
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+
+    modelImage_t * const p_image = b_isCompiled ? LoadImage(p_path) : NULL;
+    remove(p_path);
+
+    return p_image;
+}
+
+/*!
+* @brief Loop Test Procedure: the nested repeat blocks with address / data sweep have to produce
+*           the bus transactions of the unrolled program, on the model and on the batch.
+*           Then the unmatched and too deep blocks have to be invalid.
+*
+* @return void.
+*/
+static void LoopTest (void)
+{
+    static const char * const LOOP_ROWS[] =
+    {
+        "load 0 00000001",
+        "repeat 00100001 3  ; address step 0x10, data step 1",
+        "write 0 a0",
+        "repeat 00010000 2  ; inner block, address step 1",
+        "read 5 0",
+        "end 0 0",
+        "end 0 0",
+        "write 6 0          ; offsets are restored"
+    };
+    static const char * const NESTING_ROWS[] =
+    {
+        "repeat 0 1", "repeat 0 1", "repeat 0 1", "repeat 0 1",
+        "repeat 0 1         ; too deep",
+        "nop 0 0",
+        "end 0 0            ; end of the too deep block",
+        "end 0 0", "end 0 0", "end 0 0", "end 0 0",
+        "end 0 0            ; unmatched",
+        "repeat 0 0         ; no iteration"
+    };
+    const int loopRowSize = (int) (sizeof(LOOP_ROWS) / sizeof(LOOP_ROWS[0]));
+    char unrolledText[TEST_LOOP_ITERATIONS * 3 + 2][TEST_LOOP_ROW_LENGTH];
+    const char *p_unrolledRows[TEST_LOOP_ITERATIONS * 3 + 2];
+    int unrolledSize = 0;
+    int invalidCount;
+
+    snprintf(unrolledText[unrolledSize++], TEST_LOOP_ROW_LENGTH, "load 0 00000001");
+    for (int i = 0; i < TEST_LOOP_ITERATIONS; i++)
+    {
+        snprintf(unrolledText[unrolledSize++], TEST_LOOP_ROW_LENGTH, "write %x %x", 0x10 * i, 0xa0 + i);
+        snprintf(unrolledText[unrolledSize++], TEST_LOOP_ROW_LENGTH, "read %x 0", 0x10 * i + 5);
+        snprintf(unrolledText[unrolledSize++], TEST_LOOP_ROW_LENGTH, "read %x 0", 0x10 * i + 6);
+    }
+    snprintf(unrolledText[unrolledSize++], TEST_LOOP_ROW_LENGTH, "write 6 0");
+    for (int i = 0; i < unrolledSize; i++)
+    {
+        p_unrolledRows[i] = unrolledText[i];
+    }
+
+    modelImage_t * const p_loopImage = CompileRows(TEST_LOOP_FILE, LOOP_ROWS, loopRowSize, &invalidCount);
+    modelImage_t * const p_unrolledImage = CompileRows(TEST_LOOP_FILE, p_unrolledRows, unrolledSize, &invalidCount);
+    if ((p_loopImage != NULL) && (p_unrolledImage != NULL))
+    {
+        avalonModel_t model;
+        eventLog_t loopLog = { NULL, 0, 0 };
+        eventLog_t unrolledLog = { NULL, 0, 0 };
+        modelRun_t run;
+
+        ResetModel(&model, p_unrolledImage, INSTR_DEPTH_BITS, NULL, NULL);
+        RunModel(&model, MODEL_CYCLE_LIMIT, &unrolledLog);
+        ResetModel(&model, p_loopImage, INSTR_DEPTH_BITS, NULL, NULL);
+        bool b_isMatching = RunModel(&model, MODEL_CYCLE_LIMIT, &loopLog) && (loopLog.size == unrolledLog.size);
+        for (size_t k = 0; b_isMatching && (k < loopLog.size); k++)
+        {
+            b_isMatching = (loopLog.p_events[k].address == unrolledLog.p_events[k].address) &&
+                           (loopLog.p_events[k].data == unrolledLog.p_events[k].data) &&
+                           (loopLog.p_events[k].type == unrolledLog.p_events[k].type);
+        }
+
+        // The batch has to match the single simulation cycle by cycle
+        memset(&run, 0, sizeof(run));
+        run.p_image = p_loopImage;
+        run.depthBits = INSTR_DEPTH_BITS;
+        b_isMatching = b_isMatching && RunModelBatch(&run, 1, MODEL_CYCLE_LIMIT, 1) && run.b_isReady &&
+                       (run.cycle == model.cycle) && (run.instrCount == model.instrCount) && (run.log.size == loopLog.size);
+        for (size_t k = 0; b_isMatching && (k < loopLog.size); k++)
+        {
+            b_isMatching = (run.log.p_events[k].cycle == loopLog.p_events[k].cycle) &&
+                           (run.log.p_events[k].pc == loopLog.p_events[k].pc) &&
+                           (run.log.p_events[k].address == loopLog.p_events[k].address) &&
+                           (run.log.p_events[k].data == loopLog.p_events[k].data);
+        }
+        printf("--- Loop Test | Number of instructions: %u; Unrolled: %u ---\n", p_loopImage->size, p_unrolledImage->size);
+        printf("%s: %d bus event(s), %llu cycle(s)\n\n", b_isMatching ? "VALID" : "INVALID",
+               (int) loopLog.size, (unsigned long long) model.cycle);
+
+        CleanupLog(&run.log);
+        CleanupLog(&unrolledLog);
+        CleanupLog(&loopLog);
+    }
+    CleanupImage(p_unrolledImage);
+    CleanupImage(p_loopImage);
+
+    modelImage_t * const p_nestingImage = CompileRows(TEST_LOOP_FILE, NESTING_ROWS,
+                                                      (int) (sizeof(NESTING_ROWS) / sizeof(NESTING_ROWS[0])), &invalidCount);
+    printf("--- Loop Nesting Test | Depth limit: %d ---\n", LOOP_DEPTH_LIMIT);
+    printf("%s: %d invalid instruction(s)\n\n", (invalidCount == TEST_LOOP_INVALID) ? "VALID" : "INVALID", invalidCount);
+    CleanupImage(p_nestingImage);
+}
+
+/*!
+* @brief Burst Test Procedure: the beats of the burst read, the inline and the pattern burst write
+*           have to be transferred back to back, on the model and on the batch.
+*           Then the incomplete bursts, the stray beats and the invalid burst lengths have to be invalid.
+*
+* @return void.
+*/
+static void BurstTest (void)
+{
+    static const char * const BURST_ROWS[] =
+    {
+        "load 0 00010000         ; ReadLatency = 1",
+        "burstread 10 3",
+        "burstwrite 20 3         ; inline beats",
+        "beat 0 a",
+        "beat 0 b",
+        "beat 0 c",
+        "burstwrite 40 00020004  ; pattern step 2",
+        "beat 0 100"
+    };
+    static const modelEvent_t BURST_EVENTS[] =
+    {
+        { 0, 0, 0x10, 0, eventRead }, { 0, 0, 0x11, 0, eventRead }, { 0, 0, 0x12, 0, eventRead },
+        { 0, 0, 0x20, 0xa, eventWrite }, { 0, 0, 0x21, 0xb, eventWrite }, { 0, 0, 0x22, 0xc, eventWrite },
+        { 0, 0, 0x40, 0x100, eventWrite }, { 0, 0, 0x41, 0x102, eventWrite },
+        { 0, 0, 0x42, 0x104, eventWrite }, { 0, 0, 0x43, 0x106, eventWrite }
+    };
+    static const char * const INVALID_ROWS[] =
+    {
+        "beat 0 1                ; out of a burst",
+        "burstwrite 0 2          ; one beat is missing",
+        "beat 0 1",
+        "nop 0 0",
+        "burstread 0 81          ; too long",
+        "burstread 0 0           ; empty"
+    };
+    const int eventSize = (int) (sizeof(BURST_EVENTS) / sizeof(BURST_EVENTS[0]));
+    int invalidCount;
+
+    modelImage_t * const p_image = CompileRows(TEST_BURST_FILE, BURST_ROWS, (int) (sizeof(BURST_ROWS) / sizeof(BURST_ROWS[0])),
+                                               &invalidCount);
+    if (p_image != NULL)
+    {
+        avalonModel_t model;
+        eventLog_t log = { NULL, 0, 0 };
+        modelRun_t run;
+
+        ResetModel(&model, p_image, INSTR_DEPTH_BITS, NULL, NULL);
+        bool b_isMatching = RunModel(&model, MODEL_CYCLE_LIMIT, &log) && (log.size == (size_t) eventSize);
+        for (int k = 0; b_isMatching && (k < eventSize); k++)
+        {
+            // The beats of a burst are in consecutive cycles
+            const bool b_isNextBeat = (k > 0) && (BURST_EVENTS[k].address == BURST_EVENTS[k - 1].address + 1);
+            b_isMatching = (log.p_events[k].address == BURST_EVENTS[k].address) && (log.p_events[k].data == BURST_EVENTS[k].data) &&
+                           (log.p_events[k].type == BURST_EVENTS[k].type) &&
+                           (!b_isNextBeat || (log.p_events[k].cycle == log.p_events[k - 1].cycle + 1));
+        }
+
+        // The batch simulates the bursts on the scalar model
+        memset(&run, 0, sizeof(run));
+        run.p_image = p_image;
+        run.depthBits = INSTR_DEPTH_BITS;
+        b_isMatching = b_isMatching && RunModelBatch(&run, 1, MODEL_CYCLE_LIMIT, 1) && run.b_isReady &&
+                       (run.cycle == model.cycle) && (run.log.size == log.size);
+        printf("--- Burst Test | Number of instructions: %u ---\n", p_image->size);
+        printf("%s: %d bus event(s), %llu cycle(s)\n\n", b_isMatching ? "VALID" : "INVALID",
+               (int) log.size, (unsigned long long) model.cycle);
+
+        CleanupLog(&run.log);
+        CleanupLog(&log);
+        CleanupImage(p_image);
+    }
+
+    modelImage_t * const p_invalidImage = CompileRows(TEST_BURST_FILE, INVALID_ROWS,
+                                                      (int) (sizeof(INVALID_ROWS) / sizeof(INVALID_ROWS[0])), &invalidCount);
+    printf("--- Burst Validation Test | Burst limit: %d ---\n", BURST_LIMIT);
+    printf("%s: %d invalid instruction(s)\n\n", (invalidCount == TEST_BURST_INVALID) ? "VALID" : "INVALID", invalidCount);
+    CleanupImage(p_invalidImage);
+}
+
+/*!
+* @brief Pipelined Read Test Procedure: the pipelined reads have to be issued in consecutive cycles,
+*           their events have to carry the program counter and the address of the command.
+*           The read after the load of the fixed timing has to wait for the outstanding reads.
+*
+* @return void.
+*/
+static void PipelineTest (void)
+{
+    static const char * const PIPELINE_ROWS[] =
+    {
+        "load 100 00030000       ; pipelined reads, ReadLatency = 3",
+        "read 10 0",
+        "read 11 0",
+        "read 12 0",
+        "read 13 0",
+        "read 14 0",
+        "read 15 0",
+        "load 0 00010000         ; fixed timing",
+        "read 20 0"
+    };
+    int invalidCount;
+
+    modelImage_t * const p_image = CompileRows(TEST_PIPELINE_FILE, PIPELINE_ROWS,
+                                               (int) (sizeof(PIPELINE_ROWS) / sizeof(PIPELINE_ROWS[0])), &invalidCount);
+    if (p_image == NULL)
+    {
+        return;
+    }
+
+    avalonModel_t model;
+    eventLog_t log = { NULL, 0, 0 };
+    modelRun_t run;
+
+    ResetModel(&model, p_image, INSTR_DEPTH_BITS, NULL, NULL);
+    bool b_isMatching = RunModel(&model, MODEL_CYCLE_LIMIT, &log) && (log.size == TEST_PIPELINE_READS + 1);
+    for (int k = 0; b_isMatching && (k < TEST_PIPELINE_READS); k++)
+    {
+        // One response each cycle, in the order of the commands
+        b_isMatching = (log.p_events[k].pc == (uint32_t) k + 1) && (log.p_events[k].address == 0x10 + (uint32_t) k) &&
+                       ((k == 0) || (log.p_events[k].cycle == log.p_events[k - 1].cycle + 1));
+    }
+    b_isMatching = b_isMatching && (log.p_events[TEST_PIPELINE_READS].address == 0x20) &&
+                   (log.p_events[TEST_PIPELINE_READS].cycle > log.p_events[TEST_PIPELINE_READS - 1].cycle + 1);
+
+    // The batch simulates the load modes on the scalar model
+    memset(&run, 0, sizeof(run));
+    run.p_image = p_image;
+    run.depthBits = INSTR_DEPTH_BITS;
+    b_isMatching = b_isMatching && RunModelBatch(&run, 1, MODEL_CYCLE_LIMIT, 1) && run.b_isReady &&
+                   (run.cycle == model.cycle) && (run.log.size == log.size);
+    printf("--- Pipelined Read Test | Outstanding read limit: %d ---\n", PENDING_READ_LIMIT);
+    printf("%s: %d bus event(s), %llu cycle(s)\n\n", b_isMatching ? "VALID" : "INVALID",
+           (int) log.size, (unsigned long long) model.cycle);
+
+    CleanupLog(&run.log);
+    CleanupLog(&log);
+    CleanupImage(p_image);
+}
+
+/*!
+* @brief Load Mode Validation Test Procedure: the LOADs with a reserved mode bit have to be invalid,
+*           each combination of the pipelined, the waitrequest and the fast issue mode is valid.
+*
+* @return void.
+*/
+static void LoadModeTest (void)
+{
+    static const char * const LOAD_MODE_ROWS[] =
+    {
+        "load 800 0              ; reserved bit 3",
+        "load F00 0              ; each mode and a reserved bit",
+        "load 8100 0             ; reserved bit 7 with pipelined reads",
+        "load 700 0              ; each mode",
+        "load 5ff 0              ; pipelined reads, fast issue, setup 0xff",
+        "load 10000 0            ; above the load address"
+    };
+    int invalidCount;
+
+    modelImage_t * const p_image = CompileRows(TEST_LOAD_MODE_FILE, LOAD_MODE_ROWS,
+                                               (int) (sizeof(LOAD_MODE_ROWS) / sizeof(LOAD_MODE_ROWS[0])), &invalidCount);
+    printf("--- Load Mode Validation Test | Mode bits: 0x%04X ---\n", LOAD_MODE_MASK & ~LOAD_MODE_RESERVED);
+    printf("%s: %d invalid instruction(s)\n\n", (invalidCount == TEST_LOAD_MODE_INVALID) ? "VALID" : "INVALID", invalidCount);
+    CleanupImage(p_image);
+}
+
+/*!
+* @brief Slave hook of the waitrequest test: each command is held for TEST_WAITREQUEST_CYCLES cycles,
+*           the readdata is the address.
+*
+* @param[in,out] p_slave Number of the cycles the current command is held.
+* @param[in,out] p_bus The signals of the master in the cycle.
+*
+* @return The readdata of the cycle.
+*/
+static uint32_t WaitrequestHook (void *p_slave, avalonBus_t * const p_bus)
+{
+    uint32_t * const p_heldCycles = (uint32_t *) p_slave;
+    const bool b_isCommand = p_bus->b_chipselect && (p_bus->b_read || p_bus->b_write);
+
+    p_bus->b_waitrequest = b_isCommand && (*p_heldCycles < TEST_WAITREQUEST_CYCLES);
+    *p_heldCycles = p_bus->b_waitrequest ? *p_heldCycles + 1 : 0;
+
+    return p_bus->address;
+}
+
+/*!
+* @brief Waitrequest Test Procedure: in waitrequest mode the transfers have to last as long as the slave holds them,
+*           the next instruction has to follow without AVALON_DELAY. The fixed timing ignores the waitrequest.
+*
+* @return void.
+*/
+static void WaitrequestTest (void)
+{
+    static const char * const WAITREQUEST_ROWS[] =
+    {
+        "load 200 00000000       ; waitrequest mode",
+        "write 10 5",
+        "read 11 0",
+        "load 0 00000000         ; fixed timing",
+        "write 10 5",
+        "read 11 0"
+    };
+    int invalidCount;
+
+    modelImage_t * const p_image = CompileRows(TEST_WAITREQUEST_FILE, WAITREQUEST_ROWS,
+                                               (int) (sizeof(WAITREQUEST_ROWS) / sizeof(WAITREQUEST_ROWS[0])), &invalidCount);
+    if (p_image == NULL)
+    {
+        return;
+    }
+
+    avalonModel_t model;
+    eventLog_t log = { NULL, 0, 0 };
+    uint32_t heldCycles = 0;
+
+    ResetModel(&model, p_image, INSTR_DEPTH_BITS, WaitrequestHook, &heldCycles);
+    bool b_isMatching = RunModel(&model, MODEL_CYCLE_LIMIT, &log) && (log.size == 4);
+    // PC_INCR and FETCH between the write and the held read
+    b_isMatching = b_isMatching && (log.p_events[0].type == eventWrite) && (log.p_events[1].data == 0x11) &&
+                   (log.p_events[1].cycle == log.p_events[0].cycle + TEST_WAITREQUEST_CYCLES + 3) &&
+                   (log.p_events[3].cycle > log.p_events[2].cycle + AVALON_DELAY);
+    printf("--- Waitrequest Test | waitrequest cycles: %d ---\n", TEST_WAITREQUEST_CYCLES);
+    printf("%s: %d bus event(s), %llu cycle(s)\n\n", b_isMatching ? "VALID" : "INVALID",
+           (int) log.size, (unsigned long long) model.cycle);
+
+    CleanupLog(&log);
+    CleanupImage(p_image);
+}
+
+/*!
+* @brief Slave hook of the burst handshake test: each command is held like in the waitrequest test,
+*           the beats of the burst read are returned in every second cycle only.
+*
+* @param[in,out] p_slave Held cycles of the current command and the number of the cycles.
+* @param[in,out] p_bus The signals of the master in the cycle.
+*
+* @return The readdata of the cycle: the address of the beat.
+*/
+static uint32_t HandshakeHook (void *p_slave, avalonBus_t * const p_bus)
+{
+    uint32_t * const p_state = (uint32_t *) p_slave;
+    const uint32_t readdata = WaitrequestHook(&p_state[0], p_bus) + p_bus->beat;
+
+    p_bus->b_readdatavalid = p_bus->b_readdatavalid && (p_state[1]++ & 1);
+
+    return readdata;
+}
+
+/*!
+* @brief Burst Handshake Test Procedure: beginbursttransfer has to last one cycle of each burst
+*           even if the command is held, the beats of the burst read have to be captured at readdatavalid only.
+*
+* @return void.
+*/
+static void HandshakeTest (void)
+{
+    static const char * const HANDSHAKE_ROWS[] =
+    {
+        "load 200 00000000       ; waitrequest mode",
+        "burstread 10 3",
+        "burstwrite 20 00010002  ; pattern step 1",
+        "beat 0 1"
+    };
+    int invalidCount;
+
+    modelImage_t * const p_image = CompileRows(TEST_HANDSHAKE_FILE, HANDSHAKE_ROWS,
+                                               (int) (sizeof(HANDSHAKE_ROWS) / sizeof(HANDSHAKE_ROWS[0])), &invalidCount);
+    if (p_image == NULL)
+    {
+        return;
+    }
+
+    avalonModel_t model;
+    avalonBus_t bus;
+    uint32_t hookState[2] = { 0, 0 };
+    uint32_t beginCycles = 0;
+    uint32_t beats = 0;
+    bool b_isMatching = true;
+    bool b_isReady = false;
+
+    ResetModel(&model, p_image, INSTR_DEPTH_BITS, HandshakeHook, hookState);
+    while (!b_isReady && (model.cycle < MODEL_CYCLE_LIMIT))
+    {
+        b_isReady = StepModel(&model, &bus);
+        beginCycles += bus.b_beginBurst;
+        if (bus.b_readDataEN)
+        {
+            b_isMatching = b_isMatching && bus.b_readdatavalid && (bus.readdataWatch == 0x10 + beats);
+            beats++;
+        }
+    }
+    b_isMatching = b_isMatching && b_isReady && (beginCycles == 2) && (beats == TEST_HANDSHAKE_BEATS);
+    printf("--- Burst Handshake Test | waitrequest cycles: %d ---\n", TEST_WAITREQUEST_CYCLES);
+    printf("%s: %u beginbursttransfer cycle(s), %u beat(s)\n\n", b_isMatching ? "VALID" : "INVALID", beginCycles, beats);
+
+    CleanupImage(p_image);
+}
+
+/*!
+* @brief Fast Issue Test Procedure: the back to back writes and reads have to take one cycle each,
+*           the NOP has to take one FETCH cycle, then the write after it another one.
+*
+* @return void.
+*/
+static void FastIssueTest (void)
+{
+    static const char * const FAST_ROWS[] =
+    {
+        "load 400 00000000       ; fast issue",
+        "write 10 1",
+        "write 11 2",
+        "read 12 0",
+        "write 13 4",
+        "nop 0 0",
+        "write 14 5"
+    };
+    int invalidCount;
+
+    modelImage_t * const p_image = CompileRows(TEST_FAST_FILE, FAST_ROWS, (int) (sizeof(FAST_ROWS) / sizeof(FAST_ROWS[0])),
+                                               &invalidCount);
+    if (p_image == NULL)
+    {
+        return;
+    }
+
+    avalonModel_t model;
+    eventLog_t log = { NULL, 0, 0 };
+    modelRun_t run;
+
+    ResetModel(&model, p_image, INSTR_DEPTH_BITS, NULL, NULL);
+    bool b_isMatching = RunModel(&model, MODEL_CYCLE_LIMIT, &log) && (log.size == TEST_FAST_TRANSFERS + 1);
+    for (int k = 0; b_isMatching && (k < TEST_FAST_TRANSFERS); k++)
+    {
+        b_isMatching = (log.p_events[k].pc == (uint32_t) k + 1) && (log.p_events[k].address == 0x10 + (uint32_t) k) &&
+                       ((k == 0) || (log.p_events[k].cycle == log.p_events[k - 1].cycle + 1));
+    }
+    // FETCH of the NOP and of the write
+    b_isMatching = b_isMatching && (log.p_events[TEST_FAST_TRANSFERS].address == 0x14) &&
+                   (log.p_events[TEST_FAST_TRANSFERS].cycle == log.p_events[TEST_FAST_TRANSFERS - 1].cycle + 3);
+
+    memset(&run, 0, sizeof(run));
+    run.p_image = p_image;
+    run.depthBits = INSTR_DEPTH_BITS;
+    b_isMatching = b_isMatching && RunModelBatch(&run, 1, MODEL_CYCLE_LIMIT, 1) && run.b_isReady &&
+                   (run.cycle == model.cycle) && (run.log.size == log.size);
+    printf("--- Fast Issue Test | Number of instructions: %u ---\n", p_image->size);
+    printf("%s: %d bus event(s), %llu cycle(s)\n\n", b_isMatching ? "VALID" : "INVALID",
+           (int) log.size, (unsigned long long) model.cycle);
+
+    CleanupLog(&run.log);
+    CleanupLog(&log);
+    CleanupImage(p_image);
+}
+
+/*!
+* @brief Profile Test Procedure: the phases and the cycles of the program counters have to cover each cycle,
+*           the retired instructions and the longest stall have to match the program,
+*           the counters have to survive the dump.
+*
+* @return void.
+*/
+static void ProfileTest (void)
+{
+    static const char * const PROFILE_ROWS[] =
+    {
+        "load 200 00000000       ; waitrequest",
+        "write 10 1",
+        "read 11 0",
+        "nop 0 0",
+        "wait 0 3"
+    };
+    int invalidCount;
+
+    modelImage_t * const p_image = CompileRows(TEST_PROFILE_FILE, PROFILE_ROWS, (int) (sizeof(PROFILE_ROWS) / sizeof(PROFILE_ROWS[0])),
+                                               &invalidCount);
+    if (p_image == NULL)
+    {
+        return;
+    }
+
+    avalonModel_t model;
+    perfCounters_t perf;
+    perfCounters_t dump;
+    uint32_t heldCycles = 0;
+    uint64_t phaseSum = 0;
+    uint64_t pcSum = 0;
+
+    bool b_isMatching = InitPerf(&perf, p_image->size + 1);
+    ResetModel(&model, p_image, INSTR_DEPTH_BITS, WaitrequestHook, &heldCycles);
+    model.p_perf = &perf;
+    b_isMatching = b_isMatching && RunModel(&model, MODEL_CYCLE_LIMIT, NULL) && (perf.cycles == model.cycle);
+    for (int i = 0; b_isMatching && (i < perfPhaseLimit); i++)
+    {
+        phaseSum += perf.phaseCycles[i];
+    }
+    for (uint32_t pc = 0; b_isMatching && (pc < perf.pcSize); pc++)
+    {
+        pcSum += perf.p_pcCycles[pc];
+    }
+    b_isMatching = b_isMatching && (phaseSum == perf.cycles) && (pcSum == perf.cycles) &&
+                   (perf.opCodeCount[load] == 1) && (perf.opCodeCount[write] == 1) && (perf.opCodeCount[read] == 1) &&
+                   (perf.opCodeCount[nop] == 1) && (perf.opCodeCount[wait] == 1) &&
+                   (perf.phaseCycles[perfStall] == 2 * TEST_WAITREQUEST_CYCLES) &&
+                   (perf.longestStall == TEST_WAITREQUEST_CYCLES) && (perf.stallPC == 1);
+
+    // Round trip of the dump
+    b_isMatching = b_isMatching && WritePerfDump(TEST_PROFILE_DUMP, &perf) && ReadPerfDump(TEST_PROFILE_DUMP, &dump);
+    remove(TEST_PROFILE_DUMP);
+    b_isMatching = b_isMatching && (dump.cycles == perf.cycles) && (dump.busCycles == perf.busCycles) &&
+                   (dump.dataCycles == perf.dataCycles) && (dump.longestSpan == perf.longestSpan) &&
+                   (dump.longestPC == perf.longestPC) && (dump.longestStall == perf.longestStall) &&
+                   !memcmp(dump.phaseCycles, perf.phaseCycles, sizeof(perf.phaseCycles)) &&
+                   !memcmp(dump.opCodeCount, perf.opCodeCount, sizeof(perf.opCodeCount));
+    for (uint32_t pc = 0; b_isMatching && (pc < perf.pcSize); pc++)
+    {
+        b_isMatching = (pc < dump.pcSize) && (dump.p_pcCycles[pc] == perf.p_pcCycles[pc]) &&
+                       (dump.p_pcCount[pc] == perf.p_pcCount[pc]);
+    }
+    printf("--- Profile Test | Number of instructions: %u ---\n", p_image->size);
+    printf("%s: %llu cycle(s), longest instruction: %llu cycle(s)\n\n", b_isMatching ? "VALID" : "INVALID",
+           (unsigned long long) perf.cycles, (unsigned long long) perf.longestSpan);
+
+    CleanupPerf(&dump);
+    CleanupPerf(&perf);
+    CleanupImage(p_image);
+}
+
+/*!
+* @brief Timing Test Procedure: the static estimate has to predict the cycles of the native model
+*           in total and at each program counter, through all LOAD modes and nested repeat blocks.
+*
+* @return void.
+*/
+static void TimingTest (void)
+{
+    static const char * const TIMING_ROWS[] =
+    {
+        "load 0 00010000         ; fixed timing, ReadLatency = 1",
+        "read 10 0",
+        "write 11 1",
+        "wait 0 3",
+        "burstread 10 3",
+        "burstwrite 20 2",
+        "beat 0 a",
+        "beat 0 b",
+        "repeat 00010000 3",
+        "repeat 00000001 100     ; 256 iterations in the same LOAD state",
+        "read 5 0",
+        "end 0 0",
+        "write 6 0",
+        "end 0 0",
+        "load 100 00030000       ; pipelined reads, ReadLatency = 3",
+        "read 30 0", "read 31 0", "read 32 0", "read 33 0", "read 34 0",
+        "nop 0 0",
+        "load 200 00000000       ; waitrequest, never asserted",
+        "write 40 1",
+        "read 41 0",
+        "load 400 00000000       ; fast issue",
+        "repeat 00010000 4",
+        "write 50 1",
+        "read 51 0",
+        "end 0 0",
+        "nop 0 0",
+        "write 52 2"
+    };
+    const int rowSize = (int) (sizeof(TIMING_ROWS) / sizeof(TIMING_ROWS[0]));
+
+    if (!WriteRows(TEST_TIMING_FILE, TIMING_ROWS, rowSize, rowSize))
+    {
+        return;
+    }
+
+    sourceText_t * const p_sourceText = ReadFile(TEST_TIMING_FILE);
+    program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+    textBuffer_t targetText = { NULL, 0, 0 };
+    programTiming_t timing = { NULL, NULL, NULL, 0, 0 };
+    const bool b_isCompiled = (p_program != NULL) && !CountInvalid(p_program) && EmitCode(p_program, &targetText) &&
+                              WriteFile(TEST_TIMING_FILE, &targetText) && AnalyzeTiming(p_program, &timing);
+    modelImage_t * const p_image = b_isCompiled ? LoadImage(TEST_TIMING_FILE) : NULL;
+    remove(TEST_TIMING_FILE);
+
+    avalonModel_t model;
+    perfCounters_t perf;
+    bool b_isMatching = (p_image != NULL) && InitPerf(&perf, p_image->size + 1);
+    if (b_isMatching)
+    {
+        ResetModel(&model, p_image, INSTR_DEPTH_BITS, NULL, NULL);
+        model.p_perf = &perf;
+        b_isMatching = RunModel(&model, MODEL_CYCLE_LIMIT, NULL) && (timing.cycles == model.cycle) &&
+                       (timing.size == p_image->size);
+        for (uint32_t pc = 0; b_isMatching && (pc < timing.size); pc++)
+        {
+            b_isMatching = (timing.p_cycles[pc] == perf.p_pcCycles[pc]) && (timing.p_count[pc] == perf.p_pcCount[pc]);
+        }
+        CleanupPerf(&perf);
+    }
+    printf("--- Timing Test | Number of rows: %d ---\n", rowSize);
+    printf("%s: %llu cycle(s) estimated\n\n", b_isMatching ? "VALID" : "INVALID", (unsigned long long) timing.cycles);
+
+    CleanupTiming(&timing);
+    CleanupImage(p_image);
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+}
+
+/*!
+* @brief Peephole Test Procedure: the optimized program has to produce the same bus transactions
+*           with fewer instructions, the saved cycles of the estimate have to match the native model.
+*
+* @return void.
+*/
+static void PeepholeTest (void)
+{
+    static const char * const PEEPHOLE_ROWS[] =
+    {
+        "load 0 00010000         ; dead: overwritten by the next LOAD",
+        "load 100 00030000       ; pipelined reads, ReadLatency = 3",
+        "read 10 0",
+        "read 11 0",
+        "read 12 0",
+        "nop 0 0                 ; waits for the outstanding reads",
+        "nop 0 0",
+        "wait 0 3",
+        "load 100 00030000       ; redundant",
+        "read 13 0",
+        "load 400 00000000       ; fast issue",
+        "repeat 00010000 3",
+        "write 20 1",
+        "nop 0 0",
+        "nop 0 0",
+        "nop 0 0",
+        "end 0 0",
+        "load 400 00000000       ; redundant after a block without LOAD",
+        "write 30 2",
+        "nop 0 0",
+        "nop 0 0                 ; two single cycle NOPs do not fit to a WAIT",
+        "write 31 3",
+        "load 0 00000000         ; dead at the end of the program",
+        "wait 0 1"
+    };
+    const int rowSize = (int) (sizeof(PEEPHOLE_ROWS) / sizeof(PEEPHOLE_ROWS[0]));
+    int invalidCount;
+
+    modelImage_t * const p_original = CompileRows(TEST_PEEPHOLE_FILE, PEEPHOLE_ROWS, rowSize, &invalidCount);
+    if ((p_original == NULL) || !WriteRows(TEST_PEEPHOLE_FILE, PEEPHOLE_ROWS, rowSize, rowSize))
+    {
+        CleanupImage(p_original);
+        return;
+    }
+
+    sourceText_t * const p_sourceText = ReadFile(TEST_PEEPHOLE_FILE);
+    program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+    textBuffer_t targetText = { NULL, 0, 0 };
+    peepholeStats_t stats = { 0, 0, 0, 0, 0, 0 };
+    const bool b_isCompiled = (p_program != NULL) && OptimizeProgram(p_program, &stats) &&
+                              EmitCode(p_program, &targetText) && WriteFile(TEST_PEEPHOLE_FILE, &targetText);
+    modelImage_t * const p_optimized = b_isCompiled ? LoadImage(TEST_PEEPHOLE_FILE) : NULL;
+    remove(TEST_PEEPHOLE_FILE);
+
+    avalonModel_t model;
+    eventLog_t originalLog = { NULL, 0, 0 };
+    eventLog_t optimizedLog = { NULL, 0, 0 };
+    bool b_isMatching = (p_optimized != NULL) && (invalidCount == 0);
+    uint64_t originalCycles = 0;
+    if (b_isMatching)
+    {
+        ResetModel(&model, p_original, INSTR_DEPTH_BITS, NULL, NULL);
+        b_isMatching = RunModel(&model, MODEL_CYCLE_LIMIT, &originalLog);
+        originalCycles = model.cycle;
+        ResetModel(&model, p_optimized, INSTR_DEPTH_BITS, NULL, NULL);
+        b_isMatching = b_isMatching && RunModel(&model, MODEL_CYCLE_LIMIT, &optimizedLog) &&
+                       (stats.mergedDelays == TEST_PEEPHOLE_MERGED) &&
+                       (stats.deadLoads + stats.redundantLoads == TEST_PEEPHOLE_LOADS) &&
+                       (p_optimized->size + TEST_PEEPHOLE_MERGED + TEST_PEEPHOLE_LOADS == p_original->size) &&
+                       (stats.cyclesBefore == originalCycles) && (stats.cyclesAfter == model.cycle) &&
+                       (model.cycle < originalCycles) && (optimizedLog.size == originalLog.size);
+    }
+    for (size_t i = 0; b_isMatching && (i < originalLog.size); i++)
+    {
+        b_isMatching = (optimizedLog.p_events[i].type == originalLog.p_events[i].type) &&
+                       (optimizedLog.p_events[i].address == originalLog.p_events[i].address) &&
+                       (optimizedLog.p_events[i].data == originalLog.p_events[i].data);
+    }
+    printf("--- Peephole Test | Number of instructions: %u ---\n", (p_original != NULL) ? p_original->size : 0);
+    printf("%s: %u instruction(s) removed, %llu cycle(s) saved\n\n", b_isMatching ? "VALID" : "INVALID",
+           stats.mergedDelays + stats.deadLoads + stats.redundantLoads,
+           (unsigned long long) (stats.cyclesBefore - stats.cyclesAfter));
+
+    CleanupLog(&optimizedLog);
+    CleanupLog(&originalLog);
+    CleanupImage(p_optimized);
+    CleanupImage(p_original);
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+}
+
+/*!
+* @brief Compiles the source rows and returns with the program for its diagnostics.
+*
+* @param[in] p_path Path of the source.
+* @param[in] pp_rows Source rows.
+* @param[in] rowSize Number of rows.
+* @param[out] pp_source The read source, the program refers to it.
+*
+* @return MEMORY ALLOCATION: The compiled program, NULL on error.
+*/
+static program_t *CompileDiagnostics (const char * const p_path, const char * const * const pp_rows, const int rowSize,
+                                      sourceText_t ** const pp_source)
+{
+    *pp_source = NULL;
+    if (!WriteRows(p_path, pp_rows, rowSize, rowSize))
+    {
+        return NULL;
+    }
+
+    *pp_source = ReadFile(p_path);
+    remove(p_path);
+
+    return (*pp_source != NULL) ? CompileCode(*pp_source, 1) : NULL;
+}
+
+/*!
+* @brief Diagnostic Test Procedure: the compilation has to record the line, the column, the field
+*           and the reason of each error in row order. With the error limit the first errors are kept,
+*           the repeat blocks left open at the end are sorted among them, the others are counted only.
+*
+* @return void.
+*/
+static void DiagnosticTest (void)
+{
+    static const char * const DIAGNOSTIC_ROWS[] =
+    {
+        "wirte 10 1",
+        "  read 1g 0             ; non-hexadecimal address",
+        "write 10 123456789",
+        "repeat 0 0              ; without iteration",
+        "end 0 0",
+        "burstread 0 81",
+        "beat 0 1",
+        "repeat 0 2",
+        "repeat 0 2",
+        "repeat 0 2",
+        "repeat 0 2",
+        "repeat 0 2              ; too deep"
+    };
+    static const diagnostic_t DIAGNOSTICS[] =
+    {
+        { 0, 1, diagOpCode, reasonUnknownOpCode }, { 1, 8, diagAddress, reasonNotHexa }, { 2, 10, diagData, reasonTooLong },
+        { 3, 10, diagData, reasonZeroRepeat }, { 4, 1, diagNesting, reasonUnmatchedEnd }, { 5, 13, diagData, reasonBurstLength },
+        { 6, 1, diagBurst, reasonStrayBeat }, { 7, 1, diagNesting, reasonUnclosedRepeat }, { 8, 1, diagNesting, reasonUnclosedRepeat },
+        { 9, 1, diagNesting, reasonUnclosedRepeat }, { 10, 1, diagNesting, reasonUnclosedRepeat }, { 11, 1, diagNesting, reasonTooDeep }
+    };
+    const int rowSize = (int) (sizeof(DIAGNOSTIC_ROWS) / sizeof(DIAGNOSTIC_ROWS[0]));
+    const int diagSize = (int) (sizeof(DIAGNOSTICS) / sizeof(DIAGNOSTICS[0]));
+    bool b_isMatching = true;
+
+    // Each error, then the limited ones
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const int limit = pass ? TEST_DIAGNOSTIC_LIMIT : DIAG_LIMIT_NONE;
+        const int expected = pass ? TEST_DIAGNOSTIC_LIMIT : diagSize;
+        sourceText_t *p_sourceText;
+
+        ConfigureDiagnostics(limit, diagText);
+        program_t * const p_program = CompileDiagnostics(TEST_DIAGNOSTIC_FILE, DIAGNOSTIC_ROWS, rowSize, &p_sourceText);
+        const diagList_t * const p_errors = (p_program != NULL) ? &p_program->diagnostics : NULL;
+        b_isMatching = b_isMatching && (p_errors != NULL) && (p_errors->size == expected) && (p_errors->total == diagSize) &&
+                       (CountInvalid(p_program) == rowSize);
+        for (int i = 0; b_isMatching && (i < expected); i++)
+        {
+            b_isMatching = (p_errors->p_items[i].row == DIAGNOSTICS[i].row) && (p_errors->p_items[i].column == DIAGNOSTICS[i].column) &&
+                           (p_errors->p_items[i].field == DIAGNOSTICS[i].field) && (p_errors->p_items[i].reason == DIAGNOSTICS[i].reason);
+        }
+        CleanupProgram(p_program);
+        CleanupText(p_sourceText);
+    }
+    ConfigureDiagnostics(DIAG_LIMIT_DEFAULT, diagText);
+
+    printf("--- Diagnostic Test | Error limit: %d ---\n", TEST_DIAGNOSTIC_LIMIT);
+    printf("%s: %d error(s) recorded\n\n", b_isMatching ? "VALID" : "INVALID", diagSize);
+}
+
+/*!
+* @brief Compiles the source rows by the sidecar cache of the target, then compares the target
+*           with the code of a full compilation.
+*
+* @param[in] pp_rows Source rows.
+* @param[in] rowSize Number of rows.
+* @param[out] p_stats The performed work.
+*
+* @return Returns with true if the target matches the full compilation.
+*/
+static bool CompileCached (const char * const * const pp_rows, const int rowSize, cacheStats_t * const p_stats)
+{
+    if (!WriteRows(TEST_CACHE_SOURCE, pp_rows, rowSize, rowSize))
+    {
+        return false;
+    }
+
+    sourceText_t * const p_sourceText = ReadFile(TEST_CACHE_SOURCE);
+    program_t * const p_incremental = (p_sourceText != NULL) ? CompileIncremental(p_sourceText, TEST_CACHE_TARGET, 1, p_stats) : NULL;
+    program_t * const p_full = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+    textBuffer_t targetText = { NULL, 0, 0 };
+    sourceText_t * const p_targetText = ReadFile(TEST_CACHE_TARGET);
+    const bool b_isMatching = (p_incremental != NULL) && (p_full != NULL) && (p_targetText != NULL) &&
+                              EmitCode(p_full, &targetText) && (p_targetText->dataSize == targetText.size) &&
+                              !memcmp(p_targetText->p_data, targetText.p_data, targetText.size);
+
+    CleanupText(p_targetText);
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_full);
+    CleanupProgram(p_incremental);
+    CleanupText(p_sourceText);
+
+    return b_isMatching;
+}
+
+/*!
+* @brief Incremental Cache Test Procedure: an unchanged source is a cache hit, an edited row is
+*           recompiled alone, a stale or corrupt sidecar and a sidecar of an other version
+*           lead to a full build. The target has to match the full compilation in each case.
+*
+* @return void.
+*/
+static void CacheTest (void)
+{
+    static const char * const CACHE_ROWS[] =
+    {
+        "load 2 2",
+        "write 10 1",
+        "read 10 0               ; read back",
+        "wait 0 5",
+        "write 14 2",
+        "nop 0 0"
+    };
+    const int rowSize = (int) (sizeof(CACHE_ROWS) / sizeof(CACHE_ROWS[0]));
+    const char *p_editedRows[sizeof(CACHE_ROWS) / sizeof(CACHE_ROWS[0])];
+    const char * const p_cachePath = TEST_CACHE_TARGET CACHE_FILE_EXTENSION;
+    cacheHeader_t header;
+    cacheStats_t stats;
+    int passCount = 0;
+
+    remove(TEST_CACHE_TARGET);
+    remove(p_cachePath);
+
+    // Without sidecar, then the hit of the unchanged source
+    passCount += CompileCached(CACHE_ROWS, rowSize, &stats) && stats.b_isFullBuild;
+    passCount += CompileCached(CACHE_ROWS, rowSize, &stats) && !stats.b_isFullBuild && !stats.b_isChanged && (stats.patchSize == 0);
+
+    // Miss of the edited row only
+    memcpy(p_editedRows, CACHE_ROWS, sizeof(CACHE_ROWS));
+    p_editedRows[TEST_CACHE_EDITED_ROW] = "write 14 abcd";
+    passCount += CompileCached(p_editedRows, rowSize, &stats) && !stats.b_isFullBuild && stats.b_isChanged &&
+                 (stats.changedFirst == TEST_CACHE_EDITED_ROW) && (stats.changedLast == TEST_CACHE_EDITED_ROW + 1);
+
+    // Stale sidecar: the target is changed behind the cache
+    FILE *p_file = fopen(TEST_CACHE_TARGET, "a");
+    if (p_file != NULL)
+    {
+        fputs("0000\n", p_file);
+        fclose(p_file);
+    }
+    passCount += CompileCached(CACHE_ROWS, rowSize, &stats) && stats.b_isFullBuild;
+
+    // Corrupt sidecar: the entries are cut
+    p_file = fopen(p_cachePath, "r+b");
+    const bool b_hasHeader = (p_file != NULL) && (fread(&header, sizeof(header), 1, p_file) == 1);
+    if (p_file != NULL)
+    {
+        fclose(p_file);
+    }
+    p_file = b_hasHeader ? fopen(p_cachePath, "wb") : NULL;
+    if (p_file != NULL)
+    {
+        fwrite(&header, sizeof(header), 1, p_file);
+        fclose(p_file);
+    }
+    passCount += CompileCached(CACHE_ROWS, rowSize, &stats) && stats.b_isFullBuild;
+
+    // Sidecar of an other version
+    p_file = fopen(p_cachePath, "r+b");
+    if ((p_file != NULL) && (fread(&header, sizeof(header), 1, p_file) == 1))
+    {
+        header.version = CACHE_VERSION + 1;
+        rewind(p_file);
+        fwrite(&header, sizeof(header), 1, p_file);
+    }
+    if (p_file != NULL)
+    {
+        fclose(p_file);
+    }
+    passCount += CompileCached(CACHE_ROWS, rowSize, &stats) && stats.b_isFullBuild;
+
+    remove(p_cachePath);
+    remove(TEST_CACHE_TARGET);
+    remove(TEST_CACHE_SOURCE);
+
+    printf("--- Incremental Cache Test | Cache version: %d ---\n", CACHE_VERSION);
+    printf("%s: %d of %d compilation(s) passed\n\n", (passCount == TEST_CACHE_PASSES) ? "VALID" : "INVALID",
+           passCount, TEST_CACHE_PASSES);
+}
+
+/*!
+* @brief Instruction Depth Test Procedure: programs around the power-of-two boundaries have to get
+*           the instruction memory depth with the entry of the end of simulation, the program counter
+*           width of their rows and the INSTRUCTION_LIMIT_SIZE define. The largest one exceeds the default depth.
+*
+* @return void.
+*/
+static void DepthTest (void)
+{
+    static const int DEPTH_CASES[][3] =
+    {
+        // instructions  depth bits  PC width
+        { 127,           7,          3 },
+        { 128,           8,          3 },
+        { 129,           8,          3 },
+        { 999,           10,         3 },
+        { 1000,          10,         4 }
+    };
+    static const char * const NOP_ROWS[] = { "nop 0 0" };
+    const int caseSize = (int) (sizeof(DEPTH_CASES) / sizeof(DEPTH_CASES[0]));
+    char target[] = TEST_DEPTH_TARGET;
+    batchJob_t job = { NULL, target, 0, 0, true };
+    batch_t batch = { &job, 1, 1 };
+    char defLine[TEXT_BUFFER_LIMIT];
+    char expected[TEXT_BUFFER_LIMIT];
+    int passCount = 0;
+
+    for (int i = 0; i < caseSize; i++)
+    {
+        if (!WriteRows(TEST_DEPTH_FILE, NOP_ROWS, 1, DEPTH_CASES[i][0]))
+        {
+            continue;
+        }
+
+        sourceText_t * const p_sourceText = ReadFile(TEST_DEPTH_FILE);
+        program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, 1) : NULL;
+        textBuffer_t targetText = { NULL, 0, 0 };
+        bool b_isMatching = (p_program != NULL) && (p_program->progCount == DEPTH_CASES[i][0]) &&
+                            (GetDepthBits(p_program->progCount) == DEPTH_CASES[i][1]) &&
+                            (p_program->pcWidth == DEPTH_CASES[i][2]) && EmitCode(p_program, &targetText) &&
+                            !strncmp(targetText.p_data + strlen(PC_PREFIX) + DEPTH_CASES[i][2], PC_SUFFIX, strlen(PC_SUFFIX));
+
+        // The define of the batch fitting the program
+        job.progCount = (p_program != NULL) ? p_program->progCount : 0;
+        snprintf(expected, sizeof(expected), BATCH_DEF_DEPTH, DEPTH_CASES[i][1]);
+        b_isMatching = b_isMatching && WriteBatchDefFile(TEST_DEPTH_DEF, "", &batch, INSTR_DEPTH_AUTO);
+        FILE * const p_file = b_isMatching ? fopen(TEST_DEPTH_DEF, "r") : NULL;
+        bool b_hasDefine = false;
+        while ((p_file != NULL) && !b_hasDefine && (fgets(defLine, sizeof(defLine), p_file) != NULL))
+        {
+            b_hasDefine = !strcmp(defLine, expected);
+        }
+        if (p_file != NULL)
+        {
+            fclose(p_file);
+        }
+        passCount += b_isMatching && b_hasDefine;
+
+        CleanupBuffer(&targetText);
+        CleanupProgram(p_program);
+        CleanupText(p_sourceText);
+    }
+    remove(TEST_DEPTH_DEF);
+    remove(TEST_DEPTH_FILE);
+
+    // The last program does not fit to the default depth of the HDL
+    const bool b_isExceeding = (GetDepthBits(DEPTH_CASES[caseSize - 1][0]) > INSTR_DEPTH_BITS) &&
+                               (GetDepthBits((1 << INSTR_DEPTH_BITS) - 1) == INSTR_DEPTH_BITS) &&
+                               (GetDepthBits(INT32_MAX) == INSTR_DEPTH_MAX);
+
+    printf("--- Instruction Depth Test | Default depth: 2^%d ---\n", INSTR_DEPTH_BITS);
+    printf("%s: %d of %d program(s) fitted\n\n", ((passCount == caseSize) && b_isExceeding) ? "VALID" : "INVALID",
+           passCount, caseSize);
+}
+
+/*!
+* @brief Checks the job of the source in the batch.
+*
+* @param[in] p_batch The batch.
+* @param[in] p_source Source path.
+*
+* @return Index of the job, -1 if the source is not collected.
+*/
+static int FindBatchJob (const batch_t * const p_batch, const char * const p_source)
+{
+    for (int i = 0; i < p_batch->size; i++)
+    {
+        if (!strcmp(p_batch->p_jobs[i].p_source, p_source))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/*!
+* @brief Batch Test Procedure: the sources have to be collected from a folder, a wildcard pattern
+*           and a manifest, then compiled. The images have to be collected from the folder too,
+*           and the definition file has to list each image with the number and the depth of the programs.
+*
+* @return void.
+*/
+static void BatchTest (void)
+{
+    static const char * const NOP_ROWS[] = { "nop 0 0" };
+    batch_t folderBatch = { NULL, 0, 0 };
+    batch_t patternBatch = { NULL, 0, 0 };
+    batch_t manifestBatch = { NULL, 0, 0 };
+    batch_t imageBatch = { NULL, 0, 0 };
+    char path[FILENAME_MAX];
+    char defText[TEST_BATCH_DEF_LIMIT] = { '\0' };
+    char expected[TEST_BATCH_DEF_LIMIT];
+    int length;
+    int foundCount = 0;
+
+    for (int i = 0; i < TEST_BATCH_SIZE; i++)
+    {
+        snprintf(path, sizeof(path), TEST_BATCH_FILE SOURCE_FILE_EXTENSION, i);
+        if (!WriteRows(path, NOP_ROWS, 1, i + 1))
+        {
+            return;
+        }
+    }
+
+    // Comment, empty row, pattern and a single file with spaces
+    FILE *p_file = fopen(TEST_BATCH_MANIFEST, "w");
+    if (p_file != NULL)
+    {
+        fprintf(p_file, "%c sources of the batch\n\n%s\n  " TEST_BATCH_FILE "%s  \n", INPUT_COMMENT, TEST_BATCH_PATTERN,
+                0, SOURCE_FILE_EXTENSION);
+        fclose(p_file);
+    }
+    snprintf(path, sizeof(path), "%c%s", BATCH_MANIFEST, TEST_BATCH_MANIFEST);
+    const bool b_isCollected = CollectSources(TEST_BATCH_FOLDER, &folderBatch) && CollectSources(TEST_BATCH_PATTERN, &patternBatch) &&
+                               CollectSources(path, &manifestBatch) && (patternBatch.size == TEST_BATCH_SIZE) &&
+                               (manifestBatch.size == TEST_BATCH_SIZE + 1);
+
+    // The folder may hold other sources, the pattern is sorted
+    CompileBatch(&patternBatch, 1);
+    CollectFiles(TEST_BATCH_FOLDER, TARGET_FILE_EXTENSION, &imageBatch);
+    for (int i = 0; b_isCollected && (i < TEST_BATCH_SIZE); i++)
+    {
+        const batchJob_t * const p_job = &patternBatch.p_jobs[i];
+        snprintf(path, sizeof(path), TEST_BATCH_FILE SOURCE_FILE_EXTENSION, i);
+        foundCount += (FindBatchJob(&folderBatch, path) >= 0) && (FindBatchJob(&patternBatch, path) == i) &&
+                      (FindBatchJob(&manifestBatch, path) >= 0) && p_job->b_isCompiled && (p_job->progCount == i + 1) &&
+                      (FindBatchJob(&imageBatch, p_job->p_target) >= 0);
+    }
+
+    // The definitions of the images in the order of the batch
+    length = snprintf(expected, sizeof(expected), BATCH_DEF_COUNT BATCH_DEF_DEPTH, TEST_BATCH_SIZE, INSTR_DEPTH_BITS);
+    for (int i = 0; i < TEST_BATCH_SIZE; i++)
+    {
+        length += snprintf(expected + length, sizeof(expected) - length, BATCH_DEF_PATH "\"%s%s\"\n", i, TEST_BATCH_SUBFOLDER,
+                           patternBatch.p_jobs[i].p_target);
+    }
+    snprintf(expected + length, sizeof(expected) - length, "%s", BATCH_DEF_DEFAULT);
+    p_file = (b_isCollected && WriteBatchDefFile(TEST_BATCH_DEF, TEST_BATCH_SUBFOLDER, &patternBatch, INSTR_DEPTH_AUTO)) ?
+             fopen(TEST_BATCH_DEF, "r") : NULL;
+    if (p_file != NULL)
+    {
+        defText[fread(defText, 1, sizeof(defText) - 1, p_file)] = '\0';
+        fclose(p_file);
+    }
+
+    printf("--- Batch Test | Number of sources: %d ---\n", TEST_BATCH_SIZE);
+    printf("%s: %d of %d source(s) collected and compiled, %d job(s) of the manifest\n\n",
+           ((foundCount == TEST_BATCH_SIZE) && !strcmp(defText, expected)) ? "VALID" : "INVALID",
+           foundCount, TEST_BATCH_SIZE, manifestBatch.size);
+
+    for (int i = 0; i < patternBatch.size; i++)
+    {
+        remove(patternBatch.p_jobs[i].p_source);
+        remove(patternBatch.p_jobs[i].p_target);
+    }
+    remove(TEST_BATCH_MANIFEST);
+    remove(TEST_BATCH_DEF);
+    CleanupBatch(&imageBatch);
+    CleanupBatch(&manifestBatch);
+    CleanupBatch(&patternBatch);
+    CleanupBatch(&folderBatch);
+}
+
+/*!
+* @brief Checks the compiled file of the watched program against the compilation of its source.
+*           The temporary file of the atomic replacement has to be removed.
+*
+* @param[in] p_job The batch job of the program.
+*
+* @return Returns with true, if the compiled file is up to date.
+*/
+static bool IsWatchTargetFresh (const batchJob_t * const p_job)
+{
+    char tempPath[FILENAME_MAX];
+    textBuffer_t targetText = { NULL, 0, 0 };
+
+    sourceText_t * const p_source = ReadFile(p_job->p_source);
+    program_t * const p_program = (p_source != NULL) ? CompileCode(p_source, 1) : NULL;
+    sourceText_t * const p_target = ReadFile(p_job->p_target);
+    snprintf(tempPath, sizeof(tempPath), "%s%s", p_job->p_target, TEMP_FILE_EXTENSION);
+    FILE * const p_temp = fopen(tempPath, "r");
+    const bool b_isFresh = p_job->b_isCompiled && (p_program != NULL) && EmitCode(p_program, &targetText) &&
+                           (p_target != NULL) && (p_target->dataSize == targetText.size) &&
+                           !memcmp(p_target->p_data, targetText.p_data, targetText.size) && (p_temp == NULL);
+
+    if (p_temp != NULL)
+    {
+        fclose(p_temp);
+    }
+    CleanupText(p_target);
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_source);
+
+    return b_isFresh;
+}
+
+/*!
+* @brief Watch Test Procedure: the changes are handled without notification. The edited source has to
+*           replace its compiled file, the new source of the watched folder has to be added to the batch
+*           and the definition file has to follow it with the deeper instruction memory.
+*
+* @return void.
+*/
+static void WatchTest (void)
+{
+    static const char * const WATCH_ROWS[] = { "write 10 1", "read 11 0" };
+    static const char * const EDITED_ROWS[] = { "write 10 2", "read 11 0", "nop 0 0" };
+    static const char * const NOP_ROWS[] = { "nop 0 0" };
+    const int watchRowSize = (int) (sizeof(WATCH_ROWS) / sizeof(WATCH_ROWS[0]));
+    const int editedRowSize = (int) (sizeof(EDITED_ROWS) / sizeof(EDITED_ROWS[0]));
+    char folder[] = TEST_WATCH_FOLDER;
+    char *pp_inputs[] = { folder };
+    char path[FILENAME_MAX];
+    const char * const p_name = path + sizeof(TEST_WATCH_FOLDER);   // File name after the folder
+    char defLine[TEXT_BUFFER_LIMIT];
+    char expected[TEST_WATCH_DEFINES][TEXT_BUFFER_LIMIT];
+    watchSet_t set;
+    FILE *p_file = NULL;
+    int defineCount = 0;
+
+    snprintf(path, sizeof(path), "%s/" TEST_WATCH_SOURCE SOURCE_FILE_EXTENSION, TEST_WATCH_FOLDER, 0);
+    if (!WriteRows(path, WATCH_ROWS, watchRowSize, watchRowSize))
+    {
+        return;
+    }
+    if (OpenWatchSet(&set, 1, pp_inputs, "", TEST_WATCH_DEF, 1, INSTR_DEPTH_AUTO) != 0)
+    {
+        remove(path);
+        return;
+    }
+
+    // The edited source is recompiled
+    const int job = FindBatchJob(&set.batch, path);
+    bool b_isMatching = (job >= 0) && IsWatchTargetFresh(&set.batch.p_jobs[job]);
+    if (b_isMatching && WriteRows(path, EDITED_ROWS, editedRowSize, editedRowSize))
+    {
+        HandleWatchChange(&set, set.p_programs[job].folder, p_name);
+    }
+    b_isMatching = b_isMatching && (set.batch.p_jobs[job].progCount == editedRowSize) &&
+                   IsWatchTargetFresh(&set.batch.p_jobs[job]);
+
+    // The new source of the folder is added
+    const int jobSize = set.batch.size;
+    snprintf(path, sizeof(path), "%s/" TEST_WATCH_SOURCE SOURCE_FILE_EXTENSION, TEST_WATCH_FOLDER, 1);
+    if (b_isMatching && WriteRows(path, NOP_ROWS, 1, TEST_WATCH_NEW_ROWS))
+    {
+        HandleWatchChange(&set, set.p_programs[job].folder, p_name);
+    }
+    b_isMatching = b_isMatching && (set.batch.size == jobSize + 1) && IsWatchTargetFresh(&set.batch.p_jobs[jobSize]);
+
+    // The definitions of the new program
+    if (b_isMatching)
+    {
+        snprintf(expected[0], sizeof(expected[0]), BATCH_DEF_COUNT, set.batch.size);
+        snprintf(expected[1], sizeof(expected[1]), BATCH_DEF_DEPTH, GetDepthBits(TEST_WATCH_NEW_ROWS));
+        snprintf(expected[2], sizeof(expected[2]), BATCH_DEF_PATH "\"%s\"\n", jobSize, set.batch.p_jobs[jobSize].p_target);
+        p_file = fopen(TEST_WATCH_DEF, "r");
+    }
+    while ((p_file != NULL) && (fgets(defLine, sizeof(defLine), p_file) != NULL))
+    {
+        for (int i = 0; i < TEST_WATCH_DEFINES; i++)
+        {
+            defineCount += !strcmp(defLine, expected[i]);
+        }
+    }
+    if (p_file != NULL)
+    {
+        fclose(p_file);
+    }
+
+    printf("--- Watch Test | Sources: %d ---\n", set.batch.size);
+    printf("%s: %d of %d define(s) updated\n\n", (b_isMatching && (defineCount == TEST_WATCH_DEFINES)) ? "VALID" : "INVALID",
+           defineCount, TEST_WATCH_DEFINES);
+
+    for (int i = 0; i < set.batch.size; i++)
+    {
+        remove(set.batch.p_jobs[i].p_source);
+        remove(set.batch.p_jobs[i].p_target);
+    }
+    remove(TEST_WATCH_DEF);
+    CleanupWatchSet(&set);
+}
+
+/*!
+* @brief Checks the JSON syntax of the statistics: a single object with balanced
+*           objects, arrays and strings, without empty values.
+*
+* @param[in] p_text The JSON text.
+*
+* @return Returns with true if the text is well-formed.
+*/
+static bool IsJsonFormed (const char * const p_text)
+{
+    char nesting[TEST_STATS_DEPTH];
+    int depth = 0;
+    bool b_isString = false;
+    char last = '\0';               // Last significant character out of the strings
+
+    if (*p_text != '{')
+    {
+        return false;
+    }
+    for (const char *p_char = p_text; *p_char != '\0'; p_char++)
+    {
+        const char c = *p_char;
+        if (b_isString)
+        {
+            p_char += (c == '\\') && (p_char[1] != '\0');
+            b_isString = (c != '"');
+            continue;
+        }
+        if ((c == ',') || (c == ':') || (c == '}') || (c == ']'))
+        {
+            // A value or a key is needed before the separators and the ends
+            if ((last == ',') || (last == ':') || (((last == '{') || (last == '[')) && (c != '}') && (c != ']')))
+            {
+                return false;
+            }
+        }
+        switch (c)
+        {
+            case '{':
+            case '[':
+                if ((depth == TEST_STATS_DEPTH) || ((depth == 0) && (p_char != p_text)))
+                {
+                    return false;
+                }
+                nesting[depth++] = (c == '{') ? '}' : ']';
+            break;
+            case '}':
+            case ']':
+                if ((depth == 0) || (nesting[--depth] != c))
+                {
+                    return false;
+                }
+            break;
+            case '"':
+                b_isString = true;
+            break;
+            case ' ':
+            case '\n':
+            continue;
+            default:
+            break;
+        }
+        last = c;
+    }
+
+    return !b_isString && (depth == 0) && (last == '}');
+}
+
+/*!
+* @brief Statistics Test Procedure: a source of several chunks is read, compiled on the worker
+*           threads and emitted with the statistics on. The phases have to be entered, the allocations
+*           have to be counted and the JSON report has to be well-formed.
+*
+* @return void.
+*/
+static void StatsTest (void)
+{
+    // The sequence checks of a valid source do not allocate
+    static const char * const PHASES[] = { "read", "compile", "sequence", "emit" };
+    static const bool ALLOCATING[] = { true, true, false, true };
+    const int phaseSize = (int) (sizeof(PHASES) / sizeof(PHASES[0]));
+    char json[TEST_STATS_JSON_LIMIT] = { '\0' };
+    char key[TEXT_BUFFER_LIMIT];
+    uint64_t allocCount = 0;
+    int phaseCount = 0;
+
+    FILE *p_file = fopen(TEST_STATS_FILE, "w");
+    if (p_file == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < TEST_STATS_ROWS; i++)
+    {
+        fprintf(p_file, "write %x %x\n", i & 0xFFFF, i);
+    }
+    fclose(p_file);
+
+    EnableStats(true);
+    BeginPhase(statsRead);
+    sourceText_t * const p_sourceText = ReadFile(TEST_STATS_FILE);
+    EndPhase((p_sourceText != NULL) ? p_sourceText->dataSize : 0, (p_sourceText != NULL) ? (uint64_t) p_sourceText->param.rowSize : 0);
+    program_t * const p_program = (p_sourceText != NULL) ? CompileCode(p_sourceText, TEST_STATS_JOBS) : NULL;
+    textBuffer_t targetText = { NULL, 0, 0 };
+    BeginPhase(statsEmit);
+    const bool b_isEmitted = (p_program != NULL) && EmitCode(p_program, &targetText);
+    EndPhase(targetText.size, (p_program != NULL) ? (uint64_t) p_program->rowSize : 0);
+
+    p_file = fopen(TEST_STATS_JSON, "w+");
+    if (p_file != NULL)
+    {
+        PrintStats(p_file, statsJson);
+        rewind(p_file);
+        const size_t size = fread(json, 1, sizeof(json) - 1, p_file);
+        json[size] = '\0';
+        fclose(p_file);
+    }
+    EnableStats(false);
+
+    // Each phase with its allocations, then the total
+    for (int i = 0; i < phaseSize; i++)
+    {
+        snprintf(key, sizeof(key), "{\"name\":\"%s\",", PHASES[i]);
+        const char * const p_phase = strstr(json, key);
+        const char * const p_allocs = (p_phase != NULL) ? strstr(p_phase, "\"allocs\":") : NULL;
+        uint64_t phaseAllocs = 0;
+        phaseCount += (p_allocs != NULL) && (sscanf(p_allocs, "\"allocs\":%" SCNu64, &phaseAllocs) == 1) &&
+                      ((phaseAllocs > 0) || !ALLOCATING[i]);
+    }
+    const char * const p_total = strstr(json, "],\"time_us\":");
+    const char * const p_totalAllocs = (p_total != NULL) ? strstr(p_total, "\"allocs\":") : NULL;
+    const bool b_isCounted = (p_totalAllocs != NULL) && (sscanf(p_totalAllocs, "\"allocs\":%" SCNu64, &allocCount) == 1) &&
+                             (allocCount > 0);
 
-    NotifyInvalid(pp_targetText, testParam.rowSize);
+    printf("--- Statistics Test | Number of rows: %d ---\n", TEST_STATS_ROWS);
+    printf("%s: %d of %d phase(s) entered, %" PRIu64 " allocation(s)\n\n",
+           (b_isEmitted && b_isCounted && (phaseCount == phaseSize) && IsJsonFormed(json)) ? "VALID" : "INVALID",
+           phaseCount, phaseSize, allocCount);
 
-    CleanupText(pp_sourceText, testParam.rowSize);
-    CleanupText(pp_targetText, testParam.rowSize);
+    CleanupBuffer(&targetText);
+    CleanupProgram(p_program);
+    CleanupText(p_sourceText);
+    remove(TEST_STATS_JSON);
+    remove(TEST_STATS_FILE);
 }
 
 // === Public API Functions ===
@@ -73,10 +1841,32 @@ static void CompileTest (void)
 */
 void RunTest (void)
 {
-    puts("=== Avalon Compiler Test is Runnning... ===\n");
+    puts("=== Avalon Compiler Test is Runnning... ===\n");
 
     FileReadTest();
+    EmptyFileTest();
     CompileTest();
+    LongRowTest();
+    HexConvertTest();
+    LexerThroughputTest();
+    ModelTest();
+    FeederTest();
+    LoopTest();
+    BurstTest();
+    PipelineTest();
+    LoadModeTest();
+    WaitrequestTest();
+    HandshakeTest();
+    FastIssueTest();
+    ProfileTest();
+    TimingTest();
+    PeepholeTest();
+    DiagnosticTest();
+    CacheTest();
+    DepthTest();
+    BatchTest();
+    WatchTest();
+    StatsTest();
 
     puts("\n=== ...Avalon Compiler Test is Finished. ===");
 }
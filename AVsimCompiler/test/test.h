@@ -8,11 +8,24 @@
 #define TEST_H
 
 #include <stdio.h>
+#include <time.h>
 
 #include "..\source\file_access.h"
 #include "..\source\compile.h"
+#include "..\source\emit.h"
 #include "..\source\notify_invalid.h"
 #include "..\source\common.h"
+#include "..\source\avalon_model.h"
+#include "..\source\model_batch.h"
+#include "..\source\slave_model.h"
+#include "..\source\dpi_feeder.h"
+#include "..\source\profile.h"
+#include "..\source\timing.h"
+#include "..\source\peephole.h"
+#include "..\source\cache.h"
+#include "..\source\batch.h"
+#include "..\source\stats.h"
+#include "..\source\watch.h"
 
 // === Type Definitions ===
 //
@@ -21,6 +34,69 @@
 // === Constant Definitions ===
 //
 #define TEST_SOURCE_FILE    "test\\TestAvalon.txt"
+#define TEST_EMPTY_FILE     "test\\EmptyTest.av"
+#define TEST_LONG_ROW_FILE  "test\\LongRowTest.av"
+#define TEST_LONG_ROW_SPACES 70000      // Spaces before the comment: beyond 64 KiB
+#define TEST_LEXER_FILE     "test\\LexerThroughput.av"
+#define TEST_LEXER_ROWS     2000000
+#define TEST_MODEL_FILE     "test\\ModelTest.mem"
+#define TEST_MODEL_CYCLES   240         // Cycles of the division example on the HDL
+#define TEST_MODEL_EVENTS   8
+#define TEST_MODEL_BATCH    100         // Copies of the image in the lane-parallel batch
+#define TEST_MODEL_QUOTIENT 0x34        // 157 / 3 on the div_avalon model
+#define TEST_MODEL_REMAINDER 0x1
+#define TEST_FEEDER_FILE    "test\\FeederTest"
+#define TEST_FEEDER_ROWS    1000        // Program longer than the prefetch window
+#define TEST_LOOP_FILE      "test\\LoopTest.mem"
+#define TEST_LOOP_ITERATIONS 3          // Outer repeat block of the loop test
+#define TEST_LOOP_ROW_LENGTH 32         // Rows of the unrolled program
+#define TEST_LOOP_INVALID   4           // Too deep repeat and its end, unmatched end, repeat without iteration
+#define TEST_BURST_FILE     "test\\BurstTest.mem"
+#define TEST_BURST_INVALID  5           // Stray beat, incomplete burst and its beat, too long and empty burst read
+#define TEST_PIPELINE_FILE  "test\\PipelineTest.mem"
+#define TEST_PIPELINE_READS 6           // Pipelined reads after the first load
+#define TEST_LOAD_MODE_FILE "test\\LoadModeTest.mem"
+#define TEST_LOAD_MODE_INVALID 3        // LOADs with reserved mode bits
+#define TEST_WAITREQUEST_FILE "test\\WaitrequestTest.mem"
+#define TEST_WAITREQUEST_CYCLES 5       // Cycles of waitrequest in each command of the test slave
+#define TEST_HANDSHAKE_FILE "test\\HandshakeTest.mem"
+#define TEST_HANDSHAKE_BEATS 3          // Beats of the held burst read
+#define TEST_FAST_FILE      "test\\FastIssueTest.mem"
+#define TEST_FAST_TRANSFERS 4           // Back to back transfers before the NOP
+#define TEST_PROFILE_FILE   "test\\ProfileTest.mem"
+#define TEST_PROFILE_DUMP   "test\\ProfileTest.perf"
+#define TEST_TIMING_FILE    "test\\TimingTest.mem"
+#define TEST_PEEPHOLE_FILE  "test\\PeepholeTest.mem"
+#define TEST_PEEPHOLE_MERGED 4          // NOP / WAIT merged into the first delay of their sequence
+#define TEST_PEEPHOLE_LOADS 4           // Two dead and two redundant LOADs
+#define TEST_DIAGNOSTIC_FILE "test\\DiagnosticTest.av"
+#define TEST_DIAGNOSTIC_LIMIT 8         // Cuts the repeat blocks left open at the end of the source
+#define TEST_CACHE_SOURCE   "test\\CacheTest.av"
+#define TEST_CACHE_TARGET   "test\\CacheTest.mem"
+#define TEST_CACHE_EDITED_ROW 4         // New data operand, the program counters are kept
+#define TEST_CACHE_PASSES   6           // Full build, hit, edit, stale, corrupt and other version
+#define TEST_DEPTH_FILE     "test\\DepthTest.av"
+#define TEST_DEPTH_TARGET   "DepthTest.mem"
+#define TEST_DEPTH_DEF      "test\\DepthTest.v"
+#define TEST_BATCH_FOLDER   "test"
+#define TEST_BATCH_FILE     "test\\BatchTest%d"      // Sources of the batch, the n-th has n + 1 instructions
+#define TEST_BATCH_PATTERN  "test\\BatchTest*.av"
+#define TEST_BATCH_MANIFEST "test\\BatchTest.lst"
+#define TEST_BATCH_DEF      "test\\BatchTest.v"
+#define TEST_BATCH_SUBFOLDER "sim/"
+#define TEST_BATCH_SIZE     3           // Fitting the default depth
+#define TEST_BATCH_DEF_LIMIT 1024
+#define TEST_WATCH_FOLDER   "test"
+#define TEST_WATCH_SOURCE   "WatchTest%d"       // Sources of the watched folder
+#define TEST_WATCH_DEF      "test\\WatchTest.v"
+#define TEST_WATCH_NEW_ROWS 200             // The new source needs 2^8 instructions
+#define TEST_WATCH_DEFINES  3               // Number of programs, depth and the path of the new source
+#define TEST_STATS_FILE     "test\\StatsTest.av"
+#define TEST_STATS_JSON     "test\\StatsTest.json"
+#define TEST_STATS_ROWS     (3 * CHUNK_ROWS)    // Chunks of the worker threads
+#define TEST_STATS_JOBS     4
+#define TEST_STATS_JSON_LIMIT 4096
+#define TEST_STATS_DEPTH    8           // Nesting of the JSON report
 
 
 // === Macros ===
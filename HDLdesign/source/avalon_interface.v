@@ -10,22 +10,46 @@ module avalon_interface;
 		// Instruction table size
 		OPCODE_SIZE         = 4, 				 // Operation code
 		INSTR_SIZE          = 68,     // opcode|address|data -> 4|32|32
+`ifdef AVSIM_DPI_FEEDER
+		INSTR_LIMIT_SIZE    = 31;     // Streamed by the DPI-C feeder: no instruction table
+`elsif INSTRUCTION_LIMIT_SIZE
+		INSTR_LIMIT_SIZE    = `INSTRUCTION_LIMIT_SIZE; // Set by the compiler to fit the program
+`else
 		INSTR_LIMIT_SIZE    = 7; 				 // Maximum number of acceptable instruction: 2^INSTR_LIMIT_SIZE
+`endif
 		
 	reg clk, reset;
 	wire avalonMM_chipselect, avalonMM_read, avalonMM_write;
 	wire [ADDRESS_SIZE-1:0] avalonMM_address;
-	wire [DATA_SIZE-1:0] avalonMM_readdata, readdata;
+	wire [DATA_SIZE-1:0] avalonMM_readdata, readdata, divReaddata;
+	reg [DATA_SIZE-1:0] pipelinedReaddata;
+	reg avalonMM_readdatavalid;
+	wire [INSTR_LIMIT_SIZE-1:0] readdataWatchPC;
 	wire [DATA_SIZE-1:0] avalonMM_writedata;
+	wire [7:0] avalonMM_burstcount;		// BURSTCOUNT_SIZE of avalon_master
+	wire avalonMM_beginbursttransfer;
     wire avalonMM_irq;
+    wire [INSTR_LIMIT_SIZE-1:0] programCounter, prefetchCounter;
+`ifdef AVSIM_DPI_FEEDER
+    reg [INSTR_SIZE-1:0] instructionVector, prefetchVector;
+`else
     reg [INSTR_SIZE-1:0] instructionTable [0:(2**INSTR_LIMIT_SIZE)-1];
-    wire [INSTR_LIMIT_SIZE-1:0] programCounter;
+    wire [INSTR_SIZE-1:0] instructionVector = instructionTable[programCounter];
+    wire [INSTR_SIZE-1:0] prefetchVector = instructionTable[prefetchCounter];
+`endif
     wire simReady;
   
+	// Performance counters only for the dump of the profile
+`ifdef AVSIM_PERF_DUMP
+	localparam PERF_COUNTERS = 1;
+`else
+	localparam PERF_COUNTERS = 0;
+`endif
+
 	// Instantiate AvalonMM controller module
 	avalon_master #(.ADDRESS_SIZE(ADDRESS_SIZE), .DATA_SIZE(DATA_SIZE),
                     .OPCODE_SIZE(OPCODE_SIZE), .INSTR_SIZE(INSTR_SIZE),
-                    .INSTR_LIMIT_SIZE(INSTR_LIMIT_SIZE))
+                    .INSTR_LIMIT_SIZE(INSTR_LIMIT_SIZE), .PERF_COUNTERS(PERF_COUNTERS))
     avalonMasterInst
 	( 
 		// Clock-reset
@@ -38,11 +62,18 @@ module avalon_interface;
 		.avmaster_address(avalonMM_address),
 		.avmaster_readdata(readdata),
 		.avmaster_writedata(avalonMM_writedata),
+		.avmaster_burstcount(avalonMM_burstcount),
+		.avmaster_beginbursttransfer(avalonMM_beginbursttransfer),
+		.avmaster_readdatavalid(avalonMM_readdatavalid),
+		.avmaster_waitrequest(1'b0),		// div_avalon accepts each command at once
         // Avalon Master Watch
         .readdataWatch(avalonMM_readdata),
+        .readdataWatchPC(readdataWatchPC),
         // Instruction I/O
         .programCounter(programCounter),
-        .instructionVector(instructionTable[programCounter]),
+        .instructionVector(instructionVector),
+        .prefetchCounter(prefetchCounter),
+        .prefetchVector(prefetchVector),
         // Status
         .simReady(simReady)
 	);
@@ -50,8 +81,73 @@ module avalon_interface;
 	// Clock source
 	always #10 clk = ~clk;				// 50 MHz
     
+`ifdef AVSIM_DPI_FEEDER
+    // Instruction feeder of the compiler library: a *.av source is compiled at time zero
+    import "DPI-C" function int avsim_feeder_open (input string path);
+    import "DPI-C" function int avsim_feeder_fetch (input int unsigned pc, output int unsigned opCode,
+                                                    output int unsigned address, output int unsigned data);
+    import "DPI-C" function void avsim_feeder_close ();
+
+    int unsigned feederOpCode, feederAddress, feederData;
+
+    // The instruction follows the program counter, unknown after the end of the program: simReady
+    always @ (programCounter) begin
+        if (avsim_feeder_fetch(programCounter, feederOpCode, feederAddress, feederData))
+            instructionVector = {feederOpCode[OPCODE_SIZE-1:0], feederAddress, feederData};
+        else
+            instructionVector = {INSTR_SIZE{1'bx}};
+    end
+
+    // Second read port of the fast issue: the instruction at PC+1
+    int unsigned prefetchOpCode, prefetchAddress, prefetchData;
+
+    always @ (prefetchCounter) begin
+        if (avsim_feeder_fetch(prefetchCounter, prefetchOpCode, prefetchAddress, prefetchData))
+            prefetchVector = {prefetchOpCode[OPCODE_SIZE-1:0], prefetchAddress, prefetchData};
+        else
+            prefetchVector = {INSTR_SIZE{1'bx}};
+    end
+
+    always @ (posedge simReady) begin
+        avsim_feeder_close();
+    end
+`endif
+
+`ifdef AVSIM_PERF_DUMP
+    // Performance counters of avalon_master at simReady, the profile of the compiler:
+    //   avsim <source>.av --profile `AVSIM_PERF_DUMP
+    integer perfFile, perfIndex;
+
+    always @ (posedge avalonMasterInst.perf.done_reg) begin
+        #1  // The counters of the last cycle are updated
+        perfFile = $fopen(`AVSIM_PERF_DUMP, "w");
+        $fdisplay(perfFile, "# avsim perf 1");
+        $fdisplay(perfFile, "cycles %0d", avalonMasterInst.perf.cycles_reg);
+        $fdisplay(perfFile, "bus %0d %0d", avalonMasterInst.perf.busCycles_reg, avalonMasterInst.perf.dataCycles_reg);
+        for (perfIndex = 0; perfIndex < 8; perfIndex = perfIndex + 1)
+            $fdisplay(perfFile, "phase %0d %0d", perfIndex, avalonMasterInst.perf.phaseCycles_reg[perfIndex]);
+        for (perfIndex = 0; perfIndex < 10; perfIndex = perfIndex + 1)    // Operating codes of the compiler
+            $fdisplay(perfFile, "opcode %0d %0d", perfIndex, avalonMasterInst.perf.opCodeCount_reg[perfIndex]);
+        $fdisplay(perfFile, "stall %0d %0d", avalonMasterInst.perf.longestStall_reg, avalonMasterInst.perf.stallPC_reg);
+        $fdisplay(perfFile, "longest %0d %0d", avalonMasterInst.perf.longestSpan_reg, avalonMasterInst.perf.longestPC_reg);
+        for (perfIndex = 0; perfIndex < (1 << avalonMasterInst.PERF_PC_SIZE); perfIndex = perfIndex + 1)
+            if (avalonMasterInst.perf.pcCycles_reg[perfIndex] || avalonMasterInst.perf.pcCount_reg[perfIndex])
+                $fdisplay(perfFile, "pc %0d %0d %0d", perfIndex, avalonMasterInst.perf.pcCycles_reg[perfIndex],
+                          avalonMasterInst.perf.pcCount_reg[perfIndex]);
+        $fclose(perfFile);
+    end
+`endif
+
 	initial begin
+`ifdef AVSIM_DPI_FEEDER
+`ifdef INSTRUCTION_SOURCE
+        if (avsim_feeder_open(`INSTRUCTION_SOURCE) != 0) $finish;
+`else
+        if (avsim_feeder_open(`INSTRUCTION_PATH) != 0) $finish;
+`endif
+`else
 	    $readmemh(`INSTRUCTION_PATH, instructionTable); // Store insctruction in the register table
+`endif
 		clk = 1'b0;
 		reset = 1'b1;
 		#20
@@ -75,13 +171,32 @@ module avalon_interface;
 		.div_chipselect(avalonMM_chipselect),
 		.div_write(avalonMM_write),
 		.div_writedata(avalonMM_writedata),
-		.div_readdata(readdata),
+		.div_readdata(divReaddata),
 		// To be connected to IS sender interface
 		.div_irq(avalonMM_irq),
 		// Conduit circuit
 		.div_rdy(rdy)
 	);
     
+    // Pipelined slave of div_avalon: each accepted read returns burstcount beats from the next cycle,
+    // the master captures the beats of the pipelined reads and the bursts at readdatavalid only.
+    // The fixed timing reads keep sampling the readdata of div_avalon after ReadLatency.
+    reg [7:0] readBeats;                // Beats to be returned
+    wire [8:0] readBeatsNext = readBeats + ((avalonMM_chipselect && avalonMM_read) ? avalonMM_burstcount : 0);
+
+    always @ (posedge clk) begin
+        if (reset) begin
+            avalonMM_readdatavalid <= 1'b0;
+            readBeats <= 0;
+        end
+        else begin
+            avalonMM_readdatavalid <= (readBeatsNext != 0);
+            readBeats <= readBeatsNext - (readBeatsNext != 0);
+        end
+        pipelinedReaddata <= divReaddata;
+    end
+    assign readdata = avalonMM_readdatavalid ? pipelinedReaddata : divReaddata;
+    
     //========================================================
 	// Unit Testing
 	//========================================================
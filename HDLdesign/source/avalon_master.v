@@ -11,6 +11,27 @@
   2 - WRITE
   3 - WAIT
   4 - LOAD
+  5 - REPEAT : address = address step|data step (16|16), data = number of iterations
+  6 - END    : end of the innermost REPEAT block
+  7 - BURSTREAD  : data = burst length, the beats are captured at readdatavalid
+  8 - BURSTWRITE : data = pattern step|burst length (16|16), followed by the BEAT rows
+  9 - BEAT       : write data of a beat: one row each beat, or the pattern start if the step is not 0
+  LOAD mode (address bits 15:8), bit 0: pipelined READ, issued in FETCH, captured at readdatavalid
+                                 bit 1: transfers held by waitrequest, without AVALON_DELAY
+                                 bit 2: fast issue, the instruction at PC+1 is prefetched
+  Cycles of the instructions (S: setup, RW/WW: read/write wait, L: read latency, H: hold, D: AVALON_DELAY = 25):
+                  fixed timing        waitrequest (W: held cycles)    fast issue
+  NOP             2                   2                               1
+  READ            S + RW + L + D + 3  S + W + L + 3                   S + RW + L + 1, +1 FETCH if not after a READ / WRITE
+  WRITE           S + WW + H + D + 3  S + W + H + 3                   S + WW + H + 1, +1 FETCH if not after a READ / WRITE
+  LOAD            3                   3                               1
+  WAIT n          n + 2
+  REPEAT, END     2
+  BURSTREAD N     R + N + D + 2, R: cycles from the command to the first readdatavalid (held cycles included)
+  BURSTWRITE N    N + D + 2, the BEAT rows are not fetched
+  Performance counters (PERF_COUNTERS): total, bus and data cycles, cycles of the FSM phases,
+    retired instructions by opcode, the longest stall and instruction, the cycles of each PC below 2^PERF_PC_SIZE.
+    Off by default, avalon_interface enables them and dumps them at simReady if AVSIM_PERF_DUMP is defined.
 */
 module avalon_master
 #( parameter
@@ -20,7 +41,13 @@ module avalon_master
     // Instruction table size
     OPCODE_SIZE         = 4,     // Operation code
     INSTR_SIZE          = 68,    // opcode|address|data -> 4|32|32
-    INSTR_LIMIT_SIZE    = 7     // Maximum number of acceptable instruction: 2^INSTR_LIMIT_SIZE
+    INSTR_LIMIT_SIZE    = 7,    // Maximum number of acceptable instruction: 2^INSTR_LIMIT_SIZE
+    LOOP_DEPTH          = 4,    // Maximum nesting depth of the REPEAT blocks
+    BURSTCOUNT_SIZE     = 8,    // Maximum burst length: 2^(BURSTCOUNT_SIZE-1)
+    PENDING_READS       = 4,    // Maximum number of outstanding pipelined reads: power of 2
+    PERF_COUNTERS       = 0,    // Performance counters, 0: no counters (instrumentation of the testbench)
+    PERF_PC_SIZE        = 10,   // Profiled program counters: 2^PERF_PC_SIZE
+    COUNTER_SIZE        = 32    // Size of the performance counters
 )
 ( 
     // Clock-Reset
@@ -33,11 +60,18 @@ module avalon_master
     output wire [ADDRESS_SIZE-1:0]      avmaster_address,
     output wire [DATA_SIZE-1:0]         avmaster_writedata,
     input wire [DATA_SIZE-1:0]          avmaster_readdata,
+    output wire [BURSTCOUNT_SIZE-1:0]   avmaster_burstcount,
+    output wire                         avmaster_beginbursttransfer,
+    input wire                          avmaster_readdatavalid,
+    input wire                          avmaster_waitrequest,
     // Avalon Master Watch
     output wire [DATA_SIZE-1:0]         readdataWatch,
+    output wire [INSTR_LIMIT_SIZE-1:0]  readdataWatchPC,        // Program counter of the captured read
     // Instruction I/O
     output wire [INSTR_LIMIT_SIZE-1:0]  programCounter,
     input wire [INSTR_SIZE-1:0]         instructionVector,
+    output wire [INSTR_LIMIT_SIZE-1:0]  prefetchCounter,        // PC+1 for the fast issue
+    input wire [INSTR_SIZE-1:0]         prefetchVector,
     // Status
     output wire                         simReady
   );
@@ -45,18 +79,25 @@ module avalon_master
 // === Constant Definitions ===
     localparam
        AVALON_DELAY       = 25, // Delay of Avalon bus between each operation (measured by analyzator)
-       AVALON_PARAM_SIZE   = 8; // Size of Avalon parameters: 2 x hexa = 256
+       AVALON_PARAM_SIZE   = 8, // Size of Avalon parameters: 2 x hexa = 256
+       LOOP_STEP_SIZE      = 16, // Size of the address and data steps of REPEAT
+       BURST_STEP_SIZE     = 16, // Size of the pattern step of BURSTWRITE
+       LOOP_LEVEL_SIZE     = $clog2(LOOP_DEPTH+1),
+       PENDING_SIZE        = $clog2(PENDING_READS),
+       PENDING_COUNT_SIZE  = $clog2(PENDING_READS+1);
   
     // State register operations (FSM)
-    localparam [2:0]
-       ST_FETCH         = 3'h0,
-       ST_READ_TIMING   = 3'h1,
-       ST_READ_LATENCY  = 3'h2,
-       ST_WRITE_TIMING  = 3'h3,
-       ST_WRITE_HOLD    = 3'h4,
-       ST_WAIT          = 3'h5,          
-       ST_LOAD          = 3'h6,
-       ST_PC_INCR       = 3'h7;
+    localparam [3:0]
+       ST_FETCH         = 4'h0,
+       ST_READ_TIMING   = 4'h1,
+       ST_READ_LATENCY  = 4'h2,
+       ST_WRITE_TIMING  = 4'h3,
+       ST_WRITE_HOLD    = 4'h4,
+       ST_WAIT          = 4'h5,          
+       ST_LOAD          = 4'h6,
+       ST_PC_INCR       = 4'h7,
+       ST_BURST_READ    = 4'h8,
+       ST_BURST_WRITE   = 4'h9;
 
      // Opcode to be FETCHed
      localparam [3:0]
@@ -64,16 +105,34 @@ module avalon_master
        READ    = 4'h1, // Read operation
        WRITE   = 4'h2, // Write operation
        WAIT    = 4'h3, // Wait operation
-       LOAD    = 4'h4; // LOAD avalon MM slave parameters
+       LOAD    = 4'h4, // LOAD avalon MM slave parameters
+       LOOP    = 4'h5, // REPEAT: open a block
+       LOOP_END = 4'h6, // END: jump back to the first instruction of the block
+       BURST_READ = 4'h7, // Burst read operation
+       BURST_WRITE = 4'h8, // Burst write operation
+       BEAT    = 4'h9; // Write data of a burst beat
+
+     // Phases of the performance counters
+     localparam [2:0]
+       PERF_FETCH   = 3'h0, // FETCH without command
+       PERF_SETUP   = 3'h1, // Chipselect before the strobe
+       PERF_STROBE  = 3'h2, // Read / write strobe and the beats of the bursts
+       PERF_STALL   = 3'h3, // Command held by waitrequest
+       PERF_LATENCY = 3'h4, // Read latency
+       PERF_HOLD    = 3'h5, // Write hold
+       PERF_WAIT    = 3'h6, // ST_WAIT: WAIT and AVALON_DELAY
+       PERF_CONTROL = 3'h7; // LOAD, PC_INCR
      
 // === Signal Declarations ===
     // Decoding signals
     wire [3:0]              opCode;  // Operation code
     wire [ADDRESS_SIZE-1:0]    address; // Address line
     wire [DATA_SIZE-1:0]    data;    // Data line
+    wire [3:0]              prefetchOpCode;     // Instruction at PC+1
+    wire [ADDRESS_SIZE-1:0] prefetchAddress;
      
     // State register
-    reg [2:0] stateNext_reg, state_reg;
+    reg [3:0] stateNext_reg, state_reg;
      
      // Avalon parameters
     reg [AVALON_PARAM_SIZE-1:0]
@@ -91,10 +150,52 @@ module avalon_master
     wire waitEnd;                                               // Trigger signal
      
     // Internal registers
-    reg [7:0] pcNext_reg, pc_reg; // Program counter
+    reg [INSTR_LIMIT_SIZE-1:0] pcNext_reg, pc_reg; // Program counter
+     
+    // Transfer registers latched in FETCH
+    reg [ADDRESS_SIZE-1:0] addressNext_reg, address_reg;                        // Address with the loop offset
+    reg [BURSTCOUNT_SIZE-1:0] burstCountNext_reg, burstCount_reg;               // Burst length
+    reg [BURSTCOUNT_SIZE-1:0] beatCountNext_reg, beatCount_reg;                 // Beats left
+    reg [BURST_STEP_SIZE-1:0] burstStepNext_reg, burstStep_reg;                 // Pattern step, 0: inline beats
+    reg [DATA_SIZE-1:0] patternOffsetNext_reg, patternOffset_reg;               // Added to the pattern start
+    reg burstBeginNext_reg, burstBegin_reg;                                     // First cycle of the burst
+    reg burstCommandNext_reg, burstCommand_reg;                                 // Burst read command until accepted
+     
+    // Repeat blocks: one entry for each nesting level
+    reg [DATA_SIZE-1:0] loopCount_reg [0:LOOP_DEPTH-1];             // Iterations left
+    reg [INSTR_LIMIT_SIZE-1:0] loopPC_reg [0:LOOP_DEPTH-1];         // First instruction of the block
+    reg [ADDRESS_SIZE-1:0] loopStep_reg [0:LOOP_DEPTH-1];           // address step|data step
+    reg [ADDRESS_SIZE-1:0] loopAddressBase_reg [0:LOOP_DEPTH-1];    // Offsets before the block
+    reg [DATA_SIZE-1:0] loopDataBase_reg [0:LOOP_DEPTH-1];
+    reg [LOOP_LEVEL_SIZE-1:0] loopLevel_reg;                        // Number of the open blocks
+    reg [ADDRESS_SIZE-1:0] addressOffset_reg;                       // Added to the address of READ / WRITE
+    reg [DATA_SIZE-1:0] dataOffset_reg;                             // Added to the data of WRITE
+    wire [LOOP_LEVEL_SIZE-1:0] loopTop;                             // Innermost block
+    wire loopBack;                                                  // END jumps back
+     
+    // Pipelined reads: program counters of the outstanding reads in issue order
+    reg pipelined_reg;                                              // LOAD mode bit 0
+    reg [INSTR_LIMIT_SIZE-1:0] pendingPC_reg [0:PENDING_READS-1];
+    reg [PENDING_SIZE-1:0] pendingHead_reg, pendingTail_reg;
+    reg [PENDING_COUNT_SIZE-1:0] pendingCount_reg;
+    reg readIssue_reg;
+    wire readDataValid;
+     
+    // waitrequest mode: the slave holds the command, the transfer ends in PC_INCR
+    reg waitrequest_reg;                                            // LOAD mode bit 1
+    wire commandHeld;
+    wire [3:0] transferEnd;
+     
+    // Fast issue mode: the instruction at PC+1 is decoded at the end of the READ / WRITE
+    reg fastIssue_reg;                                              // LOAD mode bit 2
+    reg transferEndEN_reg;
      
     // Control registers
-    reg readDataEN_reg, loadEN_reg;
+    reg readDataEN_reg, loadEN_reg, loopPushEN_reg, loopEndEN_reg;
+    
+    // Performance counters
+    reg retireEN_reg;                                               // The instruction is completed at the clock edge
+    reg [2:0] perfPhase_reg;
      
 // === Core Logic ===
      // Wait phase counter
@@ -123,6 +224,13 @@ module avalon_master
             av_holdStore_reg <= 0;
             av_readLatencyStore_reg <= 0;    
             wait_reg <= 0;
+            address_reg <= 0;
+            burstCount_reg <= 0;
+            beatCount_reg <= 0;
+            burstStep_reg <= 0;
+            patternOffset_reg <= 0;
+            burstBegin_reg <= 0;
+            burstCommand_reg <= 0;
        end
        else begin
             state_reg <= stateNext_reg;
@@ -133,6 +241,13 @@ module avalon_master
             av_hold_reg <= av_holdNext_reg;
             av_readLatency_reg <= av_readLatencyNext_reg;
             wait_reg <= waitNext_reg;
+            address_reg <= addressNext_reg;
+            burstCount_reg <= burstCountNext_reg;
+            beatCount_reg <= beatCountNext_reg;
+            burstStep_reg <= burstStepNext_reg;
+            patternOffset_reg <= patternOffsetNext_reg;
+            burstBegin_reg <= burstBeginNext_reg;
+            burstCommand_reg <= burstCommandNext_reg;
             if (loadEN_reg) begin
                 av_setupStore_reg <= setup;
                 av_readWaitStore_reg <= readWait;
@@ -143,6 +258,62 @@ module avalon_master
         end
      end
        
+    // Repeat block registers
+    always @ (posedge clk, posedge reset) begin
+        if (reset) begin
+            loopLevel_reg <= 0;
+            addressOffset_reg <= 0;
+            dataOffset_reg <= 0;
+        end
+        else if (loopPushEN_reg && (loopLevel_reg < LOOP_DEPTH)) begin
+            loopCount_reg[loopLevel_reg] <= data;
+            loopPC_reg[loopLevel_reg] <= pc_reg + 1;
+            loopStep_reg[loopLevel_reg] <= address;
+            loopAddressBase_reg[loopLevel_reg] <= addressOffset_reg;
+            loopDataBase_reg[loopLevel_reg] <= dataOffset_reg;
+            loopLevel_reg <= loopLevel_reg + 1;
+        end
+        else if (loopEndEN_reg && (loopLevel_reg != 0)) begin
+            if (loopBack) begin
+                loopCount_reg[loopTop] <= loopCount_reg[loopTop] - 1;
+                addressOffset_reg <= addressOffset_reg + loopStep_reg[loopTop][2*LOOP_STEP_SIZE-1:LOOP_STEP_SIZE];
+                dataOffset_reg <= dataOffset_reg + loopStep_reg[loopTop][LOOP_STEP_SIZE-1:0];
+            end
+            else begin
+                addressOffset_reg <= loopAddressBase_reg[loopTop];
+                dataOffset_reg <= loopDataBase_reg[loopTop];
+                loopLevel_reg <= loopTop;
+            end
+        end
+    end
+       
+    // Outstanding pipelined reads
+    always @ (posedge clk, posedge reset) begin
+        if (reset) begin
+            pipelined_reg <= 0;
+            waitrequest_reg <= 0;
+            fastIssue_reg <= 0;
+            pendingHead_reg <= 0;
+            pendingTail_reg <= 0;
+            pendingCount_reg <= 0;
+        end
+        else begin
+            if (loadEN_reg) begin
+                pipelined_reg <= address[AVALON_PARAM_SIZE];
+                waitrequest_reg <= address[AVALON_PARAM_SIZE+1];
+                fastIssue_reg <= address[AVALON_PARAM_SIZE+2];
+            end
+            if (readIssue_reg) begin
+                pendingPC_reg[pendingTail_reg] <= pc_reg;
+                pendingTail_reg <= pendingTail_reg + 1;
+            end
+            if (readDataValid) begin
+                pendingHead_reg <= pendingHead_reg + 1;
+            end
+            pendingCount_reg <= pendingCount_reg + readIssue_reg - readDataValid;
+        end
+    end
+       
      // Finite State Machine
      always @* begin
         // Registers
@@ -154,6 +325,13 @@ module avalon_master
         av_holdNext_reg = av_hold_reg;
         av_readLatencyNext_reg = av_readLatency_reg;
         waitNext_reg = wait_reg;
+        addressNext_reg = address_reg;
+        burstCountNext_reg = burstCount_reg;
+        beatCountNext_reg = beatCount_reg;
+        burstStepNext_reg = burstStep_reg;
+        patternOffsetNext_reg = patternOffset_reg;
+        burstBeginNext_reg = burstBegin_reg;
+        burstCommandNext_reg = burstCommand_reg;
         // Default values
         avmaster_chipselect = 1'b0;
         avmaster_read = 1'b0;
@@ -161,34 +339,80 @@ module avalon_master
         waitCountReset_reg = 1'b1;
         readDataEN_reg = 1'b0;
         loadEN_reg = 1'b0;
+        loopPushEN_reg = 1'b0;
+        loopEndEN_reg = 1'b0;
+        readIssue_reg = 1'b0;
+        transferEndEN_reg = 1'b0;
+        retireEN_reg = 1'b0;
         
         case (state_reg)
         //------- Instruction Fetching ---------------
             ST_FETCH: begin
+                if (~simReady && (opCode == READ) && pipelined_reg) begin  // Pipelined read: the command is issued in FETCH
+                    if (pendingCount_reg < PENDING_READS) begin
+                        avmaster_chipselect = 1'b1;
+                        avmaster_read = 1'b1;
+                        if (~commandHeld) begin
+                            readIssue_reg = 1'b1;
+                            retireEN_reg = 1'b1;
+                            pcNext_reg = pc_reg + 1;
+                        end
+                    end
+                end
+                else if (pendingCount_reg == 0) begin       // The other instructions wait for the outstanding reads
                 case (opCode)
                     NOP:  begin                             // No operation
-                        stateNext_reg = ST_PC_INCR;         // Next operation
+                        if (fastIssue_reg) begin            // Completed in FETCH
+                            retireEN_reg = 1'b1;
+                            pcNext_reg = pc_reg + 1;
+                        end
+                        else begin
+                            stateNext_reg = ST_PC_INCR;     // Next operation
+                        end
                     end
                     READ: begin                             // Read operation
                       stateNext_reg = ST_READ_TIMING;
                       av_setupNext_reg = av_setupStore_reg;
-                      av_readWaitNext_reg = av_readWaitStore_reg;
+                      av_readWaitNext_reg = (waitrequest_reg) ? 0 : av_readWaitStore_reg;
                       av_readLatencyNext_reg = av_readLatencyStore_reg;
                     end
                     WRITE: begin                            // Write operation
                       stateNext_reg = ST_WRITE_TIMING;
                       av_setupNext_reg = av_setupStore_reg;
-                      av_writeWaitNext_reg = av_writeWaitStore_reg;
+                      av_writeWaitNext_reg = (waitrequest_reg) ? 0 : av_writeWaitStore_reg;
                       av_holdNext_reg = av_holdStore_reg; 
                     end
                     WAIT: begin                             // Wait operation
                       stateNext_reg = ST_WAIT;
                     end
                     LOAD: begin                             // LOAD avalon MM slave parameters
-                      stateNext_reg = ST_LOAD;
+                      if (fastIssue_reg) begin              // Completed in FETCH
+                          loadEN_reg = 1'b1;
+                          retireEN_reg = 1'b1;
+                          pcNext_reg = pc_reg + 1;
+                      end
+                      else begin
+                          stateNext_reg = ST_LOAD;
+                      end
+                    end
+                    BURST_READ: begin                       // Burst read operation
+                      stateNext_reg = ST_BURST_READ;
+                    end
+                    BURST_WRITE: begin                      // Burst write operation
+                      stateNext_reg = ST_BURST_WRITE;
+                      pcNext_reg = pc_reg + 1;              // First BEAT row
                     end
                     default: stateNext_reg = ST_PC_INCR;    // Next instruction
                   endcase // opCode
+                end
+                // Latch the transfer parameters
+                addressNext_reg = address + addressOffset_reg;
+                burstCountNext_reg = data[BURSTCOUNT_SIZE-1:0];
+                beatCountNext_reg = data[BURSTCOUNT_SIZE-1:0];
+                burstStepNext_reg = data[2*BURST_STEP_SIZE-1:BURST_STEP_SIZE];
+                patternOffsetNext_reg = 0;
+                burstBeginNext_reg = 1'b1;
+                burstCommandNext_reg = 1'b1;
                 // Set avalon wait parameter
                 if (opCode == WAIT) begin
                     waitNext_reg = data;
@@ -203,6 +427,9 @@ module avalon_master
                 if (av_setup_reg) begin
                     av_setupNext_reg = av_setup_reg - 1;
                 end
+                else if (commandHeld) begin
+                    avmaster_read = 1'b1;               // Held by the slave
+                end
                 else if (av_readWait_reg) begin
                     av_readWaitNext_reg = av_readWait_reg - 1;
                     avmaster_read = 1'b1;
@@ -214,7 +441,8 @@ module avalon_master
                 end
                 else begin
                     avmaster_read = 1'b1;
-                    stateNext_reg = ST_WAIT;
+                    stateNext_reg = transferEnd;
+                    transferEndEN_reg = 1'b1;
                     avmaster_read = 1'b1;
                     readDataEN_reg = 1'b1;
                 end
@@ -226,7 +454,8 @@ module avalon_master
                 end
                 else begin
                     readDataEN_reg = 1'b1;
-                    stateNext_reg = ST_WAIT;
+                    stateNext_reg = transferEnd;
+                    transferEndEN_reg = 1'b1;
                 end
             end // ST_READ_LATENCY
         //------- Write Timing --------------
@@ -235,6 +464,9 @@ module avalon_master
                 if (av_setup_reg) begin
                     av_setupNext_reg = av_setup_reg - 1;
                 end
+                else if (commandHeld) begin
+                    avmaster_write = 1'b1;              // Held by the slave
+                end
                 else if (av_writeWait_reg) begin
                     av_writeWaitNext_reg = av_writeWait_reg - 1;
                     avmaster_write = 1'b1;
@@ -246,7 +478,8 @@ module avalon_master
                 end
                 else begin
                     avmaster_write = 1'b1;
-                    stateNext_reg = ST_WAIT;
+                    stateNext_reg = transferEnd;
+                    transferEndEN_reg = 1'b1;
                 end
             end // ST_WRITE_TIMING
         //------- Write Hold ----------------
@@ -256,7 +489,8 @@ module avalon_master
                     av_holdNext_reg = av_hold_reg - 1;
                 end
                 else begin
-                    stateNext_reg = ST_WAIT;
+                    stateNext_reg = transferEnd;
+                    transferEndEN_reg = 1'b1;
                 end
             end // ST_WRITE_HOLD
         //------- Wait ----------------------
@@ -271,15 +505,79 @@ module avalon_master
               loadEN_reg = 1'b1;
               stateNext_reg = ST_PC_INCR;
             end // ST_LOAD
+        //------- Burst Read -----------------
+            ST_BURST_READ: begin
+                avmaster_chipselect = 1'b1;
+                avmaster_read = burstCommand_reg;   // Command cycles
+                burstBeginNext_reg = 1'b0;          // beginbursttransfer: first cycle only, even if held
+                if (burstCommand_reg) begin
+                    if (~commandHeld) begin
+                        burstCommandNext_reg = 1'b0;
+                    end
+                end
+                else if (avmaster_readdatavalid) begin
+                    readDataEN_reg = 1'b1;          // One beat each readdatavalid
+                    if (beatCount_reg > 1) begin
+                        beatCountNext_reg = beatCount_reg - 1;
+                    end
+                    else begin
+                        stateNext_reg = transferEnd;
+                    end
+                end
+            end // ST_BURST_READ
+        //------- Burst Write ----------------
+            ST_BURST_WRITE: begin
+                avmaster_chipselect = 1'b1;
+                avmaster_write = 1'b1;
+                burstBeginNext_reg = 1'b0;          // beginbursttransfer: first cycle only, even if held
+                if (commandHeld) begin
+                    // The beat is held by the slave
+                end
+                else if (beatCount_reg > 1) begin
+                    beatCountNext_reg = beatCount_reg - 1;
+                    if (burstStep_reg) begin
+                        patternOffsetNext_reg = patternOffset_reg + burstStep_reg;
+                    end
+                    else begin
+                        pcNext_reg = pc_reg + 1;    // Next BEAT row
+                    end
+                end
+                else begin
+                    stateNext_reg = transferEnd;
+                end
+            end // ST_BURST_WRITE
         //------- Increment Program Counter --------
             ST_PC_INCR: begin
                 if (~simReady) begin            // Simulator is not finished
-                    pcNext_reg = pc_reg + 1;
+                    loopPushEN_reg = (opCode == LOOP);
+                    loopEndEN_reg = (opCode == LOOP_END);
+                    pcNext_reg = (loopEndEN_reg && loopBack) ? loopPC_reg[loopTop] : pc_reg + 1;
                     stateNext_reg = ST_FETCH;
+                    retireEN_reg = 1'b1;
                 end
             end // ST_PC_INCR
        endcase // state_reg
          
+        // Fast issue: the prefetched READ / WRITE starts at once, the other instructions are FETCHed
+        if (transferEndEN_reg && fastIssue_reg) begin
+            retireEN_reg = 1'b1;
+            pcNext_reg = pc_reg + 1;
+            stateNext_reg = ST_FETCH;
+            addressNext_reg = prefetchAddress + addressOffset_reg;
+            if ((prefetchOpCode == READ) && ~pipelined_reg) begin
+                stateNext_reg = ST_READ_TIMING;
+                av_setupNext_reg = av_setupStore_reg;
+                av_readWaitNext_reg = (waitrequest_reg) ? 0 : av_readWaitStore_reg;
+                av_readLatencyNext_reg = av_readLatencyStore_reg;
+            end
+            else if (prefetchOpCode == WRITE) begin
+                stateNext_reg = ST_WRITE_TIMING;
+                av_setupNext_reg = av_setupStore_reg;
+                av_writeWaitNext_reg = (waitrequest_reg) ? 0 : av_writeWaitStore_reg;
+                av_holdNext_reg = av_holdStore_reg;
+            end
+        end
+         
      end
      
 // === Controller Logic ===
@@ -288,26 +586,137 @@ module avalon_master
      assign address = instructionVector [INSTR_SIZE-(OPCODE_SIZE+1):INSTR_SIZE-(ADDRESS_SIZE+OPCODE_SIZE)];
      assign data = instructionVector [DATA_SIZE-1:0];
      assign simReady = (instructionVector === {INSTR_SIZE{1'bx}});  // Determine unknown logic with case equality
+     assign prefetchCounter = pc_reg + 1;
+     assign prefetchOpCode = prefetchVector [INSTR_SIZE-1:INSTR_SIZE-OPCODE_SIZE];
+     assign prefetchAddress = prefetchVector [INSTR_SIZE-(OPCODE_SIZE+1):INSTR_SIZE-(ADDRESS_SIZE+OPCODE_SIZE)];
+     
+     // Repeat block control signals
+     assign loopTop = loopLevel_reg - 1;
+     assign loopBack = (loopLevel_reg != 0) && (loopCount_reg[loopTop] > 1);
      
      // Wait state controll signal
      assign waitEnd = (waitCount_reg == (wait_reg-1));
      
      // LOAD parameters
      /* opcode: 4 - LOAD : PARAM = 2xhex = 8bit	
-          address|data = 000000(setup)	| (hold, readLatency, writeWait, readWait) */
-     assign setup = (state_reg == ST_LOAD) ? address[AVALON_PARAM_SIZE-1:0] : 0;
-     assign hold = (state_reg == ST_LOAD) ? data[4*AVALON_PARAM_SIZE-1:3*AVALON_PARAM_SIZE] : 0;
-     assign readLatency = (state_reg == ST_LOAD) ? data[3*AVALON_PARAM_SIZE-1:2*AVALON_PARAM_SIZE] : 0;
-     assign writeWait = (state_reg == ST_LOAD) ? data[2*AVALON_PARAM_SIZE-1:AVALON_PARAM_SIZE] : 0;
-     assign readWait = (state_reg == ST_LOAD) ? data[AVALON_PARAM_SIZE-1:0] : 0;
+          address|data = 0000(mode)(setup)	| (hold, readLatency, writeWait, readWait) */
+     assign setup = (loadEN_reg) ? address[AVALON_PARAM_SIZE-1:0] : 0;
+     assign hold = (loadEN_reg) ? data[4*AVALON_PARAM_SIZE-1:3*AVALON_PARAM_SIZE] : 0;
+     assign readLatency = (loadEN_reg) ? data[3*AVALON_PARAM_SIZE-1:2*AVALON_PARAM_SIZE] : 0;
+     assign writeWait = (loadEN_reg) ? data[2*AVALON_PARAM_SIZE-1:AVALON_PARAM_SIZE] : 0;
+     assign readWait = (loadEN_reg) ? data[AVALON_PARAM_SIZE-1:0] : 0;
        
 // === Data Path ===     
      // Avalon Bus Data Path
-     assign avmaster_address    = (avmaster_chipselect) ? address : 0;
-     assign readdataWatch   = (readDataEN_reg) ? avmaster_readdata : 0;
-     assign avmaster_writedata  = ((state_reg == ST_WRITE_TIMING) || (state_reg == ST_WRITE_HOLD)) ? data : 0;
+     assign readDataValid       = avmaster_readdatavalid && (pendingCount_reg != 0);
+     assign commandHeld         = waitrequest_reg && avmaster_waitrequest;     // Used in the command cycles only
+     assign transferEnd         = (waitrequest_reg) ? ST_PC_INCR : ST_WAIT;
+     assign avmaster_address    = (avmaster_chipselect) ? ((state_reg == ST_FETCH) ? address + addressOffset_reg : address_reg) : 0;
+     assign readdataWatch   = (readDataEN_reg || readDataValid) ? avmaster_readdata : 0;
+     assign readdataWatchPC = (readDataValid) ? pendingPC_reg[pendingHead_reg] : pc_reg;
+     assign avmaster_writedata  = ((state_reg == ST_WRITE_TIMING) || (state_reg == ST_WRITE_HOLD) || (state_reg == ST_BURST_WRITE)) ?
+                                  data + dataOffset_reg + patternOffset_reg : 0;
+     assign avmaster_burstcount = ((state_reg == ST_BURST_READ) || (state_reg == ST_BURST_WRITE)) ? burstCount_reg : 1;
+     assign avmaster_beginbursttransfer = ((state_reg == ST_BURST_READ) || (state_reg == ST_BURST_WRITE)) && burstBegin_reg;
      assign programCounter = pc_reg;
 
+// === Performance Counters ===
+     // Phase of the cycle
+     always @* begin
+        case (state_reg)
+            ST_FETCH:           perfPhase_reg = (avmaster_chipselect) ? PERF_STROBE : PERF_FETCH;
+            ST_READ_TIMING,
+            ST_WRITE_TIMING:    perfPhase_reg = (avmaster_read || avmaster_write) ? PERF_STROBE : PERF_SETUP;
+            ST_READ_LATENCY:    perfPhase_reg = PERF_LATENCY;
+            ST_WRITE_HOLD:      perfPhase_reg = PERF_HOLD;
+            ST_WAIT:            perfPhase_reg = PERF_WAIT;
+            ST_BURST_READ:      perfPhase_reg = (avmaster_read || readDataEN_reg) ? PERF_STROBE : PERF_LATENCY;
+            ST_BURST_WRITE:     perfPhase_reg = PERF_STROBE;
+            default:            perfPhase_reg = PERF_CONTROL;
+        endcase
+        if (commandHeld && (avmaster_read || avmaster_write)) begin
+            perfPhase_reg = PERF_STALL;
+        end
+     end
+
+     generate
+     if (PERF_COUNTERS) begin : perf
+        reg done_reg;                                               // Frozen after the cycle of simReady in PC_INCR
+        reg [COUNTER_SIZE-1:0] cycles_reg, busCycles_reg, dataCycles_reg;
+        reg [COUNTER_SIZE-1:0] phaseCycles_reg [0:7];
+        reg [COUNTER_SIZE-1:0] opCodeCount_reg [0:(2**OPCODE_SIZE)-1];  // Retired instructions
+        reg [COUNTER_SIZE-1:0] stall_reg, longestStall_reg;            // Held command cycles
+        reg [COUNTER_SIZE-1:0] span_reg, longestSpan_reg;              // Cycles of the instruction
+        reg [INSTR_LIMIT_SIZE-1:0] issuePC_reg, stallPC_reg, longestPC_reg;
+        reg [3:0] issueOpCode_reg;                                  // The BEAT rows belong to their burst
+        reg [COUNTER_SIZE-1:0] pcCycles_reg [0:(2**PERF_PC_SIZE)-1];
+        reg [COUNTER_SIZE-1:0] pcCount_reg [0:(2**PERF_PC_SIZE)-1];
+        wire stalled = commandHeld && (avmaster_read || avmaster_write);
+        wire [COUNTER_SIZE-1:0] stallNext = (stalled) ? stall_reg + 1 : 0;
+        wire [COUNTER_SIZE-1:0] spanNext = span_reg + 1;
+        wire [3:0] retiredOpCode = (state_reg == ST_FETCH) ? opCode : issueOpCode_reg;
+        wire pcProfiled = (issuePC_reg < 2**PERF_PC_SIZE);
+        integer i;
+
+        always @ (posedge clk, posedge reset) begin
+            if (reset) begin
+                done_reg <= 0;
+                cycles_reg <= 0;
+                busCycles_reg <= 0;
+                dataCycles_reg <= 0;
+                stall_reg <= 0;
+                longestStall_reg <= 0;
+                span_reg <= 0;
+                longestSpan_reg <= 0;
+                issuePC_reg <= 0;
+                stallPC_reg <= 0;
+                longestPC_reg <= 0;
+                issueOpCode_reg <= 0;
+                for (i = 0; i < 8; i = i + 1)
+                    phaseCycles_reg[i] <= 0;
+                for (i = 0; i < 2**OPCODE_SIZE; i = i + 1)
+                    opCodeCount_reg[i] <= 0;
+                for (i = 0; i < 2**PERF_PC_SIZE; i = i + 1) begin
+                    pcCycles_reg[i] <= 0;
+                    pcCount_reg[i] <= 0;
+                end
+            end
+            else if (~done_reg) begin
+                done_reg <= simReady && (state_reg == ST_PC_INCR);
+                cycles_reg <= cycles_reg + 1;
+                busCycles_reg <= busCycles_reg + avmaster_chipselect;
+                dataCycles_reg <= dataCycles_reg + (readDataEN_reg || readDataValid || (avmaster_write && ~commandHeld));
+                phaseCycles_reg[perfPhase_reg] <= phaseCycles_reg[perfPhase_reg] + 1;
+                stall_reg <= stallNext;
+                if (stallNext > longestStall_reg) begin
+                    longestStall_reg <= stallNext;
+                    stallPC_reg <= issuePC_reg;
+                end
+                if (pcProfiled) begin
+                    pcCycles_reg[issuePC_reg] <= pcCycles_reg[issuePC_reg] + 1;
+                end
+                if (state_reg == ST_FETCH) begin
+                    issueOpCode_reg <= opCode;
+                end
+                span_reg <= spanNext;
+                if (retireEN_reg) begin
+                    opCodeCount_reg[retiredOpCode] <= opCodeCount_reg[retiredOpCode] + 1;
+                    if (pcProfiled) begin
+                        pcCount_reg[issuePC_reg] <= pcCount_reg[issuePC_reg] + 1;
+                    end
+                    if (spanNext > longestSpan_reg) begin
+                        longestSpan_reg <= spanNext;
+                        longestPC_reg <= issuePC_reg;
+                    end
+                    span_reg <= 0;
+                    issuePC_reg <= pcNext_reg;
+                    issueOpCode_reg <= prefetchOpCode;       // Fast issue of PC+1 without FETCH
+                end
+            end
+        end
+     end
+     endgenerate
+
 endmodule
 
 